@@ -0,0 +1,71 @@
+#define _DEFAULT_SOURCE
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "core/lna_file.h"
+#include "core/lna_assert.h"
+#include "core/lna_log.h"
+
+bool lna_file_map(lna_file_mapping_t* file_mapping, const char* filename)
+{
+    lna_assert(file_mapping)
+    lna_assert(file_mapping->content == NULL)
+    lna_assert(filename)
+    lna_assert(strlen(filename) > 0)
+
+    int fd = open(filename, O_RDONLY);
+    if (fd == -1)
+    {
+        return false;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1 || file_stat.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    //! the mapping keeps its own reference on the file
+    void* content = mmap(
+        NULL,
+        (size_t)file_stat.st_size,
+        PROT_READ,
+        MAP_PRIVATE,
+        fd,
+        0
+        );
+    close(fd);
+    if (content == MAP_FAILED)
+    {
+        lna_log_error("cannot map file %s", filename);
+        return false;
+    }
+    madvise(
+        content,
+        (size_t)file_stat.st_size,
+        MADV_WILLNEED
+        );
+
+    file_mapping->content   = content;
+    file_mapping->size      = (size_t)file_stat.st_size;
+    file_mapping->handle    = NULL;
+    return true;
+}
+
+void lna_file_unmap(lna_file_mapping_t* file_mapping)
+{
+    lna_assert(file_mapping)
+    lna_assert(file_mapping->content)
+
+    munmap(
+        (void*)file_mapping->content,
+        file_mapping->size
+        );
+
+    file_mapping->content   = NULL;
+    file_mapping->size      = 0;
+    file_mapping->handle    = NULL;
+}
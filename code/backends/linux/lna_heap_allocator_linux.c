@@ -0,0 +1,160 @@
+#define _DEFAULT_SOURCE
+#include <stdint.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "core/lna_heap_allocator.h"
+#include "core/lna_assert.h"
+#include "core/lna_log.h"
+
+//! pages are committed by blocks of at least this size to limit the system calls
+static const size_t LNA_HEAP_ALLOCATOR_MIN_COMMIT_GRANULARITY   = 64 * 1024;
+static const size_t LNA_HEAP_ALLOCATOR_HUGE_PAGE_SIZE           = 2 * 1024 * 1024;
+
+static size_t lna_heap_allocator_align_up(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+//! reserve the address space, aligned on the huge page size so the system
+//! can back it with transparent huge pages.
+static char* lna_heap_allocator_reserve_aligned(size_t size_in_bytes, size_t alignment)
+{
+    char* reserved = mmap(
+        NULL,
+        size_in_bytes + alignment,
+        PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+        -1,
+        0
+        );
+    if (reserved == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+    char* aligned = (char*)lna_heap_allocator_align_up((size_t)(uintptr_t)reserved, alignment);
+    if (aligned > reserved)
+    {
+        munmap(reserved, (size_t)(aligned - reserved));
+    }
+    munmap(aligned + size_in_bytes, (size_t)(reserved + alignment - aligned));
+    return aligned;
+}
+
+void lna_heap_allocator_init_with_page_mode(lna_heap_allocator_t* allocator, size_t max_size_in_bytes, lna_heap_allocator_page_mode_t page_mode)
+{
+    lna_assert(allocator)
+    lna_assert(allocator->content == 0)
+    lna_assert(allocator->cur_content_offset == 0)
+    lna_assert(allocator->max_content_size == 0)
+    lna_assert(max_size_in_bytes > 0)
+
+    const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+    allocator->commit_granularity = page_size > LNA_HEAP_ALLOCATOR_MIN_COMMIT_GRANULARITY ? page_size : LNA_HEAP_ALLOCATOR_MIN_COMMIT_GRANULARITY;
+
+    if (page_mode == LNA_HEAP_ALLOCATOR_PAGE_MODE_EXPLICIT_HUGE)
+    {
+#ifdef MAP_HUGETLB
+        //! without MAP_NORESERVE the huge pages are taken from the pool now,
+        //! the mapping fails instead of crashing at the first touch if the
+        //! pool is too small.
+        const size_t size_in_bytes = lna_heap_allocator_align_up(max_size_in_bytes, LNA_HEAP_ALLOCATOR_HUGE_PAGE_SIZE);
+        char* content = mmap(
+            NULL,
+            size_in_bytes,
+            PROT_NONE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+            -1,
+            0
+            );
+        if (content != MAP_FAILED)
+        {
+            allocator->content              = content;
+            allocator->max_content_size     = size_in_bytes;
+            allocator->commit_granularity   = LNA_HEAP_ALLOCATOR_HUGE_PAGE_SIZE;
+        }
+        else
+#endif
+        {
+            lna_log_warning("explicit huge pages are not available, fall back to transparent huge pages");
+            page_mode = LNA_HEAP_ALLOCATOR_PAGE_MODE_TRANSPARENT_HUGE;
+        }
+    }
+
+    if (allocator->content == NULL)
+    {
+        const size_t alignment = page_mode == LNA_HEAP_ALLOCATOR_PAGE_MODE_TRANSPARENT_HUGE ? LNA_HEAP_ALLOCATOR_HUGE_PAGE_SIZE : allocator->commit_granularity;
+        if (page_mode == LNA_HEAP_ALLOCATOR_PAGE_MODE_TRANSPARENT_HUGE)
+        {
+            allocator->commit_granularity = LNA_HEAP_ALLOCATOR_HUGE_PAGE_SIZE;
+        }
+        allocator->max_content_size = lna_heap_allocator_align_up(max_size_in_bytes, allocator->commit_granularity);
+        allocator->content          = lna_heap_allocator_reserve_aligned(allocator->max_content_size, alignment);
+        lna_assert(allocator->content)
+
+#ifdef MADV_HUGEPAGE
+        if (page_mode == LNA_HEAP_ALLOCATOR_PAGE_MODE_TRANSPARENT_HUGE)
+        {
+            if (madvise(allocator->content, allocator->max_content_size, MADV_HUGEPAGE) != 0)
+            {
+                lna_log_warning("transparent huge pages are not available");
+            }
+        }
+#endif
+    }
+
+    lna_log_message(
+        "reserve %d bytes of address space for allocator %p, commit granularity %d bytes",
+        allocator->max_content_size,
+        allocator,
+        allocator->commit_granularity
+        );
+
+    allocator->cur_content_offset   = 0;
+    allocator->committed_size       = 0;
+}
+
+void lna_heap_allocator_commit(lna_heap_allocator_t* allocator, size_t size_in_bytes)
+{
+    lna_assert(allocator)
+    lna_assert(allocator->content)
+    lna_assert(size_in_bytes > allocator->committed_size)
+    lna_assert(size_in_bytes <= allocator->max_content_size)
+
+    //! the pages become accessible but are only backed by physical memory
+    //! when they are touched, so the resident memory tracks the actual use.
+    const int result = mprotect(
+        allocator->content + allocator->committed_size,
+        size_in_bytes - allocator->committed_size,
+        PROT_READ | PROT_WRITE
+        );
+    lna_assert(result == 0)
+}
+
+void lna_heap_allocator_release(lna_heap_allocator_t* allocator)
+{
+    lna_assert(allocator)
+    lna_assert(allocator->content)
+
+    lna_log_message(
+        "free all %d reserved heap memory bytes for allocator %p, %d bytes were committed",
+        allocator->max_content_size,
+        allocator,
+        allocator->committed_size
+        );
+
+    munmap(
+        allocator->content,
+        allocator->max_content_size
+        );
+
+#ifdef LNA_MEMORY_TRACKING
+    lna_memory_tracking_unregister(&allocator->stats);
+#endif
+
+    allocator->content              = NULL;
+    allocator->cur_content_offset   = 0;
+    allocator->max_content_size     = 0;
+    allocator->committed_size       = 0;
+    allocator->commit_granularity   = 0;
+}
@@ -0,0 +1,71 @@
+#include "system/lna_thread.h"
+#include "backends/sdl/lna_thread_sdl.h"
+#include "core/lna_assert.h"
+
+uint32_t lna_thread_cpu_count(void)
+{
+    const int count = SDL_GetCPUCount();
+    return count > 0 ? (uint32_t)count : 1;
+}
+
+//! lna_thread_t is never defined, a thread is the SDL_Thread itself.
+lna_thread_t* lna_thread_start(lna_thread_function_t function, void* data, const char* name)
+{
+    lna_assert(function)
+
+    SDL_Thread* handle = SDL_CreateThread(
+        function,
+        name ? name : "lna_thread",
+        data
+        );
+    lna_assert(handle)
+    return (lna_thread_t*)handle;
+}
+
+int lna_thread_wait(lna_thread_t* thread)
+{
+    lna_assert(thread)
+
+    int result = 0;
+    SDL_WaitThread(
+        (SDL_Thread*)thread,
+        &result
+        );
+    return result;
+}
+
+void lna_thread_yield(void)
+{
+    SDL_Delay(0);
+}
+
+//! lna_semaphore_t is never defined, a semaphore is the SDL_sem itself.
+lna_semaphore_t* lna_semaphore_new(uint32_t initial_value)
+{
+    SDL_sem* handle = SDL_CreateSemaphore(initial_value);
+    lna_assert(handle)
+    return (lna_semaphore_t*)handle;
+}
+
+void lna_semaphore_post(lna_semaphore_t* semaphore)
+{
+    lna_assert(semaphore)
+
+    const int result = SDL_SemPost((SDL_sem*)semaphore);
+    lna_assert(result == 0)
+}
+
+void lna_semaphore_wait(lna_semaphore_t* semaphore)
+{
+    lna_assert(semaphore)
+
+    const int result = SDL_SemWait((SDL_sem*)semaphore);
+    lna_assert(result == 0)
+}
+
+void lna_semaphore_delete(lna_semaphore_t* semaphore)
+{
+    lna_assert(semaphore)
+
+    SDL_DestroySemaphore((SDL_sem*)semaphore);
+}
@@ -0,0 +1,11 @@
+#ifndef LNA_BACKENDS_SDL_LNA_THREAD_SDL_H
+#define LNA_BACKENDS_SDL_LNA_THREAD_SDL_H
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#pragma warning(push, 0)
+#include <SDL.h>
+#pragma warning(pop)
+#pragma clang diagnostic pop
+
+#endif
@@ -6,6 +6,10 @@
 #include "backends/sdl/lna_timer_sdl.h"
 #include "core/lna_assert.h"
 
+//! SDL_Delay may sleep a few milliseconds more than requested, the end of
+//! the wait is done by spinning.
+static const double LNA_TIMER_SPIN_TIME_IN_MS = 2.0;
+
 void lna_timer_start(lna_timer_t* timer)
 {
     lna_assert(timer)
@@ -13,6 +17,7 @@ void lna_timer_start(lna_timer_t* timer)
     timer->curr_frame_time_in_ms    = timer->start_frame_time_in_ms;
     timer->last_frame_time_in_ms    = timer->start_frame_time_in_ms;
     timer->delta_time_in_ms         = 0;
+    timer->limiter_last_counter     = SDL_GetPerformanceCounter();
 }
 
 void lna_timer_update(lna_timer_t* timer)
@@ -47,3 +52,28 @@ lna_millisecond_t lna_timer_delta_time_in_ms(lna_timer_t* timer)
     lna_assert(timer)
     return (lna_millisecond_t) { .value = (double)timer->delta_time_in_ms };
 }
+
+void lna_timer_limit_frame_time(lna_timer_t* timer, lna_millisecond_t target_frame_time)
+{
+    lna_assert(timer)
+    lna_assert(target_frame_time.value >= 0.0)
+
+    const double    counter_per_ms  = (double)SDL_GetPerformanceFrequency() / 1000.0;
+    const uint64_t  target_counter  = timer->limiter_last_counter + (uint64_t)(target_frame_time.value * counter_per_ms);
+    const uint64_t  spin_counter    = (uint64_t)(LNA_TIMER_SPIN_TIME_IN_MS * counter_per_ms);
+
+    uint64_t counter = SDL_GetPerformanceCounter();
+    while (counter + spin_counter < target_counter)
+    {
+        SDL_Delay(1);
+        counter = SDL_GetPerformanceCounter();
+    }
+    while (counter < target_counter)
+    {
+        counter = SDL_GetPerformanceCounter();
+    }
+
+    //! keep the frame rate steady by starting the next frame period from the
+    //! target, unless the frame is late by more than a whole period.
+    timer->limiter_last_counter = counter - target_counter < target_counter - timer->limiter_last_counter ? target_counter : counter;
+}
@@ -10,6 +10,7 @@ typedef struct lna_timer_s
     uint32_t    start_frame_time_in_ms;
     uint32_t    elapsed_time_in_ms;
     uint32_t    delta_time_in_ms;
+    uint64_t    limiter_last_counter;   //! performance counter value at the end of the previous frame limiter wait
 } lna_timer_t;
 
 #endif
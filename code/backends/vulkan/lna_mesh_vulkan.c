@@ -13,34 +13,86 @@
 #include "maths/lna_vec4.h"
 #include "maths/lna_mat4.h"
 
-typedef struct lna_mesh_mvp_uniform_s
-{
-    lna_mat4_t  model;
-    lna_mat4_t  view;
-    lna_mat4_t  projection;
-} lna_mesh_mvp_uniform_t;
-
 typedef struct lna_mesh_light_uniform_s
 {
     lna_vec4_t  light_position;
-    lna_vec4_t  view_position;
     lna_vec4_t  light_color;
 } lna_mesh_light_uniform_t;
 
-static void lna_mesh_system_create_graphics_pipeline(
+//! lna_vulkan_object_push_constants_t followed by the normal matrix, computed
+//! once per mesh on the cpu instead of per vertex in the shader. 128 bytes.
+typedef struct lna_mesh_push_constants_s
+{
+    lna_mat4_t          model;
+    lna_vec4_t          tint;
+    lna_normal_matrix_t normal_matrix;
+} lna_mesh_push_constants_t;
+
+//! count of meshes or instance batches recorded in each secondary command buffer
+static const uint32_t LNA_MESH_SYSTEM_RECORD_RANGE_SIZE = 256;
+
+static void lna_mesh_system_create_pipeline_layout(
     lna_mesh_system_t* mesh_system,
     lna_renderer_t* renderer
     )
 {
     lna_assert(mesh_system)
+    lna_assert(mesh_system->descriptor_set_layout)
+    lna_assert(renderer)
+    lna_assert(renderer->view_descriptor_set_layout)
+
+    const VkDescriptorSetLayout set_layouts[] =
+    {
+        renderer->view_descriptor_set_layout,
+        mesh_system->descriptor_set_layout,
+    };
+    const VkPushConstantRange push_constant_range =
+    {
+        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+        .offset     = 0,
+        .size       = sizeof(lna_mesh_push_constants_t),
+    };
+    const VkPipelineLayoutCreateInfo pipeline_layout_create_info =
+    {
+        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+        .setLayoutCount         = (uint32_t)(sizeof(set_layouts) / sizeof(set_layouts[0])),
+        .pSetLayouts            = set_layouts,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges    = &push_constant_range,
+    };
+    lna_vulkan_check(
+        vkCreatePipelineLayout(
+            renderer->device,
+            &pipeline_layout_create_info,
+            NULL,
+            &mesh_system->pipeline_layout
+            )
+        );
+}
+
+//! when instanced is true, the pipeline reads a lna_mesh_instance_data_t per
+//! instance from the vertex buffer bound at binding 1: the model matrix at
+//! locations 4 to 7 and the normal matrix at locations 8 to 10.
+static void lna_mesh_system_create_graphics_pipeline(
+    lna_mesh_system_t* mesh_system,
+    lna_renderer_t* renderer,
+    const char* vertex_shader_filename,
+    bool instanced,
+    VkPipeline* pipeline
+    )
+{
+    lna_assert(mesh_system)
+    lna_assert(mesh_system->pipeline_layout)
     lna_assert(renderer)
+    lna_assert(vertex_shader_filename)
+    lna_assert(pipeline)
 
     // TODO: avoid direct file load: add binary code directly in code as a static const uint32_t* 
     lna_binary_file_content_uint32_t vertex_shader_file = { 0 };
     lna_binary_file_debug_load_uint32(
         &vertex_shader_file,
         &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME],
-        "shaders/default_vert.spv"
+        vertex_shader_filename
         );
     // TODO: avoid direct file load: add binary code directly in code as a static const uint32_t* 
     lna_binary_file_content_uint32_t fragment_shader_file = { 0 };
@@ -101,6 +153,50 @@ static void lna_mesh_system_create_graphics_pipeline(
             .format     = VK_FORMAT_R32G32B32_SFLOAT,
             .offset     = offsetof(lna_model_vertex_t, normal),
         },
+        //! instance data: one mat4 uses 4 locations
+        {
+            .binding    = 1,
+            .location   = 4,
+            .format     = VK_FORMAT_R32G32B32A32_SFLOAT,
+            .offset     = offsetof(lna_mesh_instance_data_t, model) + sizeof(float) * 0,
+        },
+        {
+            .binding    = 1,
+            .location   = 5,
+            .format     = VK_FORMAT_R32G32B32A32_SFLOAT,
+            .offset     = offsetof(lna_mesh_instance_data_t, model) + sizeof(float) * 4,
+        },
+        {
+            .binding    = 1,
+            .location   = 6,
+            .format     = VK_FORMAT_R32G32B32A32_SFLOAT,
+            .offset     = offsetof(lna_mesh_instance_data_t, model) + sizeof(float) * 8,
+        },
+        {
+            .binding    = 1,
+            .location   = 7,
+            .format     = VK_FORMAT_R32G32B32A32_SFLOAT,
+            .offset     = offsetof(lna_mesh_instance_data_t, model) + sizeof(float) * 12,
+        },
+        //! one mat3 uses 3 locations, the padding of its columns is skipped
+        {
+            .binding    = 1,
+            .location   = 8,
+            .format     = VK_FORMAT_R32G32B32_SFLOAT,
+            .offset     = offsetof(lna_mesh_instance_data_t, normal_matrix) + sizeof(float) * 0,
+        },
+        {
+            .binding    = 1,
+            .location   = 9,
+            .format     = VK_FORMAT_R32G32B32_SFLOAT,
+            .offset     = offsetof(lna_mesh_instance_data_t, normal_matrix) + sizeof(float) * 4,
+        },
+        {
+            .binding    = 1,
+            .location   = 10,
+            .format     = VK_FORMAT_R32G32B32_SFLOAT,
+            .offset     = offsetof(lna_mesh_instance_data_t, normal_matrix) + sizeof(float) * 8,
+        },
     };
     const VkVertexInputBindingDescription vertex_input_binding_description[] =
     {
@@ -109,13 +205,18 @@ static void lna_mesh_system_create_graphics_pipeline(
             .stride     = sizeof(lna_model_vertex_t),
             .inputRate  = VK_VERTEX_INPUT_RATE_VERTEX,
         },
+        {
+            .binding    = 1,
+            .stride     = sizeof(lna_mesh_instance_data_t),
+            .inputRate  = VK_VERTEX_INPUT_RATE_INSTANCE,
+        },
     };
     const VkPipelineVertexInputStateCreateInfo vertex_input_state_create_info =
     {
         .sType                              = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
-        .vertexBindingDescriptionCount      = (uint32_t)(sizeof(vertex_input_binding_description) / sizeof(vertex_input_binding_description[0])),
+        .vertexBindingDescriptionCount      = instanced ? 2 : 1,
         .pVertexBindingDescriptions         = vertex_input_binding_description,
-        .vertexAttributeDescriptionCount    = (uint32_t)(sizeof(vertex_input_attribute_descriptions) / sizeof(vertex_input_attribute_descriptions[0])),
+        .vertexAttributeDescriptionCount    = instanced ? 11 : 4,
         .pVertexAttributeDescriptions       = vertex_input_attribute_descriptions,
     };
     const VkPipelineInputAssemblyStateCreateInfo input_assembly_state_create_info =
@@ -124,27 +225,13 @@ static void lna_mesh_system_create_graphics_pipeline(
         .topology               = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
         .primitiveRestartEnable = VK_FALSE,
     };
-    const VkViewport viewport =
-    {
-        .x          = 0.0f,
-        .y          = 0.0f,
-        .width      = (float)(renderer->swap_chain_extent.width),
-        .height     = (float)(renderer->swap_chain_extent.height),
-        .minDepth   = 0.0f,
-        .maxDepth   = 1.0f,
-    };
-    const VkRect2D scissor =
-    {
-        .offset = {0, 0},
-        .extent = renderer->swap_chain_extent,
-    };
     const VkPipelineViewportStateCreateInfo viewport_state_create_info =
     {
         .sType          = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
         .viewportCount  = 1,
-        .pViewports     = &viewport,
+        .pViewports     = NULL, //! dynamic state
         .scissorCount   = 1,
-        .pScissors      = &scissor,
+        .pScissors      = NULL, //! dynamic state
     };
     const VkPipelineRasterizationStateCreateInfo rasterization_state_create_info =
     {
@@ -196,30 +283,15 @@ static void lna_mesh_system_create_graphics_pipeline(
     const VkDynamicState dynamic_states[] =
     {
         VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR,
         VK_DYNAMIC_STATE_LINE_WIDTH
     };
     const VkPipelineDynamicStateCreateInfo dynamic_state_create_info =
     {
         .sType              = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
-        .dynamicStateCount  = 2,
+        .dynamicStateCount  = (uint32_t)(sizeof(dynamic_states) / sizeof(dynamic_states[0])),
         .pDynamicStates     = dynamic_states,
     };
-    const VkPipelineLayoutCreateInfo pipeline_layout_create_info =
-    {
-        .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        .setLayoutCount         = 1,
-        .pSetLayouts            = &mesh_system->descriptor_set_layout,
-        .pushConstantRangeCount = 0,
-        .pPushConstantRanges    = NULL,
-    };
-    lna_vulkan_check(
-        vkCreatePipelineLayout(
-            renderer->device,
-            &pipeline_layout_create_info,
-            NULL,
-            &mesh_system->pipeline_layout
-            )
-        );
     const VkPipelineDepthStencilStateCreateInfo depth_stencil_state_create_info =
     {
         .sType                  = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
@@ -259,7 +331,7 @@ static void lna_mesh_system_create_graphics_pipeline(
             1,
             &graphics_pipeline_create_info,
             NULL,
-            &mesh_system->pipeline
+            pipeline
             )
         );
 
@@ -280,34 +352,35 @@ static void lna_mesh_system_create_descriptor_pool(
     )
 {
     lna_assert(mesh_system)
-    lna_assert(mesh_system->meshes.max_element_count > 0)
 
     lna_renderer_t* renderer = mesh_system->renderer;
     lna_assert(renderer)
-    lna_assert(renderer->swap_chain_images.count > 0)
+
+    //! one descriptor set per mesh and per instance batch for each frame in
+    //! flight. The sets of a deleted mesh are freed when the frames in flight
+    //! are done with them, until then they are counted with the new meshes.
+    const uint32_t set_count = 2 * mesh_system->meshes.max_element_count + mesh_system->instance_batches.max_element_count;
+    lna_assert(set_count > 0)
 
     const VkDescriptorPoolSize pool_sizes[] =
     {
-        {
-            .type               = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            .descriptorCount    = renderer->swap_chain_images.count * mesh_system->meshes.max_element_count,
-        },
         {
             .type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            .descriptorCount    = renderer->swap_chain_images.count * mesh_system->meshes.max_element_count,
+            .descriptorCount    = renderer->frame_in_flight_count * set_count,
         },
         {
-            .type               = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            .descriptorCount    = renderer->swap_chain_images.count * mesh_system->meshes.max_element_count,
+            .type               = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+            .descriptorCount    = renderer->frame_in_flight_count * set_count,
         },
     };
 
     const VkDescriptorPoolCreateInfo pool_create_info =
     {
         .sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags          = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
         .poolSizeCount  = (uint32_t)(sizeof(pool_sizes) / sizeof(pool_sizes[0])),
         .pPoolSizes     = pool_sizes,
-        .maxSets        = renderer->swap_chain_images.count * mesh_system->meshes.max_element_count,
+        .maxSets        = renderer->frame_in_flight_count * set_count,
     };
 
     lna_vulkan_check(
@@ -331,84 +404,15 @@ static void lna_mesh_system_create_descriptor_pool(
     }
 }
 
-static void lna_mesh_create_uniform_buffer(
-    lna_mesh_t* mesh,
-    lna_renderer_t* renderer
-    )
-{
-    lna_assert(mesh)
-    lna_assert(mesh->mvp_uniform_buffers.count == 0)
-    lna_assert(mesh->mvp_uniform_buffers.elements == NULL)
-    lna_assert(mesh->mvp_uniform_buffers_memory.count == 0)
-    lna_assert(mesh->mvp_uniform_buffers_memory.elements == NULL)
-    lna_assert(mesh->light_uniform_buffers.count == 0)
-    lna_assert(mesh->light_uniform_buffers.elements == NULL)
-    lna_assert(mesh->light_uniform_buffers_memory.count == 0)
-    lna_assert(mesh->light_uniform_buffers_memory.elements == NULL)
-    lna_assert(renderer)
-    lna_assert(renderer->swap_chain_images.count > 0)
-
-    mesh->mvp_uniform_buffers.count     = renderer->swap_chain_images.count;
-    mesh->mvp_uniform_buffers.elements  = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
-        sizeof(VkBuffer) * renderer->swap_chain_images.count
-        );
-    mesh->mvp_uniform_buffers_memory.count      = renderer->swap_chain_images.count;
-    mesh->mvp_uniform_buffers_memory.elements   = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
-        sizeof(VkDeviceMemory) * renderer->swap_chain_images.count
-        );
-    VkDeviceSize mvp_uniform_buffer_size = sizeof(lna_mesh_mvp_uniform_t);
-    for (size_t i = 0; i < mesh->mvp_uniform_buffers.count; ++i)
-    {
-        lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
-            mvp_uniform_buffer_size,
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            &mesh->mvp_uniform_buffers.elements[i],
-            &mesh->mvp_uniform_buffers_memory.elements[i]
-            );
-    }
-
-    mesh->light_uniform_buffers.count       = renderer->swap_chain_images.count;
-    mesh->light_uniform_buffers.elements    = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
-        sizeof(VkBuffer) * renderer->swap_chain_images.count
-        );
-    mesh->light_uniform_buffers_memory.count    = 0;
-    mesh->light_uniform_buffers_memory.elements = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
-        sizeof(VkDeviceMemory) * renderer->swap_chain_images.count
-        );
-    VkDeviceSize light_uniform_buffer_size = sizeof(lna_mesh_light_uniform_t);
-    for (size_t i = 0; i < mesh->light_uniform_buffers.count; ++i)
-    {
-        lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
-            light_uniform_buffer_size,
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            &mesh->light_uniform_buffers.elements[i],
-            &mesh->light_uniform_buffers_memory.elements[i]
-            );
-    }
-}
-
 static void lna_mesh_create_descriptor_sets(
-    lna_mesh_t* mesh,
-    lna_mesh_system_t* mesh_system
+    lna_mesh_system_t* mesh_system,
+    const lna_material_t* material,
+    VkDescriptorSet* descriptor_sets
     )
 {
-    lna_assert(mesh)
-    lna_assert(mesh->descriptor_sets.count == 0)
-    lna_assert(mesh->descriptor_sets.elements == NULL)
     lna_assert(mesh_system)
-
-    const lna_material_t* material = mesh->material;
     lna_assert(material)
+    lna_assert(descriptor_sets)
 
     const lna_texture_t* texture = material->texture;
     lna_assert(texture)
@@ -417,57 +421,42 @@ static void lna_mesh_create_descriptor_sets(
 
     lna_renderer_t* renderer = mesh_system->renderer;
     lna_assert(renderer)
-    lna_assert(renderer->swap_chain_images.count)
 
-    lna_vulkan_descriptor_set_layout_array_t layouts = { 0 };
-    layouts.elements = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME],
-        sizeof(VkDescriptorSetLayout) * renderer->swap_chain_images.count
-        );
-    for (uint32_t i = 0; i < layouts.count; ++i)
+    VkDescriptorSetLayout layouts[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    for (uint32_t i = 0; i < renderer->frame_in_flight_count; ++i)
     {
-        layouts.elements[i] = mesh_system->descriptor_set_layout;
+        layouts[i] = mesh_system->descriptor_set_layout;
     }
 
     const VkDescriptorSetAllocateInfo allocate_info =
     {
         .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
         .descriptorPool     = mesh_system->descriptor_pool,
-        .descriptorSetCount = layouts.count,
-        .pSetLayouts        = layouts.elements,
+        .descriptorSetCount = renderer->frame_in_flight_count,
+        .pSetLayouts        = layouts,
     };
 
-    mesh->descriptor_sets.count     = 0;
-    mesh->descriptor_sets.elements  = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
-        sizeof(VkDescriptorSet) * renderer->swap_chain_images.count
-        );
-
     lna_vulkan_check(
         vkAllocateDescriptorSets(
             renderer->device,
             &allocate_info,
-            mesh->descriptor_sets.elements
+            descriptor_sets
             )
         );
 
-    for (size_t i = 0; i < mesh->descriptor_sets.count; ++i)
+    for (size_t i = 0; i < renderer->frame_in_flight_count; ++i)
     {
-        const VkDescriptorBufferInfo mvp_buffer_info =
-        {
-            .buffer = mesh->mvp_uniform_buffers.elements[i],
-            .offset = 0,
-            .range  = sizeof(lna_mesh_mvp_uniform_t),
-        };
         const VkDescriptorImageInfo image_info =
         {
             .imageLayout    = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
             .imageView      = texture->image_view,
             .sampler        = texture->image_sampler,
         };
+        //! uniform data are written in the renderer uniform buffer of the
+        //! frame, the final offset is given when binding the descriptor set.
         const VkDescriptorBufferInfo light_buffer_info =
         {
-            .buffer = mesh->light_uniform_buffers.elements[i],
+            .buffer = renderer->uniform_ring_buffer.buffers[i],
             .offset = 0,
             .range  = sizeof(lna_mesh_light_uniform_t),
         };
@@ -476,18 +465,7 @@ static void lna_mesh_create_descriptor_sets(
         {
             {
                 .sType              = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet             = mesh->descriptor_sets.elements[i],
-                .dstBinding         = 0,
-                .dstArrayElement    = 0,
-                .descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                .descriptorCount    = 1,
-                .pBufferInfo        = &mvp_buffer_info,
-                .pImageInfo         = NULL,
-                .pTexelBufferView   = NULL,
-            },
-            {
-                .sType              = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet             = mesh->descriptor_sets.elements[i],
+                .dstSet             = descriptor_sets[i],
                 .dstBinding         = 1,
                 .dstArrayElement    = 0,
                 .descriptorType     = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
@@ -498,10 +476,10 @@ static void lna_mesh_create_descriptor_sets(
             },
             {
                 .sType              = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet             = mesh->descriptor_sets.elements[i],
+                .dstSet             = descriptor_sets[i],
                 .dstBinding         = 2,
                 .dstArrayElement    = 0,
-                .descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+                .descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
                 .descriptorCount    = 1,
                 .pBufferInfo        = &light_buffer_info,
                 .pImageInfo         = NULL,
@@ -519,6 +497,82 @@ static void lna_mesh_create_descriptor_sets(
     }
 }
 
+static void lna_mesh_create_geometry_buffers(
+    lna_renderer_t* renderer,
+    const lna_model_vertex_t* vertices,
+    uint32_t vertex_count,
+    const void* indices,
+    size_t index_size,
+    uint32_t index_count,
+    VkBuffer* vertex_buffer,
+    lna_vulkan_memory_allocation_t* vertex_buffer_allocation,
+    VkBuffer* index_buffer,
+    lna_vulkan_memory_allocation_t* index_buffer_allocation
+    )
+{
+    lna_assert(renderer)
+    lna_assert(vertices)
+    lna_assert(vertex_count > 0)
+    lna_assert(indices)
+    lna_assert(index_count > 0)
+    lna_assert(vertex_buffer)
+    lna_assert(vertex_buffer_allocation)
+    lna_assert(index_buffer)
+    lna_assert(index_buffer_allocation)
+
+    //! VERTEX BUFFER PART
+
+    {
+        size_t vertex_buffer_size = sizeof(vertices[0]) * vertex_count;
+        
+        lna_vulkan_create_buffer(
+            &renderer->memory_allocator,
+            vertex_buffer_size,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            vertex_buffer,
+            vertex_buffer_allocation
+            );
+        memcpy(
+            lna_vulkan_upload_manager_upload_buffer(
+                &renderer->upload_manager,
+                *vertex_buffer,
+                0,
+                vertex_buffer_size,
+                NULL
+                ),
+            vertices,
+            vertex_buffer_size
+            );
+    }
+
+    //! INDEX BUFFER PART
+
+    {
+        const size_t index_buffer_size = index_size * index_count;
+
+        lna_vulkan_create_buffer(
+            &renderer->memory_allocator,
+            index_buffer_size,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            index_buffer,
+            index_buffer_allocation
+            );
+        memcpy(
+            lna_vulkan_upload_manager_upload_buffer(
+                &renderer->upload_manager,
+                *index_buffer,
+                0,
+                index_buffer_size,
+                NULL
+                ),
+            indices,
+            index_buffer_size
+            );
+    }
+}
+
 static void lna_mesh_system_on_swap_chain_cleanup(void* owner)
 {
     lna_assert(owner)
@@ -531,71 +585,14 @@ static void lna_mesh_system_on_swap_chain_cleanup(void* owner)
         mesh_system->pipeline,
         NULL
         );
-    vkDestroyPipelineLayout(
+    vkDestroyPipeline(
         renderer->device,
-        mesh_system->pipeline_layout,
+        mesh_system->instanced_pipeline,
         NULL
         );
-
-    for (uint32_t i = 0; i < mesh_system->meshes.cur_element_count; ++i)
-    {
-        lna_mesh_t* mesh = &mesh_system->meshes.elements[i];
-        lna_assert(mesh->mvp_uniform_buffers.elements)
-        lna_assert(mesh->mvp_uniform_buffers_memory.elements)
-
-        for (size_t j = 0; j < mesh->mvp_uniform_buffers.count; ++j)
-        {
-            vkDestroyBuffer(
-                renderer->device,
-                mesh->mvp_uniform_buffers.elements[j],
-                NULL
-                );
-        }
-        for (size_t j = 0; j < mesh->mvp_uniform_buffers.count; ++j)
-        {
-            vkFreeMemory(
-                renderer->device,
-                mesh->mvp_uniform_buffers_memory.elements[j],
-                NULL
-                );
-        }
-        mesh->mvp_uniform_buffers.count             = 0;
-        mesh->mvp_uniform_buffers.elements          = NULL;
-        mesh->mvp_uniform_buffers_memory.count      = 0;
-        mesh->mvp_uniform_buffers_memory.elements   = NULL;
-
-        for (size_t j = 0; j < mesh->light_uniform_buffers.count; ++j)
-        {
-            vkDestroyBuffer(
-                renderer->device,
-                mesh->light_uniform_buffers.elements[j],
-                NULL
-                );
-        }
-        for (size_t j = 0; j < mesh->light_uniform_buffers.count; ++j)
-        {
-            vkFreeMemory(
-                renderer->device,
-                mesh->light_uniform_buffers_memory.elements[j],
-                NULL
-                );
-        }
-        mesh->light_uniform_buffers.count           = 0;
-        mesh->light_uniform_buffers.elements        = NULL;
-        mesh->light_uniform_buffers_memory.count    = 0;
-        mesh->light_uniform_buffers_memory.elements = NULL;
-
-        //! NOTE: no need to explicity clean up vulkan descriptor sets objects
-        //! because it is done when the vulkan descriptor pool is destroyed.
-        //! we just have to reset the array and wait for filling it again.
-        //! the memory pool where we reserved memory for descriptor_sets has already
-        //! been reset by the vulkan renderer backend.
-        mesh->descriptor_sets.count     = 0;
-        mesh->descriptor_sets.elements  = NULL;
-    }
-    vkDestroyDescriptorPool(
+    vkDestroyPipelineLayout(
         renderer->device,
-        mesh_system->descriptor_pool,
+        mesh_system->pipeline_layout,
         NULL
         );
 }
@@ -607,70 +604,445 @@ static void lna_mesh_system_on_swap_chain_recreate(void *owner)
     lna_renderer_t* renderer = mesh_system->renderer;
     lna_assert(renderer)
 
-    lna_mesh_system_create_graphics_pipeline(
+    lna_mesh_system_create_pipeline_layout(
         mesh_system,
         renderer
         );
-    lna_mesh_system_create_descriptor_pool(
-        mesh_system
+    lna_mesh_system_create_graphics_pipeline(
+        mesh_system,
+        renderer,
+        "shaders/default_vert.spv",
+        false,
+        &mesh_system->pipeline
         );
+    lna_mesh_system_create_graphics_pipeline(
+        mesh_system,
+        renderer,
+        "shaders/default_instanced_vert.spv",
+        true,
+        &mesh_system->instanced_pipeline
+        );
+}
 
-    for (uint32_t i = 0; i < mesh_system->meshes.cur_element_count; ++i)
+static void lna_mesh_write_light_uniform(
+    lna_mesh_light_uniform_t* light_ubo
+    )
+{
+    lna_assert(light_ubo)
+
+    light_ubo->light_position       = (lna_vec4_t){ 1.5f, 1.5f, 1.5f, 0.0f }; // TODO: remove hard coded value!
+    light_ubo->light_color          = (lna_vec4_t){ 1.0f, 1.0f, 1.0f, 0.0f }; // TODO: remove hard coded value!
+}
+
+//! bound_view is the view bound in command_buffer, updated when the mesh
+//! uses another one. The vertex buffers, the push constants and the draw
+//! call are left to the caller.
+static void lna_mesh_system_bind_descriptor_sets(
+    const lna_mesh_system_t* mesh_system,
+    VkCommandBuffer command_buffer,
+    const lna_renderer_view_t* view,
+    const VkDescriptorSet* descriptor_sets,
+    uint32_t light_dynamic_offset,
+    const lna_renderer_view_t** bound_view
+    )
+{
+    lna_assert(mesh_system)
+    lna_assert(mesh_system->renderer)
+    lna_assert(view)
+    lna_assert(descriptor_sets)
+    lna_assert(bound_view)
+
+    if (view != *bound_view)
     {
-        lna_mesh_create_uniform_buffer(
-            &mesh_system->meshes.elements[i],
-            renderer
-            );
-        lna_mesh_create_descriptor_sets(
-            &mesh_system->meshes.elements[i],
-            mesh_system
+        lna_vulkan_renderer_bind_view(
+            mesh_system->renderer,
+            command_buffer,
+            mesh_system->pipeline_layout,
+            view
             );
+        *bound_view = view;
     }
+    vkCmdBindDescriptorSets(
+        command_buffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        mesh_system->pipeline_layout,
+        1,
+        1,
+        &descriptor_sets[mesh_system->renderer->curr_frame],
+        1,
+        &light_dynamic_offset
+        );
 }
 
-void lna_mesh_system_init(lna_mesh_system_t* mesh_system, const lna_mesh_system_config_t* config)
+static void lna_mesh_write_instance_data(lna_mesh_instance_data_t* instance_data, const lna_mat4_t* model_matrix)
 {
-    lna_assert(mesh_system)
-    lna_assert(mesh_system->renderer == NULL)
-    lna_assert(mesh_system->meshes.cur_element_count == 0)
-    lna_assert(mesh_system->meshes.max_element_count == 0)
-    lna_assert(mesh_system->meshes.elements == NULL)
-    lna_assert(mesh_system->descriptor_pool == VK_NULL_HANDLE)
-    lna_assert(mesh_system->descriptor_set_layout == VK_NULL_HANDLE)
-    lna_assert(mesh_system->pipeline == VK_NULL_HANDLE)
-    lna_assert(mesh_system->pipeline_layout == VK_NULL_HANDLE)
-    lna_assert(config)
-    lna_assert(config->renderer)
-    lna_assert(config->renderer->device)
-    lna_assert(config->renderer->render_pass)
-    lna_assert(config->max_mesh_count > 0)
+    lna_assert(instance_data)
+    lna_assert(model_matrix)
 
-    mesh_system->renderer = config->renderer;
+    instance_data->model = *model_matrix;
+    lna_mat4_normal_matrix(
+        model_matrix,
+        &instance_data->normal_matrix
+        );
+}
 
-    lna_renderer_register_listener(
-        config->renderer,
-        lna_mesh_system_on_swap_chain_cleanup,
-        lna_mesh_system_on_swap_chain_recreate,
-        (void*)mesh_system
+static void lna_mesh_system_push_constants(
+    const lna_mesh_system_t* mesh_system,
+    VkCommandBuffer command_buffer,
+    const lna_mat4_t* model_matrix,
+    const lna_vec4_t* tint
+    )
+{
+    lna_assert(mesh_system)
+    lna_assert(model_matrix)
+
+    lna_mesh_push_constants_t push_constants =
+    {
+        .model  = *model_matrix,
+        .tint   = tint ? *tint : (lna_vec4_t){ 1.0f, 1.0f, 1.0f, 1.0f },
+    };
+    lna_mat4_normal_matrix(
+        model_matrix,
+        &push_constants.normal_matrix
+        );
+    vkCmdPushConstants(
+        command_buffer,
+        mesh_system->pipeline_layout,
+        VK_SHADER_STAGE_VERTEX_BIT,
+        0,
+        sizeof(push_constants),
+        &push_constants
         );
+}
+
+//! the instanced pipeline reads the model and normal matrices per instance,
+//! only the tint is pushed.
+static void lna_mesh_system_push_tint(
+    const lna_mesh_system_t* mesh_system,
+    VkCommandBuffer command_buffer,
+    const lna_vec4_t* tint
+    )
+{
+    lna_assert(mesh_system)
 
-    mesh_system->meshes.max_element_count   = config->max_mesh_count;
-    mesh_system->meshes.elements            = lna_memory_pool_reserve(
-        config->memory_pool,
-        sizeof(lna_mesh_t) * config->max_mesh_count
+    const lna_vec4_t push_tint = tint ? *tint : (lna_vec4_t){ 1.0f, 1.0f, 1.0f, 1.0f };
+    vkCmdPushConstants(
+        command_buffer,
+        mesh_system->pipeline_layout,
+        VK_SHADER_STAGE_VERTEX_BIT,
+        offsetof(lna_mesh_push_constants_t, tint),
+        sizeof(push_tint),
+        &push_tint
         );
+}
 
-    //! DESCRIPTOR SET LAYOUT
+//! called by the renderer record jobs, the meshes must not change until the end of the frame.
+static void lna_mesh_system_record_meshes(void* owner, VkCommandBuffer command_buffer, uint32_t begin, uint32_t end)
+{
+    lna_assert(owner)
+    lna_mesh_system_t* mesh_system = (lna_mesh_system_t*)owner;
+    lna_renderer_t* renderer = mesh_system->renderer;
+    lna_assert(renderer)
 
-    const VkDescriptorSetLayoutBinding bindings[] =
+    vkCmdBindPipeline(
+        command_buffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        mesh_system->pipeline
+        );
+
+    //! the light is shared by all the meshes of the range
+    uint32_t light_dynamic_offset;
+    lna_mesh_write_light_uniform(
+        lna_renderer_reserve_uniform_data(
+            renderer,
+            sizeof(lna_mesh_light_uniform_t),
+            &light_dynamic_offset
+            )
+        );
+
+    const lna_renderer_view_t* bound_view = NULL;
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        const lna_mesh_t* mesh = lna_object_pool_element(&mesh_system->meshes, i);
+
+        lna_mesh_system_bind_descriptor_sets(
+            mesh_system,
+            command_buffer,
+            mesh->view,
+            mesh->descriptor_sets,
+            light_dynamic_offset,
+            &bound_view
+            );
+        lna_mesh_system_push_constants(
+            mesh_system,
+            command_buffer,
+            mesh->model_matrix,
+            mesh->tint
+            );
+        VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(
+            command_buffer,
+            0,
+            1,
+            &mesh->vertex_buffer,
+            &offset
+            );
+        vkCmdBindIndexBuffer(
+            command_buffer,
+            mesh->index_buffer,
+            0,
+            mesh->index_type
+            );
+        vkCmdDrawIndexed(
+            command_buffer,
+            mesh->index_count,
+            1,
+            0,
+            0,
+            0
+            );
+    }
+}
+
+//! called by the renderer record job when the command cache has been
+//! invalidated. A push constant would be frozen in the cached command
+//! buffer, so the static meshes are drawn with the instanced pipeline: the
+//! model and normal matrices of the mesh i are the instance i of the
+//! persistent instance data written by lna_mesh_system_draw.
+static void lna_mesh_system_record_static_meshes(void* owner, VkCommandBuffer command_buffer, uint32_t begin, uint32_t end)
+{
+    lna_assert(owner)
+    lna_mesh_system_t* mesh_system = (lna_mesh_system_t*)owner;
+    lna_renderer_t* renderer = mesh_system->renderer;
+    lna_assert(renderer)
+
+    vkCmdBindPipeline(
+        command_buffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        mesh_system->instanced_pipeline
+        );
+    const lna_renderer_view_t* bound_view = NULL;
+    for (uint32_t i = begin; i < end; ++i)
     {
+        const lna_mesh_t* mesh = lna_object_pool_element(&mesh_system->meshes, i);
+
+        lna_mesh_system_bind_descriptor_sets(
+            mesh_system,
+            command_buffer,
+            mesh->view,
+            mesh->descriptor_sets,
+            mesh_system->persistent_light_uniform_offset,
+            &bound_view
+            );
+        lna_mesh_system_push_tint(
+            mesh_system,
+            command_buffer,
+            mesh->tint
+            );
+        const VkBuffer vertex_buffers[] =
         {
-            .binding            = 0,
-            .descriptorCount    = 1,
-            .descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            .stageFlags         = VK_SHADER_STAGE_VERTEX_BIT,
-            .pImmutableSamplers = NULL,
-        },
+            mesh->vertex_buffer,
+            renderer->uniform_ring_buffer.buffers[renderer->curr_frame],
+        };
+        const VkDeviceSize offsets[] =
+        {
+            0,
+            mesh_system->persistent_instance_data_offset,
+        };
+        vkCmdBindVertexBuffers(
+            command_buffer,
+            0,
+            (uint32_t)(sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
+            vertex_buffers,
+            offsets
+            );
+        vkCmdBindIndexBuffer(
+            command_buffer,
+            mesh->index_buffer,
+            0,
+            mesh->index_type
+            );
+        vkCmdDrawIndexed(
+            command_buffer,
+            mesh->index_count,
+            1,
+            0,
+            0,
+            i
+            );
+    }
+}
+
+//! called by the renderer record jobs, the instance data of the batches are written by lna_mesh_system_draw.
+static void lna_mesh_system_record_instance_batches(void* owner, VkCommandBuffer command_buffer, uint32_t begin, uint32_t end)
+{
+    lna_assert(owner)
+    lna_mesh_system_t* mesh_system = (lna_mesh_system_t*)owner;
+    lna_renderer_t* renderer = mesh_system->renderer;
+    lna_assert(renderer)
+
+    vkCmdBindPipeline(
+        command_buffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        mesh_system->instanced_pipeline
+        );
+
+    uint32_t light_dynamic_offset;
+    lna_mesh_write_light_uniform(
+        lna_renderer_reserve_uniform_data(
+            renderer,
+            sizeof(lna_mesh_light_uniform_t),
+            &light_dynamic_offset
+            )
+        );
+
+    lna_mesh_system_push_tint(
+        mesh_system,
+        command_buffer,
+        NULL
+        );
+
+    const lna_renderer_view_t* bound_view = NULL;
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        const lna_mesh_instance_batch_t* batch = &mesh_system->instance_batches.elements[i];
+        if (batch->instance_count == 0)
+        {
+            continue;
+        }
+        lna_assert(batch->geometry)
+
+        lna_mesh_system_bind_descriptor_sets(
+            mesh_system,
+            command_buffer,
+            batch->view,
+            batch->descriptor_sets,
+            light_dynamic_offset,
+            &bound_view
+            );
+        const VkBuffer vertex_buffers[] =
+        {
+            batch->geometry->vertex_buffer,
+            batch->instance_buffer,
+        };
+        const VkDeviceSize offsets[] =
+        {
+            0,
+            batch->instance_buffer_offset,
+        };
+        vkCmdBindVertexBuffers(
+            command_buffer,
+            0,
+            (uint32_t)(sizeof(vertex_buffers) / sizeof(vertex_buffers[0])),
+            vertex_buffers,
+            offsets
+            );
+        vkCmdBindIndexBuffer(
+            command_buffer,
+            batch->geometry->index_buffer,
+            0,
+            batch->geometry->index_type
+            );
+        vkCmdDrawIndexed(
+            command_buffer,
+            batch->geometry->index_count,
+            batch->instance_count,
+            0,
+            0,
+            0
+            );
+    }
+}
+
+void lna_mesh_system_init(lna_mesh_system_t* mesh_system, const lna_mesh_system_config_t* config)
+{
+    lna_assert(mesh_system)
+    lna_assert(mesh_system->renderer == NULL)
+    lna_assert(mesh_system->meshes.cur_element_count == 0)
+    lna_assert(mesh_system->meshes.max_element_count == 0)
+    lna_assert(mesh_system->meshes.elements == NULL)
+    lna_assert(mesh_system->geometries.elements == NULL)
+    lna_assert(mesh_system->instances.elements == NULL)
+    lna_assert(mesh_system->instance_batches.elements == NULL)
+    lna_assert(mesh_system->descriptor_pool == VK_NULL_HANDLE)
+    lna_assert(mesh_system->descriptor_set_layout == VK_NULL_HANDLE)
+    lna_assert(mesh_system->pipeline == VK_NULL_HANDLE)
+    lna_assert(mesh_system->pipeline_layout == VK_NULL_HANDLE)
+    lna_assert(mesh_system->instanced_pipeline == VK_NULL_HANDLE)
+    lna_assert(mesh_system->static_meshes == false)
+    lna_assert(config)
+    lna_assert(config->renderer)
+    lna_assert(config->renderer->device)
+    lna_assert(config->renderer->render_pass)
+    lna_assert(config->max_mesh_count > 0 || config->max_instance_count > 0)
+
+    mesh_system->renderer = config->renderer;
+
+    lna_renderer_register_listener(
+        config->renderer,
+        lna_mesh_system_on_swap_chain_cleanup,
+        lna_mesh_system_on_swap_chain_recreate,
+        (void*)mesh_system
+        );
+
+    if (config->max_mesh_count > 0)
+    {
+        lna_object_pool_init(
+            &mesh_system->meshes,
+            config->memory_pool,
+            sizeof(lna_mesh_t),
+            config->max_mesh_count
+            );
+    }
+    if (config->static_meshes && config->max_mesh_count > 0)
+    {
+        //! the model and normal matrices of the static meshes are read as
+        //! instance data, the light uniform data are shared by the static meshes
+        mesh_system->static_meshes = true;
+        lna_renderer_reserve_persistent_uniform_data(
+            config->renderer,
+            sizeof(lna_mesh_instance_data_t) * config->max_mesh_count,
+            &mesh_system->persistent_instance_data_offset
+            );
+        lna_renderer_reserve_persistent_uniform_data(
+            config->renderer,
+            sizeof(lna_mesh_light_uniform_t),
+            &mesh_system->persistent_light_uniform_offset
+            );
+        lna_vulkan_command_cache_init(
+            &mesh_system->command_cache,
+            config->renderer
+            );
+    }
+    if (config->max_geometry_count > 0)
+    {
+        mesh_system->geometries.max_element_count   = config->max_geometry_count;
+        mesh_system->geometries.elements            = lna_memory_pool_reserve(
+            config->memory_pool,
+            sizeof(lna_mesh_geometry_t) * config->max_geometry_count
+            );
+    }
+    if (config->max_instance_count > 0)
+    {
+        //! in the worst case, each instance has its own batch
+        lna_object_pool_init(
+            &mesh_system->instances,
+            config->memory_pool,
+            sizeof(lna_mesh_instance_t),
+            config->max_instance_count
+            );
+        mesh_system->instance_batches.max_element_count = config->max_instance_count;
+        mesh_system->instance_batches.elements          = lna_memory_pool_reserve(
+            config->memory_pool,
+            sizeof(lna_mesh_instance_batch_t) * config->max_instance_count
+            );
+    }
+
+    //! DESCRIPTOR SET LAYOUT
+
+    //! the model matrix is a push constant
+    const VkDescriptorSetLayoutBinding bindings[] =
+    {
         {
             .binding            = 1,
             .descriptorCount    = 1,
@@ -681,7 +1053,7 @@ void lna_mesh_system_init(lna_mesh_system_t* mesh_system, const lna_mesh_system_
         {
             .binding            = 2,
             .descriptorCount    = 1,
-            .descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+            .descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
             .stageFlags         = VK_SHADER_STAGE_FRAGMENT_BIT,
             .pImmutableSamplers = NULL,
         },
@@ -701,12 +1073,26 @@ void lna_mesh_system_init(lna_mesh_system_t* mesh_system, const lna_mesh_system_
             )
         );
 
-    //! GRAPHICS PIPELINE
+    //! GRAPHICS PIPELINES
 
-    lna_mesh_system_create_graphics_pipeline(
+    lna_mesh_system_create_pipeline_layout(
         mesh_system,
         config->renderer
         );
+    lna_mesh_system_create_graphics_pipeline(
+        mesh_system,
+        config->renderer,
+        "shaders/default_vert.spv",
+        false,
+        &mesh_system->pipeline
+        );
+    lna_mesh_system_create_graphics_pipeline(
+        mesh_system,
+        config->renderer,
+        "shaders/default_instanced_vert.spv",
+        true,
+        &mesh_system->instanced_pipeline
+        );
 
     //! DESCRIPTOR POOL
 
@@ -715,193 +1101,213 @@ void lna_mesh_system_init(lna_mesh_system_t* mesh_system, const lna_mesh_system_
         );
 }
 
-lna_mesh_t* lna_mesh_system_new_mesh(lna_mesh_system_t* mesh_system, const lna_mesh_config_t* config)
+lna_handle_t lna_mesh_system_new_mesh(lna_mesh_system_t* mesh_system, const lna_mesh_config_t* config)
 {
     lna_assert(mesh_system)
     lna_assert(mesh_system->meshes.elements)
     lna_assert(mesh_system->meshes.cur_element_count < mesh_system->meshes.max_element_count)
     lna_assert(config)
 
-    lna_mesh_t* mesh = &mesh_system->meshes.elements[mesh_system->meshes.cur_element_count++];
+    lna_handle_t    handle;
+    lna_mesh_t*     mesh    = lna_object_pool_new(&mesh_system->meshes, &handle);
 
     lna_assert(mesh->material == NULL)
     lna_assert(mesh->vertex_buffer == VK_NULL_HANDLE)
-    lna_assert(mesh->vertex_buffer_memory == VK_NULL_HANDLE)
+    lna_assert(mesh->vertex_buffer_allocation.memory == VK_NULL_HANDLE)
     lna_assert(mesh->index_buffer == VK_NULL_HANDLE)
-    lna_assert(mesh->index_buffer_memory == VK_NULL_HANDLE)
-    lna_assert(mesh->mvp_uniform_buffers.count == 0)
-    lna_assert(mesh->mvp_uniform_buffers.elements == NULL)
-    lna_assert(mesh->mvp_uniform_buffers_memory.count == 0)
-    lna_assert(mesh->mvp_uniform_buffers_memory.elements == NULL)
-    lna_assert(mesh->descriptor_sets.count == 0)
-    lna_assert(mesh->descriptor_sets.elements == NULL)
+    lna_assert(mesh->index_buffer_allocation.memory == VK_NULL_HANDLE)
     lna_assert(mesh->model_matrix == NULL)
-    lna_assert(mesh->view_matrix == NULL)
-    lna_assert(mesh->projection_matrix == NULL)
+    lna_assert(mesh->view == NULL)
     lna_assert(config)
     lna_assert(config->vertices)
     lna_assert(config->vertex_count > 0)
-    lna_assert(config->indices)
+    lna_assert(config->indices || config->indices_16)
     lna_assert(config->index_count > 0)
     lna_assert(config->model_matrix)
-    lna_assert(config->view_matrix)
-    lna_assert(config->projection_matrix)
+    lna_assert(config->view)
     lna_assert(mesh_system)
 
     lna_renderer_t* renderer = mesh_system->renderer;
     lna_assert(renderer)
 
     mesh->model_matrix      = config->model_matrix;
-    mesh->view_matrix       = config->view_matrix;
-    mesh->projection_matrix = config->projection_matrix;
+    mesh->tint              = config->tint;
+    mesh->view              = config->view;
     mesh->material          = config->material;
-    mesh->index_count       = config->index_count;  
+    mesh->index_count       = config->index_count;
+    mesh->index_type        = config->indices_16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+    lna_mesh_create_geometry_buffers(
+        renderer,
+        config->vertices,
+        config->vertex_count,
+        config->indices_16 ? (const void*)config->indices_16 : (const void*)config->indices,
+        config->indices_16 ? sizeof(uint16_t) : sizeof(uint32_t),
+        config->index_count,
+        &mesh->vertex_buffer,
+        &mesh->vertex_buffer_allocation,
+        &mesh->index_buffer,
+        &mesh->index_buffer_allocation
+        );
 
-    //! VERTEX BUFFER PART
+    //! DESCRIPTOR SETS
+
+    lna_mesh_create_descriptor_sets(
+        mesh_system,
+        mesh->material,
+        mesh->descriptor_sets
+        );
 
+    if (mesh_system->static_meshes)
     {
-        size_t vertex_buffer_size = sizeof(config->vertices[0]) * config->vertex_count;
-        
-        VkBuffer staging_buffer;
-        VkDeviceMemory staging_buffer_memory;
-        lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
-            vertex_buffer_size,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            &staging_buffer,
-            &staging_buffer_memory
-            );
-        void *vertices_data;
-        lna_vulkan_check(
-            vkMapMemory(
-                renderer->device,
-                staging_buffer_memory,
-                0,
-                vertex_buffer_size,
-                0,
-                &vertices_data
-                )
-            );
-        memcpy(
-            vertices_data,
-            config->vertices,
-            vertex_buffer_size
-            );
-        vkUnmapMemory(
-            renderer->device,
-            staging_buffer_memory
-            );
-        lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
-            vertex_buffer_size,
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            &mesh->vertex_buffer,
-            &mesh->vertex_buffer_memory
-            );
-        lna_vulkan_copy_buffer(
-            renderer->device,
-            renderer->command_pool,
-            renderer->graphics_queue,
-            staging_buffer,
-            mesh->vertex_buffer,
-            vertex_buffer_size
-            );
-        vkDestroyBuffer(
-            renderer->device,
-            staging_buffer,
-            NULL
-            );
-        vkFreeMemory(
-            renderer->device,
-            staging_buffer_memory,
-            NULL
-            );
+        lna_vulkan_command_cache_invalidate(&mesh_system->command_cache);
     }
 
-    //! INDEX BUFFER PART
+    return handle;
+}
 
+void lna_mesh_system_delete_mesh(lna_mesh_system_t* mesh_system, lna_handle_t mesh_handle)
+{
+    lna_assert(mesh_system)
+    lna_assert(mesh_system->renderer)
+
+    lna_mesh_t* mesh = lna_object_pool_get(&mesh_system->meshes, mesh_handle);
+    lna_assert(mesh)
+
+    lna_vulkan_renderer_push_buffer_deletion(
+        mesh_system->renderer,
+        mesh->index_buffer,
+        &mesh->index_buffer_allocation
+        );
+    lna_vulkan_renderer_push_buffer_deletion(
+        mesh_system->renderer,
+        mesh->vertex_buffer,
+        &mesh->vertex_buffer_allocation
+        );
+    lna_vulkan_renderer_push_descriptor_sets_deletion(
+        mesh_system->renderer,
+        mesh_system->descriptor_pool,
+        mesh->descriptor_sets,
+        mesh_system->renderer->frame_in_flight_count
+        );
+    lna_object_pool_delete(
+        &mesh_system->meshes,
+        mesh_handle
+        );
+
+    //! the delete moves the last mesh, the cached command buffers use the previous order
+    if (mesh_system->static_meshes)
     {
-        const size_t index_buffer_size = sizeof(config->indices[0]) * config->index_count;
+        lna_vulkan_command_cache_invalidate(&mesh_system->command_cache);
+    }
+}
 
-        VkBuffer staging_buffer;
-        VkDeviceMemory staging_buffer_memory;
-        lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
-            index_buffer_size,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            &staging_buffer,
-            &staging_buffer_memory
-            );
-        void *indices_data;
-        lna_vulkan_check(
-            vkMapMemory(
-                renderer->device,
-                staging_buffer_memory,
-                0,
-                index_buffer_size,
-                0,
-                &indices_data
-                )
-            );
-        memcpy(
-            indices_data,
-            config->indices,
-            index_buffer_size
-            );
-        vkUnmapMemory(
-            renderer->device,
-            staging_buffer_memory
-            );
-        lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
-            index_buffer_size,
-            VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
-            &mesh->index_buffer,
-            &mesh->index_buffer_memory
-            );
-        lna_vulkan_copy_buffer(
-            renderer->device,
-            renderer->command_pool,
-            renderer->graphics_queue,
-            staging_buffer,
-            mesh->index_buffer,
-            index_buffer_size
-            );
-        vkDestroyBuffer(
-            renderer->device,
-            staging_buffer,
-            NULL
-            );
-        vkFreeMemory(
-            renderer->device,
-            staging_buffer_memory,
-            NULL
+lna_mesh_geometry_t* lna_mesh_system_new_geometry(lna_mesh_system_t* mesh_system, const lna_mesh_geometry_config_t* config)
+{
+    lna_assert(mesh_system)
+    lna_assert(mesh_system->geometries.elements)
+    lna_assert(mesh_system->geometries.cur_element_count < mesh_system->geometries.max_element_count)
+    lna_assert(mesh_system->renderer)
+    lna_assert(config)
+    lna_assert(config->vertices)
+    lna_assert(config->vertex_count > 0)
+    lna_assert(config->indices || config->indices_16)
+    lna_assert(config->index_count > 0)
+
+    lna_mesh_geometry_t* geometry = &mesh_system->geometries.elements[mesh_system->geometries.cur_element_count++];
+
+    lna_assert(geometry->vertex_buffer == VK_NULL_HANDLE)
+    lna_assert(geometry->vertex_buffer_allocation.memory == VK_NULL_HANDLE)
+    lna_assert(geometry->index_buffer == VK_NULL_HANDLE)
+    lna_assert(geometry->index_buffer_allocation.memory == VK_NULL_HANDLE)
+
+    geometry->index_count   = config->index_count;
+    geometry->index_type    = config->indices_16 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+    lna_mesh_create_geometry_buffers(
+        mesh_system->renderer,
+        config->vertices,
+        config->vertex_count,
+        config->indices_16 ? (const void*)config->indices_16 : (const void*)config->indices,
+        config->indices_16 ? sizeof(uint16_t) : sizeof(uint32_t),
+        config->index_count,
+        &geometry->vertex_buffer,
+        &geometry->vertex_buffer_allocation,
+        &geometry->index_buffer,
+        &geometry->index_buffer_allocation
+        );
+
+    return geometry;
+}
+
+lna_handle_t lna_mesh_system_new_instance(lna_mesh_system_t* mesh_system, const lna_mesh_instance_config_t* config)
+{
+    lna_assert(mesh_system)
+    lna_assert(mesh_system->instances.elements)
+    lna_assert(mesh_system->instances.cur_element_count < mesh_system->instances.max_element_count)
+    lna_assert(config)
+    lna_assert(config->geometry)
+    lna_assert(config->material)
+    lna_assert(config->model_matrix)
+    lna_assert(config->view)
+
+    //! find the batch sharing the same geometry, material and view
+
+    lna_mesh_instance_batch_t* batch = NULL;
+    for (uint32_t i = 0; i < mesh_system->instance_batches.cur_element_count; ++i)
+    {
+        lna_mesh_instance_batch_t* cur_batch = &mesh_system->instance_batches.elements[i];
+        if (
+            cur_batch->geometry == config->geometry
+            && cur_batch->material == config->material
+            && cur_batch->view == config->view
+            )
+        {
+            batch = cur_batch;
+            break;
+        }
+    }
+    if (batch == NULL)
+    {
+        lna_assert(mesh_system->instance_batches.cur_element_count < mesh_system->instance_batches.max_element_count)
+
+        batch = &mesh_system->instance_batches.elements[mesh_system->instance_batches.cur_element_count++];
+        batch->geometry             = config->geometry;
+        batch->material             = config->material;
+        batch->view                 = config->view;
+
+        lna_mesh_create_descriptor_sets(
+            mesh_system,
+            batch->material,
+            batch->descriptor_sets
             );
     }
 
-    //! UNIFORM BUFFER
+    lna_handle_t            handle;
+    lna_mesh_instance_t*    instance = lna_object_pool_new(&mesh_system->instances, &handle);
+    instance->batch         = batch;
+    instance->model_matrix  = config->model_matrix;
+    ++batch->instance_count;
 
-    lna_mesh_create_uniform_buffer(
-        mesh,
-        renderer
-        );
+    return handle;
+}
 
-    //! DESCRIPTOR SETS
+void lna_mesh_system_delete_instance(lna_mesh_system_t* mesh_system, lna_handle_t instance_handle)
+{
+    lna_assert(mesh_system)
 
-    lna_mesh_create_descriptor_sets(
-        mesh,
-        mesh_system
+    lna_mesh_instance_t* instance = lna_object_pool_get(&mesh_system->instances, instance_handle);
+    lna_assert(instance)
+    lna_assert(instance->batch)
+    lna_assert(instance->batch->instance_count > 0)
+
+    //! the instance data are written each frame, an empty batch is skipped
+    //! and kept for the next instances sharing its geometry and material
+    --instance->batch->instance_count;
+    lna_object_pool_delete(
+        &mesh_system->instances,
+        instance_handle
         );
-
-    return mesh;
 }
 
 void lna_mesh_system_draw(lna_mesh_system_t* mesh_system)
@@ -910,127 +1316,114 @@ void lna_mesh_system_draw(lna_mesh_system_t* mesh_system)
 
     lna_renderer_t* renderer = mesh_system->renderer;
     lna_assert(renderer)
-    lna_assert(renderer->command_buffers.elements)
-    lna_assert(renderer->command_buffers.count > mesh_system->renderer->image_index)
-
-    VkCommandBuffer command_buffer = mesh_system->renderer->command_buffers.elements[mesh_system->renderer->image_index];
 
-    vkCmdBindPipeline(
-        command_buffer,
-        VK_PIPELINE_BIND_POINT_GRAPHICS,
-        mesh_system->pipeline
-        );
-    for (uint32_t i = 0; i < mesh_system->meshes.cur_element_count; ++i)
+    if (mesh_system->static_meshes)
     {
-        lna_mesh_t* mesh = &mesh_system->meshes.elements[i];
-        lna_assert(mesh->model_matrix)
-        lna_assert(mesh->view_matrix)
-        lna_assert(mesh->projection_matrix)
-        lna_assert(mesh->mvp_uniform_buffers_memory.elements)
-        lna_assert(mesh->mvp_uniform_buffers_memory.count > renderer->image_index)
-        lna_assert(mesh->light_uniform_buffers_memory.count > renderer->image_index)
-        lna_assert(mesh->light_uniform_buffers_memory.elements)
-        lna_assert(mesh->descriptor_sets.count > renderer->image_index)
-        lna_assert(mesh->descriptor_sets.elements)
-
-        const lna_mesh_mvp_uniform_t mvp_ubo =
-        {
-            .model      = *mesh->model_matrix,
-            .view       = *mesh->view_matrix,
-            .projection = *mesh->projection_matrix,
-        };
-        void *mvp_data;
-        lna_vulkan_check(
-            vkMapMemory(
-                renderer->device,
-                mesh->mvp_uniform_buffers_memory.elements[renderer->image_index],
-                0,
-                sizeof(mvp_ubo),
-                0,
-                &mvp_data
-                )
+        //! only the instance data and the light are written each frame, the
+        //! commands are recorded again when the cache is invalidated
+        lna_mesh_instance_data_t* instance_data = lna_renderer_persistent_uniform_data(
+            renderer,
+            mesh_system->persistent_instance_data_offset
             );
-        memcpy(
-            mvp_data,
-            &mvp_ubo,
-            sizeof(mvp_ubo));
-        vkUnmapMemory(
-            renderer->device,
-            mesh->mvp_uniform_buffers_memory.elements[renderer->image_index]
-            );
-
-        const lna_mesh_light_uniform_t light_ubo =
+        for (uint32_t i = 0; i < mesh_system->meshes.cur_element_count; ++i)
         {
-            .light_position   = { 1.5f, 1.5f, 1.5f, 0.0f }, // TODO: remove hard coded value!
-            .view_position    = { 2.0f, 2.0f, 2.0f, 0.0f }, // TODO: remove hard coded value!
-            .light_color      = { 1.0f, 1.0f, 1.0f, 0.0f }, // TODO: remove hard coded value!
-        };
-        void *light_data;
-        lna_vulkan_check(
-            vkMapMemory(
-                renderer->device,
-                mesh->light_uniform_buffers_memory.elements[renderer->image_index],
-                0,
-                sizeof(light_ubo),
-                0,
-                &light_data
+            const lna_mesh_t* mesh = lna_object_pool_element(&mesh_system->meshes, i);
+            lna_assert(mesh->model_matrix)
+            lna_mesh_write_instance_data(
+                &instance_data[i],
+                mesh->model_matrix
+                );
+        }
+        lna_mesh_write_light_uniform(
+            lna_renderer_persistent_uniform_data(
+                renderer,
+                mesh_system->persistent_light_uniform_offset
                 )
             );
-        memcpy(
-            light_data,
-            &light_ubo,
-            sizeof(light_ubo));
-        vkUnmapMemory(
-            renderer->device,
-            mesh->light_uniform_buffers_memory.elements[renderer->image_index]
+        lna_vulkan_renderer_record_cached(
+            renderer,
+            &mesh_system->command_cache,
+            lna_mesh_system_record_static_meshes,
+            mesh_system,
+            mesh_system->meshes.cur_element_count
             );
-
-        vkCmdBindDescriptorSets(
-            command_buffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            mesh_system->pipeline_layout,
-            0,
-            1,
-            &mesh->descriptor_sets.elements[renderer->image_index],
-            0,
-            NULL
+    }
+    else
+    {
+        lna_vulkan_renderer_record(
+            renderer,
+            lna_mesh_system_record_meshes,
+            mesh_system,
+            mesh_system->meshes.cur_element_count,
+            LNA_MESH_SYSTEM_RECORD_RANGE_SIZE
             );
-        const VkBuffer vertex_buffers[] =
+    }
+
+    if (mesh_system->instances.cur_element_count == 0)
+    {
+        return;
+    }
+
+    //! INSTANCED PART
+
+    //! reserve the instance data of each batch in the frame buffer, then
+    //! write the model and normal matrices of each instance in the data of its batch.
+    for (uint32_t i = 0; i < mesh_system->instance_batches.cur_element_count; ++i)
+    {
+        lna_mesh_instance_batch_t* batch = &mesh_system->instance_batches.elements[i];
+        if (batch->instance_count == 0)
         {
-            mesh->vertex_buffer
-        };
-        VkDeviceSize offsets[] = {0};
-        vkCmdBindVertexBuffers(
-            command_buffer,
-            0,
-            1,
-            vertex_buffers,
-            offsets
-            );
-        vkCmdBindIndexBuffer(
-            command_buffer,
-            mesh->index_buffer,
-            0,
-            VK_INDEX_TYPE_UINT32
+            continue;
+        }
+
+        batch->cur_instance_index   = 0;
+        batch->instance_data        = lna_renderer_reserve_vertex_data(
+            renderer,
+            sizeof(lna_mesh_instance_data_t) * batch->instance_count,
+            &batch->instance_buffer,
+            &batch->instance_buffer_offset
             );
-        vkCmdDrawIndexed(
-            command_buffer,
-            mesh->index_count,
-            1,
-            0,
-            0,
-            0
+    }
+    for (uint32_t i = 0; i < mesh_system->instances.cur_element_count; ++i)
+    {
+        const lna_mesh_instance_t* instance = lna_object_pool_element(&mesh_system->instances, i);
+        lna_assert(instance->batch)
+        lna_assert(instance->model_matrix)
+        lna_assert(instance->batch->cur_instance_index < instance->batch->instance_count)
+
+        lna_mesh_write_instance_data(
+            &instance->batch->instance_data[instance->batch->cur_instance_index++],
+            instance->model_matrix
             );
     }
+
+    lna_vulkan_renderer_record(
+        renderer,
+        lna_mesh_system_record_instance_batches,
+        mesh_system,
+        mesh_system->instance_batches.cur_element_count,
+        LNA_MESH_SYSTEM_RECORD_RANGE_SIZE
+        );
 }
 
 void lna_mesh_system_release(lna_mesh_system_t* mesh_system)
 {
     lna_assert(mesh_system)
-    lna_assert(mesh_system->meshes.elements)
     lna_assert(mesh_system->renderer)
     lna_assert(mesh_system->renderer->device)
 
+    if (mesh_system->static_meshes)
+    {
+        lna_vulkan_command_cache_release(
+            &mesh_system->command_cache,
+            mesh_system->renderer
+            );
+    }
+    vkDestroyDescriptorPool(
+        mesh_system->renderer->device,
+        mesh_system->descriptor_pool,
+        NULL
+        );
     vkDestroyDescriptorSetLayout(
         mesh_system->renderer->device,
         mesh_system->descriptor_set_layout,
@@ -1038,27 +1431,48 @@ void lna_mesh_system_release(lna_mesh_system_t* mesh_system)
         );
     for (uint32_t i = 0; i < mesh_system->meshes.cur_element_count; ++i)
     {
-        lna_mesh_t* mesh = &mesh_system->meshes.elements[i];
+        lna_mesh_t* mesh = lna_object_pool_element(&mesh_system->meshes, i);
 
         vkDestroyBuffer(
             mesh_system->renderer->device,
             mesh->index_buffer,
             NULL
             );
-        vkFreeMemory(
+        lna_vulkan_memory_allocator_free(
+            &mesh_system->renderer->memory_allocator,
+            &mesh->index_buffer_allocation
+            );
+        vkDestroyBuffer(
             mesh_system->renderer->device,
-            mesh->index_buffer_memory,
+            mesh->vertex_buffer,
             NULL
             );
+        lna_vulkan_memory_allocator_free(
+            &mesh_system->renderer->memory_allocator,
+            &mesh->vertex_buffer_allocation
+            );
+    }
+    for (uint32_t i = 0; i < mesh_system->geometries.cur_element_count; ++i)
+    {
+        lna_mesh_geometry_t* geometry = &mesh_system->geometries.elements[i];
+
         vkDestroyBuffer(
             mesh_system->renderer->device,
-            mesh->vertex_buffer,
+            geometry->index_buffer,
             NULL
             );
-        vkFreeMemory(
+        lna_vulkan_memory_allocator_free(
+            &mesh_system->renderer->memory_allocator,
+            &geometry->index_buffer_allocation
+            );
+        vkDestroyBuffer(
             mesh_system->renderer->device,
-            mesh->vertex_buffer_memory,
+            geometry->vertex_buffer,
             NULL
             );
+        lna_vulkan_memory_allocator_free(
+            &mesh_system->renderer->memory_allocator,
+            &geometry->vertex_buffer_allocation
+            );
     }
 }
@@ -2,43 +2,95 @@
 #define LNA_BACKENDS_VULKAN_LNA_MESH_VULKAN_H
 
 #include "backends/vulkan/lna_renderer_vulkan.h"
+#include "core/lna_object_pool.h"
+#include "maths/lna_mat4.h"
 
 typedef struct lna_material_s           lna_material_t;
-typedef struct lna_mat4_s               lna_mat4_t;
 
 typedef struct lna_mesh_s
 {
     const lna_material_t*               material;
     VkBuffer                            vertex_buffer;
-    VkDeviceMemory                      vertex_buffer_memory;
+    lna_vulkan_memory_allocation_t      vertex_buffer_allocation;
     VkBuffer                            index_buffer;
-    VkDeviceMemory                      index_buffer_memory;
-    lna_vulkan_buffer_array_t           mvp_uniform_buffers;
-    lna_vulkan_device_memory_array_t    mvp_uniform_buffers_memory;
-    lna_vulkan_buffer_array_t           light_uniform_buffers;
-    lna_vulkan_device_memory_array_t    light_uniform_buffers_memory;
-    lna_vulkan_descriptor_set_array_t   descriptor_sets;
+    lna_vulkan_memory_allocation_t      index_buffer_allocation;
+    VkDescriptorSet                     descriptor_sets[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
     const lna_mat4_t*                   model_matrix;
-    const lna_mat4_t*                   view_matrix;
-    const lna_mat4_t*                   projection_matrix;
+    const lna_vec4_t*                   tint;               //! NULL for white
+    const lna_renderer_view_t*          view;
     uint32_t                            index_count;
+    VkIndexType                         index_type;
 } lna_mesh_t;
 
-typedef struct lna_mesh_vec_s
+typedef struct lna_mesh_geometry_s
+{
+    VkBuffer                            vertex_buffer;
+    lna_vulkan_memory_allocation_t      vertex_buffer_allocation;
+    VkBuffer                            index_buffer;
+    lna_vulkan_memory_allocation_t      index_buffer_allocation;
+    uint32_t                            index_count;
+    VkIndexType                         index_type;
+} lna_mesh_geometry_t;
+
+typedef struct lna_mesh_geometry_vec_s
 {
     uint32_t                            cur_element_count;
     uint32_t                            max_element_count;
-    lna_mesh_t*                         elements;
-} lna_mesh_vec_t;
+    lna_mesh_geometry_t*                elements;
+} lna_mesh_geometry_vec_t;
+
+//! per instance vertex data of the instanced pipeline, the normal matrix is
+//! computed on the cpu once per instance.
+typedef struct lna_mesh_instance_data_s
+{
+    lna_mat4_t                          model;
+    lna_normal_matrix_t                 normal_matrix;
+} lna_mesh_instance_data_t;
+
+//! group of instances drawn with one instanced draw call.
+typedef struct lna_mesh_instance_batch_s
+{
+    const lna_mesh_geometry_t*          geometry;
+    const lna_material_t*               material;
+    const lna_renderer_view_t*          view;
+    VkDescriptorSet                     descriptor_sets[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    uint32_t                            instance_count;
+    //! per frame instance data, filled in lna_mesh_system_draw
+    lna_mesh_instance_data_t*           instance_data;
+    VkBuffer                            instance_buffer;
+    VkDeviceSize                        instance_buffer_offset;
+    uint32_t                            cur_instance_index;
+} lna_mesh_instance_batch_t;
+
+typedef struct lna_mesh_instance_batch_vec_s
+{
+    uint32_t                            cur_element_count;
+    uint32_t                            max_element_count;
+    lna_mesh_instance_batch_t*          elements;
+} lna_mesh_instance_batch_vec_t;
+
+typedef struct lna_mesh_instance_s
+{
+    lna_mesh_instance_batch_t*          batch;
+    const lna_mat4_t*                   model_matrix;
+} lna_mesh_instance_t;
 
 typedef struct lna_mesh_system_s
 {
     lna_renderer_t*                     renderer;
-    lna_mesh_vec_t                      meshes;
+    lna_object_pool_t                   meshes;             //! of lna_mesh_t
+    lna_mesh_geometry_vec_t             geometries;
+    lna_object_pool_t                   instances;          //! of lna_mesh_instance_t
+    lna_mesh_instance_batch_vec_t       instance_batches;
     VkDescriptorSetLayout               descriptor_set_layout;
     VkDescriptorPool                    descriptor_pool;
     VkPipelineLayout                    pipeline_layout;
     VkPipeline                          pipeline;
+    VkPipeline                          instanced_pipeline;
+    bool                                static_meshes;
+    lna_vulkan_command_cache_t          command_cache;                      //! only used by the static meshes
+    uint32_t                            persistent_instance_data_offset;    //! model and normal matrices of the static meshes, read as instance data
+    uint32_t                            persistent_light_uniform_offset;    //! light uniform data of the static meshes
 } lna_mesh_system_t;
 
 #endif
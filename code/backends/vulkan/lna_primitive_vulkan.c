@@ -9,12 +9,8 @@
 #include "maths/lna_mat4.h"
 #include "maths/lna_maths.h"
 
-typedef struct lna_primitive_uniform_s
-{
-    lna_mat4_t  model;
-    lna_mat4_t  view;
-    lna_mat4_t  projection;
-} lna_primitive_uniform_t;
+//! count of primitives recorded in each secondary command buffer
+static const uint32_t LNA_PRIMITIVE_SYSTEM_RECORD_RANGE_SIZE = 256;
 
 static void lna_primitive_system_create_graphics_pipeline(
     lna_primitive_system_t* primitive_system,
@@ -101,27 +97,13 @@ static void lna_primitive_system_create_graphics_pipeline(
         .topology               = primitive_system->fill_shapes ? VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST : VK_PRIMITIVE_TOPOLOGY_LINE_LIST,
         .primitiveRestartEnable = VK_FALSE,
     };
-    const VkViewport viewport =
-    {
-        .x          = 0.0f,
-        .y          = 0.0f,
-        .width      = (float)(renderer->swap_chain_extent.width),
-        .height     = (float)(renderer->swap_chain_extent.height),
-        .minDepth   = 0.0f,
-        .maxDepth   = 1.0f,
-    };
-    const VkRect2D scissor =
-    {
-        .offset = {0, 0},
-        .extent = renderer->swap_chain_extent,
-    };
     const VkPipelineViewportStateCreateInfo viewport_state_create_info =
     {
         .sType          = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
         .viewportCount  = 1,
-        .pViewports     = &viewport,
+        .pViewports     = NULL, //! dynamic state
         .scissorCount   = 1,
-        .pScissors      = &scissor,
+        .pScissors      = NULL, //! dynamic state
     };
     const VkPipelineRasterizationStateCreateInfo rasterization_state_create_info =
     {
@@ -173,21 +155,29 @@ static void lna_primitive_system_create_graphics_pipeline(
     const VkDynamicState dynamic_states[] =
     {
         VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR,
         VK_DYNAMIC_STATE_LINE_WIDTH
     };
     const VkPipelineDynamicStateCreateInfo dynamic_state_create_info =
     {
         .sType              = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
-        .dynamicStateCount  = 2,
+        .dynamicStateCount  = (uint32_t)(sizeof(dynamic_states) / sizeof(dynamic_states[0])),
         .pDynamicStates     = dynamic_states,
     };
+    //! the primitives only have the view descriptor set, their model matrix is a push constant
+    const VkPushConstantRange push_constant_range =
+    {
+        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+        .offset     = 0,
+        .size       = sizeof(lna_vulkan_object_push_constants_t),
+    };
     const VkPipelineLayoutCreateInfo pipeline_layout_create_info =
     {
         .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
         .setLayoutCount         = 1,
-        .pSetLayouts            = &primitive_system->descriptor_set_layout,
-        .pushConstantRangeCount = 0,
-        .pPushConstantRanges    = NULL,
+        .pSetLayouts            = &renderer->view_descriptor_set_layout,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges    = &push_constant_range,
     };
     lna_vulkan_check(
         vkCreatePipelineLayout(
@@ -253,172 +243,6 @@ static void lna_primitive_system_create_graphics_pipeline(
         );
 }
 
-static void lna_primitive_system_create_descriptor_pool(
-    lna_primitive_system_t* primitive_system
-    )
-{
-    lna_assert(primitive_system)
-    lna_assert(primitive_system->primitives.max_element_count > 0)
-
-    lna_renderer_t* renderer = primitive_system->renderer;
-    lna_assert(renderer)
-    lna_assert(renderer->swap_chain_images.count > 0)
-
-    const VkDescriptorPoolSize pool_sizes[] =
-    {
-        {
-            .type               = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            .descriptorCount    = renderer->swap_chain_images.count * primitive_system->primitives.max_element_count,
-        },
-    };
-
-    const VkDescriptorPoolCreateInfo pool_create_info =
-    {
-        .sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
-        .poolSizeCount  = (uint32_t)(sizeof(pool_sizes) / sizeof(pool_sizes[0])),
-        .pPoolSizes     = pool_sizes,
-        .maxSets        = renderer->swap_chain_images.count * primitive_system->primitives.max_element_count,
-    };
-
-    lna_vulkan_check(
-        vkCreateDescriptorPool(
-            renderer->device,
-            &pool_create_info,
-            NULL,
-            &primitive_system->descriptor_pool
-            )
-        );
-
-    lna_log_message("-------------------------------");
-    lna_log_message("primitive descriptor pool info:");
-    lna_log_message("-------------------------------");
-    lna_log_message("\tdescriptor pool address: %p", (void*)primitive_system->descriptor_pool);
-    lna_log_message("\tmax sets               : %d", pool_create_info.maxSets);
-    lna_log_message("\tpool size count        : %d", pool_create_info.poolSizeCount);
-    for (uint32_t i = 0; i < pool_create_info.poolSizeCount; ++i)
-    {
-        lna_log_message("\tpool %d descriptor count: %d", i, pool_sizes[i].descriptorCount);
-    }
-}
-
-static void lna_primitive_create_uniform_buffer(
-    lna_primitive_t* primitive,
-    lna_renderer_t* renderer
-    )
-{
-    lna_assert(primitive)
-    lna_assert(primitive->mvp_uniform_buffers.count == 0)
-    lna_assert(primitive->mvp_uniform_buffers.elements == NULL)
-    lna_assert(primitive->mvp_uniform_buffers_memory.count == 0)
-    lna_assert(primitive->mvp_uniform_buffers_memory.elements == NULL)
-
-    primitive->mvp_uniform_buffers.count    = renderer->swap_chain_images.count;
-    primitive->mvp_uniform_buffers.elements = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
-        sizeof(VkBuffer) * renderer->swap_chain_images.count
-        );
-
-    primitive->mvp_uniform_buffers_memory.count     = renderer->swap_chain_images.count;
-    primitive->mvp_uniform_buffers_memory.elements  = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
-        sizeof(VkDeviceMemory) * renderer->swap_chain_images.count
-        );
-
-    VkDeviceSize uniform_buffer_size = sizeof(lna_primitive_uniform_t);
-    for (size_t i = 0; i < primitive->mvp_uniform_buffers.count; ++i)
-    {
-        lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
-            uniform_buffer_size,
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            &primitive->mvp_uniform_buffers.elements[i],
-            &primitive->mvp_uniform_buffers_memory.elements[i]
-            );
-    }
-}
-
-static void lna_primitive_create_descriptor_sets(
-    lna_primitive_t* primitive,
-    lna_primitive_system_t* primitive_system
-    )
-{
-    lna_assert(primitive)
-    lna_assert(primitive_system)
-    lna_assert(primitive->descriptor_sets.count == 0)
-    lna_assert(primitive->descriptor_sets.elements == NULL)
-
-    lna_renderer_t* renderer = primitive_system->renderer;
-    lna_assert(renderer)
-
-    lna_vulkan_descriptor_set_layout_array_t layouts = { 0 };
-    layouts.count       = renderer->swap_chain_images.count;
-    layouts.elements    = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME],
-        sizeof(VkDescriptorSetLayout) * renderer->swap_chain_images.count
-        );
-
-    for (uint32_t i = 0; i < layouts.count; ++i)
-    {
-        layouts.elements[i] = primitive_system->descriptor_set_layout;
-    }
-
-    const VkDescriptorSetAllocateInfo allocate_info =
-    {
-        .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
-        .descriptorPool     = primitive_system->descriptor_pool,
-        .descriptorSetCount = layouts.count,
-        .pSetLayouts        = layouts.elements,
-    };
-
-    primitive->descriptor_sets.count    = renderer->swap_chain_images.count;
-    primitive->descriptor_sets.elements = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
-        sizeof(VkDescriptorSet) * renderer->swap_chain_images.count
-        );
-
-    lna_vulkan_check(
-        vkAllocateDescriptorSets(
-            renderer->device,
-            &allocate_info,
-            primitive->descriptor_sets.elements
-            )
-        );
-
-    for (size_t i = 0; i < primitive->descriptor_sets.count; ++i)
-    {
-        const VkDescriptorBufferInfo buffer_info =
-        {
-            .buffer = primitive->mvp_uniform_buffers.elements[i],
-            .offset = 0,
-            .range  = sizeof(lna_primitive_uniform_t),
-        };
-        const VkWriteDescriptorSet write_descriptors[] =
-        {
-            {
-                .sType              = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet             = primitive->descriptor_sets.elements[i],
-                .dstBinding         = 0,
-                .dstArrayElement    = 0,
-                .descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                .descriptorCount    = 1,
-                .pBufferInfo        = &buffer_info,
-                .pImageInfo         = NULL,
-                .pTexelBufferView   = NULL,
-            },
-        };
-
-        vkUpdateDescriptorSets(
-            renderer->device,
-            (uint32_t)(sizeof(write_descriptors) / sizeof(write_descriptors[0])),
-            write_descriptors,
-            0,
-            NULL
-            );
-    }
-}
-
 static void lna_primitive_system_on_swap_chain_cleanup(void* owner)
 {
     lna_assert(owner)
@@ -438,43 +262,6 @@ static void lna_primitive_system_on_swap_chain_cleanup(void* owner)
         primitive_system->pipeline_layout,
         NULL
         );
-
-    for (uint32_t i = 0; i < primitive_system->primitives.cur_element_count; ++i)
-    {
-        lna_primitive_t* primitive = &primitive_system->primitives.elements[i];
-        for (size_t j = 0; j < primitive->mvp_uniform_buffers.count; ++j)
-        {
-            vkDestroyBuffer(
-                renderer->device,
-                primitive->mvp_uniform_buffers.elements[j],
-                NULL
-                );
-        }
-        for (size_t j = 0; j < primitive->mvp_uniform_buffers.count; ++j)
-        {
-            vkFreeMemory(
-                renderer->device,
-                primitive->mvp_uniform_buffers_memory.elements[j],
-                NULL
-                );
-        }
-        primitive->mvp_uniform_buffers.count            = 0;
-        primitive->mvp_uniform_buffers.elements         = NULL;
-        primitive->mvp_uniform_buffers_memory.count     = 0;
-        primitive->mvp_uniform_buffers_memory.elements  = NULL;
-        //! NOTE: no need to explicity clean up vulkan descriptor sets objects
-        //! because it is done when the vulkan descriptor pool is destroyed.
-        //! we just have to reset the array and wait for filling it again.
-        //! the memory pool where we reserved memory for descriptor_sets has already
-        //! been reset by the vulkan renderer backend.
-        primitive->descriptor_sets.count    = 0;
-        primitive->descriptor_sets.elements = NULL;
-    }
-    vkDestroyDescriptorPool(
-        renderer->device,
-        primitive_system->descriptor_pool,
-        NULL
-        );
 }
 
 static void lna_primitive_system_on_swap_chain_recreate(void *owner)
@@ -490,106 +277,15 @@ static void lna_primitive_system_on_swap_chain_recreate(void *owner)
         primitive_system,
         renderer
         );
-    lna_primitive_system_create_descriptor_pool(
-        primitive_system
-        );
-
-    for (uint32_t i = 0; i < primitive_system->primitives.cur_element_count; ++i)
-    {
-        lna_primitive_create_uniform_buffer(
-            &primitive_system->primitives.elements[i],
-            renderer
-            );
-        lna_primitive_create_descriptor_sets(
-            &primitive_system->primitives.elements[i],
-            primitive_system
-            );
-    }
-}
-
-void lna_primitive_system_init(lna_primitive_system_t* primitive_system, const lna_primitive_system_config_t* config)
-{
-    lna_assert(primitive_system)
-    lna_assert(primitive_system->renderer == NULL)
-    lna_assert(primitive_system->primitives.cur_element_count == 0)
-    lna_assert(primitive_system->primitives.max_element_count == 0)
-    lna_assert(primitive_system->primitives.elements == NULL)
-    lna_assert(primitive_system->descriptor_pool == VK_NULL_HANDLE)
-    lna_assert(primitive_system->descriptor_set_layout == VK_NULL_HANDLE)
-    lna_assert(primitive_system->pipeline == VK_NULL_HANDLE)
-    lna_assert(primitive_system->pipeline_layout == VK_NULL_HANDLE)
-    lna_assert(config)
-    lna_assert(config->renderer)
-    lna_assert(config->renderer->device)
-    lna_assert(config->renderer->render_pass)
-
-    primitive_system->renderer      = config->renderer;
-    primitive_system->fill_shapes   = config->fill_shapes;
-
-    lna_renderer_register_listener(
-        config->renderer,
-        lna_primitive_system_on_swap_chain_cleanup,
-        lna_primitive_system_on_swap_chain_recreate,
-        (void*)primitive_system
-        );
-
-    primitive_system->primitives.max_element_count  = config->max_primitive_count;
-    primitive_system->primitives.elements           = lna_memory_pool_reserve(
-        config->memory_pool,
-        sizeof(lna_primitive_t) * config->max_primitive_count
-        );
-
-    //! DESCRIPTOR SET LAYOUT
-
-    const VkDescriptorSetLayoutBinding bindings[] =
-    {
-        {
-            .binding            = 0,
-            .descriptorCount    = 1,
-            .descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            .stageFlags         = VK_SHADER_STAGE_VERTEX_BIT,
-            .pImmutableSamplers = NULL,
-        },
-    };
-    const VkDescriptorSetLayoutCreateInfo layout_create_info =
-    {
-        .sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
-        .bindingCount   = (uint32_t)(sizeof(bindings) / sizeof(bindings[0])),
-        .pBindings      = bindings,
-    };
-    lna_vulkan_check(
-        vkCreateDescriptorSetLayout(
-            config->renderer->device,
-            &layout_create_info,
-            NULL,
-            &primitive_system->descriptor_set_layout
-            )
-        );
-
-    //! GRAPHICS PIPELINE
-
-    lna_primitive_system_create_graphics_pipeline(
-        primitive_system,
-        config->renderer
-        );
-
-    //! DESCRIPTOR POOL
-
-    lna_primitive_system_create_descriptor_pool(
-        primitive_system
-        );
 }
 
-void lna_primitive_system_draw(lna_primitive_system_t* primitive_system)
+//! called by the renderer record jobs, the primitives must not change until the end of the frame.
+static void lna_primitive_system_record(void* owner, VkCommandBuffer command_buffer, uint32_t begin, uint32_t end)
 {
-    lna_assert(primitive_system)
-
+    lna_assert(owner)
+    lna_primitive_system_t* primitive_system = (lna_primitive_system_t*)owner;
     lna_renderer_t* renderer = primitive_system->renderer;
     lna_assert(renderer)
-    lna_assert(renderer->command_buffers.elements)
-    lna_assert(renderer->command_buffers.count > renderer->image_index)
-
-    VkCommandBuffer command_buffer = renderer->command_buffers.elements[renderer->image_index];
 
     vkCmdSetLineWidth(
         command_buffer,
@@ -601,53 +297,36 @@ void lna_primitive_system_draw(lna_primitive_system_t* primitive_system)
         VK_PIPELINE_BIND_POINT_GRAPHICS,
         primitive_system->pipeline
         );
-    for (uint32_t i = 0; i < primitive_system->primitives.cur_element_count; ++i)
+    const lna_renderer_view_t* bound_view = NULL;
+    for (uint32_t i = begin; i < end; ++i)
     {
-        lna_primitive_t* primitive = &primitive_system->primitives.elements[i];
+        lna_primitive_t* primitive = lna_object_pool_element(&primitive_system->primitives, i);
 
         lna_assert(primitive->model_matrix)
-        lna_assert(primitive->view_matrix)
-        lna_assert(primitive->projection_matrix)
-        lna_assert(primitive->mvp_uniform_buffers.count > renderer->image_index)
-        lna_assert(primitive->mvp_uniform_buffers.elements)
-        lna_assert(primitive->descriptor_sets.count > renderer->image_index)
-        lna_assert(primitive->descriptor_sets.elements)
+        lna_assert(primitive->view)
 
-        const lna_primitive_uniform_t ubo =
+        if (primitive->view != bound_view)
+        {
+            lna_vulkan_renderer_bind_view(
+                renderer,
+                command_buffer,
+                primitive_system->pipeline_layout,
+                primitive->view
+                );
+            bound_view = primitive->view;
+        }
+        const lna_vulkan_object_push_constants_t push_constants =
         {
-            .model      = *primitive->model_matrix,
-            .view       = *primitive->view_matrix,
-            .projection = *primitive->projection_matrix,
+            .model  = *primitive->model_matrix,
+            .tint   = primitive->tint ? *primitive->tint : (lna_vec4_t){ 1.0f, 1.0f, 1.0f, 1.0f },
         };
-        void *data;
-        lna_vulkan_check(
-            vkMapMemory(
-                renderer->device,
-                primitive->mvp_uniform_buffers_memory.elements[renderer->image_index],
-                0,
-                sizeof(ubo),
-                0,
-                &data
-                )
-            );
-        memcpy(
-            data,
-            &ubo,
-            sizeof(ubo));
-        vkUnmapMemory(
-            renderer->device,
-            primitive->mvp_uniform_buffers_memory.elements[renderer->image_index]
-            );
-
-        vkCmdBindDescriptorSets(
+        vkCmdPushConstants(
             command_buffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
             primitive_system->pipeline_layout,
+            VK_SHADER_STAGE_VERTEX_BIT,
             0,
-            1,
-            &primitive->descriptor_sets.elements[renderer->image_index],
-            0,
-            NULL
+            sizeof(push_constants),
+            &push_constants
             );
         const VkBuffer vertex_buffers[] =
         {
@@ -678,6 +357,61 @@ void lna_primitive_system_draw(lna_primitive_system_t* primitive_system)
     }
 }
 
+void lna_primitive_system_init(lna_primitive_system_t* primitive_system, const lna_primitive_system_config_t* config)
+{
+    lna_assert(primitive_system)
+    lna_assert(primitive_system->renderer == NULL)
+    lna_assert(primitive_system->primitives.cur_element_count == 0)
+    lna_assert(primitive_system->primitives.max_element_count == 0)
+    lna_assert(primitive_system->primitives.elements == NULL)
+    lna_assert(primitive_system->pipeline == VK_NULL_HANDLE)
+    lna_assert(primitive_system->pipeline_layout == VK_NULL_HANDLE)
+    lna_assert(config)
+    lna_assert(config->renderer)
+    lna_assert(config->renderer->device)
+    lna_assert(config->renderer->render_pass)
+
+    primitive_system->renderer      = config->renderer;
+    primitive_system->fill_shapes   = config->fill_shapes;
+
+    lna_renderer_register_listener(
+        config->renderer,
+        lna_primitive_system_on_swap_chain_cleanup,
+        lna_primitive_system_on_swap_chain_recreate,
+        (void*)primitive_system
+        );
+
+    lna_object_pool_init(
+        &primitive_system->primitives,
+        config->memory_pool,
+        sizeof(lna_primitive_t),
+        config->max_primitive_count
+        );
+
+    //! GRAPHICS PIPELINE
+
+    lna_primitive_system_create_graphics_pipeline(
+        primitive_system,
+        config->renderer
+        );
+}
+
+void lna_primitive_system_draw(lna_primitive_system_t* primitive_system)
+{
+    lna_assert(primitive_system)
+
+    lna_renderer_t* renderer = primitive_system->renderer;
+    lna_assert(renderer)
+
+    lna_vulkan_renderer_record(
+        renderer,
+        lna_primitive_system_record,
+        primitive_system,
+        primitive_system->primitives.cur_element_count,
+        LNA_PRIMITIVE_SYSTEM_RECORD_RANGE_SIZE
+        );
+}
+
 void lna_primitive_system_release(lna_primitive_system_t* primitive_system)
 {
     lna_assert(primitive_system)
@@ -685,138 +419,112 @@ void lna_primitive_system_release(lna_primitive_system_t* primitive_system)
     lna_assert(primitive_system->primitives.elements)
     lna_assert(primitive_system->renderer->device)
 
-    vkDestroyDescriptorSetLayout(
-        primitive_system->renderer->device,
-        primitive_system->descriptor_set_layout,
-        NULL
-        );
     for (uint32_t i = 0; i < primitive_system->primitives.cur_element_count; ++i)
     {
-        lna_primitive_t* primitive = &primitive_system->primitives.elements[i];
+        lna_primitive_t* primitive = lna_object_pool_element(&primitive_system->primitives, i);
 
         vkDestroyBuffer(
             primitive_system->renderer->device,
             primitive->index_buffer,
             NULL
             );
-        vkFreeMemory(
-            primitive_system->renderer->device,
-            primitive->index_buffer_memory,
-            NULL
+        lna_vulkan_memory_allocator_free(
+            &primitive_system->renderer->memory_allocator,
+            &primitive->index_buffer_allocation
             );
         vkDestroyBuffer(
             primitive_system->renderer->device,
             primitive->vertex_buffer,
             NULL
             );
-        vkFreeMemory(
-            primitive_system->renderer->device,
-            primitive->vertex_buffer_memory,
-            NULL
+        lna_vulkan_memory_allocator_free(
+            &primitive_system->renderer->memory_allocator,
+            &primitive->vertex_buffer_allocation
             );
     }
 }
 
-lna_primitive_t* lna_primitive_system_new_raw(lna_primitive_system_t* primitive_system, const lna_primitive_raw_config_t* config)
+void lna_primitive_system_delete(lna_primitive_system_t* primitive_system, lna_handle_t primitive_handle)
+{
+    lna_assert(primitive_system)
+    lna_assert(primitive_system->renderer)
+
+    lna_primitive_t* primitive = lna_object_pool_get(&primitive_system->primitives, primitive_handle);
+    lna_assert(primitive)
+
+    lna_vulkan_renderer_push_buffer_deletion(
+        primitive_system->renderer,
+        primitive->index_buffer,
+        &primitive->index_buffer_allocation
+        );
+    lna_vulkan_renderer_push_buffer_deletion(
+        primitive_system->renderer,
+        primitive->vertex_buffer,
+        &primitive->vertex_buffer_allocation
+        );
+    lna_object_pool_delete(
+        &primitive_system->primitives,
+        primitive_handle
+        );
+}
+
+lna_handle_t lna_primitive_system_new_raw(lna_primitive_system_t* primitive_system, const lna_primitive_raw_config_t* config)
 {
     lna_assert(primitive_system)
     lna_assert(primitive_system->primitives.elements)
     lna_assert(primitive_system->primitives.cur_element_count < primitive_system->primitives.max_element_count)
     lna_assert(config)
 
-    lna_primitive_t* primitive = &primitive_system->primitives.elements[primitive_system->primitives.cur_element_count++];
+    lna_handle_t        handle;
+    lna_primitive_t*    primitive   = lna_object_pool_new(&primitive_system->primitives, &handle);
 
     lna_assert(primitive)
     lna_assert(primitive->vertex_buffer == VK_NULL_HANDLE)
-    lna_assert(primitive->vertex_buffer_memory == VK_NULL_HANDLE)
+    lna_assert(primitive->vertex_buffer_allocation.memory == VK_NULL_HANDLE)
     lna_assert(primitive->index_buffer == VK_NULL_HANDLE)
-    lna_assert(primitive->index_buffer_memory == VK_NULL_HANDLE)
-    lna_assert(primitive->mvp_uniform_buffers.elements == NULL)
-    lna_assert(primitive->mvp_uniform_buffers_memory.elements == NULL)
-    lna_assert(primitive->descriptor_sets.elements == NULL)
+    lna_assert(primitive->index_buffer_allocation.memory == VK_NULL_HANDLE)
     lna_assert(primitive->model_matrix == NULL)
-    lna_assert(primitive->view_matrix == NULL)
-    lna_assert(primitive->projection_matrix == NULL)
+    lna_assert(primitive->view == NULL)
     lna_assert(config)
     lna_assert(config->vertices)
     lna_assert(config->indices)
     lna_assert(config->vertex_count > 0)
     lna_assert(config->index_count > 0)
     lna_assert(config->model_matrix)
-    lna_assert(config->view_matrix)
-    lna_assert(config->projection_matrix)
+    lna_assert(config->view)
     lna_assert(primitive_system)
 
     lna_renderer_t* renderer = primitive_system->renderer;
     lna_assert(renderer)
 
     primitive->model_matrix        = config->model_matrix;
-    primitive->view_matrix         = config->view_matrix;
-    primitive->projection_matrix   = config->projection_matrix;
+    primitive->tint                = config->tint;
+    primitive->view                = config->view;
 
     //! VERTEX BUFFER PART
 
     {
         size_t vertex_buffer_size = sizeof(config->vertices[0]) * config->vertex_count;
         
-        VkBuffer staging_buffer;
-        VkDeviceMemory staging_buffer_memory;
-        lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
-            vertex_buffer_size,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            &staging_buffer,
-            &staging_buffer_memory
-            );
-        void *vertices_data;
-        lna_vulkan_check(
-            vkMapMemory(
-                renderer->device,
-                staging_buffer_memory,
-                0,
-                vertex_buffer_size,
-                0,
-                &vertices_data
-                )
-            );
-        memcpy(
-            vertices_data,
-            config->vertices,
-            vertex_buffer_size
-            );
-        vkUnmapMemory(
-            renderer->device,
-            staging_buffer_memory
-            );
         lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
+            &renderer->memory_allocator,
             vertex_buffer_size,
             VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             &primitive->vertex_buffer,
-            &primitive->vertex_buffer_memory
+            &primitive->vertex_buffer_allocation
             );
-        lna_vulkan_copy_buffer(
-            renderer->device,
-            renderer->command_pool,
-            renderer->graphics_queue,
-            staging_buffer,
-            primitive->vertex_buffer,
+        memcpy(
+            lna_vulkan_upload_manager_upload_buffer(
+                &renderer->upload_manager,
+                primitive->vertex_buffer,
+                0,
+                vertex_buffer_size,
+                NULL
+                ),
+            config->vertices,
             vertex_buffer_size
             );
-        vkDestroyBuffer(
-            renderer->device,
-            staging_buffer,
-            NULL
-            );
-        vkFreeMemory(
-            renderer->device,
-            staging_buffer_memory,
-            NULL
-            );
     }
 
     //! INDEX BUFFER PART
@@ -826,84 +534,31 @@ lna_primitive_t* lna_primitive_system_new_raw(lna_primitive_system_t* primitive_
 
         primitive->index_count = config->index_count;
 
-        VkBuffer staging_buffer;
-        VkDeviceMemory staging_buffer_memory;
         lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
-            index_buffer_size,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            &staging_buffer,
-            &staging_buffer_memory
-            );
-        void *indices_data;
-        lna_vulkan_check(
-            vkMapMemory(
-                renderer->device,
-                staging_buffer_memory,
-                0,
-                index_buffer_size,
-                0,
-                &indices_data
-                )
-            );
-        memcpy(
-            indices_data,
-            config->indices,
-            index_buffer_size
-            );
-        vkUnmapMemory(
-            renderer->device,
-            staging_buffer_memory
-            );
-        lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
+            &renderer->memory_allocator,
             index_buffer_size,
             VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             &primitive->index_buffer,
-            &primitive->index_buffer_memory
+            &primitive->index_buffer_allocation
             );
-        lna_vulkan_copy_buffer(
-            renderer->device,
-            renderer->command_pool,
-            renderer->graphics_queue,
-            staging_buffer,
-            primitive->index_buffer,
+        memcpy(
+            lna_vulkan_upload_manager_upload_buffer(
+                &renderer->upload_manager,
+                primitive->index_buffer,
+                0,
+                index_buffer_size,
+                NULL
+                ),
+            config->indices,
             index_buffer_size
             );
-        vkDestroyBuffer(
-            renderer->device,
-            staging_buffer,
-            NULL
-            );
-        vkFreeMemory(
-            renderer->device,
-            staging_buffer_memory,
-            NULL
-            );
     }
 
-    //! UNIFORM BUFFER
-
-    lna_primitive_create_uniform_buffer(
-        primitive,
-        renderer
-        );
-
-    //! DESCRIPTOR SETS
-
-    lna_primitive_create_descriptor_sets(
-        primitive,
-        primitive_system
-        );
-
-    return primitive;
+    return handle;
 }
 
-lna_primitive_t* lna_primitive_system_new_line(lna_primitive_system_t* primitive_system, const lna_primitive_line_config_t* config)
+lna_handle_t lna_primitive_system_new_line(lna_primitive_system_t* primitive_system, const lna_primitive_line_config_t* config)
 {
     lna_assert(primitive_system)
     lna_assert(!primitive_system->fill_shapes) // TODO: check if we can draw line in fill shapes mode
@@ -934,13 +589,13 @@ lna_primitive_t* lna_primitive_system_new_line(lna_primitive_system_t* primitive
             .vertex_count       = 2,
             .index_count        = 2,
             .model_matrix       = config->model_matrix,
-            .view_matrix        = config->view_matrix,
-            .projection_matrix  = config->projection_matrix,
+            .tint               = config->tint,
+            .view               = config->view,
         }
         );
 }
 
-lna_primitive_t* lna_primitive_system_new_rect_xy(lna_primitive_system_t* primitive_system, const lna_primitive_rect_config_t* config)
+lna_handle_t lna_primitive_system_new_rect_xy(lna_primitive_system_t* primitive_system, const lna_primitive_rect_config_t* config)
 {
     lna_assert(config)
     lna_assert(config->position)
@@ -996,8 +651,8 @@ lna_primitive_t* lna_primitive_system_new_rect_xy(lna_primitive_system_t* primit
             .vertex_count       = 4,
             .index_count        = primitive_system->fill_shapes ? 6 : 8,
             .model_matrix       = config->model_matrix,
-            .view_matrix        = config->view_matrix,
-            .projection_matrix  = config->projection_matrix,
+            .tint               = config->tint,
+            .view               = config->view,
         }
         );
 }
@@ -1007,7 +662,7 @@ lna_primitive_t* lna_primitive_system_new_rect_xy(lna_primitive_system_t* primit
 #define LNA_PRIMITIVE_FILL_CIRCLE_VERTEX_COUNT  (LNA_PRIMITIVE_CIRCLE_VERTEX_COUNT + 1)
 #define LNA_PRIMITIVE_FILL_CIRCLE_INDEX_COUNT   (LNA_PRIMITIVE_FILL_CIRCLE_VERTEX_COUNT * 3)
 
-lna_primitive_t* lna_primitive_system_new_circle_xy(lna_primitive_system_t* primitive_system, const lna_primitive_circle_config_t* config)
+lna_handle_t lna_primitive_system_new_circle_xy(lna_primitive_system_t* primitive_system, const lna_primitive_circle_config_t* config)
 {
     lna_assert(config)
     lna_assert(config->center_position) 
@@ -1050,8 +705,8 @@ lna_primitive_t* lna_primitive_system_new_circle_xy(lna_primitive_system_t* prim
                 .vertex_count       = LNA_PRIMITIVE_CIRCLE_VERTEX_COUNT,
                 .index_count        = LNA_PRIMITIVE_CIRCLE_INDEX_COUNT,
                 .model_matrix       = config->model_matrix,
-                .view_matrix        = config->view_matrix,
-                .projection_matrix  = config->projection_matrix,
+                .tint               = config->tint,
+                .view               = config->view,
             }
             );
     }
@@ -1097,14 +752,14 @@ lna_primitive_t* lna_primitive_system_new_circle_xy(lna_primitive_system_t* prim
                 .vertex_count       = LNA_PRIMITIVE_FILL_CIRCLE_VERTEX_COUNT,
                 .index_count        = LNA_PRIMITIVE_FILL_CIRCLE_INDEX_COUNT,
                 .model_matrix       = config->model_matrix,
-                .view_matrix        = config->view_matrix,
-                .projection_matrix  = config->projection_matrix,
+                .tint               = config->tint,
+                .view               = config->view,
             }
             );
     }
 }
 
-lna_primitive_t* lna_primitive_system_new_arrow_xy(lna_primitive_system_t* primitive_system, const lna_primitive_arrow_config_t* config)
+lna_handle_t lna_primitive_system_new_arrow_xy(lna_primitive_system_t* primitive_system, const lna_primitive_arrow_config_t* config)
 {
     lna_assert(primitive_system)
     lna_assert(!primitive_system->fill_shapes)  // TODO: check if we can draw line in fill shapes mode. Will need some modification for the arrow's head if so.
@@ -1201,13 +856,13 @@ lna_primitive_t* lna_primitive_system_new_arrow_xy(lna_primitive_system_t* primi
             .vertex_count       = 5,
             .index_count        = 8,
             .model_matrix       = config->model_matrix,
-            .view_matrix        = config->view_matrix,
-            .projection_matrix  = config->projection_matrix,
+            .tint               = config->tint,
+            .view               = config->view,
         }
         );
 }
 
-lna_primitive_t* lna_primitive_system_new_cross_xy(lna_primitive_system_t* primitive_system, const lna_primitive_cross_config_t* config)
+lna_handle_t lna_primitive_system_new_cross_xy(lna_primitive_system_t* primitive_system, const lna_primitive_cross_config_t* config)
 {
     lna_assert(primitive_system)
     lna_assert(!primitive_system->fill_shapes) // TODO: check if we can draw line in fill shapes mode.
@@ -1265,8 +920,8 @@ lna_primitive_t* lna_primitive_system_new_cross_xy(lna_primitive_system_t* primi
             .vertex_count       = 4,
             .index_count        = 4,
             .model_matrix       = config->model_matrix,
-            .view_matrix        = config->view_matrix,
-            .projection_matrix  = config->projection_matrix,
+            .tint               = config->tint,
+            .view               = config->view,
         }
         );
 }
@@ -3,36 +3,25 @@
 
 #include <stdbool.h>
 #include "backends/vulkan/lna_renderer_vulkan.h"
+#include "core/lna_object_pool.h"
 
 typedef struct lna_primitive_s
 {
     VkBuffer                            vertex_buffer;
-    VkDeviceMemory                      vertex_buffer_memory;
+    lna_vulkan_memory_allocation_t      vertex_buffer_allocation;
     VkBuffer                            index_buffer;
-    VkDeviceMemory                      index_buffer_memory;
+    lna_vulkan_memory_allocation_t      index_buffer_allocation;
     uint32_t                            vertex_count;
     uint32_t                            index_count;
-    lna_vulkan_buffer_array_t           mvp_uniform_buffers;
-    lna_vulkan_device_memory_array_t    mvp_uniform_buffers_memory;
-    lna_vulkan_descriptor_set_array_t   descriptor_sets;
     const lna_mat4_t*                   model_matrix;
-    const lna_mat4_t*                   view_matrix;
-    const lna_mat4_t*                   projection_matrix;
+    const lna_vec4_t*                   tint;           //! NULL for white
+    const lna_renderer_view_t*          view;
 } lna_primitive_t;
 
-typedef struct lna_primitive_vec_t
-{
-    lna_primitive_t*                    elements;
-    uint32_t                            cur_element_count;
-    uint32_t                            max_element_count;
-} lna_primitive_vec_t;
-
 typedef struct lna_primitive_system_s
 {
     lna_renderer_t*                     renderer;
-    lna_primitive_vec_t                 primitives;
-    VkDescriptorSetLayout               descriptor_set_layout;
-    VkDescriptorPool                    descriptor_pool;
+    lna_object_pool_t                   primitives;     //! of lna_primitive_t
     VkPipelineLayout                    pipeline_layout;
     VkPipeline                          pipeline;
     bool                                fill_shapes;
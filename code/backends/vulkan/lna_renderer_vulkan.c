@@ -30,6 +30,40 @@ static const size_t LNA_VULKAN_RENDERER_DEFAULT_MEMORY_POOL_SIZES[LNA_VULKAN_REN
     256LL * 1024LL * 1024LL,
 };
 
+#ifdef LNA_MEMORY_TRACKING
+static const char* LNA_VULKAN_RENDERER_MEMORY_POOL_NAMES[LNA_VULKAN_RENDERER_MEMORY_POOL_COUNT] =
+{
+    "renderer frame",
+    "renderer persist",
+    "renderer swap",
+};
+
+static const char* LNA_VULKAN_RENDERER_FRAME_ARENA_NAMES[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT] =
+{
+    "frame arena 0",
+    "frame arena 1",
+    "frame arena 2",
+    "frame arena 3",
+};
+#endif
+
+static const size_t LNA_VULKAN_RENDERER_DEFAULT_UNIFORM_BUFFER_SIZE = 8LL * 1024LL * 1024LL;
+static const size_t LNA_VULKAN_RENDERER_DEFAULT_FRAME_ARENA_SIZE = 16LL * 1024LL * 1024LL;
+static const uint32_t LNA_VULKAN_RENDERER_DEFAULT_FRAME_IN_FLIGHT_COUNT = 2;
+static const size_t LNA_VULKAN_RENDERER_DEFAULT_DEVICE_MEMORY_BLOCK_SIZE = 64LL * 1024LL * 1024LL;
+static const uint32_t LNA_VULKAN_RENDERER_DEFAULT_MAX_DEVICE_MEMORY_BLOCK_COUNT = 256;
+static const uint32_t LNA_VULKAN_RENDERER_DEFAULT_MAX_DEVICE_MEMORY_ALLOCATION_COUNT = 65536;
+static const size_t LNA_VULKAN_RENDERER_DEFAULT_UPLOAD_BUFFER_SIZE = 32LL * 1024LL * 1024LL;
+static const uint32_t LNA_VULKAN_RENDERER_DEFAULT_MAX_UPLOAD_BATCH_RESOURCE_COUNT = 1024;
+//! a swap chain recreation retires 2 objects per image and 3 more, a deleted
+//! sprite or mesh 2 buffers and a set per frame in flight: the default holds
+//! the deletions of a few hundred objects during the frames in flight.
+static const uint32_t LNA_VULKAN_RENDERER_DEFAULT_MAX_DEFERRED_DELETION_COUNT = 1024;
+static const uint32_t LNA_VULKAN_RENDERER_DEFAULT_MAX_SECONDARY_COMMAND_BUFFER_COUNT = 256;
+static const uint32_t LNA_VULKAN_RENDERER_DEFAULT_MAX_VIEW_COUNT = 8;
+//! the average record time is logged at debug level every this many frames
+static const uint32_t LNA_VULKAN_RENDERER_RECORD_TIME_LOG_FRAME_COUNT = 600;
+
 //! ============================================================================
 //!                             LOCAL STRUCT
 //! ============================================================================
@@ -38,6 +72,7 @@ typedef struct lna_vulkan_queue_family_indices_s
 {
     uint32_t    graphics_family;
     uint32_t    present_family;
+    uint32_t    transfer_family;
 } lna_vulkan_queue_family_indices_t;
 
 typedef struct lna_vulkan_swap_chain_support_details_s
@@ -49,6 +84,17 @@ typedef struct lna_vulkan_swap_chain_support_details_s
     uint32_t                    present_mode_count;
 } lna_vulkan_swap_chain_support_details_t;
 
+typedef struct lna_vulkan_record_range_s
+{
+    lna_renderer_t*                 renderer;
+    lna_vulkan_record_function_t    function;
+    void*                           graphics_system;
+    uint32_t                        begin;
+    uint32_t                        end;
+    uint32_t                        slot;           //! index in the frame secondary command buffers
+    lna_vulkan_command_cache_t*     command_cache;  //! NULL when recorded for the current frame only
+} lna_vulkan_record_range_t;
+
 //! ============================================================================
 //!                         VULKAN DEBUG CALLBACKS
 //! ============================================================================
@@ -187,7 +233,8 @@ static lna_vulkan_queue_family_indices_t lna_vulkan_find_queue_families(
     lna_vulkan_queue_family_indices_t indices =
     {
         .graphics_family    = (uint32_t)-1,
-        .present_family     = (uint32_t)-1
+        .present_family     = (uint32_t)-1,
+        .transfer_family    = (uint32_t)-1,
     };
     uint32_t queue_family_count;
     vkGetPhysicalDeviceQueueFamilyProperties(
@@ -232,6 +279,22 @@ static lna_vulkan_queue_family_indices_t lna_vulkan_find_queue_families(
             break;
         }
     }
+
+    //! a queue family with transfer but without graphics capabilities is
+    //! usually backed by dedicated copy engines, uploads are done on the
+    //! graphics family when there is none.
+    indices.transfer_family = indices.graphics_family;
+    for (uint32_t i = 0; i < queue_family_count; ++i)
+    {
+        if (
+            (queue_families[i].queueFlags & VK_QUEUE_TRANSFER_BIT)
+            && !(queue_families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)
+            )
+        {
+            indices.transfer_family = i;
+            break;
+        }
+    }
     return indices;
 }
 
@@ -379,20 +442,81 @@ static VkSurfaceFormatKHR lna_vulkan_choose_swap_surface_format(
     return available_formats[0];
 }
 
-static VkPresentModeKHR lna_vulkan_choose_swap_present_mode(
-    const VkPresentModeKHR* available_present_modes,
-    uint32_t available_present_mode_count
+static const char* lna_vulkan_present_mode_name(
+    VkPresentModeKHR present_mode
     )
 {
-    lna_assert(available_present_modes)
+    switch (present_mode)
+    {
+        case VK_PRESENT_MODE_IMMEDIATE_KHR:     return "immediate";
+        case VK_PRESENT_MODE_MAILBOX_KHR:       return "mailbox";
+        case VK_PRESENT_MODE_FIFO_KHR:          return "fifo";
+        case VK_PRESENT_MODE_FIFO_RELAXED_KHR:  return "fifo relaxed";
+        default:                                return "unknown";
+    }
+}
 
+static bool lna_vulkan_is_present_mode_available(
+    const VkPresentModeKHR* available_present_modes,
+    uint32_t available_present_mode_count,
+    VkPresentModeKHR present_mode
+    )
+{
     for (uint32_t i = 0; i < available_present_mode_count; ++i)
     {
-        if (available_present_modes[i] == VK_PRESENT_MODE_MAILBOX_KHR)
+        if (available_present_modes[i] == present_mode)
         {
-            return available_present_modes[i];
+            return true;
         }
     }
+    return false;
+}
+
+//! fifo is the only present mode the surfaces must support, it is used
+//! when the requested one is not available.
+static VkPresentModeKHR lna_vulkan_choose_swap_present_mode(
+    const VkPresentModeKHR* available_present_modes,
+    uint32_t available_present_mode_count,
+    lna_renderer_present_mode_t requested_present_mode,
+    bool report
+    )
+{
+    lna_assert(available_present_modes)
+
+    VkPresentModeKHR present_mode;
+    switch (requested_present_mode)
+    {
+        case LNA_RENDERER_PRESENT_MODE_DEFAULT:
+            return lna_vulkan_is_present_mode_available(available_present_modes, available_present_mode_count, VK_PRESENT_MODE_MAILBOX_KHR) ? VK_PRESENT_MODE_MAILBOX_KHR : VK_PRESENT_MODE_FIFO_KHR;
+        case LNA_RENDERER_PRESENT_MODE_FIFO:
+            present_mode = VK_PRESENT_MODE_FIFO_KHR;
+            break;
+        case LNA_RENDERER_PRESENT_MODE_FIFO_RELAXED:
+            present_mode = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+            break;
+        case LNA_RENDERER_PRESENT_MODE_MAILBOX:
+            present_mode = VK_PRESENT_MODE_MAILBOX_KHR;
+            break;
+        case LNA_RENDERER_PRESENT_MODE_IMMEDIATE:
+            present_mode = VK_PRESENT_MODE_IMMEDIATE_KHR;
+            break;
+        default:
+            lna_assert(0)
+            return VK_PRESENT_MODE_FIFO_KHR;
+    }
+
+    if (lna_vulkan_is_present_mode_available(available_present_modes, available_present_mode_count, present_mode))
+    {
+        return present_mode;
+    }
+    if (report)
+    {
+        lna_log_warning(
+            "present mode %s is not supported by the surface, fall back to %s",
+            lna_vulkan_present_mode_name(present_mode),
+            lna_vulkan_present_mode_name(VK_PRESENT_MODE_FIFO_KHR)
+            );
+    }
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
@@ -663,12 +787,19 @@ static void lna_vulkan_renderer_create_logical_device(
         renderer->surface
         );
 
-    uint32_t unique_queue_families[] =
+    uint32_t unique_queue_families[3] =
     {
         indices.graphics_family,
-        indices.present_family
     };
-    uint32_t unique_queue_family_count = (indices.graphics_family == indices.present_family) ? 1 : 2;
+    uint32_t unique_queue_family_count = 1;
+    if (indices.present_family != indices.graphics_family)
+    {
+        unique_queue_families[unique_queue_family_count++] = indices.present_family;
+    }
+    if (indices.transfer_family != indices.graphics_family && indices.transfer_family != indices.present_family)
+    {
+        unique_queue_families[unique_queue_family_count++] = indices.transfer_family;
+    }
 
     VkDeviceQueueCreateInfo *queue_create_infos = lna_memory_pool_reserve(
         &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME],
@@ -725,12 +856,20 @@ static void lna_vulkan_renderer_create_logical_device(
         0,
         &renderer->present_queue
         );
+    renderer->transfer_family = indices.transfer_family;
+    vkGetDeviceQueue(
+        renderer->device,
+        indices.transfer_family,
+        0,
+        &renderer->transfer_queue
+        );
 }
 
 static void lna_vulkan_renderer_create_swap_chain(
     lna_renderer_t* renderer,
     uint32_t framebuffer_width,
-    uint32_t framebuffer_height
+    uint32_t framebuffer_height,
+    VkSwapchainKHR old_swap_chain
     )
 {
     lna_assert(renderer)
@@ -744,18 +883,43 @@ static void lna_vulkan_renderer_create_swap_chain(
         );
 
     VkSurfaceFormatKHR  surface_format  = lna_vulkan_choose_swap_surface_format(swap_chain_support.formats, swap_chain_support.format_count);
-    VkPresentModeKHR    present_mode    = lna_vulkan_choose_swap_present_mode(swap_chain_support.present_modes, swap_chain_support.present_mode_count);
+    VkPresentModeKHR    present_mode    = lna_vulkan_choose_swap_present_mode(swap_chain_support.present_modes, swap_chain_support.present_mode_count, renderer->requested_present_mode, old_swap_chain == VK_NULL_HANDLE);
     VkExtent2D          extent          = lna_vulkan_choose_swap_extent(&swap_chain_support.capabilities, framebuffer_width, framebuffer_height);
 
     //! simply sticking to this minimum means that we may sometimes have to wait on the driver to complete internal operations before we can acquire another image to render to.
-    //! Therefore it is recommended to request at least one more image than the minimum:
-    uint32_t image_count = swap_chain_support.capabilities.minImageCount + 1;
+    //! Therefore it is recommended by default to request at least one more image than the minimum:
+    uint32_t image_count = renderer->requested_image_count == 0 ? swap_chain_support.capabilities.minImageCount + 1 : renderer->requested_image_count;
+    if (image_count < swap_chain_support.capabilities.minImageCount)
+    {
+        image_count = swap_chain_support.capabilities.minImageCount;
+    }
     if (
         swap_chain_support.capabilities.maxImageCount > 0 && image_count > swap_chain_support.capabilities.maxImageCount)
     {
         //! do not exceed the maximum number of image:
         image_count = swap_chain_support.capabilities.maxImageCount;
     }
+    if (
+        old_swap_chain == VK_NULL_HANDLE
+        && renderer->requested_image_count != 0
+        && renderer->requested_image_count != image_count
+        )
+    {
+        lna_log_warning(
+            "swap chain image count %d is not supported by the surface, fall back to %d",
+            renderer->requested_image_count,
+            image_count
+            );
+    }
+    if (old_swap_chain == VK_NULL_HANDLE)
+    {
+        lna_log_message(
+            "swap chain: %d images, %s present mode, %d frames in flight",
+            image_count,
+            lna_vulkan_present_mode_name(present_mode),
+            renderer->frame_in_flight_count
+            );
+    }
 
     lna_vulkan_queue_family_indices_t indices = lna_vulkan_find_queue_families(
         &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME],
@@ -785,7 +949,7 @@ static void lna_vulkan_renderer_create_swap_chain(
         .compositeAlpha         = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR,
         .presentMode            = present_mode,
         .clipped                = VK_TRUE,
-        .oldSwapchain           = VK_NULL_HANDLE,
+        .oldSwapchain           = old_swap_chain,
     };
     lna_vulkan_check(
         vkCreateSwapchainKHR(
@@ -827,6 +991,11 @@ static void lna_vulkan_renderer_create_swap_chain(
         &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
         sizeof(VkFence) * renderer->swap_chain_images.count
         );
+    memset(
+        renderer->images_in_flight_fences.elements,
+        0,
+        sizeof(VkFence) * renderer->images_in_flight_fences.count
+        );
 }
 
 static void lna_vulkan_renderer_create_image_views(
@@ -984,8 +1153,7 @@ static void lna_vulkan_renderer_create_depth_resources(
     lna_assert(depth_format != VK_FORMAT_UNDEFINED)
 
     lna_vulkan_create_image(
-        renderer->device,
-        renderer->physical_device,
+        &renderer->memory_allocator,
         renderer->swap_chain_extent.width,
         renderer->swap_chain_extent.height,
         depth_format,
@@ -993,7 +1161,7 @@ static void lna_vulkan_renderer_create_depth_resources(
         VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         &renderer->depth_image,
-        &renderer->depth_image_memory
+        &renderer->depth_image_allocation
         );
 
     renderer->depth_image_view = lna_vulkan_create_image_view(
@@ -1058,12 +1226,13 @@ static void lna_vulkan_renderer_create_command_buffers(
     lna_assert(renderer->device)
     lna_assert(renderer->command_buffers.count == 0)
     lna_assert(renderer->command_buffers.elements == NULL)
-    lna_assert(renderer->swap_chain_images.count > 0)
-    
-    renderer->command_buffers.count     = renderer->swap_chain_images.count;
+
+    //! the command buffers are not tied to the swap chain images so the
+    //! ones still executing are not affected by a swap chain recreation.
+    renderer->command_buffers.count     = renderer->frame_in_flight_count;
     renderer->command_buffers.elements  = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
-        sizeof(VkCommandBuffer) * renderer->swap_chain_images.count
+        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_PERSISTENT],
+        sizeof(VkCommandBuffer) * renderer->command_buffers.count
         );
 
     const VkCommandBufferAllocateInfo command_buffer_allocate_info =
@@ -1083,6 +1252,51 @@ static void lna_vulkan_renderer_create_command_buffers(
         );
 }
 
+static void lna_vulkan_renderer_create_secondary_command_pools(
+    lna_renderer_t* renderer
+    )
+{
+    lna_assert(renderer)
+    lna_assert(renderer->device)
+    lna_assert(renderer->secondary_command_pool_count > 0)
+    lna_assert(renderer->secondary_command_buffers.max_element_count > 0)
+
+    //! the secondary command buffers are recorded again each frame
+    const VkCommandPoolCreateInfo command_pool_create_info =
+    {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .queueFamilyIndex   = renderer->graphics_family,
+        .flags              = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+    };
+
+    for (uint32_t i = 0; i < renderer->frame_in_flight_count; ++i)
+    {
+        renderer->secondary_command_pools[i] = lna_memory_pool_reserve(
+            &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_PERSISTENT],
+            sizeof(lna_vulkan_secondary_command_pool_t) * renderer->secondary_command_pool_count
+            );
+        for (uint32_t j = 0; j < renderer->secondary_command_pool_count; ++j)
+        {
+            lna_vulkan_secondary_command_pool_t* pool = &renderer->secondary_command_pools[i][j];
+            lna_vulkan_check(
+                vkCreateCommandPool(
+                    renderer->device,
+                    &command_pool_create_info,
+                    NULL,
+                    &pool->command_pool
+                    )
+                );
+            //! a single thread may record all the secondary command buffers of the frame
+            pool->command_buffers                   = lna_memory_pool_reserve(
+                &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_PERSISTENT],
+                sizeof(VkCommandBuffer) * renderer->secondary_command_buffers.max_element_count
+                );
+            pool->cur_command_buffer_count          = 0;
+            pool->allocated_command_buffer_count    = 0;
+        }
+    }
+}
+
 static void lna_vulkan_renderer_create_sync_objects(
     lna_renderer_t* renderer
     )
@@ -1101,7 +1315,7 @@ static void lna_vulkan_renderer_create_sync_objects(
         .flags  = VK_FENCE_CREATE_SIGNALED_BIT,
     };
 
-    for (uint32_t i = 0; i < LNA_VULKAN_MAX_FRAMES_IN_FLIGHT; ++i)
+    for (uint32_t i = 0; i < renderer->frame_in_flight_count; ++i)
     {
         lna_vulkan_check(
             vkCreateSemaphore(
@@ -1130,200 +1344,850 @@ static void lna_vulkan_renderer_create_sync_objects(
     }
 }
 
-static void lna_vulkan_renderer_cleanup_swap_chain(
+//! one descriptor set per frame in flight pointing on the frame uniform
+//! buffer, the views are selected by their dynamic offset.
+static void lna_vulkan_renderer_create_view_descriptor_sets(
     lna_renderer_t* renderer
     )
 {
     lna_assert(renderer)
     lna_assert(renderer->device)
+    lna_assert(renderer->view_descriptor_set_layout == VK_NULL_HANDLE)
+    lna_assert(renderer->view_descriptor_pool == VK_NULL_HANDLE)
 
-    vkDestroyImageView(
-        renderer->device,
-        renderer->depth_image_view,
-        NULL
-        );
-    vkDestroyImage(
-        renderer->device,
-        renderer->depth_image,
-        NULL
-        );
-    vkFreeMemory(
-        renderer->device,
-        renderer->depth_image_memory,
-        NULL
+    const VkDescriptorSetLayoutBinding bindings[] =
+    {
+        {
+            .binding            = 0,
+            .descriptorCount    = 1,
+            .descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+            .stageFlags         = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            .pImmutableSamplers = NULL,
+        },
+    };
+    const VkDescriptorSetLayoutCreateInfo layout_create_info =
+    {
+        .sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .bindingCount   = (uint32_t)(sizeof(bindings) / sizeof(bindings[0])),
+        .pBindings      = bindings,
+    };
+    lna_vulkan_check(
+        vkCreateDescriptorSetLayout(
+            renderer->device,
+            &layout_create_info,
+            NULL,
+            &renderer->view_descriptor_set_layout
+            )
         );
 
-    for (size_t i = 0; i < renderer->swap_chain_framebuffers.count; ++i)
+    const VkDescriptorPoolSize pool_sizes[] =
     {
-        vkDestroyFramebuffer(
+        {
+            .type               = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+            .descriptorCount    = renderer->frame_in_flight_count,
+        },
+    };
+    const VkDescriptorPoolCreateInfo pool_create_info =
+    {
+        .sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .poolSizeCount  = (uint32_t)(sizeof(pool_sizes) / sizeof(pool_sizes[0])),
+        .pPoolSizes     = pool_sizes,
+        .maxSets        = renderer->frame_in_flight_count,
+    };
+    lna_vulkan_check(
+        vkCreateDescriptorPool(
             renderer->device,
-            renderer->swap_chain_framebuffers.elements[i],
-            NULL
-            );
-    }
-
-    vkFreeCommandBuffers(
-        renderer->device,
-        renderer->command_pool,
-        renderer->command_buffers.count,
-        renderer->command_buffers.elements
+            &pool_create_info,
+            NULL,
+            &renderer->view_descriptor_pool
+            )
         );
 
-    for (uint32_t i = 0; i < renderer->listeners.cur_element_count; ++i)
+    VkDescriptorSetLayout layouts[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    for (uint32_t i = 0; i < renderer->frame_in_flight_count; ++i)
     {
-        lna_renderer_listener_t* listener = &renderer->listeners.elements[i];
-        listener->on_cleanup(listener->handle);
+        layouts[i] = renderer->view_descriptor_set_layout;
     }
-
-    vkDestroyRenderPass(
-        renderer->device,
-        renderer->render_pass,
-        NULL
+    const VkDescriptorSetAllocateInfo allocate_info =
+    {
+        .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool     = renderer->view_descriptor_pool,
+        .descriptorSetCount = renderer->frame_in_flight_count,
+        .pSetLayouts        = layouts,
+    };
+    lna_vulkan_check(
+        vkAllocateDescriptorSets(
+            renderer->device,
+            &allocate_info,
+            renderer->view_descriptor_sets
+            )
         );
 
-    for (size_t i = 0; i < renderer->swap_chain_image_views.count; ++i)
+    for (uint32_t i = 0; i < renderer->frame_in_flight_count; ++i)
     {
-        vkDestroyImageView(
+        const VkDescriptorBufferInfo buffer_info =
+        {
+            .buffer = renderer->uniform_ring_buffer.buffers[i],
+            .offset = 0,
+            .range  = sizeof(lna_vulkan_view_uniform_t),
+        };
+        const VkWriteDescriptorSet write_descriptor =
+        {
+            .sType              = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .dstSet             = renderer->view_descriptor_sets[i],
+            .dstBinding         = 0,
+            .dstArrayElement    = 0,
+            .descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+            .descriptorCount    = 1,
+            .pBufferInfo        = &buffer_info,
+            .pImageInfo         = NULL,
+            .pTexelBufferView   = NULL,
+        };
+        vkUpdateDescriptorSets(
             renderer->device,
-            renderer->swap_chain_image_views.elements[i],
+            1,
+            &write_descriptor,
+            0,
             NULL
             );
     }
-
-    vkDestroySwapchainKHR(
-        renderer->device,
-        renderer->swap_chain,
-        NULL
-        );
-
-    lna_memory_pool_empty(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN]
-        );
-
-    renderer->swap_chain_images.count           = 0;
-    renderer->swap_chain_images.elements        = NULL;
-    renderer->swap_chain_image_views.count      = 0;
-    renderer->swap_chain_image_views.elements   = NULL;
-    renderer->swap_chain_framebuffers.count     = 0;
-    renderer->swap_chain_framebuffers.elements  = NULL;
-    renderer->command_buffers.count             = 0;
-    renderer->command_buffers.elements          = NULL;
-    renderer->images_in_flight_fences.count     = 0;
-    renderer->images_in_flight_fences.elements  = NULL;
 }
 
-static void lna_vulkan_renderer_recreate_swap_chain(
-    lna_renderer_t* renderer,
-    uint32_t framebuffer_width,
-    uint32_t framebuffer_height
-    )
+//! the record time of a frame goes from its first record call to the end of
+//! its last record job, in lna_renderer_end_draw_frame.
+static void lna_vulkan_renderer_start_record_time(lna_renderer_t* renderer)
 {
     lna_assert(renderer)
-    lna_assert(renderer->device)
-
-    lna_vulkan_check(
-        vkDeviceWaitIdle(
-            renderer->device
-            )
-        );
-
-    lna_vulkan_renderer_cleanup_swap_chain(renderer);
-    lna_vulkan_renderer_create_swap_chain(renderer, framebuffer_width, framebuffer_height);
-    lna_vulkan_renderer_create_image_views(renderer);
-    lna_vulkan_renderer_create_render_pass(renderer);
-    lna_vulkan_renderer_create_depth_resources(renderer);
-    lna_vulkan_renderer_create_framebuffers(renderer);
-    lna_vulkan_renderer_create_command_buffers(renderer);
 
-    for (uint32_t i = 0; i < renderer->listeners.cur_element_count; ++i)
+    if (renderer->record_start_counter == 0)
     {
-        lna_renderer_listener_t* listener = &renderer->listeners.elements[i];
-        listener->on_recreate(listener->handle);
+        renderer->record_start_counter = SDL_GetPerformanceCounter();
     }
 }
 
-//! ============================================================================
-//!                         RENDERER PUBLIC FUNCTIONS
-//! ============================================================================
-
-bool lna_renderer_init(lna_renderer_t* renderer, const lna_renderer_config_t* config)
+static void lna_vulkan_renderer_end_record_time(lna_renderer_t* renderer)
 {
     lna_assert(renderer)
-    lna_assert(renderer->instance == NULL)
-    lna_assert(renderer->debug_messenger == NULL)
-    lna_assert(renderer->physical_device == NULL)
-    lna_assert(renderer->device == NULL)
-    lna_assert(renderer->graphics_family == 0)
-    lna_assert(renderer->graphics_queue == NULL)
-    lna_assert(renderer->surface == NULL)
-    lna_assert(renderer->present_queue == NULL)
-    lna_assert(renderer->swap_chain == NULL)
-    lna_assert(renderer->render_pass == NULL)
-    lna_assert(renderer->command_pool == NULL)
-    lna_assert(renderer->curr_frame == 0)
-    lna_assert(renderer->images_in_flight_fences.count == 0)
-    lna_assert(renderer->images_in_flight_fences.elements == NULL)
-    lna_assert(renderer->swap_chain_images.count == 0)
-    lna_assert(renderer->swap_chain_images.elements == NULL)
-    lna_assert(renderer->swap_chain_image_views.count == 0)
-    lna_assert(renderer->swap_chain_image_views.elements == NULL)
-    lna_assert(renderer->swap_chain_framebuffers.count == 0)
-    lna_assert(renderer->swap_chain_framebuffers.elements == NULL)
-    lna_assert(renderer->command_buffers.count == 0)
-    lna_assert(renderer->command_buffers.elements == NULL)
-    lna_assert(renderer->listeners.cur_element_count == 0)
-    lna_assert(renderer->listeners.max_element_count == 0)
-    lna_assert(renderer->listeners.elements == NULL)
-
-    lna_assert(config)
-    lna_assert(config->window)
-
-    lna_memory_pool_init_with_heap(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME],
-        config->allocator,
-        config->frame_mem_pool_size == 0 ? LNA_VULKAN_RENDERER_DEFAULT_MEMORY_POOL_SIZES[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME] : config->frame_mem_pool_size
-        );
-    lna_memory_pool_init_with_heap(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_PERSISTENT],
-        config->allocator,
-        config->persistent_mem_pool_size == 0 ? LNA_VULKAN_RENDERER_DEFAULT_MEMORY_POOL_SIZES[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME] : config->persistent_mem_pool_size
-        );
-    lna_memory_pool_init_with_heap(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
-        config->allocator,
-        config->swap_chain_mem_pool_size == 0 ? LNA_VULKAN_RENDERER_DEFAULT_MEMORY_POOL_SIZES[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME] : config->swap_chain_mem_pool_size
-        );
 
-    if (config->max_listener_count > 0)
+    if (renderer->record_start_counter == 0)
     {
-        renderer->listeners.max_element_count   = config->max_listener_count;
-        renderer->listeners.elements            = lna_memory_pool_reserve(
-            &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_PERSISTENT],
-            sizeof(lna_renderer_listener_t) * renderer->listeners.max_element_count
-            );
+        return;
     }
+    renderer->record_time_in_ms     += (double)(SDL_GetPerformanceCounter() - renderer->record_start_counter) * 1000.0 / (double)SDL_GetPerformanceFrequency();
+    renderer->record_start_counter  = 0;
+    ++renderer->record_frame_count;
 
-    renderer->curr_frame = 0;
-    renderer->graphics_family = (uint32_t)-1;
-    if (!lna_vulkan_renderer_create_instance(renderer, config->window, config->enable_api_diagnostic))
+    if (renderer->record_frame_count == LNA_VULKAN_RENDERER_RECORD_TIME_LOG_FRAME_COUNT)
     {
-        return false;
+        lna_log_debug(
+            "record time: %.3f ms per frame, %u secondary command buffers, %u threads",
+            renderer->record_time_in_ms / renderer->record_frame_count,
+            renderer->secondary_command_buffers.cur_element_count,
+            renderer->job_system ? renderer->job_system->worker_count : 1
+            );
+        renderer->record_time_in_ms     = 0.0;
+        renderer->record_frame_count    = 0;
     }
-    if (config->enable_api_diagnostic)
-    {
+}
+
+//! the secondary command buffers recorded by a thread come from its own pool.
+static VkCommandBuffer lna_vulkan_renderer_new_secondary_command_buffer(lna_renderer_t* renderer)
+{
+    lna_assert(renderer)
+
+    const uint32_t pool_index = renderer->job_system ? lna_job_system_worker_index(renderer->job_system) : 0;
+    lna_assert(pool_index < renderer->secondary_command_pool_count)
+
+    lna_vulkan_secondary_command_pool_t* pool = &renderer->secondary_command_pools[renderer->curr_frame][pool_index];
+    lna_assert(pool->cur_command_buffer_count < renderer->secondary_command_buffers.max_element_count)
+    if (pool->cur_command_buffer_count == pool->allocated_command_buffer_count)
+    {
+        const VkCommandBufferAllocateInfo command_buffer_allocate_info =
+        {
+            .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool        = pool->command_pool,
+            .level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+            .commandBufferCount = 1,
+        };
+        lna_vulkan_check(
+            vkAllocateCommandBuffers(
+                renderer->device,
+                &command_buffer_allocate_info,
+                &pool->command_buffers[pool->allocated_command_buffer_count]
+                )
+            );
+        ++pool->allocated_command_buffer_count;
+    }
+    return pool->command_buffers[pool->cur_command_buffer_count++];
+}
+
+static void lna_vulkan_renderer_record_range(void* data)
+{
+    lna_assert(data)
+
+    const lna_vulkan_record_range_t*    range       = data;
+    lna_renderer_t*                     renderer    = range->renderer;
+    VkCommandBuffer                     command_buffer;
+    VkFramebuffer                       framebuffer;
+    VkCommandBufferUsageFlags           usage_flags;
+    if (range->command_cache)
+    {
+        //! the command buffer is reused with the next swap chain images
+        lna_vulkan_check(
+            vkResetCommandPool(
+                renderer->device,
+                range->command_cache->command_pools[renderer->curr_frame],
+                0
+                )
+            );
+        command_buffer  = range->command_cache->command_buffers[renderer->curr_frame];
+        framebuffer     = VK_NULL_HANDLE;
+        usage_flags     = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    }
+    else
+    {
+        command_buffer  = lna_vulkan_renderer_new_secondary_command_buffer(renderer);
+        framebuffer     = renderer->swap_chain_framebuffers.elements[renderer->image_index];
+        usage_flags     = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    }
+
+    const VkCommandBufferInheritanceInfo inheritance_info =
+    {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .renderPass         = renderer->render_pass,
+        .subpass            = 0,
+        .framebuffer        = framebuffer,
+    };
+
+    const VkCommandBufferBeginInfo command_buffer_begin_info =
+    {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags              = usage_flags,
+        .pInheritanceInfo   = &inheritance_info,
+    };
+
+    const VkViewport viewport =
+    {
+        .width      = (float)renderer->swap_chain_extent.width,
+        .height     = (float)renderer->swap_chain_extent.height,
+        .minDepth   = 0.0f,
+        .maxDepth   = 1.0f,
+    };
+
+    const VkRect2D scissor_rect =
+    {
+        .offset.x       = 0,
+        .offset.y       = 0,
+        .extent.width   = renderer->swap_chain_extent.width,
+        .extent.height  = renderer->swap_chain_extent.height,
+    };
+
+    lna_vulkan_check(
+        vkBeginCommandBuffer(
+            command_buffer,
+            &command_buffer_begin_info
+            )
+        );
+    //! the dynamic states are not inherited from the primary command buffer
+    vkCmdSetViewport(
+        command_buffer,
+        0,
+        1,
+        &viewport
+        );
+    vkCmdSetScissor(
+        command_buffer,
+        0,
+        1,
+        &scissor_rect
+        );
+    range->function(
+        range->graphics_system,
+        command_buffer,
+        range->begin,
+        range->end
+        );
+    lna_vulkan_check(
+        vkEndCommandBuffer(
+            command_buffer
+            )
+        );
+
+    //! each range has its own slot, the command buffers are read once all the record jobs are finished
+    renderer->secondary_command_buffers.elements[range->slot] = command_buffer;
+}
+
+void lna_vulkan_renderer_push_deletion(
+    lna_renderer_t* renderer,
+    const lna_vulkan_deletion_t* deletion
+    )
+{
+    lna_assert(renderer)
+    lna_assert(renderer->deletion_queue.elements)
+    lna_assert(renderer->deletion_queue.cur_element_count < renderer->deletion_queue.max_element_count)
+    lna_assert(deletion)
+
+    lna_vulkan_deletion_t* element = &renderer->deletion_queue.elements[renderer->deletion_queue.cur_element_count++];
+    *element        = *deletion;
+    element->frame  = renderer->frame_counter;
+}
+
+void lna_vulkan_renderer_push_buffer_deletion(
+    lna_renderer_t* renderer,
+    VkBuffer buffer,
+    const lna_vulkan_memory_allocation_t* allocation
+    )
+{
+    lna_assert(renderer)
+    lna_assert(buffer)
+    lna_assert(allocation)
+
+    const lna_vulkan_deletion_t buffer_deletion =
+    {
+        .type               = LNA_VULKAN_DELETION_TYPE_BUFFER,
+        .handle.buffer      = buffer,
+        .allocation         = *allocation,
+    };
+    lna_vulkan_renderer_push_deletion(renderer, &buffer_deletion);
+}
+
+void lna_vulkan_renderer_push_descriptor_sets_deletion(
+    lna_renderer_t* renderer,
+    VkDescriptorPool descriptor_pool,
+    const VkDescriptorSet* descriptor_sets,
+    uint32_t descriptor_set_count
+    )
+{
+    lna_assert(renderer)
+    lna_assert(descriptor_pool)
+    lna_assert(descriptor_sets)
+
+    for (uint32_t i = 0; i < descriptor_set_count; ++i)
+    {
+        const lna_vulkan_deletion_t descriptor_set_deletion =
+        {
+            .type                   = LNA_VULKAN_DELETION_TYPE_DESCRIPTOR_SET,
+            .handle.descriptor_set  = descriptor_sets[i],
+            .descriptor_pool        = descriptor_pool,
+        };
+        lna_vulkan_renderer_push_deletion(renderer, &descriptor_set_deletion);
+    }
+}
+
+//! destroy the retired resources the gpu cannot use anymore. When called at
+//! the beginning of a frame, after its fence has been waited, all the frames
+//! submitted frame_in_flight_count frames ago or earlier have
+//! completed. device_idle destroys everything.
+static void lna_vulkan_renderer_flush_deletion_queue(
+    lna_renderer_t* renderer,
+    bool device_idle
+    )
+{
+    lna_assert(renderer)
+    lna_assert(renderer->device)
+
+    lna_vulkan_deletion_queue_t* queue = &renderer->deletion_queue;
+    uint32_t deleted_count = 0;
+
+    while (deleted_count < queue->cur_element_count)
+    {
+        lna_vulkan_deletion_t* deletion = &queue->elements[deleted_count];
+        if (!device_idle && deletion->frame + renderer->frame_in_flight_count > renderer->frame_counter)
+        {
+            //! the elements are pushed in frame order, the next ones are more recent
+            break;
+        }
+
+        switch (deletion->type)
+        {
+            case LNA_VULKAN_DELETION_TYPE_SWAP_CHAIN:
+                vkDestroySwapchainKHR(
+                    renderer->device,
+                    deletion->handle.swap_chain,
+                    NULL
+                    );
+                break;
+            case LNA_VULKAN_DELETION_TYPE_FRAMEBUFFER:
+                vkDestroyFramebuffer(
+                    renderer->device,
+                    deletion->handle.framebuffer,
+                    NULL
+                    );
+                break;
+            case LNA_VULKAN_DELETION_TYPE_IMAGE_VIEW:
+                vkDestroyImageView(
+                    renderer->device,
+                    deletion->handle.image_view,
+                    NULL
+                    );
+                break;
+            case LNA_VULKAN_DELETION_TYPE_IMAGE:
+                vkDestroyImage(
+                    renderer->device,
+                    deletion->handle.image,
+                    NULL
+                    );
+                lna_vulkan_memory_allocator_free(
+                    &renderer->memory_allocator,
+                    &deletion->allocation
+                    );
+                break;
+            case LNA_VULKAN_DELETION_TYPE_SAMPLER:
+                vkDestroySampler(
+                    renderer->device,
+                    deletion->handle.sampler,
+                    NULL
+                    );
+                break;
+            case LNA_VULKAN_DELETION_TYPE_BUFFER:
+                vkDestroyBuffer(
+                    renderer->device,
+                    deletion->handle.buffer,
+                    NULL
+                    );
+                lna_vulkan_memory_allocator_free(
+                    &renderer->memory_allocator,
+                    &deletion->allocation
+                    );
+                break;
+            case LNA_VULKAN_DELETION_TYPE_DESCRIPTOR_SET:
+                lna_vulkan_check(
+                    vkFreeDescriptorSets(
+                        renderer->device,
+                        deletion->descriptor_pool,
+                        1,
+                        &deletion->handle.descriptor_set
+                        )
+                    );
+                break;
+            default:
+                lna_assert(0)
+                break;
+        }
+        ++deleted_count;
+    }
+
+    if (deleted_count > 0)
+    {
+        queue->cur_element_count -= deleted_count;
+        memmove(
+            queue->elements,
+            queue->elements + deleted_count,
+            sizeof(lna_vulkan_deletion_t) * queue->cur_element_count
+            );
+    }
+}
+
+static void lna_vulkan_renderer_reset_swap_chain_arrays(
+    lna_renderer_t* renderer
+    )
+{
+    lna_assert(renderer)
+
+    lna_memory_pool_empty(
+        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN]
+        );
+
+    renderer->swap_chain_images.count           = 0;
+    renderer->swap_chain_images.elements        = NULL;
+    renderer->swap_chain_image_views.count      = 0;
+    renderer->swap_chain_image_views.elements   = NULL;
+    renderer->swap_chain_framebuffers.count     = 0;
+    renderer->swap_chain_framebuffers.elements  = NULL;
+    renderer->images_in_flight_fences.count     = 0;
+    renderer->images_in_flight_fences.elements  = NULL;
+}
+
+//! push the swap chain dependent resources in the deletion queue instead of
+//! destroying them, the frames in flight may still render into them. The
+//! swap chain itself is kept to be given as oldSwapchain to its successor.
+static VkSwapchainKHR lna_vulkan_renderer_retire_swap_chain(
+    lna_renderer_t* renderer
+    )
+{
+    lna_assert(renderer)
+    lna_assert(renderer->swap_chain)
+
+    const lna_vulkan_deletion_t depth_image_view_deletion =
+    {
+        .type               = LNA_VULKAN_DELETION_TYPE_IMAGE_VIEW,
+        .handle.image_view  = renderer->depth_image_view,
+    };
+    const lna_vulkan_deletion_t depth_image_deletion =
+    {
+        .type               = LNA_VULKAN_DELETION_TYPE_IMAGE,
+        .handle.image       = renderer->depth_image,
+        .allocation         = renderer->depth_image_allocation,
+    };
+    lna_vulkan_renderer_push_deletion(renderer, &depth_image_view_deletion);
+    lna_vulkan_renderer_push_deletion(renderer, &depth_image_deletion);
+
+    for (uint32_t i = 0; i < renderer->swap_chain_framebuffers.count; ++i)
+    {
+        const lna_vulkan_deletion_t framebuffer_deletion =
+        {
+            .type               = LNA_VULKAN_DELETION_TYPE_FRAMEBUFFER,
+            .handle.framebuffer = renderer->swap_chain_framebuffers.elements[i],
+        };
+        lna_vulkan_renderer_push_deletion(renderer, &framebuffer_deletion);
+    }
+    for (uint32_t i = 0; i < renderer->swap_chain_image_views.count; ++i)
+    {
+        const lna_vulkan_deletion_t image_view_deletion =
+        {
+            .type               = LNA_VULKAN_DELETION_TYPE_IMAGE_VIEW,
+            .handle.image_view  = renderer->swap_chain_image_views.elements[i],
+        };
+        lna_vulkan_renderer_push_deletion(renderer, &image_view_deletion);
+    }
+
+    VkSwapchainKHR old_swap_chain = renderer->swap_chain;
+
+    renderer->depth_image_view  = VK_NULL_HANDLE;
+    renderer->depth_image       = VK_NULL_HANDLE;
+    renderer->swap_chain        = VK_NULL_HANDLE;
+    memset(
+        &renderer->depth_image_allocation,
+        0,
+        sizeof(renderer->depth_image_allocation)
+        );
+    lna_vulkan_renderer_reset_swap_chain_arrays(renderer);
+
+    return old_swap_chain;
+}
+
+static void lna_vulkan_renderer_cleanup_swap_chain(
+    lna_renderer_t* renderer
+    )
+{
+    lna_assert(renderer)
+    lna_assert(renderer->device)
+
+    vkDestroyImageView(
+        renderer->device,
+        renderer->depth_image_view,
+        NULL
+        );
+    vkDestroyImage(
+        renderer->device,
+        renderer->depth_image,
+        NULL
+        );
+    lna_vulkan_memory_allocator_free(
+        &renderer->memory_allocator,
+        &renderer->depth_image_allocation
+        );
+
+    for (size_t i = 0; i < renderer->swap_chain_framebuffers.count; ++i)
+    {
+        vkDestroyFramebuffer(
+            renderer->device,
+            renderer->swap_chain_framebuffers.elements[i],
+            NULL
+            );
+    }
+
+    for (size_t i = 0; i < renderer->swap_chain_image_views.count; ++i)
+    {
+        vkDestroyImageView(
+            renderer->device,
+            renderer->swap_chain_image_views.elements[i],
+            NULL
+            );
+    }
+
+    vkDestroySwapchainKHR(
+        renderer->device,
+        renderer->swap_chain,
+        NULL
+        );
+    renderer->swap_chain = VK_NULL_HANDLE;
+
+    lna_vulkan_renderer_reset_swap_chain_arrays(renderer);
+}
+
+//! the graphics systems pipelines are created with the render pass, they
+//! are destroyed by the listeners before it.
+static void lna_vulkan_renderer_cleanup_render_pass(
+    lna_renderer_t* renderer
+    )
+{
+    lna_assert(renderer)
+    lna_assert(renderer->device)
+
+    for (uint32_t i = 0; i < renderer->listeners.cur_element_count; ++i)
+    {
+        lna_renderer_listener_t* listener = &renderer->listeners.elements[i];
+        listener->on_cleanup(listener->handle);
+    }
+
+    vkDestroyRenderPass(
+        renderer->device,
+        renderer->render_pass,
+        NULL
+        );
+    renderer->render_pass = VK_NULL_HANDLE;
+}
+
+//! only the swap chain dependent resources (images, views, depth buffer and
+//! framebuffers) are recreated. The viewport and the scissor are dynamic
+//! states set at the beginning of each frame so the pipelines, and all the
+//! per object resources, survive a resize. The old swap chain is handed to
+//! its successor and retired with its resources in the deletion queue, so
+//! the frames in flight complete and the presentation goes on without
+//! waiting for the device to be idle. The render pass and the pipelines are
+//! only recreated, after a device wait, if the swap chain image format has
+//! changed (when the window moves to another monitor for example).
+static void lna_vulkan_renderer_recreate_swap_chain(
+    lna_renderer_t* renderer,
+    uint32_t framebuffer_width,
+    uint32_t framebuffer_height
+    )
+{
+    lna_assert(renderer)
+    lna_assert(renderer->device)
+
+    const uint64_t start_counter    = SDL_GetPerformanceCounter();
+    const VkFormat old_image_format = renderer->swap_chain_image_format;
+
+    VkSwapchainKHR old_swap_chain = lna_vulkan_renderer_retire_swap_chain(renderer);
+    lna_vulkan_renderer_create_swap_chain(renderer, framebuffer_width, framebuffer_height, old_swap_chain);
+
+    const lna_vulkan_deletion_t swap_chain_deletion =
+    {
+        .type               = LNA_VULKAN_DELETION_TYPE_SWAP_CHAIN,
+        .handle.swap_chain  = old_swap_chain,
+    };
+    lna_vulkan_renderer_push_deletion(renderer, &swap_chain_deletion);
+
+    lna_vulkan_renderer_create_image_views(renderer);
+
+    const bool render_pass_changed = renderer->swap_chain_image_format != old_image_format;
+    if (render_pass_changed)
+    {
+        lna_log_message("swap chain image format changed, recreate render pass and pipelines");
+        lna_vulkan_check(
+            vkDeviceWaitIdle(
+                renderer->device
+                )
+            );
+        lna_vulkan_renderer_flush_deletion_queue(renderer, true);
+        lna_vulkan_renderer_cleanup_render_pass(renderer);
+        lna_vulkan_renderer_create_render_pass(renderer);
+    }
+
+    lna_vulkan_renderer_create_depth_resources(renderer);
+    lna_vulkan_renderer_create_framebuffers(renderer);
+
+    if (render_pass_changed)
+    {
+        for (uint32_t i = 0; i < renderer->listeners.cur_element_count; ++i)
+        {
+            lna_renderer_listener_t* listener = &renderer->listeners.elements[i];
+            listener->on_recreate(listener->handle);
+        }
+    }
+
+    //! the cached command buffers use the previous extent, render pass and pipelines
+    ++renderer->swap_chain_generation;
+
+    //! the resize latency on the cpu, the gpu work of the retired swap chain is not waited for
+    lna_log_debug(
+        "swap chain recreated: %ux%u in %.3f ms%s",
+        renderer->swap_chain_extent.width,
+        renderer->swap_chain_extent.height,
+        (double)(SDL_GetPerformanceCounter() - start_counter) * 1000.0 / (double)SDL_GetPerformanceFrequency(),
+        render_pass_changed ? ", render pass and pipelines recreated" : ""
+        );
+}
+
+//! ============================================================================
+//!                         RENDERER PUBLIC FUNCTIONS
+//! ============================================================================
+
+bool lna_renderer_init(lna_renderer_t* renderer, const lna_renderer_config_t* config)
+{
+    lna_assert(renderer)
+    lna_assert(renderer->instance == NULL)
+    lna_assert(renderer->debug_messenger == NULL)
+    lna_assert(renderer->physical_device == NULL)
+    lna_assert(renderer->device == NULL)
+    lna_assert(renderer->graphics_family == 0)
+    lna_assert(renderer->graphics_queue == NULL)
+    lna_assert(renderer->surface == NULL)
+    lna_assert(renderer->present_queue == NULL)
+    lna_assert(renderer->swap_chain == NULL)
+    lna_assert(renderer->render_pass == NULL)
+    lna_assert(renderer->command_pool == NULL)
+    lna_assert(renderer->curr_frame == 0)
+    lna_assert(renderer->images_in_flight_fences.count == 0)
+    lna_assert(renderer->images_in_flight_fences.elements == NULL)
+    lna_assert(renderer->swap_chain_images.count == 0)
+    lna_assert(renderer->swap_chain_images.elements == NULL)
+    lna_assert(renderer->swap_chain_image_views.count == 0)
+    lna_assert(renderer->swap_chain_image_views.elements == NULL)
+    lna_assert(renderer->swap_chain_framebuffers.count == 0)
+    lna_assert(renderer->swap_chain_framebuffers.elements == NULL)
+    lna_assert(renderer->command_buffers.count == 0)
+    lna_assert(renderer->command_buffers.elements == NULL)
+    lna_assert(renderer->listeners.cur_element_count == 0)
+    lna_assert(renderer->listeners.max_element_count == 0)
+    lna_assert(renderer->listeners.elements == NULL)
+    lna_assert(renderer->deletion_queue.cur_element_count == 0)
+    lna_assert(renderer->deletion_queue.max_element_count == 0)
+    lna_assert(renderer->deletion_queue.elements == NULL)
+    lna_assert(renderer->secondary_command_buffers.cur_element_count == 0)
+    lna_assert(renderer->secondary_command_buffers.max_element_count == 0)
+    lna_assert(renderer->secondary_command_buffers.elements == NULL)
+    lna_assert(renderer->views.cur_element_count == 0)
+    lna_assert(renderer->views.max_element_count == 0)
+    lna_assert(renderer->views.elements == NULL)
+
+    lna_assert(config)
+    lna_assert(config->window)
+    lna_assert(config->frame_in_flight_count <= LNA_VULKAN_MAX_FRAMES_IN_FLIGHT)
+
+    renderer->frame_in_flight_count     = config->frame_in_flight_count == 0 ? LNA_VULKAN_RENDERER_DEFAULT_FRAME_IN_FLIGHT_COUNT : config->frame_in_flight_count;
+    renderer->requested_image_count     = config->swap_chain_image_count;
+    renderer->requested_present_mode    = config->present_mode;
+
+    lna_memory_pool_init_with_heap(
+        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME],
+        config->allocator,
+        config->frame_mem_pool_size == 0 ? LNA_VULKAN_RENDERER_DEFAULT_MEMORY_POOL_SIZES[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME] : config->frame_mem_pool_size
+        );
+    lna_memory_pool_init_with_heap(
+        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_PERSISTENT],
+        config->allocator,
+        config->persistent_mem_pool_size == 0 ? LNA_VULKAN_RENDERER_DEFAULT_MEMORY_POOL_SIZES[LNA_VULKAN_RENDERER_MEMORY_POOL_PERSISTENT] : config->persistent_mem_pool_size
+        );
+    lna_memory_pool_init_with_heap(
+        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
+        config->allocator,
+        config->swap_chain_mem_pool_size == 0 ? LNA_VULKAN_RENDERER_DEFAULT_MEMORY_POOL_SIZES[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN] : config->swap_chain_mem_pool_size
+        );
+    for (uint32_t i = 0; i < renderer->frame_in_flight_count; ++i)
+    {
+        lna_memory_pool_init_with_heap(
+            &renderer->frame_arenas[i],
+            config->allocator,
+            config->frame_arena_size == 0 ? LNA_VULKAN_RENDERER_DEFAULT_FRAME_ARENA_SIZE : config->frame_arena_size
+            );
+        lna_atomic_memory_pool_init_with_heap(
+            &renderer->shared_frame_arenas[i],
+            config->allocator,
+            config->shared_frame_arena_size == 0 ? LNA_VULKAN_RENDERER_DEFAULT_FRAME_ARENA_SIZE : config->shared_frame_arena_size,
+            0
+            );
+        lna_memory_tracking_set_name(&renderer->frame_arenas[i], LNA_VULKAN_RENDERER_FRAME_ARENA_NAMES[i]);
+    }
+    for (uint32_t i = 0; i < LNA_VULKAN_RENDERER_MEMORY_POOL_COUNT; ++i)
+    {
+        lna_memory_tracking_set_name(&renderer->memory_pools[i], LNA_VULKAN_RENDERER_MEMORY_POOL_NAMES[i]);
+    }
+
+    if (config->max_listener_count > 0)
+    {
+        renderer->listeners.max_element_count   = config->max_listener_count;
+        renderer->listeners.elements            = lna_memory_pool_reserve(
+            &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_PERSISTENT],
+            sizeof(lna_renderer_listener_t) * renderer->listeners.max_element_count
+            );
+    }
+
+    renderer->deletion_queue.max_element_count  = config->max_deferred_deletion_count == 0 ? LNA_VULKAN_RENDERER_DEFAULT_MAX_DEFERRED_DELETION_COUNT : config->max_deferred_deletion_count;
+    renderer->deletion_queue.elements           = lna_memory_pool_reserve(
+        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_PERSISTENT],
+        sizeof(lna_vulkan_deletion_t) * renderer->deletion_queue.max_element_count
+        );
+
+    renderer->job_system                                    = config->job_system;
+    renderer->secondary_command_pool_count                  = config->job_system ? config->job_system->worker_count : 1;
+    renderer->secondary_command_buffers.max_element_count   = config->max_secondary_command_buffer_count == 0 ? LNA_VULKAN_RENDERER_DEFAULT_MAX_SECONDARY_COMMAND_BUFFER_COUNT : config->max_secondary_command_buffer_count;
+    renderer->secondary_command_buffers.elements            = lna_memory_pool_reserve(
+        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_PERSISTENT],
+        sizeof(VkCommandBuffer) * renderer->secondary_command_buffers.max_element_count
+        );
+    atomic_init(&renderer->record_counter.count, 0);
+    renderer->record_start_counter  = 0;
+    renderer->record_time_in_ms     = 0.0;
+    renderer->record_frame_count    = 0;
+
+    renderer->views.max_element_count   = config->max_view_count == 0 ? LNA_VULKAN_RENDERER_DEFAULT_MAX_VIEW_COUNT : config->max_view_count;
+    renderer->views.elements            = lna_memory_pool_reserve(
+        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_PERSISTENT],
+        sizeof(lna_renderer_view_t) * renderer->views.max_element_count
+        );
+
+    renderer->curr_frame = 0;
+    renderer->frame_counter = 0;
+    renderer->swap_chain_generation = 0;
+    renderer->graphics_family = (uint32_t)-1;
+    if (!lna_vulkan_renderer_create_instance(renderer, config->window, config->enable_api_diagnostic))
+    {
+        return false;
+    }
+    if (config->enable_api_diagnostic)
+    {
         lna_vulkan_renderer_setup_debug_messenger(renderer);
     }
     lna_vulkan_renderer_create_surface(renderer, config->window);
     lna_vulkan_renderer_pick_physical_device(renderer);
     lna_vulkan_renderer_create_logical_device(renderer, config->enable_api_diagnostic);
-    lna_vulkan_renderer_create_swap_chain(renderer, lna_window_width(config->window), lna_window_height(config->window));
+
+    const lna_vulkan_memory_allocator_config_t memory_allocator_config =
+    {
+        .device                 = renderer->device,
+        .physical_device        = renderer->physical_device,
+        .memory_pool            = &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_PERSISTENT],
+        .block_size             = config->device_memory_block_size == 0 ? LNA_VULKAN_RENDERER_DEFAULT_DEVICE_MEMORY_BLOCK_SIZE : (VkDeviceSize)config->device_memory_block_size,
+        .max_block_count        = config->max_device_memory_block_count == 0 ? LNA_VULKAN_RENDERER_DEFAULT_MAX_DEVICE_MEMORY_BLOCK_COUNT : config->max_device_memory_block_count,
+        .max_allocation_count   = config->max_device_memory_allocation_count == 0 ? LNA_VULKAN_RENDERER_DEFAULT_MAX_DEVICE_MEMORY_ALLOCATION_COUNT : config->max_device_memory_allocation_count,
+    };
+    lna_vulkan_memory_allocator_init(
+        &renderer->memory_allocator,
+        &memory_allocator_config
+        );
+
+    lna_vulkan_renderer_create_swap_chain(renderer, lna_window_width(config->window), lna_window_height(config->window), VK_NULL_HANDLE);
     lna_vulkan_renderer_create_image_views(renderer);
     lna_vulkan_renderer_create_render_pass(renderer);
     lna_vulkan_renderer_create_command_pool(renderer);
     lna_vulkan_renderer_create_depth_resources(renderer);
     lna_vulkan_renderer_create_framebuffers(renderer);
     lna_vulkan_renderer_create_command_buffers(renderer);
+    lna_vulkan_renderer_create_secondary_command_pools(renderer);
     lna_vulkan_renderer_create_sync_objects(renderer);
+    const lna_vulkan_uniform_ring_buffer_config_t uniform_ring_buffer_config =
+    {
+        .memory_allocator   = &renderer->memory_allocator,
+        .frame_count        = renderer->frame_in_flight_count,
+        .size               = (VkDeviceSize)(config->uniform_buffer_size == 0 ? LNA_VULKAN_RENDERER_DEFAULT_UNIFORM_BUFFER_SIZE : config->uniform_buffer_size),
+    };
+    lna_vulkan_uniform_ring_buffer_init(
+        &renderer->uniform_ring_buffer,
+        &uniform_ring_buffer_config
+        );
+    lna_vulkan_renderer_create_view_descriptor_sets(renderer);
+
+    const lna_vulkan_upload_manager_config_t upload_manager_config =
+    {
+        .device                 = renderer->device,
+        .physical_device        = renderer->physical_device,
+        .memory_allocator       = &renderer->memory_allocator,
+        .memory_pool            = &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_PERSISTENT],
+        .transfer_family        = renderer->transfer_family,
+        .transfer_queue         = renderer->transfer_queue,
+        .graphics_family        = renderer->graphics_family,
+        .graphics_queue         = renderer->graphics_queue,
+        .frame_count            = renderer->frame_in_flight_count,
+        .staging_buffer_size    = config->upload_buffer_size == 0 ? LNA_VULKAN_RENDERER_DEFAULT_UPLOAD_BUFFER_SIZE : (VkDeviceSize)config->upload_buffer_size,
+        .max_barrier_count      = LNA_VULKAN_RENDERER_DEFAULT_MAX_UPLOAD_BATCH_RESOURCE_COUNT,
+    };
+    lna_vulkan_upload_manager_init(
+        &renderer->upload_manager,
+        &upload_manager_config
+        );
 
     return true;
 }
@@ -1343,6 +2207,49 @@ void lna_renderer_begin_draw_frame(lna_renderer_t* renderer, uint32_t window_wid
             )
         );
 
+    //! the gpu does not use the uniform data, the arena and the secondary command buffers of this frame anymore
+    lna_vulkan_uniform_ring_buffer_reset(&renderer->uniform_ring_buffer);
+    lna_memory_pool_empty(&renderer->frame_arenas[renderer->curr_frame]);
+    lna_atomic_memory_pool_empty(&renderer->shared_frame_arenas[renderer->curr_frame]);
+    for (uint32_t i = 0; i < renderer->secondary_command_pool_count; ++i)
+    {
+        lna_vulkan_secondary_command_pool_t* pool = &renderer->secondary_command_pools[renderer->curr_frame][i];
+        lna_vulkan_check(
+            vkResetCommandPool(
+                renderer->device,
+                pool->command_pool,
+                0
+                )
+            );
+        pool->cur_command_buffer_count = 0;
+    }
+    renderer->secondary_command_buffers.cur_element_count = 0;
+
+    //! the view blocks are written once for all the objects drawn from them
+    for (uint32_t i = 0; i < renderer->views.cur_element_count; ++i)
+    {
+        const lna_renderer_view_t* view = &renderer->views.elements[i];
+        lna_vulkan_view_uniform_t* ubo  = lna_renderer_persistent_uniform_data(
+            renderer,
+            view->dynamic_offset
+            );
+        ubo->view       = *view->view_matrix;
+        ubo->projection = *view->projection_matrix;
+        ubo->position   = (lna_vec4_t){ view->position->x, view->position->y, view->position->z, 1.0f };
+        lna_mat4_mult(
+            view->view_matrix,
+            view->projection_matrix,
+            &ubo->view_projection
+            );
+    }
+
+    lna_vulkan_renderer_flush_deletion_queue(renderer, false);
+
+    lna_vulkan_upload_manager_begin_frame(
+        &renderer->upload_manager,
+        (uint32_t)renderer->curr_frame
+        );
+
     VkResult result = vkAcquireNextImageKHR(
         renderer->device,
         renderer->swap_chain,
@@ -1351,16 +2258,25 @@ void lna_renderer_begin_draw_frame(lna_renderer_t* renderer, uint32_t window_wid
         VK_NULL_HANDLE,
         &renderer->image_index
         );
-    if (result == VK_ERROR_OUT_OF_DATE_KHR)
+    while (result == VK_ERROR_OUT_OF_DATE_KHR)
     {
+        //! the image available semaphore has not been signaled, the frame
+        //! can go on with an image of the new swap chain
         lna_vulkan_renderer_recreate_swap_chain(
             renderer,
             window_width,
             window_height
             );
-        return;
+        result = vkAcquireNextImageKHR(
+            renderer->device,
+            renderer->swap_chain,
+            UINT64_MAX,
+            renderer->image_available_semaphores[renderer->curr_frame],
+            VK_NULL_HANDLE,
+            &renderer->image_index
+            );
     }
-    else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR)
     {
         lna_assert(0)
     }
@@ -1402,33 +2318,18 @@ void lna_renderer_begin_draw_frame(lna_renderer_t* renderer, uint32_t window_wid
     const VkCommandBufferBeginInfo command_buffer_begin_info =
     {
         .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-        .flags              = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+        .flags              = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
         .pInheritanceInfo   = NULL,
     };
 
-    const VkViewport viewport =
-    {
-        .width      = (float)renderer->swap_chain_extent.width,
-	    .height     = (float)renderer->swap_chain_extent.height,
-	    .minDepth   = 0.0f,
-	    .maxDepth   = 1.0f,
-    };
-
-    const VkRect2D scissor_rect =
-    {
-        .offset.x       = 0,
-        .offset.y       = 0,
-        .extent.width   = renderer->swap_chain_extent.width,
-        .extent.height  = renderer->swap_chain_extent.height,
-    };
-
-    lna_assert(renderer->command_buffers.count > renderer->image_index)
-    VkCommandBuffer command_buffer = renderer->command_buffers.elements[renderer->image_index];
+    lna_assert(renderer->command_buffers.count > renderer->curr_frame)
+    VkCommandBuffer command_buffer = renderer->command_buffers.elements[renderer->curr_frame];
 
+    //! the memory of the command buffer is kept for the next frames
     lna_vulkan_check(
         vkResetCommandBuffer(
             command_buffer,
-            VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT
+            0
             )
         );
 
@@ -1450,45 +2351,60 @@ void lna_renderer_begin_draw_frame(lna_renderer_t* renderer, uint32_t window_wid
         .pClearValues       = clear_values,
     };
 
+    //! the graphics systems are recorded in secondary command buffers, see lna_vulkan_renderer_record
     vkCmdBeginRenderPass(
         command_buffer,
         &render_pass_begin_info,
-        VK_SUBPASS_CONTENTS_INLINE
-        );
-    vkCmdSetViewport(
-        command_buffer,
-        0,
-        1,
-        &viewport
-        );
-    vkCmdSetScissor(
-        command_buffer,
-        0,
-        1,
-        &scissor_rect
+        VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
         );
 }
 
 void lna_renderer_end_draw_frame(lna_renderer_t* renderer, bool window_resized, uint32_t window_width, uint32_t window_height)
 {
-    const VkSemaphore wait_semaphores[] =
-    {
-        renderer->image_available_semaphores[renderer->curr_frame],
-    };
+    //! the frame waits on the gpu for the uploads done since the previous one
+    VkCommandBuffer upload_command_buffer = lna_vulkan_upload_manager_end_frame(
+        &renderer->upload_manager,
+        (uint32_t)renderer->curr_frame
+        );
+
+    VkSemaphore             wait_semaphores[1 + LNA_VULKAN_MAX_UPLOAD_BATCHES];
+    VkPipelineStageFlags    wait_stages[1 + LNA_VULKAN_MAX_UPLOAD_BATCHES];
+    uint32_t                wait_semaphore_count = 0;
 
-    const VkPipelineStageFlags wait_stages[] =
+    wait_semaphores[wait_semaphore_count]   = renderer->image_available_semaphores[renderer->curr_frame];
+    wait_stages[wait_semaphore_count]       = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    ++wait_semaphore_count;
+    for (uint32_t i = 0; i < renderer->upload_manager.wait_semaphore_count; ++i)
     {
-        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-    };
+        wait_semaphores[wait_semaphore_count]   = renderer->upload_manager.wait_semaphores[i];
+        wait_stages[wait_semaphore_count]       = LNA_VULKAN_UPLOAD_WAIT_STAGES;
+        ++wait_semaphore_count;
+    }
 
     const VkSemaphore signal_semaphores[] =
     {
         renderer->render_finished_semaphores[renderer->curr_frame],
     };
 
-    lna_assert(renderer->command_buffers.count > renderer->image_index)
-    VkCommandBuffer command_buffer = renderer->command_buffers.elements[renderer->image_index];
+    lna_assert(renderer->command_buffers.count > renderer->curr_frame)
+    VkCommandBuffer command_buffer = renderer->command_buffers.elements[renderer->curr_frame];
 
+    if (renderer->job_system)
+    {
+        lna_job_system_wait(
+            renderer->job_system,
+            &renderer->record_counter
+            );
+    }
+    lna_vulkan_renderer_end_record_time(renderer);
+    if (renderer->secondary_command_buffers.cur_element_count > 0)
+    {
+        vkCmdExecuteCommands(
+            command_buffer,
+            renderer->secondary_command_buffers.cur_element_count,
+            renderer->secondary_command_buffers.elements
+            );
+    }
     vkCmdEndRenderPass(
         command_buffer
         );
@@ -1498,14 +2414,22 @@ void lna_renderer_end_draw_frame(lna_renderer_t* renderer, bool window_resized,
             )
         );
 
+    VkCommandBuffer submit_command_buffers[2];
+    uint32_t        submit_command_buffer_count = 0;
+    if (upload_command_buffer != VK_NULL_HANDLE)
+    {
+        submit_command_buffers[submit_command_buffer_count++] = upload_command_buffer;
+    }
+    submit_command_buffers[submit_command_buffer_count++] = command_buffer;
+
     const VkSubmitInfo submit_info =
     {
         .sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .waitSemaphoreCount     = 1,
+        .waitSemaphoreCount     = wait_semaphore_count,
         .pWaitSemaphores        = wait_semaphores,
         .pWaitDstStageMask      = wait_stages,
-        .commandBufferCount     = 1,
-        .pCommandBuffers        = &command_buffer,
+        .commandBufferCount     = submit_command_buffer_count,
+        .pCommandBuffers        = submit_command_buffers,
         .signalSemaphoreCount   = 1,
         .pSignalSemaphores      = signal_semaphores,
     };
@@ -1541,19 +2465,21 @@ void lna_renderer_end_draw_frame(lna_renderer_t* renderer, bool window_resized,
         );
     if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || window_resized)
     {
+        //! the submitted frame still uses the retired framebuffers, they
+        //! are destroyed once its fence has been signaled.
         lna_vulkan_renderer_recreate_swap_chain(
             renderer,
             window_width,
             window_height
             );
-        return;
     }
     else if (result != VK_SUCCESS)
     {
         lna_assert(0)
     }
 
-    renderer->curr_frame = (renderer->curr_frame + 1) % LNA_VULKAN_MAX_FRAMES_IN_FLIGHT;
+    renderer->curr_frame = (renderer->curr_frame + 1) % renderer->frame_in_flight_count;
+    ++renderer->frame_counter;
 
     lna_memory_pool_empty(&renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME]);
 }
@@ -1568,6 +2494,7 @@ void lna_renderer_wait_idle(lna_renderer_t* renderer)
             renderer->device
             )
         );
+    lna_vulkan_renderer_flush_deletion_queue(renderer, true);
 }
 
 void lna_renderer_release(lna_renderer_t* renderer)
@@ -1575,9 +2502,24 @@ void lna_renderer_release(lna_renderer_t* renderer)
     lna_assert(renderer)
     lna_assert(renderer->device)
 
+    lna_vulkan_renderer_flush_deletion_queue(renderer, true);
     lna_vulkan_renderer_cleanup_swap_chain(renderer);
+    lna_vulkan_renderer_cleanup_render_pass(renderer);
+    lna_vulkan_upload_manager_release(&renderer->upload_manager);
+
+    vkDestroyDescriptorPool(
+        renderer->device,
+        renderer->view_descriptor_pool,
+        NULL
+        );
+    vkDestroyDescriptorSetLayout(
+        renderer->device,
+        renderer->view_descriptor_set_layout,
+        NULL
+        );
+    lna_vulkan_uniform_ring_buffer_release(&renderer->uniform_ring_buffer);
 
-    for (size_t i = 0; i < LNA_VULKAN_MAX_FRAMES_IN_FLIGHT; ++i)
+    for (size_t i = 0; i < renderer->frame_in_flight_count; ++i)
     {
         vkDestroySemaphore(
             renderer->device,
@@ -1594,6 +2536,14 @@ void lna_renderer_release(lna_renderer_t* renderer)
             renderer->in_flight_fences[i],
             NULL
             );
+        for (uint32_t j = 0; j < renderer->secondary_command_pool_count; ++j)
+        {
+            vkDestroyCommandPool(
+                renderer->device,
+                renderer->secondary_command_pools[i][j].command_pool,
+                NULL
+                );
+        }
     }
 
     vkDestroyCommandPool(
@@ -1601,6 +2551,8 @@ void lna_renderer_release(lna_renderer_t* renderer)
         renderer->command_pool,
         NULL 
         );
+    lna_vulkan_memory_allocator_log_stats(&renderer->memory_allocator);
+    lna_vulkan_memory_allocator_release(&renderer->memory_allocator);
     vkDestroyDevice(
         renderer->device,
         NULL
@@ -1622,6 +2574,15 @@ void lna_renderer_release(lna_renderer_t* renderer)
         renderer->instance,
         NULL
         );
+
+    for (uint32_t i = 0; i < renderer->frame_in_flight_count; ++i)
+    {
+        lna_memory_pool_release(&renderer->frame_arenas[i]);
+    }
+    for (uint32_t i = 0; i < LNA_VULKAN_RENDERER_MEMORY_POOL_COUNT; ++i)
+    {
+        lna_memory_pool_release(&renderer->memory_pools[i]);
+    }
 }
 
 void lna_renderer_register_listener(
@@ -1643,3 +2604,310 @@ void lna_renderer_register_listener(
     listener->on_recreate   = on_recreate;
     listener->handle        = handle;
 }
+
+lna_renderer_view_t* lna_renderer_new_view(lna_renderer_t* renderer, const lna_renderer_view_config_t* config)
+{
+    lna_assert(renderer)
+    lna_assert(renderer->views.elements)
+    lna_assert(renderer->views.cur_element_count < renderer->views.max_element_count)
+    lna_assert(config)
+    lna_assert(config->view_matrix)
+    lna_assert(config->projection_matrix)
+    lna_assert(config->position)
+
+    lna_renderer_view_t* view = &renderer->views.elements[renderer->views.cur_element_count++];
+    view->view_matrix       = config->view_matrix;
+    view->projection_matrix = config->projection_matrix;
+    view->position          = config->position;
+    lna_renderer_reserve_persistent_uniform_data(
+        renderer,
+        sizeof(lna_vulkan_view_uniform_t),
+        &view->dynamic_offset
+        );
+    return view;
+}
+
+void lna_vulkan_renderer_bind_view(lna_renderer_t* renderer, VkCommandBuffer command_buffer, VkPipelineLayout pipeline_layout, const lna_renderer_view_t* view)
+{
+    lna_assert(renderer)
+    lna_assert(command_buffer)
+    lna_assert(pipeline_layout)
+    lna_assert(view)
+
+    vkCmdBindDescriptorSets(
+        command_buffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        pipeline_layout,
+        0,
+        1,
+        &renderer->view_descriptor_sets[renderer->curr_frame],
+        1,
+        &view->dynamic_offset
+        );
+}
+
+void* lna_renderer_reserve_uniform_data(lna_renderer_t* renderer, size_t size_in_bytes, uint32_t* dynamic_offset)
+{
+    lna_assert(renderer)
+
+    return lna_vulkan_uniform_ring_buffer_reserve(
+        &renderer->uniform_ring_buffer,
+        renderer->curr_frame,
+        size_in_bytes,
+        dynamic_offset
+        );
+}
+
+void lna_renderer_reserve_persistent_uniform_data(lna_renderer_t* renderer, size_t size_in_bytes, uint32_t* dynamic_offset)
+{
+    lna_assert(renderer)
+
+    lna_vulkan_uniform_ring_buffer_reserve_persistent(
+        &renderer->uniform_ring_buffer,
+        size_in_bytes,
+        dynamic_offset
+        );
+}
+
+void* lna_renderer_persistent_uniform_data(lna_renderer_t* renderer, uint32_t dynamic_offset)
+{
+    lna_assert(renderer)
+
+    return lna_vulkan_uniform_ring_buffer_persistent_data(
+        &renderer->uniform_ring_buffer,
+        renderer->curr_frame,
+        dynamic_offset
+        );
+}
+
+void* lna_renderer_reserve_vertex_data(lna_renderer_t* renderer, size_t size_in_bytes, VkBuffer* buffer, VkDeviceSize* offset)
+{
+    lna_assert(renderer)
+    lna_assert(buffer)
+    lna_assert(offset)
+
+    uint32_t dynamic_offset;
+    void* data = lna_renderer_reserve_uniform_data(
+        renderer,
+        size_in_bytes,
+        &dynamic_offset
+        );
+    *buffer = renderer->uniform_ring_buffer.buffers[renderer->curr_frame];
+    *offset = (VkDeviceSize)dynamic_offset;
+    return data;
+}
+
+void* lna_renderer_reserve_index_data(lna_renderer_t* renderer, size_t size_in_bytes, VkBuffer* buffer, VkDeviceSize* offset)
+{
+    //! the uniform buffer offset alignment is a multiple of the index size
+    return lna_renderer_reserve_vertex_data(
+        renderer,
+        size_in_bytes,
+        buffer,
+        offset
+        );
+}
+
+void lna_vulkan_renderer_record(lna_renderer_t* renderer, lna_vulkan_record_function_t function, void* graphics_system, uint32_t object_count, uint32_t range_size)
+{
+    lna_assert(renderer)
+    lna_assert(function)
+
+    if (object_count == 0)
+    {
+        return;
+    }
+    lna_assert(range_size > 0)
+    lna_vulkan_renderer_start_record_time(renderer);
+
+    const uint32_t range_count = (object_count + range_size - 1) / range_size;
+    lna_vulkan_secondary_command_buffer_vec_t* secondary_command_buffers = &renderer->secondary_command_buffers;
+    lna_assert(secondary_command_buffers->cur_element_count + range_count <= secondary_command_buffers->max_element_count)
+
+    //! the ranges are read by the record jobs until lna_renderer_end_draw_frame empties the frame memory pool
+    lna_vulkan_record_range_t* ranges = lna_memory_pool_reserve(
+        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME],
+        sizeof(lna_vulkan_record_range_t) * range_count
+        );
+    lna_job_t* jobs = lna_memory_pool_reserve(
+        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME],
+        sizeof(lna_job_t) * range_count
+        );
+    for (uint32_t i = 0; i < range_count; ++i)
+    {
+        ranges[i].renderer          = renderer;
+        ranges[i].function          = function;
+        ranges[i].graphics_system   = graphics_system;
+        ranges[i].begin             = i * range_size;
+        ranges[i].end               = (i + 1) * range_size < object_count ? (i + 1) * range_size : object_count;
+        ranges[i].slot              = secondary_command_buffers->cur_element_count++;
+        ranges[i].command_cache     = NULL;
+        jobs[i].function            = lna_vulkan_renderer_record_range;
+        jobs[i].data                = &ranges[i];
+    }
+
+    if (renderer->job_system)
+    {
+        lna_job_system_run(
+            renderer->job_system,
+            jobs,
+            range_count,
+            &renderer->record_counter
+            );
+    }
+    else
+    {
+        for (uint32_t i = 0; i < range_count; ++i)
+        {
+            lna_vulkan_renderer_record_range(&ranges[i]);
+        }
+    }
+}
+
+void lna_vulkan_renderer_record_cached(lna_renderer_t* renderer, lna_vulkan_command_cache_t* command_cache, lna_vulkan_record_function_t function, void* graphics_system, uint32_t object_count)
+{
+    lna_assert(renderer)
+    lna_assert(command_cache)
+    lna_assert(command_cache->command_pools[renderer->curr_frame])
+    lna_assert(function)
+
+    if (object_count == 0)
+    {
+        return;
+    }
+
+    lna_vulkan_renderer_start_record_time(renderer);
+
+    lna_vulkan_secondary_command_buffer_vec_t* secondary_command_buffers = &renderer->secondary_command_buffers;
+    lna_assert(secondary_command_buffers->cur_element_count < secondary_command_buffers->max_element_count)
+
+    const uint32_t slot = secondary_command_buffers->cur_element_count++;
+    if (
+        command_cache->recorded_generations[renderer->curr_frame] == command_cache->generation
+        && command_cache->recorded_swap_chain_generations[renderer->curr_frame] == renderer->swap_chain_generation
+        )
+    {
+        secondary_command_buffers->elements[slot] = command_cache->command_buffers[renderer->curr_frame];
+        return;
+    }
+    command_cache->recorded_generations[renderer->curr_frame]               = command_cache->generation;
+    command_cache->recorded_swap_chain_generations[renderer->curr_frame]    = renderer->swap_chain_generation;
+
+    lna_vulkan_record_range_t* range = lna_memory_pool_reserve(
+        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME],
+        sizeof(lna_vulkan_record_range_t)
+        );
+    range->renderer         = renderer;
+    range->function         = function;
+    range->graphics_system  = graphics_system;
+    range->begin            = 0;
+    range->end              = object_count;
+    range->slot             = slot;
+    range->command_cache    = command_cache;
+
+    if (renderer->job_system)
+    {
+        const lna_job_t job =
+        {
+            .function   = lna_vulkan_renderer_record_range,
+            .data       = range,
+        };
+        lna_job_system_run(
+            renderer->job_system,
+            &job,
+            1,
+            &renderer->record_counter
+            );
+    }
+    else
+    {
+        lna_vulkan_renderer_record_range(range);
+    }
+}
+
+void lna_vulkan_command_cache_init(lna_vulkan_command_cache_t* command_cache, lna_renderer_t* renderer)
+{
+    lna_assert(command_cache)
+    lna_assert(renderer)
+    lna_assert(renderer->device)
+
+    const VkCommandPoolCreateInfo command_pool_create_info =
+    {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .queueFamilyIndex   = renderer->graphics_family,
+    };
+
+    for (uint32_t i = 0; i < renderer->frame_in_flight_count; ++i)
+    {
+        lna_assert(command_cache->command_pools[i] == VK_NULL_HANDLE)
+
+        lna_vulkan_check(
+            vkCreateCommandPool(
+                renderer->device,
+                &command_pool_create_info,
+                NULL,
+                &command_cache->command_pools[i]
+                )
+            );
+
+        const VkCommandBufferAllocateInfo command_buffer_allocate_info =
+        {
+            .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+            .commandPool        = command_cache->command_pools[i],
+            .level              = VK_COMMAND_BUFFER_LEVEL_SECONDARY,
+            .commandBufferCount = 1,
+        };
+        lna_vulkan_check(
+            vkAllocateCommandBuffers(
+                renderer->device,
+                &command_buffer_allocate_info,
+                &command_cache->command_buffers[i]
+                )
+            );
+        command_cache->recorded_generations[i]              = 0;
+        command_cache->recorded_swap_chain_generations[i]   = 0;
+    }
+    //! the command buffers are recorded at their first use
+    command_cache->generation = 1;
+}
+
+void lna_vulkan_command_cache_invalidate(lna_vulkan_command_cache_t* command_cache)
+{
+    lna_assert(command_cache)
+
+    ++command_cache->generation;
+}
+
+void lna_vulkan_command_cache_release(lna_vulkan_command_cache_t* command_cache, lna_renderer_t* renderer)
+{
+    lna_assert(command_cache)
+    lna_assert(renderer)
+    lna_assert(renderer->device)
+
+    for (uint32_t i = 0; i < renderer->frame_in_flight_count; ++i)
+    {
+        vkDestroyCommandPool(
+            renderer->device,
+            command_cache->command_pools[i],
+            NULL
+            );
+        command_cache->command_pools[i]     = VK_NULL_HANDLE;
+        command_cache->command_buffers[i]   = VK_NULL_HANDLE;
+    }
+}
+
+lna_memory_pool_t* lna_renderer_frame_arena(lna_renderer_t* renderer)
+{
+    lna_assert(renderer)
+    lna_assert(renderer->frame_arenas[renderer->curr_frame].content)
+
+    return &renderer->frame_arenas[renderer->curr_frame];
+}
+
+lna_atomic_memory_pool_t* lna_renderer_shared_frame_arena(lna_renderer_t* renderer)
+{
+    lna_assert(renderer)
+    lna_assert(renderer->shared_frame_arenas[renderer->curr_frame].content)
+
+    return &renderer->shared_frame_arenas[renderer->curr_frame];
+}
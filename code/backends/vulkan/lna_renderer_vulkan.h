@@ -2,9 +2,16 @@
 #define LNA_BACKENDS_VULKAN_LNA_RENDERER_VULKAN_H
 
 #include <vulkan/vulkan.h>
+#include <stdatomic.h>
 #include "core/lna_memory_pool.h"
-
-#define LNA_VULKAN_MAX_FRAMES_IN_FLIGHT 2
+#include "core/lna_atomic_memory_pool.h"
+#include "core/lna_job_system.h"
+#include "graphics/lna_renderer.h"
+#include "maths/lna_mat4.h"
+#include "maths/lna_vec4.h"
+#include "backends/vulkan/lna_vulkan_memory_allocator.h"
+#include "backends/vulkan/lna_vulkan_upload_manager.h"
+#include "backends/vulkan/lna_vulkan_uniform_ring_buffer.h"
 
 typedef enum lna_vulkan_renderer_memory_pool_s
 {
@@ -68,6 +75,50 @@ typedef struct lna_vulkan_descriptor_set_layout_array_s
     uint32_t                count;
 } lna_vulkan_descriptor_set_layout_array_t;
 
+typedef enum lna_vulkan_deletion_type_e
+{
+    LNA_VULKAN_DELETION_TYPE_SWAP_CHAIN,
+    LNA_VULKAN_DELETION_TYPE_FRAMEBUFFER,
+    LNA_VULKAN_DELETION_TYPE_IMAGE_VIEW,
+    LNA_VULKAN_DELETION_TYPE_IMAGE,
+    LNA_VULKAN_DELETION_TYPE_SAMPLER,
+    LNA_VULKAN_DELETION_TYPE_BUFFER,
+    LNA_VULKAN_DELETION_TYPE_DESCRIPTOR_SET,
+} lna_vulkan_deletion_type_t;
+
+typedef struct lna_vulkan_deletion_s
+{
+    lna_vulkan_deletion_type_t              type;
+    uint64_t                                frame;      //! value of the renderer frame counter when the resource was retired
+    union
+    {
+        VkSwapchainKHR                      swap_chain;
+        VkFramebuffer                       framebuffer;
+        VkImageView                         image_view;
+        VkImage                             image;
+        VkSampler                           sampler;
+        VkBuffer                            buffer;
+        VkDescriptorSet                     descriptor_set;
+    } handle;
+    lna_vulkan_memory_allocation_t          allocation;         //! only used by images and buffers
+    VkDescriptorPool                        descriptor_pool;    //! only used by descriptor sets, the pool must have been created with VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT
+} lna_vulkan_deletion_t;
+
+//! resources retired while the frames in flight may still use them. They
+//! are pushed in frame order and destroyed at the beginning of the first
+//! frame whose fence guarantees the gpu is done with them, so the renderer
+//! never has to wait for the device to be idle.
+typedef struct lna_vulkan_deletion_queue_s
+{
+    uint32_t                                cur_element_count;
+    uint32_t                                max_element_count;
+    lna_vulkan_deletion_t*                  elements;
+} lna_vulkan_deletion_queue_t;
+
+//! called when the render pass is destroyed and recreated: when the swap
+//! chain image format changes and at release (cleanup only). A simple
+//! resize does not call the listeners, the viewport and the scissor must be
+//! dynamic states of the pipelines.
 typedef void (*lna_vulkan_on_swap_chain_cleanup_t)(void* graphics_system);
 typedef void (*lna_vulkan_on_swap_chain_recreate_t)(void* graphics_system);
 typedef struct lna_renderer_listener_s
@@ -91,6 +142,79 @@ extern void lna_renderer_register_listener(
     void* handle
     );
 
+//! secondary command buffers of one thread for one frame in flight. The
+//! pool is reset once the frame fence has been signaled, its command
+//! buffers are allocated when needed and reused by the next frames. Each
+//! thread only touches its own pool, the padding keeps them on different
+//! cache lines.
+typedef struct lna_vulkan_secondary_command_pool_s
+{
+    VkCommandPool                           command_pool;
+    VkCommandBuffer*                        command_buffers;
+    uint32_t                                cur_command_buffer_count;
+    uint32_t                                allocated_command_buffer_count;
+    char                                    end_padding[LNA_ATOMIC_MEMORY_POOL_CACHE_LINE_SIZE];
+} lna_vulkan_secondary_command_pool_t;
+
+//! secondary command buffers executed by the frame primary command buffer,
+//! in the order their slots have been reserved, whatever the thread and the
+//! time they have been recorded.
+typedef struct lna_vulkan_secondary_command_buffer_vec_s
+{
+    uint32_t                                cur_element_count;
+    uint32_t                                max_element_count;
+    VkCommandBuffer*                        elements;
+} lna_vulkan_secondary_command_buffer_vec_t;
+
+//! secondary command buffer recorded once and executed by the next frames
+//! until it is invalidated, by the graphics system owning it or by a swap
+//! chain recreation. There is one command buffer per frame in flight, since
+//! they use the descriptor sets and the uniform buffer of their frame.
+typedef struct lna_vulkan_command_cache_s
+{
+    VkCommandPool                           command_pools[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    VkCommandBuffer                         command_buffers[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    uint64_t                                recorded_generations[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    uint64_t                                recorded_swap_chain_generations[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    uint64_t                                generation;
+} lna_vulkan_command_cache_t;
+
+//! uniform block of a view, at binding 0 of descriptor set 0 in the
+//! pipeline layouts of the graphics systems.
+typedef struct lna_vulkan_view_uniform_s
+{
+    lna_mat4_t                              view;
+    lna_mat4_t                              projection;
+    lna_mat4_t                              view_projection;
+    lna_vec4_t                              position;
+} lna_vulkan_view_uniform_t;
+
+//! per draw data of the graphics systems, pushed with vkCmdPushConstants
+//! instead of being written in the uniform buffer and bound with a
+//! descriptor set. It fits in the 128 bytes guaranteed by maxPushConstantsSize.
+typedef struct lna_vulkan_object_push_constants_s
+{
+    lna_mat4_t                              model;
+    lna_vec4_t                              tint;       //! multiplies the vertex colors
+} lna_vulkan_object_push_constants_t;
+
+//! the uniform block of the view is written at a persistent offset at the
+//! beginning of each frame, so it can be bound by the cached command buffers.
+typedef struct lna_renderer_view_s
+{
+    const lna_mat4_t*                       view_matrix;
+    const lna_mat4_t*                       projection_matrix;
+    const lna_vec3_t*                       position;
+    uint32_t                                dynamic_offset;
+} lna_renderer_view_t;
+
+typedef struct lna_renderer_view_vec_s
+{
+    uint32_t                                cur_element_count;
+    uint32_t                                max_element_count;
+    lna_renderer_view_t*                    elements;
+} lna_renderer_view_vec_t;
+
 typedef struct lna_renderer_s
 {
     VkInstance                              instance;
@@ -101,26 +225,110 @@ typedef struct lna_renderer_s
     VkQueue                                 graphics_queue;
     VkSurfaceKHR                            surface;
     VkQueue                                 present_queue;
+    uint32_t                                transfer_family;
+    VkQueue                                 transfer_queue;
     VkSwapchainKHR                          swap_chain;
     VkFormat                                swap_chain_image_format;
     VkExtent2D                              swap_chain_extent;
     VkRenderPass                            render_pass;
     VkCommandPool                           command_pool;
     size_t                                  curr_frame;
+    uint32_t                                frame_in_flight_count;
+    uint64_t                                frame_counter;
+    uint64_t                                swap_chain_generation;  //! incremented by each swap chain recreation
+    uint32_t                                requested_image_count;
+    lna_renderer_present_mode_t             requested_present_mode;
     VkSemaphore                             image_available_semaphores[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
     VkSemaphore                             render_finished_semaphores[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
     VkFence                                 in_flight_fences[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
     VkImage                                 depth_image;
-    VkDeviceMemory                          depth_image_memory;
+    lna_vulkan_memory_allocation_t          depth_image_allocation;
     VkImageView                             depth_image_view;
     lna_memory_pool_t                       memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_COUNT];
+    lna_memory_pool_t                       frame_arenas[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    lna_atomic_memory_pool_t                shared_frame_arenas[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    lna_vulkan_memory_allocator_t           memory_allocator;
+    lna_vulkan_uniform_ring_buffer_t        uniform_ring_buffer;
+    lna_vulkan_upload_manager_t             upload_manager;
     lna_vulkan_fence_array_t                images_in_flight_fences;
     lna_vulkan_image_array_t                swap_chain_images;
     lna_vulkan_image_view_array_t           swap_chain_image_views;
     lna_vulkan_frame_buffer_array_t         swap_chain_framebuffers;
-    lna_vulkan_command_buffer_array_t       command_buffers;
+    lna_vulkan_command_buffer_array_t       command_buffers;    //! one per frame in flight, indexed by curr_frame
+    lna_job_system_t*                       job_system;
+    lna_vulkan_secondary_command_pool_t*    secondary_command_pools[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];  //! one per job system worker
+    uint32_t                                secondary_command_pool_count;
+    lna_vulkan_secondary_command_buffer_vec_t secondary_command_buffers;
+    lna_job_counter_t                       record_counter;
+    uint64_t                                record_start_counter;           //! performance counter at the first record of the frame, 0 before it
+    double                                  record_time_in_ms;              //! record times summed since the last log
+    uint32_t                                record_frame_count;             //! frames summed in record_time_in_ms
+    lna_renderer_view_vec_t                 views;
+    VkDescriptorSetLayout                   view_descriptor_set_layout;     //! set 0 of the graphics systems pipeline layouts
+    VkDescriptorPool                        view_descriptor_pool;
+    VkDescriptorSet                         view_descriptor_sets[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
     uint32_t                                image_index;
     lna_renderer_listener_vec_t             listeners;
+    lna_vulkan_deletion_queue_t             deletion_queue;
 } lna_renderer_t;
 
+//! record the objects [begin, end[ of graphics_system in command_buffer, a
+//! secondary command buffer inside the frame render pass with the viewport
+//! and the scissor already set. It can be called on any job system thread.
+typedef void (*lna_vulkan_record_function_t)(void* graphics_system, VkCommandBuffer command_buffer, uint32_t begin, uint32_t end);
+
+//! split [0, object_count[ in ranges of range_size objects, each recorded by
+//! function in its own secondary command buffer. With a renderer job system
+//! the ranges are recorded in parallel, while the calling thread goes on,
+//! otherwise they are recorded immediately. The command buffers are executed
+//! in the order of the calls, at lna_renderer_end_draw_frame, so the recorded
+//! objects must not change until then.
+//! called between lna_renderer_begin_draw_frame and lna_renderer_end_draw_frame, from the thread drawing the frame.
+extern void     lna_vulkan_renderer_record          (lna_renderer_t* renderer, lna_vulkan_record_function_t function, void* graphics_system, uint32_t object_count, uint32_t range_size);
+
+//! same as lna_vulkan_renderer_record, but the objects are recorded in a
+//! single secondary command buffer kept in the cache and only recorded
+//! again once the cache has been invalidated. The uniform data bound by the
+//! record function must be persistent, see lna_renderer_reserve_persistent_uniform_data.
+extern void     lna_vulkan_renderer_record_cached   (lna_renderer_t* renderer, lna_vulkan_command_cache_t* command_cache, lna_vulkan_record_function_t function, void* graphics_system, uint32_t object_count);
+
+extern void     lna_vulkan_command_cache_init       (lna_vulkan_command_cache_t* command_cache, lna_renderer_t* renderer);
+//! the command buffers are recorded again at their next use.
+extern void     lna_vulkan_command_cache_invalidate (lna_vulkan_command_cache_t* command_cache);
+//! the frames in flight must be done with the command buffers, see lna_renderer_wait_idle.
+extern void     lna_vulkan_command_cache_release    (lna_vulkan_command_cache_t* command_cache, lna_renderer_t* renderer);
+
+//! bind the uniform block of view at descriptor set 0, the graphics
+//! systems bind it again only when the view changes between two objects.
+extern void     lna_vulkan_renderer_bind_view       (lna_renderer_t* renderer, VkCommandBuffer command_buffer, VkPipelineLayout pipeline_layout, const lna_renderer_view_t* view);
+
+//! reserve size_in_bytes of uniform data in the current frame uniform buffer.
+//! the returned pointer is persistently mapped and host coherent, the offset
+//! must be given as dynamic offset when binding a descriptor set pointing on
+//! renderer->uniform_ring_buffer.buffers[renderer->curr_frame].
+//! the reservations are thread safe, like the vertex and index ones.
+extern void*    lna_renderer_reserve_uniform_data   (lna_renderer_t* renderer, size_t size_in_bytes, uint32_t* dynamic_offset);
+//! reserve size_in_bytes of uniform data at the end of all the frame uniform
+//! buffers, for the lifetime of the renderer. The offset is the same in all
+//! the frame buffers, the data of the current frame are given by
+//! lna_renderer_persistent_uniform_data and must be written each frame.
+//! called outside of a frame, from the thread drawing the frames.
+extern void     lna_renderer_reserve_persistent_uniform_data    (lna_renderer_t* renderer, size_t size_in_bytes, uint32_t* dynamic_offset);
+extern void*    lna_renderer_persistent_uniform_data            (lna_renderer_t* renderer, uint32_t dynamic_offset);
+//! reserve size_in_bytes of vertex data in the current frame uniform buffer.
+//! buffer and offset must be used when binding the data with vkCmdBindVertexBuffers.
+extern void*    lna_renderer_reserve_vertex_data    (lna_renderer_t* renderer, size_t size_in_bytes, VkBuffer* buffer, VkDeviceSize* offset);
+//! reserve size_in_bytes of index data in the current frame uniform buffer.
+//! buffer and offset must be used when binding the data with vkCmdBindIndexBuffer.
+extern void*    lna_renderer_reserve_index_data     (lna_renderer_t* renderer, size_t size_in_bytes, VkBuffer* buffer, VkDeviceSize* offset);
+
+//! destroy the resource once the frames in flight recorded until now are
+//! completed. The graphics systems use it to delete an object at any time,
+//! even when it has already been recorded in the current frame.
+//! lna_renderer_wait_idle destroys all the pending resources, it must be
+//! called before releasing the systems owning the descriptor pools.
+extern void     lna_vulkan_renderer_push_deletion                 (lna_renderer_t* renderer, const lna_vulkan_deletion_t* deletion);
+extern void     lna_vulkan_renderer_push_buffer_deletion          (lna_renderer_t* renderer, VkBuffer buffer, const lna_vulkan_memory_allocation_t* allocation);
+extern void     lna_vulkan_renderer_push_descriptor_sets_deletion (lna_renderer_t* renderer, VkDescriptorPool descriptor_pool, const VkDescriptorSet* descriptor_sets, uint32_t descriptor_set_count);
+
 #endif
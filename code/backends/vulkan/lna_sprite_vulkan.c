@@ -11,19 +11,12 @@
 #include "maths/lna_vec4.h"
 #include "maths/lna_mat4.h"
 
-typedef struct lna_sprite_vertex_s
-{
-    lna_vec3_t  position;
-    lna_vec2_t  uv;
-    lna_vec4_t  color;
-} lna_sprite_vertex_t;
+static const uint32_t LNA_SPRITE_INDICES[LNA_SPRITE_INDEX_COUNT] = { 0, 1, 2, 2, 3, 0 };
 
-typedef struct lna_sprite_uniform_s
-{
-    lna_mat4_t  model;
-    lna_mat4_t  view;
-    lna_mat4_t  projection;
-} lna_sprite_uniform_t;
+//! count of sprites recorded in each secondary command buffer, a batch is
+//! split at the end of a range so the batched ranges are bigger.
+static const uint32_t LNA_SPRITE_SYSTEM_RECORD_RANGE_SIZE           = 256;
+static const uint32_t LNA_SPRITE_SYSTEM_BATCHED_RECORD_RANGE_SIZE   = 4096;
 
 static void lna_sprite_system_create_graphics_pipeline(
     lna_sprite_system_t* sprite_system,
@@ -38,7 +31,7 @@ static void lna_sprite_system_create_graphics_pipeline(
     lna_binary_file_debug_load_uint32(
         &vertex_shader_file,
         &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME],
-        "shaders/sprite_vert.spv"
+        sprite_system->batched ? "shaders/sprite_batch_vert.spv" : "shaders/sprite_vert.spv"
         );
     // TODO: avoid direct file load: add binary code directly in code as a static const uint32_t* 
     lna_binary_file_content_uint32_t fragment_shader_file = { 0 };
@@ -116,27 +109,13 @@ static void lna_sprite_system_create_graphics_pipeline(
         .topology               = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST,
         .primitiveRestartEnable = VK_FALSE,
     };
-    const VkViewport viewport =
-    {
-        .x          = 0.0f,
-        .y          = 0.0f,
-        .width      = (float)(renderer->swap_chain_extent.width),
-        .height     = (float)(renderer->swap_chain_extent.height),
-        .minDepth   = 0.0f,
-        .maxDepth   = 1.0f,
-    };
-    const VkRect2D scissor =
-    {
-        .offset = {0, 0},
-        .extent = renderer->swap_chain_extent,
-    };
     const VkPipelineViewportStateCreateInfo viewport_state_create_info =
     {
         .sType          = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO,
         .viewportCount  = 1,
-        .pViewports     = &viewport,
+        .pViewports     = NULL, //! dynamic state
         .scissorCount   = 1,
-        .pScissors      = &scissor,
+        .pScissors      = NULL, //! dynamic state
     };
     const VkPipelineRasterizationStateCreateInfo rasterization_state_create_info =
     {
@@ -184,21 +163,34 @@ static void lna_sprite_system_create_graphics_pipeline(
     const VkDynamicState dynamic_states[] =
     {
         VK_DYNAMIC_STATE_VIEWPORT,
+        VK_DYNAMIC_STATE_SCISSOR,
         VK_DYNAMIC_STATE_LINE_WIDTH
     };
     const VkPipelineDynamicStateCreateInfo dynamic_state_create_info =
     {
         .sType              = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
-        .dynamicStateCount  = 2,
+        .dynamicStateCount  = (uint32_t)(sizeof(dynamic_states) / sizeof(dynamic_states[0])),
         .pDynamicStates     = dynamic_states,
     };
+    const VkDescriptorSetLayout set_layouts[] =
+    {
+        renderer->view_descriptor_set_layout,
+        sprite_system->descriptor_set_layout,
+    };
+    //! batched sprite vertices are already in world space and tinted, their shader does not use the push constants
+    const VkPushConstantRange push_constant_range =
+    {
+        .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+        .offset     = 0,
+        .size       = sizeof(lna_vulkan_object_push_constants_t),
+    };
     const VkPipelineLayoutCreateInfo pipeline_layout_create_info =
     {
         .sType                  = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
-        .setLayoutCount         = 1,
-        .pSetLayouts            = &sprite_system->descriptor_set_layout,
-        .pushConstantRangeCount = 0,
-        .pPushConstantRanges    = NULL,
+        .setLayoutCount         = (uint32_t)(sizeof(set_layouts) / sizeof(set_layouts[0])),
+        .pSetLayouts            = set_layouts,
+        .pushConstantRangeCount = 1,
+        .pPushConstantRanges    = &push_constant_range,
     };
     lna_vulkan_check(
         vkCreatePipelineLayout(
@@ -267,26 +259,26 @@ static void lna_sprite_system_create_descriptor_pool(
 
     lna_renderer_t* renderer = sprite_system->renderer;
     lna_assert(renderer)
-    lna_assert(renderer->swap_chain_images.count > 0)
+
+    //! the sets of a deleted sprite are freed when the frames in flight are
+    //! done with them, until then they are counted with the new sprites.
+    const uint32_t set_count = 2 * sprite_system->sprites.max_element_count;
 
     const VkDescriptorPoolSize pool_sizes[] =
     {
-        {
-            .type               = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            .descriptorCount    = renderer->swap_chain_images.count * sprite_system->sprites.max_element_count,
-        },
         {
             .type               = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
-            .descriptorCount    = renderer->swap_chain_images.count * sprite_system->sprites.max_element_count,
+            .descriptorCount    = renderer->frame_in_flight_count * set_count,
         },
     };
 
     const VkDescriptorPoolCreateInfo pool_create_info =
     {
         .sType          = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags          = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT,
         .poolSizeCount  = (uint32_t)(sizeof(pool_sizes) / sizeof(pool_sizes[0])),
         .pPoolSizes     = pool_sizes,
-        .maxSets        = renderer->swap_chain_images.count * sprite_system->sprites.max_element_count,
+        .maxSets        = renderer->frame_in_flight_count * set_count,
     };
 
     lna_vulkan_check(
@@ -310,105 +302,45 @@ static void lna_sprite_system_create_descriptor_pool(
     }
 }
 
-static void lna_sprite_create_uniform_buffer(
-    lna_sprite_t* sprite,
-    lna_renderer_t* renderer
-    )
-{
-    lna_assert(sprite)
-    lna_assert(sprite->mvp_uniform_buffers.count == 0)
-    lna_assert(sprite->mvp_uniform_buffers.elements == NULL)
-    lna_assert(sprite->mvp_uniform_buffers_memory.count == 0)
-    lna_assert(sprite->mvp_uniform_buffers_memory.elements == 0)
-
-    sprite->mvp_uniform_buffers.count       = renderer->swap_chain_images.count;
-    sprite->mvp_uniform_buffers.elements    = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
-        sizeof(VkBuffer) * renderer->swap_chain_images.count
-        );
-
-    sprite->mvp_uniform_buffers_memory.count    = renderer->swap_chain_images.count;
-    sprite->mvp_uniform_buffers_memory.elements = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
-        sizeof(VkDeviceMemory) * renderer->swap_chain_images.count
-        );
-
-    VkDeviceSize uniform_buffer_size = sizeof(lna_sprite_uniform_t);
-    for (size_t i = 0; i < sprite->mvp_uniform_buffers.count; ++i)
-    {
-        lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
-            uniform_buffer_size,
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            &sprite->mvp_uniform_buffers.elements[i],
-            &sprite->mvp_uniform_buffers_memory.elements[i]
-            );
-    }
-}
-
 static void lna_sprite_create_descriptor_sets(
-    lna_sprite_t* sprite,
-    lna_sprite_system_t* sprite_system
+    lna_sprite_system_t* sprite_system,
+    const lna_texture_t* texture,
+    VkDescriptorSet* descriptor_sets
     )
 {
-    lna_assert(sprite)
     lna_assert(sprite_system)
-    lna_assert(sprite->descriptor_sets.count == 0)
-    lna_assert(sprite->descriptor_sets.elements == NULL)
-
-    const lna_texture_t* texture = sprite->texture;
+    lna_assert(descriptor_sets)
     lna_assert(texture)
     lna_assert(texture->image_view)
     lna_assert(texture->image_sampler)
 
     lna_renderer_t* renderer = sprite_system->renderer;
     lna_assert(renderer)
-    lna_assert(renderer->swap_chain_images.count > 0)
-
-    lna_vulkan_descriptor_set_layout_array_t layouts = { 0 };
-    layouts.count       = renderer->swap_chain_images.count;
-    layouts.elements    = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_FRAME],
-        sizeof(VkDescriptorSetLayout) * renderer->swap_chain_images.count
-        );
 
-    for (uint32_t i = 0; i < layouts.count; ++i)
+    VkDescriptorSetLayout layouts[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    for (uint32_t i = 0; i < renderer->frame_in_flight_count; ++i)
     {
-        layouts.elements[i] = sprite_system->descriptor_set_layout;
+        layouts[i] = sprite_system->descriptor_set_layout;
     }
 
     const VkDescriptorSetAllocateInfo allocate_info =
     {
         .sType              = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
         .descriptorPool     = sprite_system->descriptor_pool,
-        .descriptorSetCount = layouts.count,
-        .pSetLayouts        = layouts.elements,
+        .descriptorSetCount = renderer->frame_in_flight_count,
+        .pSetLayouts        = layouts,
     };
 
-    sprite->descriptor_sets.count       = renderer->swap_chain_images.count;
-    sprite->descriptor_sets.elements    = lna_memory_pool_reserve(
-        &renderer->memory_pools[LNA_VULKAN_RENDERER_MEMORY_POOL_SWAP_CHAIN],
-        sizeof(VkDescriptorSet) * renderer->swap_chain_images.count
-        );
-
     lna_vulkan_check(
         vkAllocateDescriptorSets(
             renderer->device,
             &allocate_info,
-            sprite->descriptor_sets.elements
+            descriptor_sets
             )
         );
 
-    for (size_t i = 0; i < sprite->descriptor_sets.count; ++i)
+    for (size_t i = 0; i < renderer->frame_in_flight_count; ++i)
     {
-        const VkDescriptorBufferInfo buffer_info =
-        {
-            .buffer = sprite->mvp_uniform_buffers.elements[i],
-            .offset = 0,
-            .range  = sizeof(lna_sprite_uniform_t),
-        };
         const VkDescriptorImageInfo image_info =
         {
             .imageLayout    = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
@@ -419,18 +351,7 @@ static void lna_sprite_create_descriptor_sets(
         {
             {
                 .sType              = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet             = sprite->descriptor_sets.elements[i],
-                .dstBinding         = 0,
-                .dstArrayElement    = 0,
-                .descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-                .descriptorCount    = 1,
-                .pBufferInfo        = &buffer_info,
-                .pImageInfo         = NULL,
-                .pTexelBufferView   = NULL,
-            },
-            {
-                .sType              = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-                .dstSet             = sprite->descriptor_sets.elements[i],
+                .dstSet             = descriptor_sets[i],
                 .dstBinding         = 1,
                 .dstArrayElement    = 0,
                 .descriptorType     = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
@@ -451,61 +372,402 @@ static void lna_sprite_create_descriptor_sets(
     }
 }
 
-static void lna_sprite_system_on_swap_chain_cleanup(void* owner)
+static void lna_sprite_system_create_batch_index_buffer(
+    lna_sprite_system_t* sprite_system
+    )
 {
-    lna_assert(owner)
-    lna_sprite_system_t*    sprite_system   = (lna_sprite_system_t*)owner;
-    lna_renderer_t*         renderer        = sprite_system->renderer;
+    lna_assert(sprite_system)
+    lna_assert(sprite_system->sprites.max_element_count > 0)
+    lna_assert(sprite_system->batch_index_buffer == VK_NULL_HANDLE)
+
+    lna_renderer_t* renderer = sprite_system->renderer;
     lna_assert(renderer)
 
-    vkDestroyPipeline(
-        renderer->device,
-        sprite_system->pipeline,
-        NULL
+    //! the same indices are used by all the batches, batch vertices are
+    //! written in sorted sprite order so quad i uses vertices 4 * i to 4 * i + 3.
+    const size_t index_buffer_size = sizeof(uint32_t) * LNA_SPRITE_INDEX_COUNT * sprite_system->sprites.max_element_count;
+
+    lna_vulkan_create_buffer(
+        &renderer->memory_allocator,
+        index_buffer_size,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        &sprite_system->batch_index_buffer,
+        &sprite_system->batch_index_buffer_allocation
         );
-    vkDestroyPipelineLayout(
-        renderer->device,
-        sprite_system->pipeline_layout,
+    uint32_t* indices = lna_vulkan_upload_manager_upload_buffer(
+        &renderer->upload_manager,
+        sprite_system->batch_index_buffer,
+        0,
+        index_buffer_size,
         NULL
         );
+    for (uint32_t i = 0; i < sprite_system->sprites.max_element_count; ++i)
+    {
+        for (uint32_t j = 0; j < LNA_SPRITE_INDEX_COUNT; ++j)
+        {
+            indices[i * LNA_SPRITE_INDEX_COUNT + j] = i * LNA_SPRITE_VERTEX_COUNT + LNA_SPRITE_INDICES[j];
+        }
+    }
+}
+
+//! index of the texture of the new sprite in the cache of the sprite system,
+//! the new sprite is counted in the entry.
+static uint32_t lna_sprite_system_acquire_texture_index(
+    lna_sprite_system_t* sprite_system,
+    const lna_sprite_t* new_sprite
+    )
+{
+    lna_assert(sprite_system)
+    lna_assert(sprite_system->textures.elements)
+    lna_assert(new_sprite)
+    lna_assert(new_sprite->texture)
+
+    const lna_texture_t* texture = new_sprite->texture;
+
+    uint32_t index = sprite_system->textures.cur_element_count;
+    for (uint32_t i = 0; i < sprite_system->textures.cur_element_count; ++i)
+    {
+        lna_sprite_texture_t* sprite_texture = &sprite_system->textures.elements[i];
+        if (sprite_texture->texture == NULL)
+        {
+            //! the first released entry is reused
+            if (index == sprite_system->textures.cur_element_count)
+            {
+                index = i;
+            }
+            continue;
+        }
+        //! a deleted texture can have the address of the new one: its entry
+        //! is kept for the sprites still using it, it is not shared.
+        if (
+            sprite_texture->texture == texture
+            && sprite_texture->texture_handle.index == texture->handle.index
+            && sprite_texture->texture_handle.generation == texture->handle.generation
+            )
+        {
+            ++sprite_texture->sprite_count;
+            return i;
+        }
+    }
+
+    if (index == sprite_system->textures.cur_element_count)
+    {
+        lna_assert(sprite_system->textures.cur_element_count < sprite_system->textures.max_element_count)
+        ++sprite_system->textures.cur_element_count;
+    }
+
+    lna_sprite_texture_t* sprite_texture = &sprite_system->textures.elements[index];
+    sprite_texture->texture         = texture;
+    sprite_texture->texture_handle  = texture->handle;
+    sprite_texture->sprite_count    = 1;
+    lna_sprite_create_descriptor_sets(
+        sprite_system,
+        texture,
+        sprite_texture->descriptor_sets
+        );
+    return index;
+}
 
+//! the entry of the last sprite using a texture is released, its sets are
+//! freed when the frames in flight are done with them.
+static void lna_sprite_system_release_texture_index(
+    lna_sprite_system_t* sprite_system,
+    uint32_t texture_index
+    )
+{
+    lna_assert(sprite_system)
+    lna_assert(texture_index < sprite_system->textures.cur_element_count)
+
+    lna_sprite_texture_t* sprite_texture = &sprite_system->textures.elements[texture_index];
+    lna_assert(sprite_texture->texture)
+    lna_assert(sprite_texture->sprite_count > 0)
+
+    if (--sprite_texture->sprite_count > 0)
+    {
+        return;
+    }
+    lna_vulkan_renderer_push_descriptor_sets_deletion(
+        sprite_system->renderer,
+        sprite_system->descriptor_pool,
+        sprite_texture->descriptor_sets,
+        sprite_system->renderer->frame_in_flight_count
+        );
+    memset(
+        sprite_texture,
+        0,
+        sizeof(lna_sprite_texture_t)
+        );
+
+    //! the released entries at the end are not visited by the lookups and the sort
+    while (
+        sprite_system->textures.cur_element_count > 0
+        && sprite_system->textures.elements[sprite_system->textures.cur_element_count - 1].texture == NULL
+        )
+    {
+        --sprite_system->textures.cur_element_count;
+    }
+}
+
+static void lna_sprite_system_sort_sprites(
+    lna_sprite_system_t* sprite_system
+    )
+{
+    lna_assert(sprite_system)
+    lna_assert(sprite_system->sorted_sprite_indices)
+    lna_assert(sprite_system->texture_sprite_counts)
+
+    //! counting sort on the texture index: stable, so sprites using the same
+    //! texture keep their order in the sprite pool.
+    uint32_t* counts = sprite_system->texture_sprite_counts;
+    memset(
+        counts,
+        0,
+        sizeof(uint32_t) * sprite_system->textures.cur_element_count
+        );
+    for (uint32_t i = 0; i < sprite_system->sprites.cur_element_count; ++i)
+    {
+        const lna_sprite_t* sprite = lna_object_pool_element(&sprite_system->sprites, i);
+        ++counts[sprite->texture_index];
+    }
+    uint32_t first = 0;
+    for (uint32_t i = 0; i < sprite_system->textures.cur_element_count; ++i)
+    {
+        const uint32_t count = counts[i];
+        counts[i] = first;
+        first += count;
+    }
     for (uint32_t i = 0; i < sprite_system->sprites.cur_element_count; ++i)
     {
-        lna_sprite_t* sprite = &sprite_system->sprites.elements[i];
-        lna_assert(sprite->mvp_uniform_buffers.elements)
-        lna_assert(sprite->mvp_uniform_buffers_memory.elements)
+        const lna_sprite_t* sprite = lna_object_pool_element(&sprite_system->sprites, i);
+        sprite_system->sorted_sprite_indices[counts[sprite->texture_index]++] = i;
+    }
+    sprite_system->sorted_sprite_dirty = false;
+}
+
+static void lna_sprite_transform_vertices(
+    const lna_sprite_t* sprite,
+    lna_sprite_vertex_t* vertices
+    )
+{
+    lna_assert(sprite)
+    lna_assert(sprite->model_matrix)
+    lna_assert(vertices)
+
+    const float (*m)[4] = sprite->model_matrix->values;
+    const lna_vec4_t tint = sprite->tint ? *sprite->tint : (lna_vec4_t){ 1.0f, 1.0f, 1.0f, 1.0f };
+    for (uint32_t i = 0; i < LNA_SPRITE_VERTEX_COUNT; ++i)
+    {
+        const lna_sprite_vertex_t*  src = &sprite->local_vertices[i];
+        lna_sprite_vertex_t*        dst = &vertices[i];
+        const float x = src->position.x;
+        const float y = src->position.y;
+        const float z = src->position.z;
+        dst->position.x = m[0][0] * x + m[1][0] * y + m[2][0] * z + m[3][0];
+        dst->position.y = m[0][1] * x + m[1][1] * y + m[2][1] * z + m[3][1];
+        dst->position.z = m[0][2] * x + m[1][2] * y + m[2][2] * z + m[3][2];
+        dst->uv         = src->uv;
+        dst->color.r    = src->color.r * tint.r;
+        dst->color.g    = src->color.g * tint.g;
+        dst->color.b    = src->color.b * tint.b;
+        dst->color.a    = src->color.a * tint.a;
+    }
+}
+
+//! called by the renderer record jobs for the sorted sprites [begin, end[,
+//! sorted by lna_sprite_system_draw. Each range has its own vertex data.
+static void lna_sprite_system_record_batched(void* owner, VkCommandBuffer command_buffer, uint32_t begin, uint32_t end)
+{
+    lna_assert(owner)
+    lna_sprite_system_t* sprite_system = (lna_sprite_system_t*)owner;
+    lna_assert(sprite_system->batch_index_buffer)
+    lna_assert(!sprite_system->sorted_sprite_dirty)
+    lna_assert(command_buffer)
+
+    lna_renderer_t* renderer = sprite_system->renderer;
+    lna_assert(renderer)
+
+    vkCmdBindPipeline(
+        command_buffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        sprite_system->pipeline
+        );
+
+    VkBuffer        vertex_buffer;
+    VkDeviceSize    vertex_buffer_offset;
+    lna_sprite_vertex_t* vertices = lna_renderer_reserve_vertex_data(
+        renderer,
+        sizeof(lna_sprite_vertex_t) * LNA_SPRITE_VERTEX_COUNT * (end - begin),
+        &vertex_buffer,
+        &vertex_buffer_offset
+        );
+
+    vkCmdBindVertexBuffers(
+        command_buffer,
+        0,
+        1,
+        &vertex_buffer,
+        &vertex_buffer_offset
+        );
+    vkCmdBindIndexBuffer(
+        command_buffer,
+        sprite_system->batch_index_buffer,
+        0,
+        VK_INDEX_TYPE_UINT32
+        );
+
+    //! a batch is a run of sorted sprites sharing the same texture and view.
+    const lna_renderer_view_t* bound_view = NULL;
+    uint32_t first_batch_sprite = begin;
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        const lna_sprite_t* sprite = lna_object_pool_element(&sprite_system->sprites, sprite_system->sorted_sprite_indices[i]);
+        lna_sprite_transform_vertices(
+            sprite,
+            &vertices[(i - begin) * LNA_SPRITE_VERTEX_COUNT]
+            );
 
-        for (size_t j = 0; j < sprite->mvp_uniform_buffers.count; ++j)
+        const lna_sprite_t* next_sprite = (i + 1 < end) ? lna_object_pool_element(&sprite_system->sprites, sprite_system->sorted_sprite_indices[i + 1]) : NULL;
+        if (
+            next_sprite
+            && next_sprite->texture_index == sprite->texture_index
+            && next_sprite->view == sprite->view
+            )
         {
-            vkDestroyBuffer(
-                renderer->device,
-                sprite->mvp_uniform_buffers.elements[j],
-                NULL
+            continue;
+        }
+
+        lna_assert(sprite->view)
+
+        if (sprite->view != bound_view)
+        {
+            lna_vulkan_renderer_bind_view(
+                renderer,
+                command_buffer,
+                sprite_system->pipeline_layout,
+                sprite->view
                 );
+            bound_view = sprite->view;
         }
-        for (size_t j = 0; j < sprite->mvp_uniform_buffers.count; ++j)
+        vkCmdBindDescriptorSets(
+            command_buffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            sprite_system->pipeline_layout,
+            1,
+            1,
+            &sprite_system->textures.elements[sprite->texture_index].descriptor_sets[renderer->curr_frame],
+            0,
+            NULL
+            );
+        vkCmdDrawIndexed(
+            command_buffer,
+            (i + 1 - first_batch_sprite) * LNA_SPRITE_INDEX_COUNT,
+            1,
+            (first_batch_sprite - begin) * LNA_SPRITE_INDEX_COUNT,
+            0,
+            0
+            );
+        first_batch_sprite = i + 1;
+    }
+}
+
+//! called by the renderer record jobs, the sprites must not change until the end of the frame.
+static void lna_sprite_system_record(void* owner, VkCommandBuffer command_buffer, uint32_t begin, uint32_t end)
+{
+    lna_assert(owner)
+    lna_sprite_system_t* sprite_system = (lna_sprite_system_t*)owner;
+    lna_renderer_t* renderer = sprite_system->renderer;
+    lna_assert(renderer)
+
+    vkCmdBindPipeline(
+        command_buffer,
+        VK_PIPELINE_BIND_POINT_GRAPHICS,
+        sprite_system->pipeline
+        );
+    const lna_renderer_view_t* bound_view = NULL;
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        lna_sprite_t* sprite = lna_object_pool_element(&sprite_system->sprites, i);
+        lna_assert(sprite->model_matrix)
+        lna_assert(sprite->view)
+
+        if (sprite->view != bound_view)
         {
-            vkFreeMemory(
-                renderer->device,
-                sprite->mvp_uniform_buffers_memory.elements[j],
-                NULL
+            lna_vulkan_renderer_bind_view(
+                renderer,
+                command_buffer,
+                sprite_system->pipeline_layout,
+                sprite->view
                 );
+            bound_view = sprite->view;
         }
-        sprite->mvp_uniform_buffers.count           = 0;
-        sprite->mvp_uniform_buffers.elements        = NULL;
-        sprite->mvp_uniform_buffers_memory.count    = 0;
-        sprite->mvp_uniform_buffers_memory.elements = NULL;
-        //! NOTE: no need to explicity clean up vulkan descriptor sets objects
-        //! because it is done when the vulkan descriptor pool is destroyed.
-        //! we just have to reset the array and wait for filling it again.
-        //! the memory pool where we reserved memory for descriptor_sets has already
-        //! been reset by the vulkan renderer backend.
-        sprite->descriptor_sets.count       = 0;
-        sprite->descriptor_sets.elements    = 0;
+        vkCmdBindDescriptorSets(
+            command_buffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            sprite_system->pipeline_layout,
+            1,
+            1,
+            &sprite->descriptor_sets[renderer->curr_frame],
+            0,
+            NULL
+            );
+        const lna_vulkan_object_push_constants_t push_constants =
+        {
+            .model  = *sprite->model_matrix,
+            .tint   = sprite->tint ? *sprite->tint : (lna_vec4_t){ 1.0f, 1.0f, 1.0f, 1.0f },
+        };
+        vkCmdPushConstants(
+            command_buffer,
+            sprite_system->pipeline_layout,
+            VK_SHADER_STAGE_VERTEX_BIT,
+            0,
+            sizeof(push_constants),
+            &push_constants
+            );
+        const VkBuffer vertex_buffers[] =
+        {
+            sprite->vertex_buffer
+        };
+        VkDeviceSize offsets[] = {0};
+        vkCmdBindVertexBuffers(
+            command_buffer,
+            0,
+            1,
+            vertex_buffers,
+            offsets
+            );
+        vkCmdBindIndexBuffer(
+            command_buffer,
+            sprite->index_buffer,
+            0,
+            VK_INDEX_TYPE_UINT32
+            );
+        vkCmdDrawIndexed(
+            command_buffer,
+            sprite->index_count,
+            1,
+            0,
+            0,
+            0
+            );
     }
-    vkDestroyDescriptorPool(
+}
+
+static void lna_sprite_system_on_swap_chain_cleanup(void* owner)
+{
+    lna_assert(owner)
+    lna_sprite_system_t*    sprite_system   = (lna_sprite_system_t*)owner;
+    lna_renderer_t*         renderer        = sprite_system->renderer;
+    lna_assert(renderer)
+
+    vkDestroyPipeline(
         renderer->device,
-        sprite_system->descriptor_pool,
+        sprite_system->pipeline,
+        NULL
+        );
+    vkDestroyPipelineLayout(
+        renderer->device,
+        sprite_system->pipeline_layout,
         NULL
         );
 }
@@ -522,21 +784,6 @@ static void lna_sprite_system_on_swap_chain_recreate(void *owner)
         sprite_system,
         renderer
         );
-    lna_sprite_system_create_descriptor_pool(
-        sprite_system
-        );
-
-    for (uint32_t i = 0; i < sprite_system->sprites.cur_element_count; ++i)
-    {
-        lna_sprite_create_uniform_buffer(
-            &sprite_system->sprites.elements[i],
-            renderer
-            );
-        lna_sprite_create_descriptor_sets(
-            &sprite_system->sprites.elements[i],
-            sprite_system
-            );
-    }
 }
 
 void lna_sprite_system_init(lna_sprite_system_t* sprite_system, const lna_sprite_system_config_t* config)
@@ -550,6 +797,7 @@ void lna_sprite_system_init(lna_sprite_system_t* sprite_system, const lna_sprite
     lna_assert(sprite_system->descriptor_set_layout == VK_NULL_HANDLE)
     lna_assert(sprite_system->pipeline == VK_NULL_HANDLE)
     lna_assert(sprite_system->pipeline_layout == VK_NULL_HANDLE)
+    lna_assert(sprite_system->batch_index_buffer == VK_NULL_HANDLE)
     lna_assert(config)
     lna_assert(config->renderer)
     lna_assert(config->renderer->device)
@@ -564,23 +812,35 @@ void lna_sprite_system_init(lna_sprite_system_t* sprite_system, const lna_sprite
         (void*)sprite_system
         );
 
-    sprite_system->sprites.max_element_count    = config->max_sprite_count;
-    sprite_system->sprites.elements             = lna_memory_pool_reserve(
+    lna_object_pool_init(
+        &sprite_system->sprites,
         config->memory_pool,
-        sizeof(lna_sprite_t) * config->max_sprite_count
+        sizeof(lna_sprite_t),
+        config->max_sprite_count
         );
+    sprite_system->batched                      = config->batched;
+    if (sprite_system->batched)
+    {
+        sprite_system->textures.max_element_count   = config->max_sprite_count;
+        sprite_system->textures.elements            = lna_memory_pool_reserve(
+            config->memory_pool,
+            sizeof(lna_sprite_texture_t) * config->max_sprite_count
+            );
+        sprite_system->sorted_sprite_indices        = lna_memory_pool_reserve(
+            config->memory_pool,
+            sizeof(uint32_t) * config->max_sprite_count
+            );
+        sprite_system->texture_sprite_counts        = lna_memory_pool_reserve(
+            config->memory_pool,
+            sizeof(uint32_t) * config->max_sprite_count
+            );
+    }
 
     //! DESCRIPTOR SET LAYOUT
 
+    //! the model matrix is a push constant
     const VkDescriptorSetLayoutBinding bindings[] =
     {
-        {
-            .binding            = 0,
-            .descriptorCount    = 1,
-            .descriptorType     = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
-            .stageFlags         = VK_SHADER_STAGE_VERTEX_BIT,
-            .pImmutableSamplers = NULL,
-        },
         {
             .binding            = 1,
             .descriptorCount    = 1,
@@ -616,44 +876,46 @@ void lna_sprite_system_init(lna_sprite_system_t* sprite_system, const lna_sprite
     lna_sprite_system_create_descriptor_pool(
         sprite_system
         );
+
+    //! BATCH INDEX BUFFER
+
+    if (sprite_system->batched)
+    {
+        lna_sprite_system_create_batch_index_buffer(
+            sprite_system
+            );
+    }
 }
 
-lna_sprite_t* lna_sprite_system_new_sprite(lna_sprite_system_t* sprite_system, const lna_sprite_config_t* config)
+lna_handle_t lna_sprite_system_new_sprite(lna_sprite_system_t* sprite_system, const lna_sprite_config_t* config)
 {
     lna_assert(sprite_system)
     lna_assert(config)
     lna_assert(sprite_system->sprites.elements)
     lna_assert(sprite_system->sprites.cur_element_count < sprite_system->sprites.max_element_count)
 
-    lna_sprite_t* sprite = &sprite_system->sprites.elements[sprite_system->sprites.cur_element_count++];
+    lna_handle_t    handle;
+    lna_sprite_t*   sprite  = lna_object_pool_new(&sprite_system->sprites, &handle);
 
     lna_assert(sprite)
     lna_assert(sprite->texture == NULL)
     lna_assert(sprite->vertex_buffer == VK_NULL_HANDLE)
-    lna_assert(sprite->vertex_buffer_memory == VK_NULL_HANDLE)
+    lna_assert(sprite->vertex_buffer_allocation.memory == VK_NULL_HANDLE)
     lna_assert(sprite->index_buffer == VK_NULL_HANDLE)
-    lna_assert(sprite->index_buffer_memory == VK_NULL_HANDLE)
-    lna_assert(sprite->mvp_uniform_buffers.count == 0)
-    lna_assert(sprite->mvp_uniform_buffers.elements == 0)
-    lna_assert(sprite->mvp_uniform_buffers_memory.count == 0)
-    lna_assert(sprite->mvp_uniform_buffers_memory.elements == NULL)
-    lna_assert(sprite->descriptor_sets.count == 0)
-    lna_assert(sprite->descriptor_sets.elements == 0)
+    lna_assert(sprite->index_buffer_allocation.memory == VK_NULL_HANDLE)
     lna_assert(sprite->model_matrix == NULL)
-    lna_assert(sprite->view_matrix == NULL)
-    lna_assert(sprite->projection_matrix == NULL)
+    lna_assert(sprite->view == NULL)
     lna_assert(config)
     lna_assert(config->model_matrix)
-    lna_assert(config->view_matrix)
-    lna_assert(config->projection_matrix)
+    lna_assert(config->view)
     lna_assert(sprite_system)
 
     lna_renderer_t* renderer = sprite_system->renderer;
     lna_assert(renderer)
 
     sprite->model_matrix        = config->model_matrix;
-    sprite->view_matrix         = config->view_matrix;
-    sprite->projection_matrix   = config->projection_matrix;
+    sprite->tint                = config->tint;
+    sprite->view                = config->view;
     sprite->texture             = config->texture;
 
     //! VERTEX BUFFER PART
@@ -753,242 +1015,159 @@ lna_sprite_t* lna_sprite_system_new_sprite(lna_sprite_system_t* sprite_system, c
                 },
             },
         };
-
-        size_t vertex_buffer_size = sizeof(vertices);
-        
-        VkBuffer staging_buffer;
-        VkDeviceMemory staging_buffer_memory;
-        lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
-            vertex_buffer_size,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            &staging_buffer,
-            &staging_buffer_memory
-            );
-        void *vertices_data;
-        lna_vulkan_check(
-            vkMapMemory(
-                renderer->device,
-                staging_buffer_memory,
-                0,
-                vertex_buffer_size,
-                0,
-                &vertices_data
-                )
-            );
         memcpy(
-            vertices_data,
+            sprite->local_vertices,
             vertices,
-            vertex_buffer_size
-            );
-        vkUnmapMemory(
-            renderer->device,
-            staging_buffer_memory
+            sizeof(vertices)
             );
+    }
+
+    //! batched sprites are transformed and written in the frame vertex buffer
+    //! when the sprite system is drawn.
+
+    if (sprite_system->batched)
+    {
+        sprite->texture_index               = lna_sprite_system_acquire_texture_index(sprite_system, sprite);
+        sprite->index_count                 = LNA_SPRITE_INDEX_COUNT;
+        sprite_system->sorted_sprite_dirty  = true;
+        return handle;
+    }
+
+    {
+        const size_t vertex_buffer_size = sizeof(sprite->local_vertices);
+
         lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
+            &renderer->memory_allocator,
             vertex_buffer_size,
             VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             &sprite->vertex_buffer,
-            &sprite->vertex_buffer_memory
+            &sprite->vertex_buffer_allocation
             );
-        lna_vulkan_copy_buffer(
-            renderer->device,
-            renderer->command_pool,
-            renderer->graphics_queue,
-            staging_buffer,
-            sprite->vertex_buffer,
+        memcpy(
+            lna_vulkan_upload_manager_upload_buffer(
+                &renderer->upload_manager,
+                sprite->vertex_buffer,
+                0,
+                vertex_buffer_size,
+                NULL
+                ),
+            sprite->local_vertices,
             vertex_buffer_size
             );
-        vkDestroyBuffer(
-            renderer->device,
-            staging_buffer,
-            NULL
-            );
-        vkFreeMemory(
-            renderer->device,
-            staging_buffer_memory,
-            NULL
-            );
     }
 
     //! INDEX BUFFER PART
 
     {
-        const uint32_t indices[] = { 0, 1, 2, 2, 3, 0 };
-        const size_t index_buffer_size = sizeof(indices);
+        const size_t index_buffer_size = sizeof(LNA_SPRITE_INDICES);
 
-        sprite->index_count = (uint32_t)(sizeof(indices) / sizeof(indices[0]));
+        sprite->index_count = LNA_SPRITE_INDEX_COUNT;
 
-        VkBuffer staging_buffer;
-        VkDeviceMemory staging_buffer_memory;
-        lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
-            index_buffer_size,
-            VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-            &staging_buffer,
-            &staging_buffer_memory
-            );
-        void *indices_data;
-        lna_vulkan_check(
-            vkMapMemory(
-                renderer->device,
-                staging_buffer_memory,
-                0,
-                index_buffer_size,
-                0,
-                &indices_data
-                )
-            );
-        memcpy(
-            indices_data,
-            indices,
-            index_buffer_size
-            );
-        vkUnmapMemory(
-            renderer->device,
-            staging_buffer_memory
-            );
         lna_vulkan_create_buffer(
-            renderer->device,
-            renderer->physical_device,
+            &renderer->memory_allocator,
             index_buffer_size,
             VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             &sprite->index_buffer,
-            &sprite->index_buffer_memory
+            &sprite->index_buffer_allocation
             );
-        lna_vulkan_copy_buffer(
-            renderer->device,
-            renderer->command_pool,
-            renderer->graphics_queue,
-            staging_buffer,
-            sprite->index_buffer,
+        memcpy(
+            lna_vulkan_upload_manager_upload_buffer(
+                &renderer->upload_manager,
+                sprite->index_buffer,
+                0,
+                index_buffer_size,
+                NULL
+                ),
+            LNA_SPRITE_INDICES,
             index_buffer_size
             );
-        vkDestroyBuffer(
-            renderer->device,
-            staging_buffer,
-            NULL
-            );
-        vkFreeMemory(
-            renderer->device,
-            staging_buffer_memory,
-            NULL
-            );
     }
 
-    //! UNIFORM BUFFER
-
-    lna_sprite_create_uniform_buffer(
-        sprite,
-        renderer
-        );
-
     //! DESCRIPTOR SETS
 
     lna_sprite_create_descriptor_sets(
-        sprite,
-        sprite_system
+        sprite_system,
+        sprite->texture,
+        sprite->descriptor_sets
         );
 
-    return sprite;
+    return handle;
 }
 
-void lna_sprite_system_draw(lna_sprite_system_t* sprite_system)
+void lna_sprite_system_delete_sprite(lna_sprite_system_t* sprite_system, lna_handle_t sprite_handle)
 {
     lna_assert(sprite_system)
+    lna_assert(sprite_system->renderer)
 
-    lna_renderer_t* renderer = sprite_system->renderer;
-    lna_assert(renderer)
-    lna_assert(renderer->command_buffers.elements)
-    lna_assert(renderer->command_buffers.count > renderer->image_index)
-
-    VkCommandBuffer command_buffer = renderer->command_buffers.elements[renderer->image_index];
+    lna_sprite_t* sprite = lna_object_pool_get(&sprite_system->sprites, sprite_handle);
+    lna_assert(sprite)
 
-    vkCmdBindPipeline(
-        command_buffer,
-        VK_PIPELINE_BIND_POINT_GRAPHICS,
-        sprite_system->pipeline
-        );
-    for (uint32_t i = 0; i < sprite_system->sprites.cur_element_count; ++i)
+    if (sprite_system->batched)
     {
-        lna_sprite_t* sprite = &sprite_system->sprites.elements[i];
-        lna_assert(sprite->model_matrix)
-        lna_assert(sprite->view_matrix)
-        lna_assert(sprite->projection_matrix)
-        lna_assert(sprite->mvp_uniform_buffers_memory.count > renderer->image_index)
-        lna_assert(sprite->descriptor_sets.count > renderer->image_index)
-
-        const lna_sprite_uniform_t ubo =
-        {
-            .model      = *sprite->model_matrix,
-            .view       = *sprite->view_matrix,
-            .projection = *sprite->projection_matrix,
-        };
-        void *data;
-        lna_vulkan_check(
-            vkMapMemory(
-                renderer->device,
-                sprite->mvp_uniform_buffers_memory.elements[renderer->image_index],
-                0,
-                sizeof(ubo),
-                0,
-                &data
-                )
+        //! the descriptor sets are shared by the sprites using the texture
+        lna_sprite_system_release_texture_index(
+            sprite_system,
+            sprite->texture_index
             );
-        memcpy(
-            data,
-            &ubo,
-            sizeof(ubo));
-        vkUnmapMemory(
-            renderer->device,
-            sprite->mvp_uniform_buffers_memory.elements[renderer->image_index]
-            );
-
-        vkCmdBindDescriptorSets(
-            command_buffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            sprite_system->pipeline_layout,
-            0,
-            1,
-            &sprite->descriptor_sets.elements[renderer->image_index],
-            0,
-            NULL
+        sprite_system->sorted_sprite_dirty = true;
+    }
+    else
+    {
+        lna_vulkan_renderer_push_buffer_deletion(
+            sprite_system->renderer,
+            sprite->index_buffer,
+            &sprite->index_buffer_allocation
             );
-        const VkBuffer vertex_buffers[] =
-        {
-            sprite->vertex_buffer
-        };
-        VkDeviceSize offsets[] = {0};
-        vkCmdBindVertexBuffers(
-            command_buffer,
-            0,
-            1,
-            vertex_buffers,
-            offsets
+        lna_vulkan_renderer_push_buffer_deletion(
+            sprite_system->renderer,
+            sprite->vertex_buffer,
+            &sprite->vertex_buffer_allocation
             );
-        vkCmdBindIndexBuffer(
-            command_buffer,
-            sprite->index_buffer,
-            0,
-            VK_INDEX_TYPE_UINT32
+        lna_vulkan_renderer_push_descriptor_sets_deletion(
+            sprite_system->renderer,
+            sprite_system->descriptor_pool,
+            sprite->descriptor_sets,
+            sprite_system->renderer->frame_in_flight_count
             );
-        vkCmdDrawIndexed(
-            command_buffer,
-            sprite->index_count,
-            1,
-            0,
-            0,
-            0
+    }
+    lna_object_pool_delete(
+        &sprite_system->sprites,
+        sprite_handle
+        );
+}
+
+void lna_sprite_system_draw(lna_sprite_system_t* sprite_system)
+{
+    lna_assert(sprite_system)
+
+    lna_renderer_t* renderer = sprite_system->renderer;
+    lna_assert(renderer)
+
+    if (sprite_system->batched)
+    {
+        //! the sort is done before the record jobs read the sorted sprites
+        if (sprite_system->sprites.cur_element_count > 0 && sprite_system->sorted_sprite_dirty)
+        {
+            lna_sprite_system_sort_sprites(sprite_system);
+        }
+        lna_vulkan_renderer_record(
+            renderer,
+            lna_sprite_system_record_batched,
+            sprite_system,
+            sprite_system->sprites.cur_element_count,
+            LNA_SPRITE_SYSTEM_BATCHED_RECORD_RANGE_SIZE
             );
+        return;
     }
+    lna_vulkan_renderer_record(
+        renderer,
+        lna_sprite_system_record,
+        sprite_system,
+        sprite_system->sprites.cur_element_count,
+        LNA_SPRITE_SYSTEM_RECORD_RANGE_SIZE
+        );
 }
 
 void lna_sprite_system_release(lna_sprite_system_t* sprite_system)
@@ -998,34 +1177,50 @@ void lna_sprite_system_release(lna_sprite_system_t* sprite_system)
     lna_assert(sprite_system->renderer)
     lna_assert(sprite_system->renderer->device)
 
+    vkDestroyDescriptorPool(
+        sprite_system->renderer->device,
+        sprite_system->descriptor_pool,
+        NULL
+        );
     vkDestroyDescriptorSetLayout(
         sprite_system->renderer->device,
         sprite_system->descriptor_set_layout,
         NULL
         );
+    if (sprite_system->batched)
+    {
+        vkDestroyBuffer(
+            sprite_system->renderer->device,
+            sprite_system->batch_index_buffer,
+            NULL
+            );
+        lna_vulkan_memory_allocator_free(
+            &sprite_system->renderer->memory_allocator,
+            &sprite_system->batch_index_buffer_allocation
+            );
+        return;
+    }
     for (uint32_t i = 0; i < sprite_system->sprites.cur_element_count; ++i)
     {
-        lna_sprite_t* sprite = &sprite_system->sprites.elements[i];
+        lna_sprite_t* sprite = lna_object_pool_element(&sprite_system->sprites, i);
 
         vkDestroyBuffer(
             sprite_system->renderer->device,
             sprite->index_buffer,
             NULL
             );
-        vkFreeMemory(
-            sprite_system->renderer->device,
-            sprite->index_buffer_memory,
-            NULL
+        lna_vulkan_memory_allocator_free(
+            &sprite_system->renderer->memory_allocator,
+            &sprite->index_buffer_allocation
             );
         vkDestroyBuffer(
             sprite_system->renderer->device,
             sprite->vertex_buffer,
             NULL
             );
-        vkFreeMemory(
-            sprite_system->renderer->device,
-            sprite->vertex_buffer_memory,
-            NULL
+        lna_vulkan_memory_allocator_free(
+            &sprite_system->renderer->memory_allocator,
+            &sprite->vertex_buffer_allocation
             );
     }
 }
@@ -1,42 +1,74 @@
 #ifndef LNA_BACKENDS_VULKAN_LNA_SPRITE_VULKAN_H
 #define LNA_BACKENDS_VULKAN_LNA_SPRITE_VULKAN_H
 
+#include <stdbool.h>
 #include "backends/vulkan/lna_renderer_vulkan.h"
+#include "core/lna_object_pool.h"
+#include "maths/lna_vec2.h"
+#include "maths/lna_vec4.h"
 
 typedef struct lna_texture_s    lna_texture_t;
 typedef struct lna_mat4_s       lna_mat4_t;
 
+#define LNA_SPRITE_VERTEX_COUNT 4
+#define LNA_SPRITE_INDEX_COUNT  6
+
+typedef struct lna_sprite_vertex_s
+{
+    lna_vec3_t                          position;
+    lna_vec2_t                          uv;
+    lna_vec4_t                          color;
+} lna_sprite_vertex_t;
+
 typedef struct lna_sprite_s
 {
     const lna_texture_t*                texture;
-    VkBuffer                            vertex_buffer;
-    VkDeviceMemory                      vertex_buffer_memory;
-    VkBuffer                            index_buffer;
-    VkDeviceMemory                      index_buffer_memory;
-    lna_vulkan_buffer_array_t           mvp_uniform_buffers;
-    lna_vulkan_device_memory_array_t    mvp_uniform_buffers_memory;
-    lna_vulkan_descriptor_set_array_t   descriptor_sets;
+    VkBuffer                            vertex_buffer;      //! VK_NULL_HANDLE for batched sprites
+    lna_vulkan_memory_allocation_t      vertex_buffer_allocation;
+    VkBuffer                            index_buffer;       //! VK_NULL_HANDLE for batched sprites
+    lna_vulkan_memory_allocation_t      index_buffer_allocation;
+    VkDescriptorSet                     descriptor_sets[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    lna_sprite_vertex_t                 local_vertices[LNA_SPRITE_VERTEX_COUNT];
+    uint32_t                            texture_index;      //! index in sprite_system->textures for batched sprites
     const lna_mat4_t*                   model_matrix;
-    const lna_mat4_t*                   view_matrix;
-    const lna_mat4_t*                   projection_matrix;
+    const lna_vec4_t*                   tint;               //! NULL for white
+    const lna_renderer_view_t*          view;
     uint32_t                            index_count;
 } lna_sprite_t;
 
-typedef struct lna_sprite_vec_s
+//! descriptor sets shared by all the batched sprites using the same texture.
+//! The entry is released when its last sprite is deleted, it can then be
+//! reused by another texture.
+typedef struct lna_sprite_texture_s
+{
+    const lna_texture_t*                texture;            //! NULL for a released entry
+    lna_handle_t                        texture_handle;     //! the address of a deleted texture can be reused by a new one
+    uint32_t                            sprite_count;
+    VkDescriptorSet                     descriptor_sets[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+} lna_sprite_texture_t;
+
+typedef struct lna_sprite_texture_vec_s
 {
     uint32_t                            cur_element_count;
     uint32_t                            max_element_count;
-    lna_sprite_t*                       elements;
-} lna_sprite_vec_t;
+    lna_sprite_texture_t*               elements;
+} lna_sprite_texture_vec_t;
 
 typedef struct lna_sprite_system_s
 {
     lna_renderer_t*                     renderer;
-    lna_sprite_vec_t                    sprites;
+    lna_object_pool_t                   sprites;                //! of lna_sprite_t
     VkDescriptorSetLayout               descriptor_set_layout;
     VkDescriptorPool                    descriptor_pool;
     VkPipelineLayout                    pipeline_layout;
     VkPipeline                          pipeline;
+    bool                                batched;
+    lna_sprite_texture_vec_t            textures;               //! batched mode only, cur_element_count is the end of the last used entry
+    uint32_t*                           sorted_sprite_indices;  //! batched mode only, sprite dense indices in the pool sorted by texture index
+    uint32_t*                           texture_sprite_counts;  //! batched mode only, used to sort the sprites
+    bool                                sorted_sprite_dirty;
+    VkBuffer                            batch_index_buffer;     //! batched mode only, indices of max_sprite_count quads
+    lna_vulkan_memory_allocation_t      batch_index_buffer_allocation;
 } lna_sprite_system_t;
 
 #endif
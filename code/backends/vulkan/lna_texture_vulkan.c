@@ -63,7 +63,7 @@ static void lna_texture_init(lna_texture_t* texture, const lna_texture_config_t*
 {
     lna_assert(texture)
     lna_assert(texture->image == VK_NULL_HANDLE)
-    lna_assert(texture->image_memory == VK_NULL_HANDLE)
+    lna_assert(texture->image_allocation.memory == VK_NULL_HANDLE)
     lna_assert(texture->image_view == VK_NULL_HANDLE)
     lna_assert(texture->image_sampler == VK_NULL_HANDLE)
     lna_assert(config)
@@ -97,48 +97,8 @@ static void lna_texture_init(lna_texture_t* texture, const lna_texture_config_t*
     lna_assert(texture_pixels)
     lna_assert(texture_size > 0)
 
-    VkBuffer        staging_buffer;
-    VkDeviceMemory  staging_buffer_memory;
-
-    lna_vulkan_create_buffer(
-        renderer->device,
-        renderer->physical_device,
-        texture_size,
-        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-        &staging_buffer,
-        &staging_buffer_memory
-        );
-
-    void* data;
-    lna_vulkan_check(
-        vkMapMemory(
-            renderer->device,
-            staging_buffer_memory,
-            0,
-            texture_size,
-            0,
-            &data
-            )
-        );
-    memcpy(
-        data,
-        texture_pixels,
-        (size_t)texture_size
-        );
-    vkUnmapMemory(
-        renderer->device,
-        staging_buffer_memory
-        );
-
-    if (config->filename)
-    {
-        stbi_image_free(texture_pixels);
-    }
-
     lna_vulkan_create_image(
-        renderer->device,
-        renderer->physical_device,
+        &renderer->memory_allocator,
         (uint32_t)texture_width,
         (uint32_t)texture_height,
         lna_texture_format_to_vulkan(config->format),
@@ -146,44 +106,26 @@ static void lna_texture_init(lna_texture_t* texture, const lna_texture_config_t*
         VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
         &texture->image,
-        &texture->image_memory
+        &texture->image_allocation
         );
-    lna_vulkan_transition_image_layout(
-        renderer->device,
-        renderer->command_pool,
-        renderer->graphics_queue,
-        texture->image,
-        VK_IMAGE_LAYOUT_UNDEFINED,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL
-        );
-    lna_vulkan_copy_buffer_to_image(
-        renderer->device,
-        renderer->command_pool,
-        staging_buffer,
-        renderer->graphics_queue,
-        texture->image,
-        (uint32_t)texture_width,
-        (uint32_t)texture_height
-        );
-    lna_vulkan_transition_image_layout(
-        renderer->device,
-        renderer->command_pool,
-        renderer->graphics_queue,
-        texture->image,
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
-        );
-    vkDestroyBuffer(
-        renderer->device,
-        staging_buffer,
-        NULL
-        );
-    vkFreeMemory(
-        renderer->device,
-        staging_buffer_memory,
-        NULL
+    memcpy(
+        lna_vulkan_upload_manager_upload_image(
+            &renderer->upload_manager,
+            texture->image,
+            (uint32_t)texture_width,
+            (uint32_t)texture_height,
+            texture_size,
+            NULL
+            ),
+        texture_pixels,
+        (size_t)texture_size
         );
 
+    if (config->filename)
+    {
+        stbi_image_free(texture_pixels);
+    }
+
     //! IMAGE VIEW PART
 
     texture->image_view = lna_vulkan_create_image_view(
@@ -236,40 +178,39 @@ static void lna_texture_init(lna_texture_t* texture, const lna_texture_config_t*
     texture->atlas_row_count    = config->atlas_row_count;
 }
 
-static void lna_texture_release(lna_texture_t* texture, VkDevice device)
+static void lna_texture_release(lna_texture_t* texture, lna_renderer_t* renderer)
 {
     lna_assert(texture)
     lna_assert(texture->image_sampler)
     lna_assert(texture->image_view)
     lna_assert(texture->image)
-    lna_assert(texture->image_memory)
-    lna_assert(device)
+    lna_assert(texture->image_allocation.memory)
+    lna_assert(renderer)
+    lna_assert(renderer->device)
 
     vkDestroySampler(
-        device,
+        renderer->device,
         texture->image_sampler,
         NULL
         );
     vkDestroyImageView(
-        device,
+        renderer->device,
         texture->image_view,
         NULL
         );
     vkDestroyImage(
-        device,
+        renderer->device,
         texture->image,
         NULL
         );
-    vkFreeMemory(
-        device,
-        texture->image_memory,
-        NULL
+    lna_vulkan_memory_allocator_free(
+        &renderer->memory_allocator,
+        &texture->image_allocation
         );
 
     texture->image_sampler  = VK_NULL_HANDLE;
     texture->image_view     = VK_NULL_HANDLE;
     texture->image          = VK_NULL_HANDLE;
-    texture->image_memory   = VK_NULL_HANDLE;
 }
 
 void lna_texture_system_init(lna_texture_system_t* texture_system, const lna_texture_system_config_t* config)
@@ -283,28 +224,77 @@ void lna_texture_system_init(lna_texture_system_t* texture_system, const lna_tex
     lna_assert(config->memory_pool)
     lna_assert(config->max_texture_count > 0)
 
-    texture_system->renderer                    = config->renderer;
-    texture_system->textures.cur_element_count  = 0;
-    texture_system->textures.max_element_count  = config->max_texture_count;
-    texture_system->textures.elements           = lna_memory_pool_reserve(
+    texture_system->renderer = config->renderer;
+    lna_object_pool_init(
+        &texture_system->textures,
         config->memory_pool,
-        config->max_texture_count * sizeof(lna_texture_t)
+        sizeof(lna_texture_t),
+        config->max_texture_count
         );
 }
 
-lna_texture_t* lna_texture_system_new_texture(lna_texture_system_t* texture_system, const lna_texture_config_t* config)
+lna_handle_t lna_texture_system_new_texture(lna_texture_system_t* texture_system, const lna_texture_config_t* config)
 {
     lna_assert(texture_system)
 
-    lna_texture_t* texture = &texture_system->textures.elements[texture_system->textures.cur_element_count++];
+    lna_handle_t    handle;
+    lna_texture_t*  texture = lna_object_pool_new(&texture_system->textures, &handle);
 
     lna_texture_init(
         texture,
         config,
         texture_system->renderer
         );
+    texture->handle = handle;
+
+    return handle;
+}
+
+lna_texture_t* lna_texture_system_texture(lna_texture_system_t* texture_system, lna_handle_t texture_handle)
+{
+    lna_assert(texture_system)
+
+    return lna_object_pool_get(&texture_system->textures, texture_handle);
+}
+
+void lna_texture_system_delete_texture(lna_texture_system_t* texture_system, lna_handle_t texture_handle)
+{
+    lna_assert(texture_system)
+    lna_assert(texture_system->renderer)
 
-    return texture;
+    lna_texture_t* texture = lna_object_pool_get(&texture_system->textures, texture_handle);
+    lna_assert(texture)
+    lna_assert(texture->image_sampler)
+    lna_assert(texture->image_view)
+    lna_assert(texture->image)
+
+    const lna_vulkan_deletion_t deletions[] =
+    {
+        {
+            .type               = LNA_VULKAN_DELETION_TYPE_SAMPLER,
+            .handle.sampler     = texture->image_sampler,
+        },
+        {
+            .type               = LNA_VULKAN_DELETION_TYPE_IMAGE_VIEW,
+            .handle.image_view  = texture->image_view,
+        },
+        {
+            .type               = LNA_VULKAN_DELETION_TYPE_IMAGE,
+            .handle.image       = texture->image,
+            .allocation         = texture->image_allocation,
+        },
+    };
+    for (uint32_t i = 0; i < (uint32_t)(sizeof(deletions) / sizeof(deletions[0])); ++i)
+    {
+        lna_vulkan_renderer_push_deletion(
+            texture_system->renderer,
+            &deletions[i]
+            );
+    }
+    lna_object_pool_delete(
+        &texture_system->textures,
+        texture_handle
+        );
 }
 
 void lna_texture_system_release(lna_texture_system_t* texture_system)
@@ -315,8 +305,8 @@ void lna_texture_system_release(lna_texture_system_t* texture_system)
     for (uint32_t index = 0; index < texture_system->textures.cur_element_count; ++index)
     {
         lna_texture_release(
-            &texture_system->textures.elements[index],
-            texture_system->renderer->device
+            lna_object_pool_element(&texture_system->textures, index),
+            texture_system->renderer
             );
     }
 }
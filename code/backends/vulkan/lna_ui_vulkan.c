@@ -13,8 +13,7 @@ static void lna_ui_buffer_init(
     const lna_ui_buffer_config_t* config,
     VkDescriptorPool descriptor_pool,
     VkDescriptorSetLayout descriptor_set_layout,
-    VkDevice device,
-    VkPhysicalDevice physical_device
+    VkDevice device
     )
 {
     lna_assert(buffer)
@@ -24,13 +23,7 @@ static void lna_ui_buffer_init(
     lna_assert(buffer->max_index_count == 0)
     lna_assert(buffer->cur_vertex_count == 0)
     lna_assert(buffer->cur_index_count == 0)
-    lna_assert(buffer->vertex_buffer == VK_NULL_HANDLE)
-    lna_assert(buffer->vertex_buffer_memory == VK_NULL_HANDLE)
-    lna_assert(buffer->index_buffer == VK_NULL_HANDLE)
-    lna_assert(buffer->index_buffer_memory == VK_NULL_HANDLE)
     lna_assert(buffer->descriptor_set == VK_NULL_HANDLE)
-    lna_assert(buffer->vertex_data_mapped == NULL)
-    lna_assert(buffer->index_data_mapped == NULL)
     lna_assert(buffer->texture == NULL)
     lna_assert(config)
     lna_assert(config->memory_pool)
@@ -85,180 +78,6 @@ static void lna_ui_buffer_init(
         0,
         NULL
         );
-
-    const VkDeviceSize vertex_buffer_size = buffer->max_vertex_count * sizeof(lna_ui_vertex_t);
-    const VkBufferCreateInfo vertex_buffer_create_info =
-    {
-        .sType  = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .usage  = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-        .size   = vertex_buffer_size,
-    };
-    lna_vulkan_check(
-        vkCreateBuffer(
-            device,
-            &vertex_buffer_create_info,
-            NULL,
-            &buffer->vertex_buffer
-            )
-        );
-
-    VkMemoryRequirements vertex_buffer_memory_requirements;
-    vkGetBufferMemoryRequirements(
-        device,
-        buffer->vertex_buffer,
-        &vertex_buffer_memory_requirements
-        );
-
-    const VkMemoryAllocateInfo vertex_buffer_memory_allocate_info =
-    {
-        .sType              = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize     = vertex_buffer_memory_requirements.size,
-        .memoryTypeIndex    = lna_vulkan_find_memory_type(physical_device, vertex_buffer_memory_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT),
-    };
-    lna_vulkan_check(
-        vkAllocateMemory(
-            device,
-            &vertex_buffer_memory_allocate_info,
-            NULL,
-            &buffer->vertex_buffer_memory
-            )
-        );
-    lna_vulkan_check(
-        vkBindBufferMemory(
-            device,
-            buffer->vertex_buffer,
-            buffer->vertex_buffer_memory,
-            0
-            )
-        );
-    lna_vulkan_check(
-        vkMapMemory(
-            device,
-            buffer->vertex_buffer_memory,
-            0,
-            VK_WHOLE_SIZE,
-            0,
-            &buffer->vertex_data_mapped
-            )
-        );
-
-    const VkDeviceSize index_buffer_size = buffer->max_index_count * sizeof (uint32_t);
-    const VkBufferCreateInfo index_buffer_create_info =
-    {
-        .sType  = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .usage  = VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-        .size   = index_buffer_size,
-    };
-    lna_vulkan_check(
-        vkCreateBuffer(
-            device,
-            &index_buffer_create_info,
-            NULL,
-            &buffer->index_buffer
-            )
-        );
-    VkMemoryRequirements index_buffer_memory_requirements;
-    vkGetBufferMemoryRequirements(
-        device,
-        buffer->index_buffer,
-        &index_buffer_memory_requirements
-        );
-    const VkMemoryAllocateInfo index_buffer_memory_allocate_info =
-    {
-        .sType              = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize     = index_buffer_memory_requirements.size,
-        .memoryTypeIndex    = lna_vulkan_find_memory_type(physical_device, index_buffer_memory_requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT),
-    };
-    lna_vulkan_check(
-        vkAllocateMemory(
-            device,
-            &index_buffer_memory_allocate_info,
-            NULL,
-            &buffer->index_buffer_memory
-            )
-        );
-    lna_vulkan_check(
-        vkBindBufferMemory(
-            device,
-            buffer->index_buffer,
-            buffer->index_buffer_memory,
-            0
-            )
-        );
-    lna_vulkan_check(
-        vkMapMemory(
-            device,
-            buffer->index_buffer_memory,
-            0,
-            VK_WHOLE_SIZE,
-            0,
-            &buffer->index_data_mapped
-            )
-        );
-
-    {
-        lna_ui_vertex_t* vertex_dst = (lna_ui_vertex_t*)buffer->vertex_data_mapped;
-        memcpy(
-            vertex_dst,
-            buffer->vertices,
-            buffer->max_vertex_count * sizeof(lna_ui_vertex_t)
-            );
-        const VkMappedMemoryRange mapped_memory_range =
-        {
-            .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-            .memory = buffer->vertex_buffer_memory,
-            .offset = 0,
-            .size   = vertex_buffer_size,
-        };
-        lna_vulkan_check(
-            vkFlushMappedMemoryRanges(
-                device,
-                1,
-                &mapped_memory_range
-            )   
-        );
-    }
-
-    {
-        uint32_t* index_dst = (uint32_t*)buffer->index_data_mapped;
-        memcpy(
-            index_dst,
-            buffer->indices,
-            buffer->max_index_count * sizeof(uint32_t)
-            );
-        const VkMappedMemoryRange mapped_memory_range =
-        {
-            .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-            .memory = buffer->index_buffer_memory,
-            .offset = 0,
-            .size   = index_buffer_size,
-        };
-        lna_vulkan_check(
-            vkFlushMappedMemoryRanges(
-                device,
-                1,
-                &mapped_memory_range
-            )   
-        );
-    }
-}
-
-static void lna_ui_buffer_release(lna_ui_buffer_t* buffer, VkDevice device)
-{
-    lna_assert(buffer)
-    lna_assert(buffer->vertex_buffer)
-    lna_assert(buffer->vertex_buffer_memory)
-    lna_assert(buffer->index_buffer)
-    lna_assert(buffer->index_buffer_memory)
-    lna_assert(device)
-
-    vkUnmapMemory(device, buffer->vertex_buffer_memory);
-    vkDestroyBuffer(device, buffer->vertex_buffer, NULL);
-    vkFreeMemory(device, buffer->vertex_buffer_memory, NULL);
-
-    vkUnmapMemory(device, buffer->index_buffer_memory);
-    vkDestroyBuffer(device, buffer->index_buffer, NULL);
-    vkFreeMemory(device, buffer->index_buffer_memory, NULL);
 }
 
 void lna_ui_system_init(lna_ui_system_t* ui_system, const lna_ui_system_config_t* config)
@@ -569,18 +388,17 @@ lna_ui_buffer_t* lna_ui_system_new_buffer(lna_ui_system_t* ui_system, const lna_
         config,
         ui_system->descriptor_pool,
         ui_system->descriptor_set_layout,
-        ui_system->renderer->device,
-        ui_system->renderer->physical_device
+        ui_system->renderer->device
         );
     return buffer;
 }
 
-void lna_ui_system_draw(lna_ui_system_t* ui_system)
+//! called by the renderer record job, the buffers must not change until the end of the frame.
+static void lna_ui_system_record(void* owner, VkCommandBuffer command_buffer, uint32_t begin, uint32_t end)
 {
-    lna_assert(ui_system)
+    lna_assert(owner)
+    lna_ui_system_t* ui_system = (lna_ui_system_t*)owner;
     lna_assert(ui_system->renderer)
-    lna_assert(ui_system->renderer->command_buffers.elements)
-    lna_assert(ui_system->renderer->command_buffers.count > ui_system->renderer->image_index)
 
     const VkViewport viewport =
     {
@@ -597,62 +415,10 @@ void lna_ui_system_draw(lna_ui_system_t* ui_system)
         .extent.height  = ui_system->renderer->swap_chain_extent.height,
     };
 
-    VkCommandBuffer command_buffer = ui_system->renderer->command_buffers.elements[ui_system->renderer->image_index];
-
-    for (uint32_t i = 0; i < ui_system->buffers.cur_element_count; ++i)
+    for (uint32_t i = begin; i < end; ++i)
     {
         lna_ui_buffer_t* buffer = &ui_system->buffers.elements[i];
 
-        //! 1. UPDATE MAPPED DATA
-
-        {
-            lna_ui_vertex_t* vertex_dst = (lna_ui_vertex_t*)buffer->vertex_data_mapped;
-            memcpy(
-                vertex_dst,
-                buffer->vertices,
-                buffer->max_vertex_count * sizeof(lna_ui_vertex_t)
-                );
-            const VkDeviceSize vertex_buffer_size = buffer->max_vertex_count * sizeof(lna_ui_vertex_t);
-            const VkMappedMemoryRange mapped_memory_range =
-            {
-                .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-                .memory = buffer->vertex_buffer_memory,
-                .offset = 0,
-                .size   = vertex_buffer_size,
-            };
-            lna_vulkan_check(
-                vkFlushMappedMemoryRanges(
-                    ui_system->renderer->device,
-                    1,
-                    &mapped_memory_range
-                    )   
-                );
-        }
-
-        {
-            uint32_t* index_dst = (uint32_t*)buffer->index_data_mapped;
-            memcpy(
-                index_dst,
-                buffer->indices,
-                buffer->max_index_count * sizeof(uint32_t)
-                );
-            const VkDeviceSize index_buffer_size = buffer->max_index_count * sizeof (uint32_t);
-            const VkMappedMemoryRange mapped_memory_range =
-            {
-                .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
-                .memory = buffer->index_buffer_memory,
-                .offset = 0,
-                .size   = index_buffer_size,
-            };
-            lna_vulkan_check(
-                vkFlushMappedMemoryRanges(
-                    ui_system->renderer->device,
-                    1,
-                    &mapped_memory_range
-                    )   
-                );
-        }
-
         //! 2. UPDATE CURRENT COMMAND BUFFER
 
         vkCmdBindDescriptorSets(
@@ -692,18 +458,48 @@ void lna_ui_system_draw(lna_ui_system_t* ui_system)
 
         if (buffer->cur_index_count > 0)
         {
-            const VkDeviceSize offsets[] = { 0 };
+            //! the geometry is rebuilt every frame, it is written in the
+            //! current frame uniform buffer instead of a buffer the frames
+            //! in flight may still read.
+            VkBuffer        vertex_buffer;
+            VkDeviceSize    vertex_offset;
+            void* vertex_data = lna_renderer_reserve_vertex_data(
+                ui_system->renderer,
+                buffer->cur_vertex_count * sizeof(lna_ui_vertex_t),
+                &vertex_buffer,
+                &vertex_offset
+                );
+            memcpy(
+                vertex_data,
+                buffer->vertices,
+                buffer->cur_vertex_count * sizeof(lna_ui_vertex_t)
+                );
+
+            VkBuffer        index_buffer;
+            VkDeviceSize    index_offset;
+            void* index_data = lna_renderer_reserve_index_data(
+                ui_system->renderer,
+                buffer->cur_index_count * sizeof(uint32_t),
+                &index_buffer,
+                &index_offset
+                );
+            memcpy(
+                index_data,
+                buffer->indices,
+                buffer->cur_index_count * sizeof(uint32_t)
+                );
+
             vkCmdBindVertexBuffers(
                 command_buffer,
                 0,
                 1,
-                &buffer->vertex_buffer,
-                offsets
+                &vertex_buffer,
+                &vertex_offset
                 );
             vkCmdBindIndexBuffer(
                 command_buffer,
-                buffer->index_buffer,
-                0,
+                index_buffer,
+                index_offset,
                 VK_INDEX_TYPE_UINT32
                 );
 
@@ -725,6 +521,21 @@ void lna_ui_system_draw(lna_ui_system_t* ui_system)
     }
 }
 
+void lna_ui_system_draw(lna_ui_system_t* ui_system)
+{
+    lna_assert(ui_system)
+    lna_assert(ui_system->renderer)
+
+    //! the ui is drawn over the other systems, its buffers are recorded in a single secondary command buffer
+    lna_vulkan_renderer_record(
+        ui_system->renderer,
+        lna_ui_system_record,
+        ui_system,
+        ui_system->buffers.cur_element_count,
+        ui_system->buffers.cur_element_count
+        );
+}
+
 void lna_ui_system_release(lna_ui_system_t* ui_system)
 {
     lna_assert(ui_system)
@@ -737,12 +548,6 @@ void lna_ui_system_release(lna_ui_system_t* ui_system)
     lna_assert(ui_system->renderer)
     lna_assert(ui_system->renderer->device)
 
-    for (uint32_t index = 0; index < ui_system->buffers.cur_element_count; ++index)
-    {
-        lna_ui_buffer_t* buffer = &ui_system->buffers.elements[index];
-        lna_ui_buffer_release(buffer, ui_system->renderer->device);
-    }
-
     vkDestroyPipelineCache(ui_system->renderer->device, ui_system->pipeline_cache, NULL);
     vkDestroyPipeline(ui_system->renderer->device, ui_system->pipeline, NULL);
     vkDestroyPipelineLayout(ui_system->renderer->device, ui_system->pipeline_layout, NULL);
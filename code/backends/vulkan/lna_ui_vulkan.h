@@ -29,14 +29,8 @@ typedef struct lna_ui_buffer_s
     uint32_t                            max_index_count;
     uint32_t                            cur_index_count;
     lna_texture_t*                      texture;
-    VkBuffer                            vertex_buffer;
-    VkDeviceMemory                      vertex_buffer_memory;
-    VkBuffer                            index_buffer;
-    VkDeviceMemory                      index_buffer_memory;
     VkDescriptorSet                     descriptor_set;   
     lna_ui_push_const_block_vulkan_t    push_const_block;
-    void*                               vertex_data_mapped;
-    void*                               index_data_mapped;
 } lna_ui_buffer_t;
 
 typedef struct lna_ui_buffer_vec_s
@@ -65,9 +65,10 @@ uint32_t lna_vulkan_find_memory_type(VkPhysicalDevice physical_device, uint32_t
     lna_assert(0)
 }
 
-void lna_vulkan_create_buffer(VkDevice device, VkPhysicalDevice physical_device, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer* buffer, VkDeviceMemory* buffer_memory)
+void lna_vulkan_create_buffer(lna_vulkan_memory_allocator_t* allocator, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer* buffer, lna_vulkan_memory_allocation_t* buffer_allocation)
 {
-    lna_assert(device)
+    lna_assert(allocator)
+    lna_assert(allocator->device)
 
     const VkBufferCreateInfo buffer_create_info =
     {
@@ -79,7 +80,7 @@ void lna_vulkan_create_buffer(VkDevice device, VkPhysicalDevice physical_device,
 
     lna_vulkan_check(
         vkCreateBuffer(
-            device,
+            allocator->device,
             &buffer_create_info,
             NULL,
             buffer
@@ -88,45 +89,33 @@ void lna_vulkan_create_buffer(VkDevice device, VkPhysicalDevice physical_device,
 
     VkMemoryRequirements memory_requirements;
     vkGetBufferMemoryRequirements(
-        device,
+        allocator->device,
         *buffer,
         &memory_requirements
         );
 
-    const VkMemoryAllocateInfo memory_allocate_info =
-    {
-        .sType              = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize     = memory_requirements.size,
-        .memoryTypeIndex    = lna_vulkan_find_memory_type(
-            physical_device,
-            memory_requirements.memoryTypeBits,
-            properties
-            ),
-    };
-        
-    lna_vulkan_check(
-        vkAllocateMemory(
-            device,
-            &memory_allocate_info,
-            NULL,
-            buffer_memory
-            )
+    lna_vulkan_memory_allocator_alloc(
+        allocator,
+        &memory_requirements,
+        properties,
+        false,
+        buffer_allocation
         );
-        
+
     lna_vulkan_check(
         vkBindBufferMemory(
-            device,
+            allocator->device,
             *buffer,
-            *buffer_memory,
-            0
+            buffer_allocation->memory,
+            buffer_allocation->offset
             )
         );
 }
 
-void lna_vulkan_create_image(VkDevice device, VkPhysicalDevice physical_device, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage* image, VkDeviceMemory* image_memory)
+void lna_vulkan_create_image(lna_vulkan_memory_allocator_t* allocator, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage* image, lna_vulkan_memory_allocation_t* image_allocation)
 {
-    lna_assert(device)
-    lna_assert(physical_device)
+    lna_assert(allocator)
+    lna_assert(allocator->device)
 
     const VkImageCreateInfo image_create_info =
     {
@@ -148,7 +137,7 @@ void lna_vulkan_create_image(VkDevice device, VkPhysicalDevice physical_device,
 
     lna_vulkan_check(
         vkCreateImage(
-            device,
+            allocator->device,
             &image_create_info,
             NULL,
             image
@@ -157,37 +146,25 @@ void lna_vulkan_create_image(VkDevice device, VkPhysicalDevice physical_device,
 
     VkMemoryRequirements memory_requirements;
     vkGetImageMemoryRequirements(
-        device,
+        allocator->device,
         *image,
         &memory_requirements
         );
 
-    const VkMemoryAllocateInfo allocate_info =
-    {
-        .sType              = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-        .allocationSize     = memory_requirements.size,
-        .memoryTypeIndex    = lna_vulkan_find_memory_type(
-            physical_device,
-            memory_requirements.memoryTypeBits,
-            properties
-            ),
-    };
-
-    lna_vulkan_check(
-        vkAllocateMemory(
-            device,
-            &allocate_info,
-            NULL,
-            image_memory
-            )
+    lna_vulkan_memory_allocator_alloc(
+        allocator,
+        &memory_requirements,
+        properties,
+        tiling == VK_IMAGE_TILING_OPTIMAL,
+        image_allocation
         );
 
     lna_vulkan_check(
         vkBindImageMemory(
-            device,
+            allocator->device,
             *image,
-            *image_memory,
-            0
+            image_allocation->memory,
+            image_allocation->offset
             )
         );
 }
@@ -3,14 +3,15 @@
 
 #include <stdbool.h>
 #include <vulkan/vulkan.h>
+#include "backends/vulkan/lna_vulkan_memory_allocator.h"
 #include "core/lna_log.h"
 #include "core/lna_assert.h"
 
 extern const char*      lna_vulkan_error_string                 (VkResult error_code);
 extern void             lna_vulkan_check                        (VkResult result);
 extern uint32_t         lna_vulkan_find_memory_type             (VkPhysicalDevice physical_device, uint32_t type_filter, VkMemoryPropertyFlags properties);
-extern void             lna_vulkan_create_buffer                (VkDevice device, VkPhysicalDevice physical_device, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer* buffer, VkDeviceMemory* buffer_memory);
-extern void             lna_vulkan_create_image                 (VkDevice device, VkPhysicalDevice physical_device, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage* image, VkDeviceMemory* image_memory);
+extern void             lna_vulkan_create_buffer                (lna_vulkan_memory_allocator_t* allocator, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer* buffer, lna_vulkan_memory_allocation_t* buffer_allocation);
+extern void             lna_vulkan_create_image                 (lna_vulkan_memory_allocator_t* allocator, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage* image, lna_vulkan_memory_allocation_t* image_allocation);
 extern VkImageView      lna_vulkan_create_image_view            (VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspect_flags);
 extern VkCommandBuffer  lna_vulkan_begin_single_time_commands   (VkDevice device, VkCommandPool command_pool);
 extern void             lna_vulkan_end_single_time_commands     (VkDevice device, VkCommandPool command_pool, VkCommandBuffer command_buffer, VkQueue graphics_queue);
@@ -0,0 +1,614 @@
+#include "backends/vulkan/lna_vulkan_memory_allocator.h"
+#include "backends/vulkan/lna_vulkan.h"
+#include "core/lna_assert.h"
+#include "core/lna_log.h"
+
+static VkDeviceSize lna_vulkan_memory_align_up(VkDeviceSize value, VkDeviceSize alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static uint32_t lna_vulkan_memory_allocator_find_memory_type(
+    const lna_vulkan_memory_allocator_t* allocator,
+    uint32_t type_filter,
+    VkMemoryPropertyFlags properties
+    )
+{
+    lna_assert(allocator)
+
+    for (uint32_t i = 0; i < allocator->memory_properties.memoryTypeCount; ++i)
+    {
+        if (
+            (type_filter & (1 << i))
+            && (allocator->memory_properties.memoryTypes[i].propertyFlags & properties) == properties
+            )
+        {
+            return i;
+        }
+    }
+    lna_assert(0)
+    return LNA_VULKAN_MEMORY_INVALID_INDEX;
+}
+
+//! ============================================================================
+//! FREE RANGE PART
+//! ============================================================================
+
+static uint32_t lna_vulkan_memory_range_new(
+    lna_vulkan_memory_range_pool_t* ranges,
+    VkDeviceSize offset,
+    VkDeviceSize size,
+    uint32_t next
+    )
+{
+    lna_assert(ranges)
+    lna_assert(ranges->first_free != LNA_VULKAN_MEMORY_INVALID_INDEX)
+
+    const uint32_t index = ranges->first_free;
+    lna_vulkan_memory_range_t* range = &ranges->elements[index];
+    ranges->first_free  = range->next;
+    range->offset       = offset;
+    range->size         = size;
+    range->next         = next;
+    return index;
+}
+
+static void lna_vulkan_memory_range_delete(
+    lna_vulkan_memory_range_pool_t* ranges,
+    uint32_t index
+    )
+{
+    lna_assert(ranges)
+    lna_assert(index < ranges->max_element_count)
+
+    ranges->elements[index].next    = ranges->first_free;
+    ranges->first_free              = index;
+}
+
+//! ============================================================================
+//! BLOCK PART
+//! ============================================================================
+
+static bool lna_vulkan_memory_block_try_alloc(
+    lna_vulkan_memory_block_t* block,
+    lna_vulkan_memory_range_pool_t* ranges,
+    VkDeviceSize size,
+    VkDeviceSize alignment,
+    VkDeviceSize* offset,
+    VkDeviceSize* padding
+    )
+{
+    lna_assert(block)
+    lna_assert(ranges)
+    lna_assert(offset)
+    lna_assert(padding)
+
+    //! first fit in the free ranges. The padding before the aligned offset is
+    //! taken with the allocation: left free, these small ranges would pile up
+    //! in the list and be scanned by every next allocation.
+    uint32_t        prev                = LNA_VULKAN_MEMORY_INVALID_INDEX;
+    uint32_t        cur                 = block->first_free_range;
+    VkDeviceSize    max_free_range_size = 0;
+    while (cur != LNA_VULKAN_MEMORY_INVALID_INDEX)
+    {
+        lna_vulkan_memory_range_t* range = &ranges->elements[cur];
+
+        const VkDeviceSize aligned_offset   = lna_vulkan_memory_align_up(range->offset, alignment);
+        const VkDeviceSize range_end        = range->offset + range->size;
+
+        if (aligned_offset + size <= range_end)
+        {
+            *offset     = aligned_offset;
+            *padding    = aligned_offset - range->offset;
+
+            if (aligned_offset + size < range_end)
+            {
+                range->offset   = aligned_offset + size;
+                range->size     = range_end - range->offset;
+            }
+            else
+            {
+                if (prev == LNA_VULKAN_MEMORY_INVALID_INDEX)
+                {
+                    block->first_free_range = range->next;
+                }
+                else
+                {
+                    ranges->elements[prev].next = range->next;
+                }
+                lna_vulkan_memory_range_delete(ranges, cur);
+            }
+            return true;
+        }
+        max_free_range_size = range->size > max_free_range_size ? range->size : max_free_range_size;
+        prev = cur;
+        cur  = range->next;
+    }
+    //! the whole list has been seen, the next allocations skip the block if
+    //! they are bigger than its largest range
+    block->max_free_range_size = max_free_range_size;
+    return false;
+}
+
+static void lna_vulkan_memory_block_free(
+    lna_vulkan_memory_block_t* block,
+    lna_vulkan_memory_range_pool_t* ranges,
+    VkDeviceSize offset,
+    VkDeviceSize size
+    )
+{
+    lna_assert(block)
+    lna_assert(ranges)
+    lna_assert(offset + size <= block->size)
+
+    //! insert the range in the offset sorted list and merge it with its neighbors
+    uint32_t prev = LNA_VULKAN_MEMORY_INVALID_INDEX;
+    uint32_t cur  = block->first_free_range;
+    while (
+        cur != LNA_VULKAN_MEMORY_INVALID_INDEX
+        && ranges->elements[cur].offset < offset
+        )
+    {
+        prev = cur;
+        cur  = ranges->elements[cur].next;
+    }
+
+    const bool merge_prev = prev != LNA_VULKAN_MEMORY_INVALID_INDEX && ranges->elements[prev].offset + ranges->elements[prev].size == offset;
+    const bool merge_next = cur != LNA_VULKAN_MEMORY_INVALID_INDEX && offset + size == ranges->elements[cur].offset;
+
+    VkDeviceSize free_range_size = size;
+    if (merge_prev && merge_next)
+    {
+        ranges->elements[prev].size += size + ranges->elements[cur].size;
+        ranges->elements[prev].next  = ranges->elements[cur].next;
+        lna_vulkan_memory_range_delete(ranges, cur);
+        free_range_size = ranges->elements[prev].size;
+    }
+    else if (merge_prev)
+    {
+        ranges->elements[prev].size += size;
+        free_range_size = ranges->elements[prev].size;
+    }
+    else if (merge_next)
+    {
+        ranges->elements[cur].offset = offset;
+        ranges->elements[cur].size  += size;
+        free_range_size = ranges->elements[cur].size;
+    }
+    else
+    {
+        const uint32_t index = lna_vulkan_memory_range_new(
+            ranges,
+            offset,
+            size,
+            cur
+            );
+        if (prev == LNA_VULKAN_MEMORY_INVALID_INDEX)
+        {
+            block->first_free_range = index;
+        }
+        else
+        {
+            ranges->elements[prev].next = index;
+        }
+    }
+    block->max_free_range_size = free_range_size > block->max_free_range_size ? free_range_size : block->max_free_range_size;
+}
+
+static uint32_t lna_vulkan_memory_allocator_new_block(
+    lna_vulkan_memory_allocator_t* allocator,
+    uint32_t memory_type_index,
+    VkDeviceSize size,
+    bool optimal_image,
+    bool dedicated
+    )
+{
+    lna_assert(allocator)
+    lna_assert(size > 0)
+
+    //! reuse the slot of a released block if there is one
+    uint32_t block_index = LNA_VULKAN_MEMORY_INVALID_INDEX;
+    for (uint32_t i = 0; i < allocator->blocks.cur_element_count; ++i)
+    {
+        if (allocator->blocks.elements[i].memory == VK_NULL_HANDLE)
+        {
+            block_index = i;
+            break;
+        }
+    }
+    if (block_index == LNA_VULKAN_MEMORY_INVALID_INDEX)
+    {
+        lna_assert(allocator->blocks.cur_element_count < allocator->blocks.max_element_count)
+        block_index = allocator->blocks.cur_element_count++;
+    }
+
+    lna_vulkan_memory_block_t* block = &allocator->blocks.elements[block_index];
+
+    const VkMemoryAllocateInfo memory_allocate_info =
+    {
+        .sType              = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize     = size,
+        .memoryTypeIndex    = memory_type_index,
+    };
+    lna_vulkan_check(
+        vkAllocateMemory(
+            allocator->device,
+            &memory_allocate_info,
+            NULL,
+            &block->memory
+            )
+        );
+
+    block->size                 = size;
+    block->used_size            = 0;
+    block->max_free_range_size  = size;
+    block->mapped_data          = NULL;
+    block->memory_type_index    = memory_type_index;
+    block->allocation_count     = 0;
+    block->optimal_image        = optimal_image;
+    block->dedicated            = dedicated;
+    block->first_free_range     = lna_vulkan_memory_range_new(
+        &allocator->ranges,
+        0,
+        size,
+        LNA_VULKAN_MEMORY_INVALID_INDEX
+        );
+
+    if (allocator->memory_properties.memoryTypes[memory_type_index].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+    {
+        lna_vulkan_check(
+            vkMapMemory(
+                allocator->device,
+                block->memory,
+                0,
+                VK_WHOLE_SIZE,
+                0,
+                (void**)&block->mapped_data
+                )
+            );
+    }
+
+    allocator->allocated_size += size;
+
+    return block_index;
+}
+
+static void lna_vulkan_memory_allocator_delete_block(
+    lna_vulkan_memory_allocator_t* allocator,
+    lna_vulkan_memory_block_t* block
+    )
+{
+    lna_assert(allocator)
+    lna_assert(block)
+    lna_assert(block->memory)
+
+    if (block->mapped_data)
+    {
+        vkUnmapMemory(
+            allocator->device,
+            block->memory
+            );
+    }
+    vkFreeMemory(
+        allocator->device,
+        block->memory,
+        NULL
+        );
+
+    uint32_t cur = block->first_free_range;
+    while (cur != LNA_VULKAN_MEMORY_INVALID_INDEX)
+    {
+        const uint32_t next = allocator->ranges.elements[cur].next;
+        lna_vulkan_memory_range_delete(&allocator->ranges, cur);
+        cur = next;
+    }
+
+    allocator->allocated_size -= block->size;
+
+    block->memory               = VK_NULL_HANDLE;
+    block->size                 = 0;
+    block->used_size            = 0;
+    block->max_free_range_size  = 0;
+    block->mapped_data          = NULL;
+    block->first_free_range     = LNA_VULKAN_MEMORY_INVALID_INDEX;
+    block->allocation_count     = 0;
+}
+
+//! ============================================================================
+//! ALLOCATOR PART
+//! ============================================================================
+
+void lna_vulkan_memory_allocator_init(lna_vulkan_memory_allocator_t* allocator, const lna_vulkan_memory_allocator_config_t* config)
+{
+    lna_assert(allocator)
+    lna_assert(allocator->device == VK_NULL_HANDLE)
+    lna_assert(allocator->blocks.elements == NULL)
+    lna_assert(allocator->ranges.elements == NULL)
+    lna_assert(config)
+    lna_assert(config->device)
+    lna_assert(config->physical_device)
+    lna_assert(config->memory_pool)
+    lna_assert(config->block_size > 0)
+    lna_assert(config->max_block_count > 0)
+    lna_assert(config->max_allocation_count > 0)
+
+    allocator->device           = config->device;
+    allocator->physical_device  = config->physical_device;
+    allocator->block_size       = config->block_size;
+    allocator->allocation_count = 0;
+    allocator->allocated_size   = 0;
+    allocator->used_size        = 0;
+
+    vkGetPhysicalDeviceMemoryProperties(
+        allocator->physical_device,
+        &allocator->memory_properties
+        );
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(
+        allocator->physical_device,
+        &properties
+        );
+    allocator->non_coherent_atom_size = properties.limits.nonCoherentAtomSize > 0 ? properties.limits.nonCoherentAtomSize : 1;
+    if (config->max_block_count > properties.limits.maxMemoryAllocationCount)
+    {
+        lna_log_warning("max device memory block count (%d) is greater than maxMemoryAllocationCount (%d)", config->max_block_count, properties.limits.maxMemoryAllocationCount);
+    }
+
+    allocator->blocks.cur_element_count = 0;
+    allocator->blocks.max_element_count = config->max_block_count;
+    allocator->blocks.elements          = lna_memory_pool_reserve(
+        config->memory_pool,
+        sizeof(lna_vulkan_memory_block_t) * allocator->blocks.max_element_count
+        );
+
+    //! a block cannot have more free ranges than its allocation count + 1
+    allocator->ranges.max_element_count = config->max_allocation_count + config->max_block_count;
+    allocator->ranges.elements          = lna_memory_pool_reserve(
+        config->memory_pool,
+        sizeof(lna_vulkan_memory_range_t) * allocator->ranges.max_element_count
+        );
+    for (uint32_t i = 0; i < allocator->ranges.max_element_count; ++i)
+    {
+        allocator->ranges.elements[i].next = (i + 1 < allocator->ranges.max_element_count) ? i + 1 : LNA_VULKAN_MEMORY_INVALID_INDEX;
+    }
+    allocator->ranges.first_free = 0;
+}
+
+void lna_vulkan_memory_allocator_alloc(lna_vulkan_memory_allocator_t* allocator, const VkMemoryRequirements* requirements, VkMemoryPropertyFlags properties, bool optimal_image, lna_vulkan_memory_allocation_t* allocation)
+{
+    lna_assert(allocator)
+    lna_assert(allocator->device)
+    lna_assert(requirements)
+    lna_assert(requirements->size > 0)
+    lna_assert(allocation)
+
+    const uint32_t memory_type_index = lna_vulkan_memory_allocator_find_memory_type(
+        allocator,
+        requirements->memoryTypeBits,
+        properties
+        );
+    const VkMemoryPropertyFlags memory_type_flags = allocator->memory_properties.memoryTypes[memory_type_index].propertyFlags;
+
+    VkDeviceSize size       = requirements->size;
+    VkDeviceSize alignment  = requirements->alignment > 0 ? requirements->alignment : 1;
+
+    //! non coherent allocations must not share an atom with another allocation
+    //! to be flushed independently
+    if (
+        (memory_type_flags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)
+        && !(memory_type_flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+        )
+    {
+        alignment   = alignment > allocator->non_coherent_atom_size ? alignment : allocator->non_coherent_atom_size;
+        size        = lna_vulkan_memory_align_up(size, allocator->non_coherent_atom_size);
+    }
+
+    uint32_t        block_index = LNA_VULKAN_MEMORY_INVALID_INDEX;
+    VkDeviceSize    offset      = 0;
+    VkDeviceSize    padding     = 0;
+
+    if (size > allocator->block_size / 2)
+    {
+        block_index = lna_vulkan_memory_allocator_new_block(
+            allocator,
+            memory_type_index,
+            size,
+            optimal_image,
+            true
+            );
+        lna_vulkan_memory_block_try_alloc(
+            &allocator->blocks.elements[block_index],
+            &allocator->ranges,
+            size,
+            alignment,
+            &offset,
+            &padding
+            );
+    }
+    else
+    {
+        for (uint32_t i = 0; i < allocator->blocks.cur_element_count; ++i)
+        {
+            lna_vulkan_memory_block_t* block = &allocator->blocks.elements[i];
+            if (
+                block->memory != VK_NULL_HANDLE
+                && !block->dedicated
+                && block->memory_type_index == memory_type_index
+                && block->optimal_image == optimal_image
+                && block->max_free_range_size >= size
+                && lna_vulkan_memory_block_try_alloc(block, &allocator->ranges, size, alignment, &offset, &padding)
+                )
+            {
+                block_index = i;
+                break;
+            }
+        }
+        if (block_index == LNA_VULKAN_MEMORY_INVALID_INDEX)
+        {
+            block_index = lna_vulkan_memory_allocator_new_block(
+                allocator,
+                memory_type_index,
+                allocator->block_size,
+                optimal_image,
+                false
+                );
+            const bool allocated = lna_vulkan_memory_block_try_alloc(
+                &allocator->blocks.elements[block_index],
+                &allocator->ranges,
+                size,
+                alignment,
+                &offset,
+                &padding
+                );
+            lna_assert(allocated)
+        }
+    }
+
+    lna_vulkan_memory_block_t* block = &allocator->blocks.elements[block_index];
+    block->used_size += padding + size;
+    ++block->allocation_count;
+    ++allocator->allocation_count;
+    allocator->used_size += padding + size;
+
+    allocation->memory      = block->memory;
+    allocation->offset      = offset;
+    allocation->size        = size;
+    allocation->padding     = padding;
+    allocation->mapped_data = block->mapped_data ? block->mapped_data + offset : NULL;
+    allocation->block_index = block_index;
+}
+
+void lna_vulkan_memory_allocator_free(lna_vulkan_memory_allocator_t* allocator, lna_vulkan_memory_allocation_t* allocation)
+{
+    lna_assert(allocator)
+    lna_assert(allocation)
+    lna_assert(allocation->memory)
+    lna_assert(allocation->block_index < allocator->blocks.cur_element_count)
+
+    lna_vulkan_memory_block_t* block = &allocator->blocks.elements[allocation->block_index];
+    lna_assert(block->memory == allocation->memory)
+    lna_assert(block->allocation_count > 0)
+
+    lna_vulkan_memory_block_free(
+        block,
+        &allocator->ranges,
+        allocation->offset - allocation->padding,
+        allocation->padding + allocation->size
+        );
+    block->used_size -= allocation->padding + allocation->size;
+    --block->allocation_count;
+    --allocator->allocation_count;
+    allocator->used_size -= allocation->padding + allocation->size;
+
+    //! regular blocks are kept to be reused by the next allocations
+    if (block->dedicated)
+    {
+        lna_vulkan_memory_allocator_delete_block(allocator, block);
+    }
+
+    allocation->memory      = VK_NULL_HANDLE;
+    allocation->offset      = 0;
+    allocation->size        = 0;
+    allocation->padding     = 0;
+    allocation->mapped_data = NULL;
+    allocation->block_index = LNA_VULKAN_MEMORY_INVALID_INDEX;
+}
+
+void lna_vulkan_memory_allocator_flush(lna_vulkan_memory_allocator_t* allocator, const lna_vulkan_memory_allocation_t* allocation, VkDeviceSize offset, VkDeviceSize size)
+{
+    lna_assert(allocator)
+    lna_assert(allocation)
+    lna_assert(allocation->mapped_data)
+    lna_assert(allocation->block_index < allocator->blocks.cur_element_count)
+
+    const lna_vulkan_memory_block_t* block = &allocator->blocks.elements[allocation->block_index];
+    if (allocator->memory_properties.memoryTypes[block->memory_type_index].propertyFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)
+    {
+        return;
+    }
+
+    const VkDeviceSize  atom_size   = allocator->non_coherent_atom_size;
+    const VkDeviceSize  begin       = (allocation->offset + offset) & ~(atom_size - 1);
+    VkDeviceSize        end         = lna_vulkan_memory_align_up(allocation->offset + offset + size, atom_size);
+    end = end < block->size ? end : block->size;
+
+    const VkMappedMemoryRange memory_range =
+    {
+        .sType  = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE,
+        .memory = block->memory,
+        .offset = begin,
+        .size   = end - begin,
+    };
+    lna_vulkan_check(
+        vkFlushMappedMemoryRanges(
+            allocator->device,
+            1,
+            &memory_range
+            )
+        );
+}
+
+void lna_vulkan_memory_allocator_log_stats(const lna_vulkan_memory_allocator_t* allocator)
+{
+    lna_assert(allocator)
+
+    lna_log_message("----------------------------");
+    lna_log_message("device memory allocator info:");
+    lna_log_message("----------------------------");
+    lna_log_message("\tallocation count       : %d", allocator->allocation_count);
+    lna_log_message("\tallocated size         : %llu", (unsigned long long)allocator->allocated_size);
+    lna_log_message("\tused size              : %llu", (unsigned long long)allocator->used_size);
+    for (uint32_t i = 0; i < allocator->blocks.cur_element_count; ++i)
+    {
+        const lna_vulkan_memory_block_t* block = &allocator->blocks.elements[i];
+        if (block->memory == VK_NULL_HANDLE)
+        {
+            continue;
+        }
+        uint32_t free_range_count = 0;
+        for (
+            uint32_t range = block->first_free_range;
+            range != LNA_VULKAN_MEMORY_INVALID_INDEX;
+            range = allocator->ranges.elements[range].next
+            )
+        {
+            ++free_range_count;
+        }
+        lna_log_message(
+            "\tblock %d: type %d, %llu/%llu bytes used, %d allocations, %d free ranges%s%s",
+            i,
+            block->memory_type_index,
+            (unsigned long long)block->used_size,
+            (unsigned long long)block->size,
+            block->allocation_count,
+            free_range_count,
+            block->optimal_image ? ", optimal images" : "",
+            block->dedicated ? ", dedicated" : ""
+            );
+    }
+}
+
+void lna_vulkan_memory_allocator_release(lna_vulkan_memory_allocator_t* allocator)
+{
+    lna_assert(allocator)
+    lna_assert(allocator->device)
+
+    if (allocator->allocation_count > 0)
+    {
+        lna_log_warning("%d device memory allocations have not been freed", allocator->allocation_count);
+    }
+
+    for (uint32_t i = 0; i < allocator->blocks.cur_element_count; ++i)
+    {
+        lna_vulkan_memory_block_t* block = &allocator->blocks.elements[i];
+        if (block->memory != VK_NULL_HANDLE)
+        {
+            lna_vulkan_memory_allocator_delete_block(allocator, block);
+        }
+    }
+    allocator->blocks.cur_element_count = 0;
+    allocator->allocation_count         = 0;
+    allocator->used_size                = 0;
+    allocator->device                   = VK_NULL_HANDLE;
+}
@@ -0,0 +1,96 @@
+#ifndef LNA_BACKENDS_VULKAN_LNA_VULKAN_MEMORY_ALLOCATOR_H
+#define LNA_BACKENDS_VULKAN_LNA_VULKAN_MEMORY_ALLOCATOR_H
+
+#include <stdbool.h>
+#include <vulkan/vulkan.h>
+#include "core/lna_memory_pool.h"
+
+//! device memory is allocated by big blocks (one vkAllocateMemory per block)
+//! and each buffer or image is bound to a sub range of a block. Free ranges of
+//! a block are kept in a list sorted by offset and merged when released, the
+//! alignment padding of an allocation is released with it.
+//! Linear resources (buffers) and optimal tiling images never share a block,
+//! that way bufferImageGranularity does not have to be taken into account.
+//! Host visible blocks are persistently mapped.
+
+#define LNA_VULKAN_MEMORY_INVALID_INDEX ((uint32_t)-1)
+
+typedef struct lna_vulkan_memory_allocation_s
+{
+    VkDeviceMemory                      memory;         //! memory to bind the resource to
+    VkDeviceSize                        offset;         //! offset to bind the resource at
+    VkDeviceSize                        size;
+    VkDeviceSize                        padding;        //! bytes of the block before offset, lost to the alignment while the allocation lives
+    char*                               mapped_data;    //! NULL if the memory is not host visible
+    uint32_t                            block_index;
+} lna_vulkan_memory_allocation_t;
+
+typedef struct lna_vulkan_memory_range_s
+{
+    VkDeviceSize                        offset;
+    VkDeviceSize                        size;
+    uint32_t                            next;           //! index of the next range, LNA_VULKAN_MEMORY_INVALID_INDEX at the end of the list
+} lna_vulkan_memory_range_t;
+
+typedef struct lna_vulkan_memory_range_pool_s
+{
+    lna_vulkan_memory_range_t*          elements;
+    uint32_t                            max_element_count;
+    uint32_t                            first_free;
+} lna_vulkan_memory_range_pool_t;
+
+typedef struct lna_vulkan_memory_block_s
+{
+    VkDeviceMemory                      memory;         //! VK_NULL_HANDLE if the block slot is unused
+    VkDeviceSize                        size;
+    VkDeviceSize                        used_size;
+    char*                               mapped_data;
+    uint32_t                            memory_type_index;
+    VkDeviceSize                        max_free_range_size;    //! not lower than the largest free range, exact after a failed allocation
+    uint32_t                            first_free_range;
+    uint32_t                            allocation_count;
+    bool                                optimal_image;  //! true if the block only contains optimal tiling images
+    bool                                dedicated;      //! true if the block contains only one big allocation
+} lna_vulkan_memory_block_t;
+
+typedef struct lna_vulkan_memory_block_vec_s
+{
+    uint32_t                            cur_element_count;
+    uint32_t                            max_element_count;
+    lna_vulkan_memory_block_t*          elements;
+} lna_vulkan_memory_block_vec_t;
+
+typedef struct lna_vulkan_memory_allocator_config_s
+{
+    VkDevice                            device;
+    VkPhysicalDevice                    physical_device;
+    lna_memory_pool_t*                  memory_pool;
+    VkDeviceSize                        block_size;
+    uint32_t                            max_block_count;
+    uint32_t                            max_allocation_count;
+} lna_vulkan_memory_allocator_config_t;
+
+typedef struct lna_vulkan_memory_allocator_s
+{
+    VkDevice                            device;
+    VkPhysicalDevice                    physical_device;
+    VkPhysicalDeviceMemoryProperties    memory_properties;
+    VkDeviceSize                        block_size;
+    VkDeviceSize                        non_coherent_atom_size;
+    lna_vulkan_memory_block_vec_t       blocks;
+    lna_vulkan_memory_range_pool_t      ranges;
+    uint32_t                            allocation_count;
+    VkDeviceSize                        allocated_size; //! sum of the block sizes
+    VkDeviceSize                        used_size;      //! sum of the allocation sizes and paddings
+} lna_vulkan_memory_allocator_t;
+
+extern void     lna_vulkan_memory_allocator_init        (lna_vulkan_memory_allocator_t* allocator, const lna_vulkan_memory_allocator_config_t* config);
+extern void     lna_vulkan_memory_allocator_alloc       (lna_vulkan_memory_allocator_t* allocator, const VkMemoryRequirements* requirements, VkMemoryPropertyFlags properties, bool optimal_image, lna_vulkan_memory_allocation_t* allocation);
+extern void     lna_vulkan_memory_allocator_free        (lna_vulkan_memory_allocator_t* allocator, lna_vulkan_memory_allocation_t* allocation);
+//! make host writes visible to the device, only needed for memory types which are not host coherent.
+//! offset is relative to the allocation.
+extern void     lna_vulkan_memory_allocator_flush       (lna_vulkan_memory_allocator_t* allocator, const lna_vulkan_memory_allocation_t* allocation, VkDeviceSize offset, VkDeviceSize size);
+extern void     lna_vulkan_memory_allocator_log_stats   (const lna_vulkan_memory_allocator_t* allocator);
+extern void     lna_vulkan_memory_allocator_release     (lna_vulkan_memory_allocator_t* allocator);
+
+#endif
@@ -0,0 +1,124 @@
+#include "backends/vulkan/lna_vulkan_uniform_ring_buffer.h"
+#include "backends/vulkan/lna_vulkan.h"
+#include "core/lna_assert.h"
+
+//! ============================================================================
+//!                             PUBLIC FUNCTIONS
+//! ============================================================================
+
+void lna_vulkan_uniform_ring_buffer_init(lna_vulkan_uniform_ring_buffer_t* ring_buffer, const lna_vulkan_uniform_ring_buffer_config_t* config)
+{
+    lna_assert(ring_buffer)
+    lna_assert(config)
+    lna_assert(config->memory_allocator)
+    lna_assert(config->memory_allocator->physical_device)
+    lna_assert(config->frame_count > 0)
+    lna_assert(config->frame_count <= LNA_VULKAN_MAX_FRAMES_IN_FLIGHT)
+    lna_assert(config->size > 0)
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(
+        config->memory_allocator->physical_device,
+        &properties
+        );
+
+    ring_buffer->memory_allocator   = config->memory_allocator;
+    ring_buffer->frame_count        = config->frame_count;
+    ring_buffer->alignment          = properties.limits.minUniformBufferOffsetAlignment > 0 ? properties.limits.minUniformBufferOffsetAlignment : 1;
+    ring_buffer->max_size           = config->size;
+    atomic_init(&ring_buffer->cur_offset, 0);
+    ring_buffer->persistent_size    = 0;
+
+    for (uint32_t i = 0; i < ring_buffer->frame_count; ++i)
+    {
+        lna_vulkan_create_buffer(
+            ring_buffer->memory_allocator,
+            ring_buffer->max_size,
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+            &ring_buffer->buffers[i],
+            &ring_buffer->buffers_allocation[i]
+            );
+        ring_buffer->mapped_data[i] = ring_buffer->buffers_allocation[i].mapped_data;
+    }
+}
+
+void lna_vulkan_uniform_ring_buffer_reset(lna_vulkan_uniform_ring_buffer_t* ring_buffer)
+{
+    lna_assert(ring_buffer)
+
+    atomic_store_explicit(
+        &ring_buffer->cur_offset,
+        0,
+        memory_order_relaxed
+        );
+}
+
+void* lna_vulkan_uniform_ring_buffer_reserve(lna_vulkan_uniform_ring_buffer_t* ring_buffer, uint32_t frame, size_t size_in_bytes, uint32_t* dynamic_offset)
+{
+    lna_assert(ring_buffer)
+    lna_assert(frame < ring_buffer->frame_count)
+    lna_assert(ring_buffer->mapped_data[frame])
+    lna_assert(size_in_bytes > 0)
+    lna_assert(dynamic_offset)
+
+    //! the current offset stays aligned since all the reservations are rounded up to the alignment
+    const VkDeviceSize aligned_size = ((VkDeviceSize)size_in_bytes + ring_buffer->alignment - 1) & ~(ring_buffer->alignment - 1);
+    const VkDeviceSize offset       = atomic_fetch_add_explicit(
+        &ring_buffer->cur_offset,
+        aligned_size,
+        memory_order_relaxed
+        );
+    lna_assert(offset + size_in_bytes <= ring_buffer->max_size - ring_buffer->persistent_size)
+
+    *dynamic_offset = (uint32_t)offset;
+    return ring_buffer->mapped_data[frame] + offset;
+}
+
+void lna_vulkan_uniform_ring_buffer_reserve_persistent(lna_vulkan_uniform_ring_buffer_t* ring_buffer, size_t size_in_bytes, uint32_t* dynamic_offset)
+{
+    lna_assert(ring_buffer)
+    lna_assert(size_in_bytes > 0)
+    lna_assert(dynamic_offset)
+
+    //! the persistent reservations grow down from the end of the buffers
+    const VkDeviceSize aligned_size = ((VkDeviceSize)size_in_bytes + ring_buffer->alignment - 1) & ~(ring_buffer->alignment - 1);
+    lna_assert(ring_buffer->persistent_size + aligned_size <= ring_buffer->max_size)
+
+    const VkDeviceSize offset = (ring_buffer->max_size - ring_buffer->persistent_size - aligned_size) & ~(ring_buffer->alignment - 1);
+    ring_buffer->persistent_size = ring_buffer->max_size - offset;
+
+    *dynamic_offset = (uint32_t)offset;
+}
+
+void* lna_vulkan_uniform_ring_buffer_persistent_data(lna_vulkan_uniform_ring_buffer_t* ring_buffer, uint32_t frame, uint32_t dynamic_offset)
+{
+    lna_assert(ring_buffer)
+    lna_assert(frame < ring_buffer->frame_count)
+    lna_assert(ring_buffer->mapped_data[frame])
+    lna_assert((VkDeviceSize)dynamic_offset >= ring_buffer->max_size - ring_buffer->persistent_size)
+    lna_assert((VkDeviceSize)dynamic_offset < ring_buffer->max_size)
+
+    return ring_buffer->mapped_data[frame] + dynamic_offset;
+}
+
+void lna_vulkan_uniform_ring_buffer_release(lna_vulkan_uniform_ring_buffer_t* ring_buffer)
+{
+    lna_assert(ring_buffer)
+    lna_assert(ring_buffer->memory_allocator)
+
+    for (uint32_t i = 0; i < ring_buffer->frame_count; ++i)
+    {
+        vkDestroyBuffer(
+            ring_buffer->memory_allocator->device,
+            ring_buffer->buffers[i],
+            NULL
+            );
+        lna_vulkan_memory_allocator_free(
+            ring_buffer->memory_allocator,
+            &ring_buffer->buffers_allocation[i]
+            );
+        ring_buffer->buffers[i]     = VK_NULL_HANDLE;
+        ring_buffer->mapped_data[i] = NULL;
+    }
+}
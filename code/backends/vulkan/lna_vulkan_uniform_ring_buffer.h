@@ -0,0 +1,53 @@
+#ifndef LNA_BACKENDS_VULKAN_LNA_VULKAN_UNIFORM_RING_BUFFER_H
+#define LNA_BACKENDS_VULKAN_LNA_VULKAN_UNIFORM_RING_BUFFER_H
+
+#include <stdint.h>
+#include <stdatomic.h>
+#include <vulkan/vulkan.h>
+#include "backends/vulkan/lna_vulkan_memory_allocator.h"
+
+//! the frame in flight count is set at runtime by the renderer config, up to this maximum
+#define LNA_VULKAN_MAX_FRAMES_IN_FLIGHT 4
+
+//! persistently mapped uniform buffers, one per frame in flight, from which
+//! the graphics systems sub-allocate their per frame uniform data and bind
+//! it with dynamic offsets. The buffers can also hold per frame vertex and
+//! index data (like instance data or dynamic geometry). The current frame
+//! buffer is reset once its fence has been signaled. The reservations are
+//! made by an atomic add so the systems can record from several threads.
+//! The end of each buffer holds the persistent reservations, at the same
+//! offset in all the frame buffers and never reset, for the cached command
+//! buffers whose dynamic offsets cannot change.
+
+typedef struct lna_vulkan_uniform_ring_buffer_config_s
+{
+    lna_vulkan_memory_allocator_t*  memory_allocator;
+    uint32_t                        frame_count;
+    VkDeviceSize                    size;       //! size of each frame buffer
+} lna_vulkan_uniform_ring_buffer_config_t;
+
+typedef struct lna_vulkan_uniform_ring_buffer_s
+{
+    lna_vulkan_memory_allocator_t*  memory_allocator;
+    uint32_t                        frame_count;
+    VkBuffer                        buffers[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    lna_vulkan_memory_allocation_t  buffers_allocation[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    char*                           mapped_data[LNA_VULKAN_MAX_FRAMES_IN_FLIGHT];
+    _Atomic VkDeviceSize            cur_offset;
+    VkDeviceSize                    persistent_size;
+    VkDeviceSize                    max_size;   //! size of each frame buffer
+    VkDeviceSize                    alignment;  //! minUniformBufferOffsetAlignment
+} lna_vulkan_uniform_ring_buffer_t;
+
+extern void     lna_vulkan_uniform_ring_buffer_init                 (lna_vulkan_uniform_ring_buffer_t* ring_buffer, const lna_vulkan_uniform_ring_buffer_config_t* config);
+//! give back all the per frame reservations of the buffer of a frame, must be called once the fence of the frame has been signaled.
+extern void     lna_vulkan_uniform_ring_buffer_reset                (lna_vulkan_uniform_ring_buffer_t* ring_buffer);
+//! reserve size_in_bytes in the buffer of frame, thread safe. dynamic_offset receives the offset of the
+//! reservation in ring_buffer->buffers[frame], a multiple of the alignment.
+extern void*    lna_vulkan_uniform_ring_buffer_reserve              (lna_vulkan_uniform_ring_buffer_t* ring_buffer, uint32_t frame, size_t size_in_bytes, uint32_t* dynamic_offset);
+//! reserve size_in_bytes at the same offset in the buffers of all the frames, not thread safe.
+extern void     lna_vulkan_uniform_ring_buffer_reserve_persistent   (lna_vulkan_uniform_ring_buffer_t* ring_buffer, size_t size_in_bytes, uint32_t* dynamic_offset);
+extern void*    lna_vulkan_uniform_ring_buffer_persistent_data      (lna_vulkan_uniform_ring_buffer_t* ring_buffer, uint32_t frame, uint32_t dynamic_offset);
+extern void     lna_vulkan_uniform_ring_buffer_release              (lna_vulkan_uniform_ring_buffer_t* ring_buffer);
+
+#endif
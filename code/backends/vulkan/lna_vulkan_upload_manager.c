@@ -0,0 +1,877 @@
+#include "backends/vulkan/lna_vulkan_upload_manager.h"
+#include "backends/vulkan/lna_vulkan.h"
+#include "core/lna_assert.h"
+#include "core/lna_log.h"
+
+//! ============================================================================
+//!                             LOCAL FUNCTIONS
+//! ============================================================================
+
+static bool lna_vulkan_upload_manager_transfers_ownership(const lna_vulkan_upload_manager_t* upload_manager)
+{
+    lna_assert(upload_manager)
+    return upload_manager->transfer_family != upload_manager->graphics_family;
+}
+
+static lna_vulkan_upload_batch_t* lna_vulkan_upload_manager_batch(lna_vulkan_upload_manager_t* upload_manager, uint32_t i)
+{
+    lna_assert(upload_manager)
+    lna_assert(i < upload_manager->batch_count)
+    return &upload_manager->batches[(upload_manager->first_batch + i) % LNA_VULKAN_MAX_UPLOAD_BATCHES];
+}
+
+static void lna_vulkan_upload_manager_submit_batch(lna_vulkan_upload_manager_t* upload_manager, lna_vulkan_upload_batch_t* batch)
+{
+    lna_assert(upload_manager)
+    lna_assert(batch)
+    lna_assert(batch->state == LNA_VULKAN_UPLOAD_BATCH_STATE_RECORDING)
+
+    lna_vulkan_check(
+        vkEndCommandBuffer(
+            batch->command_buffer
+            )
+        );
+
+    const VkSubmitInfo submit_info =
+    {
+        .sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .commandBufferCount     = 1,
+        .pCommandBuffers        = &batch->command_buffer,
+        .signalSemaphoreCount   = 1,
+        .pSignalSemaphores      = &batch->semaphore,
+    };
+
+    lna_vulkan_check(
+        vkQueueSubmit(
+            upload_manager->transfer_queue,
+            1,
+            &submit_info,
+            batch->fence
+            )
+        );
+    batch->state = LNA_VULKAN_UPLOAD_BATCH_STATE_SUBMITTED;
+}
+
+static lna_vulkan_upload_batch_t* lna_vulkan_upload_manager_recording_batch(lna_vulkan_upload_manager_t* upload_manager)
+{
+    lna_assert(upload_manager)
+
+    if (upload_manager->batch_count == 0)
+    {
+        return NULL;
+    }
+    lna_vulkan_upload_batch_t* batch = lna_vulkan_upload_manager_batch(
+        upload_manager,
+        upload_manager->batch_count - 1
+        );
+    return batch->state == LNA_VULKAN_UPLOAD_BATCH_STATE_RECORDING ? batch : NULL;
+}
+
+static void lna_vulkan_upload_manager_submit_recording_batch(lna_vulkan_upload_manager_t* upload_manager)
+{
+    lna_assert(upload_manager)
+
+    lna_vulkan_upload_batch_t* batch = lna_vulkan_upload_manager_recording_batch(upload_manager);
+    if (batch)
+    {
+        lna_vulkan_upload_manager_submit_batch(
+            upload_manager,
+            batch
+            );
+    }
+}
+
+//! give back the staging memory of the batches the transfer queue is done
+//! with and free the oldest batches the graphics queue is done with. Both
+//! are done in submission order, the staging memory is used as a ring.
+static void lna_vulkan_upload_manager_retire_batches(lna_vulkan_upload_manager_t* upload_manager)
+{
+    lna_assert(upload_manager)
+
+    for (uint32_t i = 0; i < upload_manager->batch_count; ++i)
+    {
+        lna_vulkan_upload_batch_t* batch = lna_vulkan_upload_manager_batch(
+            upload_manager,
+            i
+            );
+        if (batch->transfer_done)
+        {
+            continue;
+        }
+        if (
+            batch->state == LNA_VULKAN_UPLOAD_BATCH_STATE_RECORDING
+            || vkGetFenceStatus(upload_manager->device, batch->fence) != VK_SUCCESS
+            )
+        {
+            break;
+        }
+        lna_assert(upload_manager->staging_used_size >= batch->staging_size)
+        upload_manager->staging_used_size -= batch->staging_size;
+        batch->transfer_done = true;
+    }
+
+    while (upload_manager->batch_count > 0)
+    {
+        lna_vulkan_upload_batch_t* batch = &upload_manager->batches[upload_manager->first_batch];
+        if (!batch->transfer_done || batch->state != LNA_VULKAN_UPLOAD_BATCH_STATE_DONE)
+        {
+            break;
+        }
+        lna_vulkan_check(
+            vkResetFences(
+                upload_manager->device,
+                1,
+                &batch->fence
+                )
+            );
+        lna_vulkan_check(
+            vkResetCommandBuffer(
+                batch->command_buffer,
+                0
+                )
+            );
+        upload_manager->completed_ticket    = batch->ticket;
+        batch->state                        = LNA_VULKAN_UPLOAD_BATCH_STATE_FREE;
+        upload_manager->first_batch         = (upload_manager->first_batch + 1) % LNA_VULKAN_MAX_UPLOAD_BATCHES;
+        --upload_manager->batch_count;
+    }
+
+    if (upload_manager->staging_used_size == 0)
+    {
+        upload_manager->staging_head = 0;
+    }
+}
+
+//! return the recording batch, starting a new one if there is none or if
+//! the current one cannot record another upload.
+static lna_vulkan_upload_batch_t* lna_vulkan_upload_manager_begin_upload(lna_vulkan_upload_manager_t* upload_manager)
+{
+    lna_assert(upload_manager)
+
+    lna_vulkan_upload_batch_t* batch = lna_vulkan_upload_manager_recording_batch(upload_manager);
+    if (batch)
+    {
+        if (batch->upload_count < upload_manager->max_barrier_count)
+        {
+            return batch;
+        }
+        lna_vulkan_upload_manager_submit_batch(
+            upload_manager,
+            batch
+            );
+    }
+
+    lna_vulkan_upload_manager_retire_batches(upload_manager);
+    if (upload_manager->batch_count == LNA_VULKAN_MAX_UPLOAD_BATCHES)
+    {
+        lna_log_warning("no free upload batch, waiting for the pending uploads");
+        lna_vulkan_upload_manager_flush(upload_manager);
+    }
+    lna_assert(upload_manager->batch_count < LNA_VULKAN_MAX_UPLOAD_BATCHES)
+
+    batch = &upload_manager->batches[(upload_manager->first_batch + upload_manager->batch_count) % LNA_VULKAN_MAX_UPLOAD_BATCHES];
+    lna_assert(batch->state == LNA_VULKAN_UPLOAD_BATCH_STATE_FREE)
+    ++upload_manager->batch_count;
+
+    batch->state                = LNA_VULKAN_UPLOAD_BATCH_STATE_RECORDING;
+    batch->staging_size         = 0;
+    batch->transfer_done        = false;
+    batch->ticket               = ++upload_manager->next_ticket;
+    batch->acquire_frame        = (uint32_t)-1;
+    batch->upload_count         = 0;
+    batch->buffer_barrier_count = 0;
+    batch->image_barrier_count  = 0;
+
+    const VkCommandBufferBeginInfo begin_info =
+    {
+        .sType  = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags  = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+    lna_vulkan_check(
+        vkBeginCommandBuffer(
+            batch->command_buffer,
+            &begin_info
+            )
+        );
+    return batch;
+}
+
+//! reserve size bytes in the staging ring for the recording batch.
+static VkDeviceSize lna_vulkan_upload_manager_reserve_staging(lna_vulkan_upload_manager_t* upload_manager, lna_vulkan_upload_batch_t** batch, VkDeviceSize size)
+{
+    lna_assert(upload_manager)
+    lna_assert(batch && *batch)
+    lna_assert(size > 0)
+    lna_assert(size <= upload_manager->staging_buffer_size)
+
+    for (;;)
+    {
+        VkDeviceSize offset = (upload_manager->staging_head + upload_manager->copy_alignment - 1) & ~(upload_manager->copy_alignment - 1);
+        if (offset + size > upload_manager->staging_buffer_size)
+        {
+            //! wrap, the end of the buffer is lost until the batch is retired
+            offset = 0;
+        }
+        const VkDeviceSize padding  = offset >= upload_manager->staging_head ? offset - upload_manager->staging_head : upload_manager->staging_buffer_size - upload_manager->staging_head;
+        const VkDeviceSize needed   = padding + size;
+        if (upload_manager->staging_used_size + needed <= upload_manager->staging_buffer_size)
+        {
+            upload_manager->staging_used_size   += needed;
+            upload_manager->staging_head        = offset + size;
+            (*batch)->staging_size              += needed;
+            return offset;
+        }
+
+        //! the staging buffer is full, all the pending uploads have to be
+        //! done before the recording one can go on.
+        lna_log_warning("upload staging buffer full, waiting for the pending uploads");
+        lna_vulkan_upload_manager_flush(upload_manager);
+        *batch = lna_vulkan_upload_manager_begin_upload(upload_manager);
+    }
+}
+
+static void lna_vulkan_upload_manager_record_acquire_barriers(const lna_vulkan_upload_batch_t* batch, VkCommandBuffer command_buffer)
+{
+    lna_assert(batch)
+    lna_assert(command_buffer)
+
+    if (batch->buffer_barrier_count == 0 && batch->image_barrier_count == 0)
+    {
+        return;
+    }
+    vkCmdPipelineBarrier(
+        command_buffer,
+        LNA_VULKAN_UPLOAD_WAIT_STAGES,
+        LNA_VULKAN_UPLOAD_WAIT_STAGES,
+        0,
+        0,
+        NULL,
+        batch->buffer_barrier_count,
+        batch->buffer_barriers,
+        batch->image_barrier_count,
+        batch->image_barriers
+        );
+}
+
+//! ============================================================================
+//!                             PUBLIC FUNCTIONS
+//! ============================================================================
+
+void lna_vulkan_upload_manager_init(lna_vulkan_upload_manager_t* upload_manager, const lna_vulkan_upload_manager_config_t* config)
+{
+    lna_assert(upload_manager)
+    lna_assert(upload_manager->device == VK_NULL_HANDLE)
+    lna_assert(upload_manager->staging_buffer == VK_NULL_HANDLE)
+    lna_assert(config)
+    lna_assert(config->device)
+    lna_assert(config->physical_device)
+    lna_assert(config->memory_allocator)
+    lna_assert(config->memory_pool)
+    lna_assert(config->transfer_queue)
+    lna_assert(config->graphics_queue)
+    lna_assert(config->staging_buffer_size > 0)
+    lna_assert(config->frame_count > 0)
+    lna_assert(config->max_barrier_count > 0)
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(
+        config->physical_device,
+        &properties
+        );
+
+    upload_manager->device              = config->device;
+    upload_manager->memory_allocator    = config->memory_allocator;
+    upload_manager->transfer_family     = config->transfer_family;
+    upload_manager->transfer_queue      = config->transfer_queue;
+    upload_manager->graphics_family     = config->graphics_family;
+    upload_manager->graphics_queue      = config->graphics_queue;
+    upload_manager->frame_count         = config->frame_count;
+    upload_manager->staging_buffer_size = config->staging_buffer_size;
+    upload_manager->staging_head        = 0;
+    upload_manager->staging_used_size   = 0;
+    //! image copies need at least a 4 bytes aligned buffer offset (texel size)
+    upload_manager->copy_alignment      = properties.limits.optimalBufferCopyOffsetAlignment > 16 ? properties.limits.optimalBufferCopyOffsetAlignment : 16;
+    upload_manager->max_barrier_count   = config->max_barrier_count;
+    upload_manager->first_batch         = 0;
+    upload_manager->batch_count         = 0;
+    upload_manager->next_ticket         = 0;
+    upload_manager->completed_ticket    = 0;
+    upload_manager->wait_semaphore_count = 0;
+
+    lna_vulkan_create_buffer(
+        upload_manager->memory_allocator,
+        upload_manager->staging_buffer_size,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        &upload_manager->staging_buffer,
+        &upload_manager->staging_buffer_allocation
+        );
+    lna_assert(upload_manager->staging_buffer_allocation.mapped_data)
+
+    const VkCommandPoolCreateInfo transfer_command_pool_create_info =
+    {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .queueFamilyIndex   = upload_manager->transfer_family,
+        .flags              = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+    };
+    lna_vulkan_check(
+        vkCreateCommandPool(
+            upload_manager->device,
+            &transfer_command_pool_create_info,
+            NULL,
+            &upload_manager->transfer_command_pool
+            )
+        );
+
+    const VkCommandPoolCreateInfo graphics_command_pool_create_info =
+    {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .queueFamilyIndex   = upload_manager->graphics_family,
+        .flags              = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+    };
+    lna_vulkan_check(
+        vkCreateCommandPool(
+            upload_manager->device,
+            &graphics_command_pool_create_info,
+            NULL,
+            &upload_manager->graphics_command_pool
+            )
+        );
+
+    const VkCommandBufferAllocateInfo flush_command_buffer_allocate_info =
+    {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandPool        = upload_manager->graphics_command_pool,
+        .commandBufferCount = 1,
+    };
+    lna_vulkan_check(
+        vkAllocateCommandBuffers(
+            upload_manager->device,
+            &flush_command_buffer_allocate_info,
+            &upload_manager->flush_command_buffer
+            )
+        );
+
+    upload_manager->acquire_command_buffers = lna_memory_pool_reserve(
+        config->memory_pool,
+        sizeof(VkCommandBuffer) * upload_manager->frame_count
+        );
+    const VkCommandBufferAllocateInfo acquire_command_buffer_allocate_info =
+    {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandPool        = upload_manager->graphics_command_pool,
+        .commandBufferCount = upload_manager->frame_count,
+    };
+    lna_vulkan_check(
+        vkAllocateCommandBuffers(
+            upload_manager->device,
+            &acquire_command_buffer_allocate_info,
+            upload_manager->acquire_command_buffers
+            )
+        );
+
+    const VkFenceCreateInfo fence_create_info =
+    {
+        .sType  = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+    };
+    lna_vulkan_check(
+        vkCreateFence(
+            upload_manager->device,
+            &fence_create_info,
+            NULL,
+            &upload_manager->flush_fence
+            )
+        );
+
+    const VkSemaphoreCreateInfo semaphore_create_info =
+    {
+        .sType  = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+    };
+
+    const VkCommandBufferAllocateInfo batch_command_buffer_allocate_info =
+    {
+        .sType              = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .level              = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+        .commandPool        = upload_manager->transfer_command_pool,
+        .commandBufferCount = 1,
+    };
+
+    for (uint32_t i = 0; i < LNA_VULKAN_MAX_UPLOAD_BATCHES; ++i)
+    {
+        lna_vulkan_upload_batch_t* batch = &upload_manager->batches[i];
+
+        batch->state                = LNA_VULKAN_UPLOAD_BATCH_STATE_FREE;
+        batch->upload_count         = 0;
+        batch->buffer_barrier_count = 0;
+        batch->image_barrier_count  = 0;
+        batch->buffer_barriers      = lna_memory_pool_reserve(
+            config->memory_pool,
+            sizeof(VkBufferMemoryBarrier) * upload_manager->max_barrier_count
+            );
+        batch->image_barriers       = lna_memory_pool_reserve(
+            config->memory_pool,
+            sizeof(VkImageMemoryBarrier) * upload_manager->max_barrier_count
+            );
+
+        lna_vulkan_check(
+            vkAllocateCommandBuffers(
+                upload_manager->device,
+                &batch_command_buffer_allocate_info,
+                &batch->command_buffer
+                )
+            );
+        lna_vulkan_check(
+            vkCreateFence(
+                upload_manager->device,
+                &fence_create_info,
+                NULL,
+                &batch->fence
+                )
+            );
+        lna_vulkan_check(
+            vkCreateSemaphore(
+                upload_manager->device,
+                &semaphore_create_info,
+                NULL,
+                &batch->semaphore
+                )
+            );
+    }
+
+    if (lna_vulkan_upload_manager_transfers_ownership(upload_manager))
+    {
+        lna_log_message("uploads use the dedicated transfer queue family %u", upload_manager->transfer_family);
+    }
+}
+
+void* lna_vulkan_upload_manager_upload_buffer(lna_vulkan_upload_manager_t* upload_manager, VkBuffer dst, VkDeviceSize dst_offset, VkDeviceSize size, uint64_t* ticket)
+{
+    lna_assert(upload_manager)
+    lna_assert(dst)
+    lna_assert(size > 0)
+
+    lna_vulkan_upload_batch_t* batch = lna_vulkan_upload_manager_begin_upload(upload_manager);
+    const VkDeviceSize staging_offset = lna_vulkan_upload_manager_reserve_staging(
+        upload_manager,
+        &batch,
+        size
+        );
+
+    const VkBufferCopy copy_region =
+    {
+        .srcOffset  = staging_offset,
+        .dstOffset  = dst_offset,
+        .size       = size,
+    };
+    vkCmdCopyBuffer(
+        batch->command_buffer,
+        upload_manager->staging_buffer,
+        dst,
+        1,
+        &copy_region
+        );
+
+    if (lna_vulkan_upload_manager_transfers_ownership(upload_manager))
+    {
+        VkBufferMemoryBarrier barrier =
+        {
+            .sType                  = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+            .srcAccessMask          = VK_ACCESS_TRANSFER_WRITE_BIT,
+            .dstAccessMask          = 0,
+            .srcQueueFamilyIndex    = upload_manager->transfer_family,
+            .dstQueueFamilyIndex    = upload_manager->graphics_family,
+            .buffer                 = dst,
+            .offset                 = dst_offset,
+            .size                   = size,
+        };
+        vkCmdPipelineBarrier(
+            batch->command_buffer,
+            VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0,
+            0,
+            NULL,
+            1,
+            &barrier,
+            0,
+            NULL
+            );
+
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+        batch->buffer_barriers[batch->buffer_barrier_count++] = barrier;
+    }
+    ++batch->upload_count;
+
+    if (ticket)
+    {
+        *ticket = batch->ticket;
+    }
+    return upload_manager->staging_buffer_allocation.mapped_data + staging_offset;
+}
+
+void* lna_vulkan_upload_manager_upload_image(lna_vulkan_upload_manager_t* upload_manager, VkImage dst, uint32_t width, uint32_t height, VkDeviceSize size, uint64_t* ticket)
+{
+    lna_assert(upload_manager)
+    lna_assert(dst)
+    lna_assert(width > 0)
+    lna_assert(height > 0)
+    lna_assert(size > 0)
+
+    lna_vulkan_upload_batch_t* batch = lna_vulkan_upload_manager_begin_upload(upload_manager);
+    const VkDeviceSize staging_offset = lna_vulkan_upload_manager_reserve_staging(
+        upload_manager,
+        &batch,
+        size
+        );
+
+    const bool transfers_ownership = lna_vulkan_upload_manager_transfers_ownership(upload_manager);
+
+    VkImageMemoryBarrier barrier =
+    {
+        .sType                              = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+        .srcAccessMask                      = 0,
+        .dstAccessMask                      = VK_ACCESS_TRANSFER_WRITE_BIT,
+        .oldLayout                          = VK_IMAGE_LAYOUT_UNDEFINED,
+        .newLayout                          = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        .srcQueueFamilyIndex                = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex                = VK_QUEUE_FAMILY_IGNORED,
+        .image                              = dst,
+        .subresourceRange.aspectMask        = VK_IMAGE_ASPECT_COLOR_BIT,
+        .subresourceRange.baseMipLevel      = 0,
+        .subresourceRange.levelCount        = 1,
+        .subresourceRange.baseArrayLayer    = 0,
+        .subresourceRange.layerCount        = 1,
+    };
+    vkCmdPipelineBarrier(
+        batch->command_buffer,
+        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0,
+        0,
+        NULL,
+        0,
+        NULL,
+        1,
+        &barrier
+        );
+
+    const VkBufferImageCopy region =
+    {
+        .bufferOffset                       = staging_offset,
+        .bufferRowLength                    = 0,
+        .bufferImageHeight                  = 0,
+        .imageSubresource.aspectMask        = VK_IMAGE_ASPECT_COLOR_BIT,
+        .imageSubresource.mipLevel          = 0,
+        .imageSubresource.baseArrayLayer    = 0,
+        .imageSubresource.layerCount        = 1,
+        .imageOffset                        = (VkOffset3D){ 0, 0, 0 },
+        .imageExtent                        = (VkExtent3D){ width, height, 1 },
+    };
+    vkCmdCopyBufferToImage(
+        batch->command_buffer,
+        upload_manager->staging_buffer,
+        dst,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1,
+        &region
+        );
+
+    //! the layout transition to shader read only is done by the release
+    //! barrier, and again (with the same layouts) by the acquire barrier
+    //! when the ownership goes to the graphics queue family.
+    barrier.srcAccessMask       = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask       = 0;
+    barrier.oldLayout           = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.newLayout           = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barrier.srcQueueFamilyIndex = transfers_ownership ? upload_manager->transfer_family : VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = transfers_ownership ? upload_manager->graphics_family : VK_QUEUE_FAMILY_IGNORED;
+    vkCmdPipelineBarrier(
+        batch->command_buffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0,
+        0,
+        NULL,
+        0,
+        NULL,
+        1,
+        &barrier
+        );
+
+    if (transfers_ownership)
+    {
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        batch->image_barriers[batch->image_barrier_count++] = barrier;
+    }
+    ++batch->upload_count;
+
+    if (ticket)
+    {
+        *ticket = batch->ticket;
+    }
+    return upload_manager->staging_buffer_allocation.mapped_data + staging_offset;
+}
+
+bool lna_vulkan_upload_manager_is_done(const lna_vulkan_upload_manager_t* upload_manager, uint64_t ticket)
+{
+    lna_assert(upload_manager)
+    return ticket <= upload_manager->completed_ticket;
+}
+
+void lna_vulkan_upload_manager_begin_frame(lna_vulkan_upload_manager_t* upload_manager, uint32_t frame)
+{
+    lna_assert(upload_manager)
+    lna_assert(frame < upload_manager->frame_count)
+
+    //! the fence of the frame has been signaled, the batches it waited for
+    //! are not used by the graphics queue anymore.
+    for (uint32_t i = 0; i < upload_manager->batch_count; ++i)
+    {
+        lna_vulkan_upload_batch_t* batch = lna_vulkan_upload_manager_batch(
+            upload_manager,
+            i
+            );
+        if (batch->state == LNA_VULKAN_UPLOAD_BATCH_STATE_ACQUIRED && batch->acquire_frame == frame)
+        {
+            batch->state = LNA_VULKAN_UPLOAD_BATCH_STATE_DONE;
+        }
+    }
+    lna_vulkan_upload_manager_retire_batches(upload_manager);
+}
+
+VkCommandBuffer lna_vulkan_upload_manager_end_frame(lna_vulkan_upload_manager_t* upload_manager, uint32_t frame)
+{
+    lna_assert(upload_manager)
+    lna_assert(frame < upload_manager->frame_count)
+
+    lna_vulkan_upload_manager_submit_recording_batch(upload_manager);
+
+    upload_manager->wait_semaphore_count = 0;
+    VkCommandBuffer command_buffer = upload_manager->acquire_command_buffers[frame];
+    bool            has_barriers   = false;
+
+    for (uint32_t i = 0; i < upload_manager->batch_count; ++i)
+    {
+        lna_vulkan_upload_batch_t* batch = lna_vulkan_upload_manager_batch(
+            upload_manager,
+            i
+            );
+        if (batch->state != LNA_VULKAN_UPLOAD_BATCH_STATE_SUBMITTED)
+        {
+            continue;
+        }
+        if (!has_barriers && (batch->buffer_barrier_count > 0 || batch->image_barrier_count > 0))
+        {
+            const VkCommandBufferBeginInfo begin_info =
+            {
+                .sType  = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+                .flags  = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+            };
+            lna_vulkan_check(
+                vkBeginCommandBuffer(
+                    command_buffer,
+                    &begin_info
+                    )
+                );
+            has_barriers = true;
+        }
+        if (has_barriers)
+        {
+            lna_vulkan_upload_manager_record_acquire_barriers(
+                batch,
+                command_buffer
+                );
+        }
+        upload_manager->wait_semaphores[upload_manager->wait_semaphore_count++] = batch->semaphore;
+        batch->state            = LNA_VULKAN_UPLOAD_BATCH_STATE_ACQUIRED;
+        batch->acquire_frame    = frame;
+    }
+
+    if (!has_barriers)
+    {
+        return VK_NULL_HANDLE;
+    }
+    lna_vulkan_check(
+        vkEndCommandBuffer(
+            command_buffer
+            )
+        );
+    return command_buffer;
+}
+
+void lna_vulkan_upload_manager_flush(lna_vulkan_upload_manager_t* upload_manager)
+{
+    lna_assert(upload_manager)
+
+    lna_vulkan_upload_manager_submit_recording_batch(upload_manager);
+
+    //! the submitted batches are acquired by a graphics submit of their own.
+    VkSemaphore             wait_semaphores[LNA_VULKAN_MAX_UPLOAD_BATCHES];
+    VkPipelineStageFlags    wait_stages[LNA_VULKAN_MAX_UPLOAD_BATCHES];
+    uint32_t                wait_semaphore_count = 0;
+
+    const VkCommandBufferBeginInfo begin_info =
+    {
+        .sType  = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags  = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+    lna_vulkan_check(
+        vkBeginCommandBuffer(
+            upload_manager->flush_command_buffer,
+            &begin_info
+            )
+        );
+    for (uint32_t i = 0; i < upload_manager->batch_count; ++i)
+    {
+        lna_vulkan_upload_batch_t* batch = lna_vulkan_upload_manager_batch(
+            upload_manager,
+            i
+            );
+        if (batch->state != LNA_VULKAN_UPLOAD_BATCH_STATE_SUBMITTED)
+        {
+            continue;
+        }
+        if (lna_vulkan_upload_manager_transfers_ownership(upload_manager))
+        {
+            lna_vulkan_upload_manager_record_acquire_barriers(
+                batch,
+                upload_manager->flush_command_buffer
+                );
+        }
+        wait_semaphores[wait_semaphore_count]   = batch->semaphore;
+        wait_stages[wait_semaphore_count]       = LNA_VULKAN_UPLOAD_WAIT_STAGES;
+        ++wait_semaphore_count;
+        batch->state = LNA_VULKAN_UPLOAD_BATCH_STATE_DONE;
+    }
+    lna_vulkan_check(
+        vkEndCommandBuffer(
+            upload_manager->flush_command_buffer
+            )
+        );
+
+    const VkSubmitInfo submit_info =
+    {
+        .sType                  = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .waitSemaphoreCount     = wait_semaphore_count,
+        .pWaitSemaphores        = wait_semaphores,
+        .pWaitDstStageMask      = wait_stages,
+        .commandBufferCount     = 1,
+        .pCommandBuffers        = &upload_manager->flush_command_buffer,
+    };
+    lna_vulkan_check(
+        vkQueueSubmit(
+            upload_manager->graphics_queue,
+            1,
+            &submit_info,
+            upload_manager->flush_fence
+            )
+        );
+    lna_vulkan_check(
+        vkWaitForFences(
+            upload_manager->device,
+            1,
+            &upload_manager->flush_fence,
+            VK_TRUE,
+            UINT64_MAX
+            )
+        );
+    lna_vulkan_check(
+        vkResetFences(
+            upload_manager->device,
+            1,
+            &upload_manager->flush_fence
+            )
+        );
+    lna_vulkan_check(
+        vkResetCommandBuffer(
+            upload_manager->flush_command_buffer,
+            0
+            )
+        );
+
+    //! the frames submitted before the flush are done too
+    for (uint32_t i = 0; i < upload_manager->batch_count; ++i)
+    {
+        lna_vulkan_upload_batch_t* batch = lna_vulkan_upload_manager_batch(
+            upload_manager,
+            i
+            );
+        if (batch->state == LNA_VULKAN_UPLOAD_BATCH_STATE_ACQUIRED)
+        {
+            batch->state = LNA_VULKAN_UPLOAD_BATCH_STATE_DONE;
+        }
+        if (!batch->transfer_done)
+        {
+            lna_vulkan_check(
+                vkWaitForFences(
+                    upload_manager->device,
+                    1,
+                    &batch->fence,
+                    VK_TRUE,
+                    UINT64_MAX
+                    )
+                );
+        }
+    }
+    lna_vulkan_upload_manager_retire_batches(upload_manager);
+}
+
+void lna_vulkan_upload_manager_release(lna_vulkan_upload_manager_t* upload_manager)
+{
+    lna_assert(upload_manager)
+    lna_assert(upload_manager->device)
+
+    lna_vulkan_check(
+        vkQueueWaitIdle(
+            upload_manager->transfer_queue
+            )
+        );
+    lna_vulkan_check(
+        vkQueueWaitIdle(
+            upload_manager->graphics_queue
+            )
+        );
+
+    for (uint32_t i = 0; i < LNA_VULKAN_MAX_UPLOAD_BATCHES; ++i)
+    {
+        vkDestroySemaphore(
+            upload_manager->device,
+            upload_manager->batches[i].semaphore,
+            NULL
+            );
+        vkDestroyFence(
+            upload_manager->device,
+            upload_manager->batches[i].fence,
+            NULL
+            );
+    }
+    vkDestroyFence(
+        upload_manager->device,
+        upload_manager->flush_fence,
+        NULL
+        );
+    vkDestroyCommandPool(
+        upload_manager->device,
+        upload_manager->graphics_command_pool,
+        NULL
+        );
+    vkDestroyCommandPool(
+        upload_manager->device,
+        upload_manager->transfer_command_pool,
+        NULL
+        );
+    vkDestroyBuffer(
+        upload_manager->device,
+        upload_manager->staging_buffer,
+        NULL
+        );
+    lna_vulkan_memory_allocator_free(
+        upload_manager->memory_allocator,
+        &upload_manager->staging_buffer_allocation
+        );
+    upload_manager->device = VK_NULL_HANDLE;
+}
@@ -0,0 +1,115 @@
+#ifndef LNA_BACKENDS_VULKAN_LNA_VULKAN_UPLOAD_MANAGER_H
+#define LNA_BACKENDS_VULKAN_LNA_VULKAN_UPLOAD_MANAGER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <vulkan/vulkan.h>
+#include "core/lna_memory_pool.h"
+#include "backends/vulkan/lna_vulkan_memory_allocator.h"
+
+//! uploads to device local buffers and images go through a persistently
+//! mapped staging ring buffer. The copies are recorded in a batch command
+//! buffer which is submitted on the transfer queue (a dedicated transfer
+//! queue family when the device has one) at the end of the frame, the frame
+//! submit waits for the batch semaphore on the gpu so the cpu never waits for
+//! an upload to complete. When the transfer queue family is not the graphics
+//! one, the ownership of the uploaded resources is released by the batch and
+//! acquired by a command buffer submitted before the frame command buffer.
+//! Batches are retired (and their staging memory reused) once their fence
+//! and the fence of the frame which acquired them have been signaled.
+
+#define LNA_VULKAN_MAX_UPLOAD_BATCHES 8
+//! stages of the frame submit waiting for the upload batches
+#define LNA_VULKAN_UPLOAD_WAIT_STAGES (VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT)
+
+typedef enum lna_vulkan_upload_batch_state_e
+{
+    LNA_VULKAN_UPLOAD_BATCH_STATE_FREE,
+    LNA_VULKAN_UPLOAD_BATCH_STATE_RECORDING,
+    LNA_VULKAN_UPLOAD_BATCH_STATE_SUBMITTED,    //! submitted on the transfer queue, not waited by a frame yet
+    LNA_VULKAN_UPLOAD_BATCH_STATE_ACQUIRED,     //! waited by the frame in flight acquire_frame
+    LNA_VULKAN_UPLOAD_BATCH_STATE_DONE,         //! the frame which waited for the batch is done
+} lna_vulkan_upload_batch_state_t;
+
+typedef struct lna_vulkan_upload_batch_s
+{
+    lna_vulkan_upload_batch_state_t state;
+    VkCommandBuffer                 command_buffer;
+    VkFence                         fence;
+    VkSemaphore                     semaphore;
+    VkDeviceSize                    staging_size;           //! staging memory used by the batch, including the padding
+    bool                            transfer_done;          //! fence signaled, the staging memory has been given back
+    uint64_t                        ticket;
+    uint32_t                        acquire_frame;
+    uint32_t                        upload_count;           //! uploads recorded by the batch, up to max_barrier_count
+    uint32_t                        buffer_barrier_count;   //! 0 when the transfer and graphics families are the same
+    uint32_t                        image_barrier_count;    //! 0 when the transfer and graphics families are the same
+    VkBufferMemoryBarrier*          buffer_barriers;        //! ownership acquire barriers
+    VkImageMemoryBarrier*           image_barriers;         //! ownership acquire barriers
+} lna_vulkan_upload_batch_t;
+
+typedef struct lna_vulkan_upload_manager_config_s
+{
+    VkDevice                        device;
+    VkPhysicalDevice                physical_device;
+    lna_vulkan_memory_allocator_t*  memory_allocator;
+    lna_memory_pool_t*              memory_pool;
+    uint32_t                        transfer_family;
+    VkQueue                         transfer_queue;
+    uint32_t                        graphics_family;
+    VkQueue                         graphics_queue;
+    uint32_t                        frame_count;            //! frames in flight
+    VkDeviceSize                    staging_buffer_size;
+    uint32_t                        max_barrier_count;      //! max resource count uploaded by a batch
+} lna_vulkan_upload_manager_config_t;
+
+typedef struct lna_vulkan_upload_manager_s
+{
+    VkDevice                        device;
+    lna_vulkan_memory_allocator_t*  memory_allocator;
+    uint32_t                        transfer_family;
+    VkQueue                         transfer_queue;
+    uint32_t                        graphics_family;
+    VkQueue                         graphics_queue;
+    VkCommandPool                   transfer_command_pool;
+    VkCommandPool                   graphics_command_pool;
+    VkCommandBuffer                 flush_command_buffer;
+    VkCommandBuffer*                acquire_command_buffers; //! one per frame in flight
+    uint32_t                        frame_count;
+    VkFence                         flush_fence;
+    VkBuffer                        staging_buffer;
+    lna_vulkan_memory_allocation_t  staging_buffer_allocation;
+    VkDeviceSize                    staging_buffer_size;
+    VkDeviceSize                    staging_head;           //! offset of the next staging reservation
+    VkDeviceSize                    staging_used_size;      //! staging memory used by all the batches not retired yet
+    VkDeviceSize                    copy_alignment;
+    uint32_t                        max_barrier_count;
+    lna_vulkan_upload_batch_t       batches[LNA_VULKAN_MAX_UPLOAD_BATCHES];
+    uint32_t                        first_batch;            //! oldest batch not retired yet
+    uint32_t                        batch_count;            //! batches not retired yet, the last one may be recording
+    uint64_t                        next_ticket;
+    uint64_t                        completed_ticket;       //! every upload with a ticket lower or equal is done
+    VkSemaphore                     wait_semaphores[LNA_VULKAN_MAX_UPLOAD_BATCHES];
+    uint32_t                        wait_semaphore_count;   //! semaphores the current frame submit must wait for
+} lna_vulkan_upload_manager_t;
+
+extern void             lna_vulkan_upload_manager_init          (lna_vulkan_upload_manager_t* upload_manager, const lna_vulkan_upload_manager_config_t* config);
+//! reserve size bytes of staging memory to fill and record their copy to dst at dst_offset.
+//! the returned pointer is valid until the next call to an upload manager function.
+//! ticket can be NULL, otherwise it receives the value to give to lna_vulkan_upload_manager_is_done.
+extern void*            lna_vulkan_upload_manager_upload_buffer (lna_vulkan_upload_manager_t* upload_manager, VkBuffer dst, VkDeviceSize dst_offset, VkDeviceSize size, uint64_t* ticket);
+//! same as lna_vulkan_upload_manager_upload_buffer for the first mip level of a 2D color image.
+//! the image layout goes from undefined to shader read only optimal.
+extern void*            lna_vulkan_upload_manager_upload_image  (lna_vulkan_upload_manager_t* upload_manager, VkImage dst, uint32_t width, uint32_t height, VkDeviceSize size, uint64_t* ticket);
+extern bool             lna_vulkan_upload_manager_is_done       (const lna_vulkan_upload_manager_t* upload_manager, uint64_t ticket);
+//! must be called once the fence of frame has been signaled.
+extern void             lna_vulkan_upload_manager_begin_frame   (lna_vulkan_upload_manager_t* upload_manager, uint32_t frame);
+//! submit the pending uploads, must be called right before the frame submit.
+//! the frame submit must wait for the upload_manager->wait_semaphores and execute the returned
+//! command buffer (if not VK_NULL_HANDLE) before the frame command buffer.
+extern VkCommandBuffer  lna_vulkan_upload_manager_end_frame     (lna_vulkan_upload_manager_t* upload_manager, uint32_t frame);
+//! submit the pending uploads and wait for all of them to be done, blocking.
+extern void             lna_vulkan_upload_manager_flush         (lna_vulkan_upload_manager_t* upload_manager);
+extern void             lna_vulkan_upload_manager_release       (lna_vulkan_upload_manager_t* upload_manager);
+
+#endif
@@ -0,0 +1,85 @@
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <string.h>
+#include "core/lna_file.h"
+#include "core/lna_assert.h"
+#include "core/lna_log.h"
+
+bool lna_file_map(lna_file_mapping_t* file_mapping, const char* filename)
+{
+    lna_assert(file_mapping)
+    lna_assert(file_mapping->content == NULL)
+    lna_assert(file_mapping->handle == NULL)
+    lna_assert(filename)
+    lna_assert(strlen(filename) > 0)
+
+    HANDLE file = CreateFileA(
+        filename,
+        GENERIC_READ,
+        FILE_SHARE_READ,
+        NULL,
+        OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+        NULL
+        );
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    //! the mapping object keeps its own reference on the file
+    HANDLE mapping = CreateFileMappingA(
+        file,
+        NULL,
+        PAGE_READONLY,
+        0,
+        0,
+        NULL
+        );
+    CloseHandle(file);
+    if (mapping == NULL)
+    {
+        lna_log_error("cannot create file mapping for %s", filename);
+        return false;
+    }
+
+    const char* content = MapViewOfFile(
+        mapping,
+        FILE_MAP_READ,
+        0,
+        0,
+        0
+        );
+    if (content == NULL)
+    {
+        lna_log_error("cannot map view of file %s", filename);
+        CloseHandle(mapping);
+        return false;
+    }
+
+    file_mapping->content   = content;
+    file_mapping->size      = (size_t)file_size.QuadPart;
+    file_mapping->handle    = mapping;
+    return true;
+}
+
+void lna_file_unmap(lna_file_mapping_t* file_mapping)
+{
+    lna_assert(file_mapping)
+    lna_assert(file_mapping->content)
+    lna_assert(file_mapping->handle)
+
+    UnmapViewOfFile(file_mapping->content);
+    CloseHandle((HANDLE)file_mapping->handle);
+
+    file_mapping->content   = NULL;
+    file_mapping->size      = 0;
+    file_mapping->handle    = NULL;
+}
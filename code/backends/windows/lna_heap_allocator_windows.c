@@ -4,7 +4,10 @@
 #include "core/lna_assert.h"
 #include "core/lna_log.h"
 
-void lna_heap_allocator_init(lna_heap_allocator_t* allocator, size_t max_size_in_bytes)
+//! pages are committed by blocks of at least this size to limit the system calls
+static const size_t LNA_HEAP_ALLOCATOR_MIN_COMMIT_GRANULARITY = 64 * 1024;
+
+void lna_heap_allocator_init_with_page_mode(lna_heap_allocator_t* allocator, size_t max_size_in_bytes, lna_heap_allocator_page_mode_t page_mode)
 {
     lna_assert(allocator)
     lna_assert(allocator->content == 0)
@@ -12,32 +15,61 @@ void lna_heap_allocator_init(lna_heap_allocator_t* allocator, size_t max_size_in
     lna_assert(allocator->max_content_size == 0)
     lna_assert(max_size_in_bytes > 0)
 
+    if (page_mode != LNA_HEAP_ALLOCATOR_PAGE_MODE_DEFAULT)
+    {
+        //! large pages must be committed at reservation and need the lock pages in memory privilege
+        lna_log_warning("huge pages are not supported by the windows heap allocator, fall back to default pages");
+    }
+
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+    allocator->commit_granularity   = system_info.dwPageSize > LNA_HEAP_ALLOCATOR_MIN_COMMIT_GRANULARITY ? system_info.dwPageSize : LNA_HEAP_ALLOCATOR_MIN_COMMIT_GRANULARITY;
+    allocator->max_content_size     = (max_size_in_bytes + allocator->commit_granularity - 1) / allocator->commit_granularity * allocator->commit_granularity;
+    allocator->committed_size       = 0;
+
     lna_log_message(
-        "allocate %d bytes in heap memory for allocator %p",
-        max_size_in_bytes,
-        allocator
+        "reserve %d bytes of address space for allocator %p, commit granularity %d bytes",
+        allocator->max_content_size,
+        allocator,
+        allocator->commit_granularity
         );
 
-    allocator->max_content_size = max_size_in_bytes;
     allocator->content = VirtualAlloc(
         0,
-        max_size_in_bytes,
-        MEM_RESERVE | MEM_COMMIT,
-        PAGE_EXECUTE_READWRITE
+        allocator->max_content_size,
+        MEM_RESERVE,
+        PAGE_NOACCESS
         );
     
     lna_assert(allocator->content)
 }
 
+void lna_heap_allocator_commit(lna_heap_allocator_t* allocator, size_t size_in_bytes)
+{
+    lna_assert(allocator)
+    lna_assert(allocator->content)
+    lna_assert(size_in_bytes > allocator->committed_size)
+    lna_assert(size_in_bytes <= allocator->max_content_size)
+
+    void* committed = VirtualAlloc(
+        allocator->content + allocator->committed_size,
+        size_in_bytes - allocator->committed_size,
+        MEM_COMMIT,
+        PAGE_READWRITE
+        );
+    lna_assert(committed)
+}
+
 void lna_heap_allocator_release(lna_heap_allocator_t* allocator)
 {
     lna_assert(allocator)
     lna_assert(allocator->content)
 
     lna_log_message(
-        "free all %d allocated heap memory bytes for allocator %p",
+        "free all %d reserved heap memory bytes for allocator %p, %d bytes were committed",
         allocator->max_content_size,
-        allocator
+        allocator,
+        allocator->committed_size
         );
 
     VirtualFree(
@@ -46,7 +78,13 @@ void lna_heap_allocator_release(lna_heap_allocator_t* allocator)
         MEM_RELEASE
         );
 
+#ifdef LNA_MEMORY_TRACKING
+    lna_memory_tracking_unregister(&allocator->stats);
+#endif
+
     allocator->content              = NULL;
     allocator->cur_content_offset   = 0;
     allocator->max_content_size     = 0;
+    allocator->committed_size       = 0;
+    allocator->commit_granularity   = 0;
 }
@@ -0,0 +1,131 @@
+#include "core/lna_atomic_memory_pool.h"
+#include "core/lna_memory_pool.h"
+#include "core/lna_heap_allocator.h"
+#include "core/lna_assert.h"
+
+static const size_t LNA_ATOMIC_MEMORY_POOL_DEFAULT_BLOCK_SIZE = 64 * 1024;
+
+static size_t lna_atomic_memory_pool_align_up(size_t size, size_t alignment)
+{
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+static void lna_atomic_memory_pool_init(lna_atomic_memory_pool_t* atomic_pool, char* region, size_t size_in_bytes, size_t block_size)
+{
+    atomic_pool->content            = (char*)lna_atomic_memory_pool_align_up((size_t)(uintptr_t)region, LNA_ATOMIC_MEMORY_POOL_CACHE_LINE_SIZE);
+    atomic_pool->max_content_size   = size_in_bytes;
+    atomic_pool->block_size         = lna_atomic_memory_pool_align_up(block_size == 0 ? LNA_ATOMIC_MEMORY_POOL_DEFAULT_BLOCK_SIZE : block_size, LNA_ATOMIC_MEMORY_POOL_CACHE_LINE_SIZE);
+    atomic_pool->empty_count        = 0;
+    atomic_init(&atomic_pool->cur_content_size, 0);
+}
+
+void lna_atomic_memory_pool_init_with_heap(lna_atomic_memory_pool_t* atomic_pool, lna_heap_allocator_t* allocator, size_t size_in_bytes, size_t block_size)
+{
+    lna_assert(atomic_pool)
+    lna_assert(atomic_pool->content == NULL)
+    lna_assert(atomic_pool->max_content_size == 0)
+    lna_assert(allocator)
+    lna_assert(size_in_bytes > 0)
+
+    //! the region is over reserved to align its start
+    char* region = lna_heap_allocator_alloc(
+        allocator,
+        size_in_bytes + LNA_ATOMIC_MEMORY_POOL_CACHE_LINE_SIZE - 1
+        );
+    lna_atomic_memory_pool_init(
+        atomic_pool,
+        region,
+        size_in_bytes,
+        block_size
+        );
+}
+
+void lna_atomic_memory_pool_init_with_pool(lna_atomic_memory_pool_t* atomic_pool, lna_memory_pool_t* memory_pool, size_t size_in_bytes, size_t block_size)
+{
+    lna_assert(atomic_pool)
+    lna_assert(atomic_pool->content == NULL)
+    lna_assert(atomic_pool->max_content_size == 0)
+    lna_assert(memory_pool)
+    lna_assert(size_in_bytes > 0)
+
+    char* region = lna_memory_pool_reserve(
+        memory_pool,
+        size_in_bytes + LNA_ATOMIC_MEMORY_POOL_CACHE_LINE_SIZE - 1
+        );
+    lna_atomic_memory_pool_init(
+        atomic_pool,
+        region,
+        size_in_bytes,
+        block_size
+        );
+}
+
+void* lna_atomic_memory_pool_reserve(lna_atomic_memory_pool_t* atomic_pool, size_t size_in_bytes)
+{
+    lna_assert(atomic_pool)
+    lna_assert(atomic_pool->content)
+    lna_assert(size_in_bytes > 0)
+
+    //! the reservations are only ordered with the empty, which is done while no thread reserves
+    const size_t aligned_size   = lna_atomic_memory_pool_align_up(size_in_bytes, LNA_ATOMIC_MEMORY_POOL_CACHE_LINE_SIZE);
+    const size_t offset         = atomic_fetch_add_explicit(
+        &atomic_pool->cur_content_size,
+        aligned_size,
+        memory_order_relaxed
+        );
+    lna_assert(offset + aligned_size <= atomic_pool->max_content_size)
+
+    return atomic_pool->content + offset;
+}
+
+void lna_atomic_memory_pool_empty(lna_atomic_memory_pool_t* atomic_pool)
+{
+    lna_assert(atomic_pool)
+
+    atomic_store_explicit(
+        &atomic_pool->cur_content_size,
+        0,
+        memory_order_relaxed
+        );
+    ++atomic_pool->empty_count;
+}
+
+void lna_atomic_memory_pool_cursor_init(lna_atomic_memory_pool_cursor_t* cursor, lna_atomic_memory_pool_t* atomic_pool)
+{
+    lna_assert(cursor)
+    lna_assert(atomic_pool)
+    lna_assert(atomic_pool->content)
+
+    cursor->pool        = atomic_pool;
+    cursor->cur         = NULL;
+    cursor->end         = NULL;
+    cursor->empty_count = atomic_pool->empty_count;
+}
+
+void* lna_atomic_memory_pool_cursor_reserve(lna_atomic_memory_pool_cursor_t* cursor, size_t size_in_bytes, size_t alignment)
+{
+    lna_assert(cursor)
+    lna_assert(cursor->pool)
+    lna_assert(alignment > 0 && (alignment & (alignment - 1)) == 0)
+    lna_assert(alignment <= LNA_ATOMIC_MEMORY_POOL_CACHE_LINE_SIZE)
+    lna_assert(size_in_bytes > 0)
+
+    if (cursor->empty_count != cursor->pool->empty_count)
+    {
+        //! the block of the cursor has been given back by the empty
+        cursor->cur         = NULL;
+        cursor->end         = NULL;
+        cursor->empty_count = cursor->pool->empty_count;
+    }
+
+    char* address = (char*)lna_atomic_memory_pool_align_up((size_t)(uintptr_t)cursor->cur, alignment);
+    if (cursor->cur == NULL || address + size_in_bytes > cursor->end)
+    {
+        //! the rest of the current block is lost, a reservation bigger than a block gets its own block
+        const size_t block_size = size_in_bytes > cursor->pool->block_size ? size_in_bytes : cursor->pool->block_size;
+        address     = lna_atomic_memory_pool_reserve(cursor->pool, block_size);
+        cursor->end = address + lna_atomic_memory_pool_align_up(block_size, LNA_ATOMIC_MEMORY_POOL_CACHE_LINE_SIZE);
+    }
+    cursor->cur = address + size_in_bytes;
+    return address;
+}
@@ -0,0 +1,52 @@
+#ifndef LNA_CORE_LNA_ATOMIC_MEMORY_POOL_H
+#define LNA_CORE_LNA_ATOMIC_MEMORY_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+#define LNA_ATOMIC_MEMORY_POOL_CACHE_LINE_SIZE 64
+
+typedef struct lna_heap_allocator_s lna_heap_allocator_t;
+typedef struct lna_memory_pool_s    lna_memory_pool_t;
+
+//! memory pool whose reservations can be made by several threads at the same
+//! time without lock: the top of the pool is moved by an atomic add. To avoid
+//! an atomic operation, and the contention on it, for each reservation a
+//! thread takes cache line aligned blocks from the pool with a cursor and
+//! reserves in them with no synchronization. The blocks of two threads never
+//! share a cache line.
+//! The empty is not thread safe: no thread may reserve while the pool is
+//! emptied, the cursors see it and take a new block at their next reservation.
+typedef struct lna_atomic_memory_pool_s
+{
+    atomic_size_t   cur_content_size;
+    size_t          max_content_size;
+    size_t          block_size;
+    uint32_t        empty_count;
+    char*           content;            //! cache line aligned
+} lna_atomic_memory_pool_t;
+
+//! owned by one thread.
+typedef struct lna_atomic_memory_pool_cursor_s
+{
+    lna_atomic_memory_pool_t*   pool;
+    char*                       cur;
+    char*                       end;
+    uint32_t                    empty_count;
+} lna_atomic_memory_pool_cursor_t;
+
+//! block_size is rounded up to the cache line size, set it to 0 to use default value.
+extern void     lna_atomic_memory_pool_init_with_heap   (lna_atomic_memory_pool_t* atomic_pool, lna_heap_allocator_t* allocator, size_t size_in_bytes, size_t block_size);
+//! the pool uses a region of size_in_bytes reserved in memory_pool, it has the lifetime of the pool content.
+extern void     lna_atomic_memory_pool_init_with_pool   (lna_atomic_memory_pool_t* atomic_pool, lna_memory_pool_t* memory_pool, size_t size_in_bytes, size_t block_size);
+//! thread safe, one atomic operation per call, the reservation is cache line aligned.
+//! for the rare or big reservations, the others should go through a cursor.
+extern void*    lna_atomic_memory_pool_reserve          (lna_atomic_memory_pool_t* atomic_pool, size_t size_in_bytes);
+extern void     lna_atomic_memory_pool_empty            (lna_atomic_memory_pool_t* atomic_pool);
+
+extern void     lna_atomic_memory_pool_cursor_init      (lna_atomic_memory_pool_cursor_t* cursor, lna_atomic_memory_pool_t* atomic_pool);
+//! alignment must be a power of two, not greater than the cache line size.
+extern void*    lna_atomic_memory_pool_cursor_reserve   (lna_atomic_memory_pool_cursor_t* cursor, size_t size_in_bytes, size_t alignment);
+
+#endif
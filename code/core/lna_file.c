@@ -78,3 +78,27 @@ void lna_binary_file_debug_load_uint32(lna_binary_file_content_uint32_t* file_co
     }
     fclose(fp);
 }
+
+bool lna_file_write(const char* filename, const void* content, size_t size)
+{
+    lna_assert(filename)
+    lna_assert(strlen(filename) > 0)
+    lna_assert(content)
+    lna_assert(size > 0)
+
+    FILE* fp = NULL;
+    fopen_s(&fp, filename, "wb");
+    if (!fp)
+    {
+        return false;
+    }
+
+    size_t count = fwrite(
+        content,
+        sizeof(char),
+        size,
+        fp
+        );
+    fclose(fp);
+    return count == size;
+}
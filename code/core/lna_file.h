@@ -18,7 +18,23 @@ typedef struct lna_binary_file_content_uint32_s
     size_t      size;
 } lna_binary_file_content_uint32_t;
 
+//! read only view of a whole file mapped in memory, the content is loaded
+//! by the os on demand and is not copied in a memory pool.
+typedef struct lna_file_mapping_s
+{
+    const char* content;
+    size_t      size;
+    void*       handle;     //! platform specific
+} lna_file_mapping_t;
+
 extern void lna_file_debug_load(lna_file_content_t* file_content, lna_memory_pool_t* memory_pool, const char* filename, bool is_binary);
 extern void lna_binary_file_debug_load_uint32(lna_binary_file_content_uint32_t* file_content, lna_memory_pool_t* memory_pool, const char* filename);
+//! write size bytes of content in filename, the file is created or truncated. return false if the file cannot be written.
+extern bool lna_file_write(const char* filename, const void* content, size_t size);
+
+//! file mapping functions are implemented by the platform backends.
+//! return false if the file does not exist, is empty or cannot be mapped.
+extern bool lna_file_map(lna_file_mapping_t* file_mapping, const char* filename);
+extern void lna_file_unmap(lna_file_mapping_t* file_mapping);
 
 #endif
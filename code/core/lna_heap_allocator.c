@@ -2,13 +2,61 @@
 #include "core/lna_assert.h"
 #include "core/lna_log.h"
 
+void lna_heap_allocator_init(lna_heap_allocator_t* allocator, size_t max_size_in_bytes)
+{
+    lna_heap_allocator_init_with_page_mode(
+        allocator,
+        max_size_in_bytes,
+        LNA_HEAP_ALLOCATOR_PAGE_MODE_DEFAULT
+        );
+}
+
+#ifdef LNA_MEMORY_TRACKING
+char* lna_heap_allocator_alloc_tagged(lna_heap_allocator_t* allocator, size_t size_in_bytes, const char* tag)
+#else
 char* lna_heap_allocator_alloc(lna_heap_allocator_t* allocator, size_t size_in_bytes)
+#endif
 {
     lna_assert(allocator)
     lna_assert(allocator->content)
+    lna_assert(allocator->commit_granularity > 0)
     lna_assert(allocator->cur_content_offset + size_in_bytes <= allocator->max_content_size)
 
+#ifdef LNA_MEMORY_TRACKING
+    if (allocator->cur_content_offset == 0)
+    {
+        lna_memory_tracking_register(
+            &allocator->stats,
+            "heap allocator",
+            allocator->max_content_size
+            );
+    }
+#endif
+
     size_t offset = allocator->cur_content_offset;
     allocator->cur_content_offset += size_in_bytes;
+#ifdef LNA_MEMORY_TRACKING
+    lna_memory_tracking_record(
+        &allocator->stats,
+        allocator->cur_content_offset,
+        size_in_bytes,
+        tag
+        );
+#endif
+
+    if (allocator->cur_content_offset > allocator->committed_size)
+    {
+        size_t commit_size = (allocator->cur_content_offset + allocator->commit_granularity - 1) / allocator->commit_granularity * allocator->commit_granularity;
+        if (commit_size > allocator->max_content_size)
+        {
+            commit_size = allocator->max_content_size;
+        }
+        lna_heap_allocator_commit(
+            allocator,
+            commit_size
+            );
+        allocator->committed_size = commit_size;
+    }
+
     return allocator->content + offset;
 }
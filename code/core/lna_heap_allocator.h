@@ -2,16 +2,43 @@
 #define LNA_CORE_LNA_HEAP_ALLOCATOR_H
 
 #include <stddef.h>
+#include "core/lna_memory_tracking.h"
 
+typedef enum lna_heap_allocator_page_mode_e
+{
+    LNA_HEAP_ALLOCATOR_PAGE_MODE_DEFAULT,
+    LNA_HEAP_ALLOCATOR_PAGE_MODE_TRANSPARENT_HUGE,  //! ask the system to back the memory with huge pages when it can
+    LNA_HEAP_ALLOCATOR_PAGE_MODE_EXPLICIT_HUGE,     //! use the reserved huge pages, falls back to transparent huge pages if there are none
+} lna_heap_allocator_page_mode_t;
+
+//! the address space is reserved at init and the pages are committed, by
+//! blocks of commit_granularity bytes, as the allocations advance. The
+//! memory is not executable.
 typedef struct lna_heap_allocator_s
 {
-    size_t  cur_content_offset;
-    size_t  max_content_size;
-    char*   content;
+    size_t              cur_content_offset;
+    size_t              max_content_size;
+    size_t              committed_size;
+    size_t              commit_granularity;
+    char*               content;
+#ifdef LNA_MEMORY_TRACKING
+    lna_memory_stats_t  stats;              //! registered at the first allocation, unregistered at release
+#endif
 } lna_heap_allocator_t;
 
-extern void     lna_heap_allocator_init      (lna_heap_allocator_t* allocator, size_t max_size_in_bytes);
-extern char*    lna_heap_allocator_alloc     (lna_heap_allocator_t* allocator, size_t size_in_bytes);
-extern void     lna_heap_allocator_release   (lna_heap_allocator_t* allocator);
+extern void     lna_heap_allocator_init                 (lna_heap_allocator_t* allocator, size_t max_size_in_bytes);
+extern void     lna_heap_allocator_init_with_page_mode  (lna_heap_allocator_t* allocator, size_t max_size_in_bytes, lna_heap_allocator_page_mode_t page_mode);
+extern char*    lna_heap_allocator_alloc                (lna_heap_allocator_t* allocator, size_t size_in_bytes);
+extern void     lna_heap_allocator_release              (lna_heap_allocator_t* allocator);
+
+//! implemented by the platform backends, called by lna_heap_allocator_alloc
+//! to commit the pages up to size_in_bytes (a multiple of commit_granularity).
+extern void     lna_heap_allocator_commit               (lna_heap_allocator_t* allocator, size_t size_in_bytes);
+
+#ifdef LNA_MEMORY_TRACKING
+extern char*    lna_heap_allocator_alloc_tagged         (lna_heap_allocator_t* allocator, size_t size_in_bytes, const char* tag);
+
+#define lna_heap_allocator_alloc(allocator, size_in_bytes) lna_heap_allocator_alloc_tagged(allocator, size_in_bytes, LNA_MEMORY_TRACKING_TAG)
+#endif
 
 #endif
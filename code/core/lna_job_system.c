@@ -0,0 +1,423 @@
+#include <string.h>
+#include "core/lna_job_system.h"
+#include "core/lna_memory_pool.h"
+#include "core/lna_assert.h"
+#include "core/lna_log.h"
+#include "system/lna_thread.h"
+
+#define LNA_JOB_SYSTEM_CACHE_LINE_SIZE                  64
+#define LNA_JOB_SYSTEM_RANGES_PER_WORKER                4
+#define LNA_JOB_SYSTEM_MAX_PARALLEL_FOR_RANGE_COUNT     (LNA_JOB_SYSTEM_MAX_WORKER_COUNT * LNA_JOB_SYSTEM_RANGES_PER_WORKER)
+
+static const uint32_t LNA_JOB_SYSTEM_DEFAULT_MAX_QUEUED_JOB_COUNT = 4096;
+
+typedef struct lna_job_queue_item_s
+{
+    lna_job_t           job;
+    lna_job_counter_t*  counter;
+} lna_job_queue_item_t;
+
+//! storage of a queued item: a thief may read a slot while the owner writes
+//! it again once the top has moved past it, the read item is then dropped by
+//! the failed compare exchange of the steal. The fields are atomic so the
+//! race is on relaxed accesses, the bottom and the top order them.
+typedef struct lna_job_queue_slot_s
+{
+    _Atomic(lna_job_function_t) function;
+    _Atomic(void*)              data;
+    _Atomic(lna_job_counter_t*) counter;
+} lna_job_queue_slot_t;
+
+//! top and bottom are on different cache lines, so the steals do not slow
+//! down the owner pushing and popping at the bottom.
+typedef struct lna_job_worker_s
+{
+    _Atomic int64_t         top;
+    char                    top_padding[LNA_JOB_SYSTEM_CACHE_LINE_SIZE - sizeof(_Atomic int64_t)];
+    _Atomic int64_t         bottom;
+    lna_job_queue_slot_t*   slots;
+    int64_t                 slot_mask;
+    uint32_t                random_state;
+    lna_job_system_t*       job_system;
+    lna_thread_t*           thread;
+    char                    end_padding[LNA_JOB_SYSTEM_CACHE_LINE_SIZE];
+} lna_job_worker_t;
+
+typedef struct lna_job_parallel_for_range_s
+{
+    lna_job_parallel_for_function_t function;
+    void*                           data;
+    uint32_t                        begin;
+    uint32_t                        end;
+} lna_job_parallel_for_range_t;
+
+//! worker of the calling thread, NULL for the threads that are not part of a job system.
+static _Thread_local lna_job_worker_t* g_job_worker = NULL;
+
+//! ============================================================================
+//!                             LOCAL FUNCTIONS
+//! ============================================================================
+
+static uint32_t lna_job_system_round_up_power_of_two(uint32_t value)
+{
+    uint32_t result = 1;
+    while (result < value)
+    {
+        result <<= 1;
+    }
+    return result;
+}
+
+static void lna_job_queue_slot_store(lna_job_queue_slot_t* slot, const lna_job_queue_item_t* item)
+{
+    atomic_store_explicit(&slot->function, item->job.function, memory_order_relaxed);
+    atomic_store_explicit(&slot->data, item->job.data, memory_order_relaxed);
+    atomic_store_explicit(&slot->counter, item->counter, memory_order_relaxed);
+}
+
+static void lna_job_queue_slot_load(lna_job_queue_slot_t* slot, lna_job_queue_item_t* item)
+{
+    item->job.function  = atomic_load_explicit(&slot->function, memory_order_relaxed);
+    item->job.data      = atomic_load_explicit(&slot->data, memory_order_relaxed);
+    item->counter       = atomic_load_explicit(&slot->counter, memory_order_relaxed);
+}
+
+//! owner only.
+static bool lna_job_worker_push(lna_job_worker_t* worker, const lna_job_queue_item_t* item)
+{
+    const int64_t bottom    = atomic_load_explicit(&worker->bottom, memory_order_relaxed);
+    const int64_t top       = atomic_load_explicit(&worker->top, memory_order_acquire);
+    if (bottom - top > worker->slot_mask)
+    {
+        return false;
+    }
+    lna_job_queue_slot_store(
+        &worker->slots[bottom & worker->slot_mask],
+        item
+        );
+    atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_release);
+    return true;
+}
+
+//! owner only.
+static bool lna_job_worker_pop(lna_job_worker_t* worker, lna_job_queue_item_t* item)
+{
+    const int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&worker->bottom, bottom, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t top = atomic_load_explicit(&worker->top, memory_order_relaxed);
+
+    bool found = false;
+    if (top <= bottom)
+    {
+        lna_job_queue_slot_load(
+            &worker->slots[bottom & worker->slot_mask],
+            item
+            );
+        found = true;
+        if (top == bottom)
+        {
+            //! last item: the thieves may take it at the same time, the top decides
+            found = atomic_compare_exchange_strong_explicit(
+                &worker->top,
+                &top,
+                top + 1,
+                memory_order_seq_cst,
+                memory_order_relaxed
+                );
+            atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+        }
+    }
+    else
+    {
+        atomic_store_explicit(&worker->bottom, bottom + 1, memory_order_relaxed);
+    }
+    return found;
+}
+
+//! any thread.
+static bool lna_job_worker_steal(lna_job_worker_t* worker, lna_job_queue_item_t* item)
+{
+    int64_t top = atomic_load_explicit(&worker->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    const int64_t bottom = atomic_load_explicit(&worker->bottom, memory_order_acquire);
+
+    if (top >= bottom)
+    {
+        return false;
+    }
+    //! the item is copied before taking it: once the top moves the owner can reuse the slot
+    lna_job_queue_slot_load(
+        &worker->slots[top & worker->slot_mask],
+        item
+        );
+    return atomic_compare_exchange_strong_explicit(
+        &worker->top,
+        &top,
+        top + 1,
+        memory_order_seq_cst,
+        memory_order_relaxed
+        );
+}
+
+static void lna_job_system_execute(const lna_job_queue_item_t* item)
+{
+    item->job.function(item->job.data);
+    if (item->counter)
+    {
+        atomic_fetch_sub_explicit(&item->counter->count, 1, memory_order_release);
+    }
+}
+
+static bool lna_job_system_try_run_one(lna_job_system_t* job_system, lna_job_worker_t* worker)
+{
+    lna_job_queue_item_t item;
+    bool found = lna_job_worker_pop(worker, &item);
+
+    if (!found && job_system->worker_count > 1)
+    {
+        //! xorshift, the victims are visited from a random one to spread the steals
+        worker->random_state ^= worker->random_state << 13;
+        worker->random_state ^= worker->random_state >> 17;
+        worker->random_state ^= worker->random_state << 5;
+        const uint32_t first_victim = worker->random_state % job_system->worker_count;
+        for (uint32_t i = 0; !found && i < job_system->worker_count; ++i)
+        {
+            lna_job_worker_t* victim = &job_system->workers[(first_victim + i) % job_system->worker_count];
+            if (victim != worker)
+            {
+                found = lna_job_worker_steal(victim, &item);
+            }
+        }
+    }
+
+    if (found)
+    {
+        atomic_fetch_sub(&job_system->queued_job_count, 1);
+        lna_job_system_execute(&item);
+    }
+    return found;
+}
+
+static int lna_job_system_worker_main(void* data)
+{
+    lna_job_worker_t* worker        = data;
+    lna_job_system_t* job_system    = worker->job_system;
+    g_job_worker = worker;
+
+    while (atomic_load(&job_system->running))
+    {
+        if (lna_job_system_try_run_one(job_system, worker))
+        {
+            continue;
+        }
+
+        //! a thread queuing jobs increments the queued job count before
+        //! reading the sleeping worker count, so either the jobs are seen
+        //! here or this worker is woken up.
+        atomic_fetch_add(&job_system->sleeping_worker_count, 1);
+        if (atomic_load(&job_system->queued_job_count) == 0 && atomic_load(&job_system->running))
+        {
+            lna_semaphore_wait(job_system->wake_semaphore);
+        }
+        atomic_fetch_sub(&job_system->sleeping_worker_count, 1);
+    }
+    return 0;
+}
+
+static void lna_job_system_run_parallel_for_range(void* data)
+{
+    const lna_job_parallel_for_range_t* range = data;
+    range->function(range->data, range->begin, range->end);
+}
+
+//! ============================================================================
+//!                             PUBLIC FUNCTIONS
+//! ============================================================================
+
+void lna_job_system_init(lna_job_system_t* job_system, const lna_job_system_config_t* config)
+{
+    lna_assert(job_system)
+    lna_assert(job_system->workers == NULL)
+    lna_assert(job_system->worker_count == 0)
+    lna_assert(config)
+    lna_assert(config->memory_pool)
+    lna_assert(g_job_worker == NULL)
+
+    uint32_t worker_count = config->worker_count > 0 ? config->worker_count : lna_thread_cpu_count();
+    worker_count = worker_count < LNA_JOB_SYSTEM_MAX_WORKER_COUNT ? worker_count : LNA_JOB_SYSTEM_MAX_WORKER_COUNT;
+    const uint32_t max_queued_job_count = lna_job_system_round_up_power_of_two(
+        config->max_queued_job_count > 0 ? config->max_queued_job_count : LNA_JOB_SYSTEM_DEFAULT_MAX_QUEUED_JOB_COUNT
+        );
+
+    job_system->worker_count    = worker_count;
+    job_system->workers         = lna_memory_pool_reserve(
+        config->memory_pool,
+        sizeof(lna_job_worker_t) * worker_count
+        );
+    job_system->wake_semaphore  = lna_semaphore_new(0);
+    memset(job_system->workers, 0, sizeof(lna_job_worker_t) * worker_count);
+
+    atomic_init(&job_system->running, true);
+    atomic_init(&job_system->queued_job_count, 0);
+    atomic_init(&job_system->sleeping_worker_count, 0);
+
+    for (uint32_t i = 0; i < worker_count; ++i)
+    {
+        lna_job_worker_t* worker = &job_system->workers[i];
+        atomic_init(&worker->top, 0);
+        atomic_init(&worker->bottom, 0);
+        worker->slots           = lna_memory_pool_reserve(
+            config->memory_pool,
+            sizeof(lna_job_queue_slot_t) * max_queued_job_count
+            );
+        worker->slot_mask       = (int64_t)max_queued_job_count - 1;
+        worker->random_state    = 2463534242u + i * 0x9E3779B9u;
+        worker->job_system      = job_system;
+    }
+
+    g_job_worker = &job_system->workers[0];
+    for (uint32_t i = 1; i < worker_count; ++i)
+    {
+        job_system->workers[i].thread = lna_thread_start(
+            lna_job_system_worker_main,
+            &job_system->workers[i],
+            "lna_job_worker"
+            );
+    }
+
+    lna_log_message("job system started with %d workers", worker_count);
+}
+
+void lna_job_system_release(lna_job_system_t* job_system)
+{
+    lna_assert(job_system)
+    lna_assert(job_system->workers)
+    lna_assert(g_job_worker == &job_system->workers[0])
+    lna_assert(atomic_load(&job_system->queued_job_count) == 0)
+
+    atomic_store(&job_system->running, false);
+    for (uint32_t i = 1; i < job_system->worker_count; ++i)
+    {
+        lna_semaphore_post(job_system->wake_semaphore);
+    }
+    for (uint32_t i = 1; i < job_system->worker_count; ++i)
+    {
+        lna_thread_wait(job_system->workers[i].thread);
+        job_system->workers[i].thread = NULL;
+    }
+    lna_semaphore_delete(job_system->wake_semaphore);
+
+    g_job_worker                = NULL;
+    job_system->workers         = NULL;
+    job_system->wake_semaphore  = NULL;
+    job_system->worker_count    = 0;
+}
+
+void lna_job_system_run(lna_job_system_t* job_system, const lna_job_t* jobs, uint32_t job_count, lna_job_counter_t* counter)
+{
+    lna_assert(job_system)
+    lna_assert(job_system->workers)
+    lna_assert(g_job_worker && g_job_worker->job_system == job_system)
+    lna_assert(jobs || job_count == 0)
+
+    if (counter)
+    {
+        atomic_fetch_add(&counter->count, job_count);
+    }
+    atomic_fetch_add(&job_system->queued_job_count, job_count);
+
+    for (uint32_t i = 0; i < job_count; ++i)
+    {
+        lna_assert(jobs[i].function)
+
+        const lna_job_queue_item_t item =
+        {
+            .job        = jobs[i],
+            .counter    = counter,
+        };
+        if (!lna_job_worker_push(g_job_worker, &item))
+        {
+            atomic_fetch_sub(&job_system->queued_job_count, 1);
+            lna_job_system_execute(&item);
+        }
+    }
+
+    uint32_t sleeping_worker_count = atomic_load(&job_system->sleeping_worker_count);
+    sleeping_worker_count = sleeping_worker_count < job_count ? sleeping_worker_count : job_count;
+    for (uint32_t i = 0; i < sleeping_worker_count; ++i)
+    {
+        lna_semaphore_post(job_system->wake_semaphore);
+    }
+}
+
+void lna_job_system_wait(lna_job_system_t* job_system, lna_job_counter_t* counter)
+{
+    lna_assert(job_system)
+    lna_assert(g_job_worker && g_job_worker->job_system == job_system)
+    lna_assert(counter)
+
+    while (atomic_load_explicit(&counter->count, memory_order_acquire) > 0)
+    {
+        if (!lna_job_system_try_run_one(job_system, g_job_worker))
+        {
+            lna_thread_yield();
+        }
+    }
+}
+
+void lna_job_system_parallel_for(lna_job_system_t* job_system, uint32_t count, uint32_t min_range_size, lna_job_parallel_for_function_t function, void* data)
+{
+    lna_assert(job_system)
+    lna_assert(function)
+
+    min_range_size = min_range_size > 0 ? min_range_size : 1;
+
+    const uint32_t  max_range_count = job_system->worker_count * LNA_JOB_SYSTEM_RANGES_PER_WORKER;
+    uint32_t        range_count     = (count + min_range_size - 1) / min_range_size;
+    range_count = range_count < max_range_count ? range_count : max_range_count;
+    if (range_count <= 1)
+    {
+        if (count > 0)
+        {
+            function(data, 0, count);
+        }
+        return;
+    }
+
+    const uint32_t range_size = (count + range_count - 1) / range_count;
+    range_count = (count + range_size - 1) / range_size;
+
+    lna_job_parallel_for_range_t    ranges[LNA_JOB_SYSTEM_MAX_PARALLEL_FOR_RANGE_COUNT];
+    lna_job_t                       jobs[LNA_JOB_SYSTEM_MAX_PARALLEL_FOR_RANGE_COUNT];
+    for (uint32_t i = 0; i < range_count; ++i)
+    {
+        ranges[i].function  = function;
+        ranges[i].data      = data;
+        ranges[i].begin     = i * range_size;
+        ranges[i].end       = (i + 1) * range_size < count ? (i + 1) * range_size : count;
+        jobs[i].function    = lna_job_system_run_parallel_for_range;
+        jobs[i].data        = &ranges[i];
+    }
+
+    lna_job_counter_t counter;
+    atomic_init(&counter.count, 0);
+    lna_job_system_run(
+        job_system,
+        jobs,
+        range_count,
+        &counter
+        );
+    lna_job_system_wait(
+        job_system,
+        &counter
+        );
+}
+
+uint32_t lna_job_system_worker_index(const lna_job_system_t* job_system)
+{
+    lna_assert(job_system)
+    lna_assert(g_job_worker && g_job_worker->job_system == job_system)
+
+    return (uint32_t)(g_job_worker - job_system->workers);
+}
@@ -0,0 +1,66 @@
+#ifndef LNA_CORE_LNA_JOB_SYSTEM_H
+#define LNA_CORE_LNA_JOB_SYSTEM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+#define LNA_JOB_SYSTEM_MAX_WORKER_COUNT 32
+
+typedef struct lna_memory_pool_s    lna_memory_pool_t;
+typedef struct lna_semaphore_s      lna_semaphore_t;
+typedef struct lna_job_worker_s     lna_job_worker_t;
+
+typedef void (*lna_job_function_t)(void* data);
+typedef void (*lna_job_parallel_for_function_t)(void* data, uint32_t begin, uint32_t end);
+
+typedef struct lna_job_s
+{
+    lna_job_function_t  function;
+    void*               data;
+} lna_job_t;
+
+//! count of the jobs run with the counter that are not finished. A job
+//! depending on other jobs waits on their counter: the waiting thread runs
+//! the queued jobs meanwhile, so a dependency never blocks a worker.
+typedef struct lna_job_counter_s
+{
+    atomic_uint         count;
+} lna_job_counter_t;
+
+typedef struct lna_job_system_config_s
+{
+    lna_memory_pool_t*  memory_pool;
+    uint32_t            worker_count;           //! threads running jobs, including the one calling lna_job_system_init, set to 0 to use default value (cpu count)
+    uint32_t            max_queued_job_count;   //! capacity of the queue of each worker, rounded up to a power of two, set to 0 to use default value
+} lna_job_system_config_t;
+
+//! each worker has a queue of jobs it pushes and pops at the bottom while the
+//! idle workers steal from the top (Chase-Lev deque), so the workers only
+//! synchronize when they run out of jobs. The idle workers sleep until jobs
+//! are queued.
+//! The thread calling lna_job_system_init is the first worker, it only runs
+//! jobs when it waits. The jobs are run from this thread or from a job.
+typedef struct lna_job_system_s
+{
+    uint32_t            worker_count;
+    lna_job_worker_t*   workers;
+    lna_semaphore_t*    wake_semaphore;
+    atomic_bool         running;
+    atomic_uint         queued_job_count;
+    atomic_uint         sleeping_worker_count;
+} lna_job_system_t;
+
+extern void     lna_job_system_init         (lna_job_system_t* job_system, const lna_job_system_config_t* config);
+//! the queued jobs must be finished.
+extern void     lna_job_system_release      (lna_job_system_t* job_system);
+//! counter can be NULL. A job that does not fit in the queue is run immediately.
+extern void     lna_job_system_run          (lna_job_system_t* job_system, const lna_job_t* jobs, uint32_t job_count, lna_job_counter_t* counter);
+//! run the queued jobs until the counter reaches 0.
+extern void     lna_job_system_wait         (lna_job_system_t* job_system, lna_job_counter_t* counter);
+//! split [0, count[ in ranges of at least min_range_size indices, run them as jobs and wait for them.
+extern void     lna_job_system_parallel_for (lna_job_system_t* job_system, uint32_t count, uint32_t min_range_size, lna_job_parallel_for_function_t function, void* data);
+//! index of the worker of the calling thread, from 0 to worker_count - 1, to give each worker its own resources.
+extern uint32_t lna_job_system_worker_index (const lna_job_system_t* job_system);
+
+#endif
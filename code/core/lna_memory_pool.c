@@ -2,7 +2,11 @@
 #include "core/lna_assert.h"
 #include "core/lna_heap_allocator.h"
 
+#ifdef LNA_MEMORY_TRACKING
+void lna_memory_pool_init_with_heap_tagged(lna_memory_pool_t* memory_pool, lna_heap_allocator_t* allocator, size_t size_in_bytes, const char* tag)
+#else
 void lna_memory_pool_init_with_heap(lna_memory_pool_t* memory_pool, lna_heap_allocator_t* allocator, size_t size_in_bytes)
+#endif
 {
     lna_assert(memory_pool)
     lna_assert(memory_pool->content == 0)
@@ -16,14 +20,31 @@ void lna_memory_pool_init_with_heap(lna_memory_pool_t* memory_pool, lna_heap_all
         memory_pool
         );
 
+#ifdef LNA_MEMORY_TRACKING
+    memory_pool->content = lna_heap_allocator_alloc_tagged(
+        allocator,
+        size_in_bytes,
+        tag
+        );
+    lna_memory_tracking_register(
+        &memory_pool->stats,
+        tag,
+        size_in_bytes
+        );
+#else
     memory_pool->content = lna_heap_allocator_alloc(
         allocator,
         size_in_bytes
         );
+#endif
     memory_pool->max_content_size = size_in_bytes;
 }
 
+#ifdef LNA_MEMORY_TRACKING
+void* lna_memory_pool_reserve_tagged(lna_memory_pool_t* memory_pool, size_t size_in_bytes, const char* tag)
+#else
 void* lna_memory_pool_reserve(lna_memory_pool_t* memory_pool, size_t size_in_bytes)
+#endif
 {
     lna_assert(memory_pool)
     lna_assert(memory_pool->content)
@@ -32,6 +53,14 @@ void* lna_memory_pool_reserve(lna_memory_pool_t* memory_pool, size_t size_in_byt
 
     size_t offset = memory_pool->cur_content_size;
     memory_pool->cur_content_size += size_in_bytes;
+#ifdef LNA_MEMORY_TRACKING
+    lna_memory_tracking_record(
+        &memory_pool->stats,
+        memory_pool->cur_content_size,
+        size_in_bytes,
+        tag
+        );
+#endif
     return (void*)(memory_pool->content + offset);
 }
 
@@ -39,4 +68,18 @@ void lna_memory_pool_empty(lna_memory_pool_t* memory_pool)
 {
     lna_assert(memory_pool)
     memory_pool->cur_content_size = 0;
+#ifdef LNA_MEMORY_TRACKING
+    lna_memory_tracking_end_cycle(&memory_pool->stats);
+#endif
+}
+
+void lna_memory_pool_release(lna_memory_pool_t* memory_pool)
+{
+    lna_assert(memory_pool)
+#ifdef LNA_MEMORY_TRACKING
+    lna_memory_tracking_unregister(&memory_pool->stats);
+#endif
+    memory_pool->content            = NULL;
+    memory_pool->cur_content_size   = 0;
+    memory_pool->max_content_size   = 0;
 }
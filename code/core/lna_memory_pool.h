@@ -2,12 +2,16 @@
 #define LNA_CORE_LNA_MEMORY_POOL_H
 
 #include <stddef.h>
+#include "core/lna_memory_tracking.h"
 
 typedef struct lna_memory_pool_s
 {
-    size_t  cur_content_size;
-    size_t  max_content_size;
-    char*   content;
+    size_t              cur_content_size;
+    size_t              max_content_size;
+    char*               content;
+#ifdef LNA_MEMORY_TRACKING
+    lna_memory_stats_t  stats;
+#endif
 } lna_memory_pool_t;
 
 typedef struct lna_heap_allocator_s lna_heap_allocator_t;
@@ -15,5 +19,19 @@ typedef struct lna_heap_allocator_s lna_heap_allocator_t;
 extern void     lna_memory_pool_init_with_heap  (lna_memory_pool_t* memory_pool, lna_heap_allocator_t* allocator, size_t size_in_bytes);
 extern void*    lna_memory_pool_reserve         (lna_memory_pool_t* memory_pool, size_t size_in_bytes);
 extern void     lna_memory_pool_empty           (lna_memory_pool_t* memory_pool);
+//! the content stays owned by the heap allocator or the pool it was reserved in,
+//! the pool only stops being tracked and can be initialized again.
+extern void     lna_memory_pool_release         (lna_memory_pool_t* memory_pool);
+
+#ifdef LNA_MEMORY_TRACKING
+//! the calls are tagged with their call site, the pool is named by the call
+//! site of its init until lna_memory_tracking_set_name is used. The end of a
+//! tracking cycle is lna_memory_pool_empty.
+extern void     lna_memory_pool_init_with_heap_tagged   (lna_memory_pool_t* memory_pool, lna_heap_allocator_t* allocator, size_t size_in_bytes, const char* tag);
+extern void*    lna_memory_pool_reserve_tagged          (lna_memory_pool_t* memory_pool, size_t size_in_bytes, const char* tag);
+
+#define lna_memory_pool_init_with_heap(memory_pool, allocator, size_in_bytes)   lna_memory_pool_init_with_heap_tagged(memory_pool, allocator, size_in_bytes, LNA_MEMORY_TRACKING_TAG)
+#define lna_memory_pool_reserve(memory_pool, size_in_bytes)                     lna_memory_pool_reserve_tagged(memory_pool, size_in_bytes, LNA_MEMORY_TRACKING_TAG)
+#endif
 
 #endif
@@ -0,0 +1,168 @@
+#include <string.h>
+#include "core/lna_memory_tracking.h"
+#include "core/lna_assert.h"
+#include "core/lna_log.h"
+
+#ifdef LNA_MEMORY_TRACKING
+
+static const char* LNA_MEMORY_TRACKING_OTHER_TAG = "(other call sites)";
+
+static lna_memory_stats_t* g_memory_stats_first = NULL;
+
+static const char* lna_memory_tracking_short_tag(const char* tag)
+{
+    const char* file_name = strrchr(tag, '/');
+    return file_name ? file_name + 1 : tag;
+}
+
+static lna_memory_tag_stats_t* lna_memory_tracking_find_tag(lna_memory_stats_t* stats, const char* tag)
+{
+    for (uint32_t i = 0; i < stats->tag_count; ++i)
+    {
+        //! the tag of a call site is always the same literal, the string compare is for the merged literals
+        if (stats->tags[i].tag == tag || strcmp(stats->tags[i].tag, tag) == 0)
+        {
+            return &stats->tags[i];
+        }
+    }
+
+    if (stats->tag_count < LNA_MEMORY_TRACKING_MAX_TAG_COUNT - 1)
+    {
+        lna_memory_tag_stats_t* tag_stats = &stats->tags[stats->tag_count++];
+        tag_stats->tag = tag;
+        return tag_stats;
+    }
+
+    lna_memory_tag_stats_t* other_stats = &stats->tags[LNA_MEMORY_TRACKING_MAX_TAG_COUNT - 1];
+    if (stats->tag_count < LNA_MEMORY_TRACKING_MAX_TAG_COUNT)
+    {
+        other_stats->tag = LNA_MEMORY_TRACKING_OTHER_TAG;
+        ++stats->tag_count;
+    }
+    return other_stats;
+}
+
+static void lna_memory_tracking_unlink(lna_memory_stats_t* stats)
+{
+    lna_memory_stats_t** link = &g_memory_stats_first;
+    while (*link)
+    {
+        if (*link == stats)
+        {
+            *link = stats->next;
+            return;
+        }
+        link = &(*link)->next;
+    }
+}
+
+void lna_memory_tracking_register(lna_memory_stats_t* stats, const char* name, size_t max_size)
+{
+    lna_assert(stats)
+    lna_assert(name)
+
+    //! registering again restarts the tracking
+    lna_memory_tracking_unlink(stats);
+
+    const char* stats_name = stats->name ? stats->name : name;
+    memset(stats, 0, sizeof(lna_memory_stats_t));
+    stats->name             = stats_name;
+    stats->max_size         = max_size;
+    stats->next             = g_memory_stats_first;
+    g_memory_stats_first    = stats;
+}
+
+void lna_memory_tracking_unregister(lna_memory_stats_t* stats)
+{
+    lna_assert(stats)
+
+    lna_memory_tracking_unlink(stats);
+    memset(stats, 0, sizeof(lna_memory_stats_t));
+}
+
+void lna_memory_tracking_record(lna_memory_stats_t* stats, size_t cur_size, size_t size_in_bytes, const char* tag)
+{
+    lna_assert(stats)
+    lna_assert(tag)
+
+    stats->cur_size         = cur_size;
+    stats->peak_size        = cur_size > stats->peak_size ? cur_size : stats->peak_size;
+    stats->cycle_peak_size  = cur_size > stats->cycle_peak_size ? cur_size : stats->cycle_peak_size;
+    ++stats->count;
+
+    lna_memory_tag_stats_t* tag_stats = lna_memory_tracking_find_tag(
+        stats,
+        tag
+        );
+    ++tag_stats->count;
+    tag_stats->cycle_size       += size_in_bytes;
+    tag_stats->peak_cycle_size  = tag_stats->cycle_size > tag_stats->peak_cycle_size ? tag_stats->cycle_size : tag_stats->peak_cycle_size;
+}
+
+void lna_memory_tracking_record_free(lna_memory_stats_t* stats, size_t cur_size)
+{
+    lna_assert(stats)
+    lna_assert(cur_size <= stats->cur_size)
+
+    stats->cur_size = cur_size;
+}
+
+void lna_memory_tracking_end_cycle(lna_memory_stats_t* stats)
+{
+    lna_assert(stats)
+
+    stats->last_cycle_peak_size = stats->cycle_peak_size;
+    stats->cycle_peak_size      = 0;
+    stats->cur_size             = 0;
+    ++stats->cycle_count;
+    for (uint32_t i = 0; i < stats->tag_count; ++i)
+    {
+        stats->tags[i].cycle_size = 0;
+    }
+}
+
+lna_memory_stats_t* lna_memory_tracking_first_stats(void)
+{
+    return g_memory_stats_first;
+}
+
+void lna_memory_tracking_log_report(void)
+{
+    lna_log_message("memory report:");
+
+    const lna_memory_stats_t* stats = g_memory_stats_first;
+    while (stats)
+    {
+        lna_log_message(
+            "%s: %d / %d bytes, peak %d bytes (%d%%), last cycle peak %d bytes, %d reservations, %d cycles",
+            stats->name,
+            stats->cur_size,
+            stats->max_size,
+            stats->peak_size,
+            stats->max_size > 0 ? (int)(stats->peak_size * 100 / stats->max_size) : 0,
+            stats->last_cycle_peak_size,
+            stats->count,
+            stats->cycle_count
+            );
+        for (uint32_t i = 0; i < stats->tag_count; ++i)
+        {
+            lna_log_message(
+                "    %s: %d reservations, %d bytes in cycle, peak %d bytes in a cycle",
+                lna_memory_tracking_short_tag(stats->tags[i].tag),
+                stats->tags[i].count,
+                stats->tags[i].cycle_size,
+                stats->tags[i].peak_cycle_size
+                );
+        }
+        stats = stats->next;
+    }
+}
+
+#else
+
+void lna_memory_tracking_log_report(void)
+{
+    lna_log_message("memory report: tracking is disabled, build with LNA_MEMORY_TRACKING defined");
+}
+
+#endif
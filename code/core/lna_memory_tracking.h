@@ -0,0 +1,66 @@
+#ifndef LNA_CORE_LNA_MEMORY_TRACKING_H
+#define LNA_CORE_LNA_MEMORY_TRACKING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+//! build with LNA_MEMORY_TRACKING defined to record, for each memory pool and
+//! heap allocator, the bytes used, the high-water mark and the reservations
+//! by call site. Without it the tracking data and calls are compiled out and
+//! lna_memory_tracking_log_report only logs that tracking is disabled.
+
+#ifdef LNA_MEMORY_TRACKING
+
+#define LNA_MEMORY_TRACKING_MAX_TAG_COUNT   16
+#define LNA_MEMORY_TRACKING_STR_(x)         #x
+#define LNA_MEMORY_TRACKING_STR(x)          LNA_MEMORY_TRACKING_STR_(x)
+#define LNA_MEMORY_TRACKING_TAG             __FILE__ ":" LNA_MEMORY_TRACKING_STR(__LINE__)
+
+typedef struct lna_memory_tag_stats_s
+{
+    const char*                 tag;
+    size_t                      count;              //! reservations since the init
+    size_t                      cycle_size;         //! bytes reserved since the last empty
+    size_t                      peak_cycle_size;    //! highest cycle_size seen
+} lna_memory_tag_stats_t;
+
+//! a cycle is the time between two empty of the tracked allocator, a frame
+//! for a frame pool.
+typedef struct lna_memory_stats_s
+{
+    const char*                 name;
+    size_t                      max_size;
+    size_t                      cur_size;
+    size_t                      peak_size;              //! high-water mark since the init
+    size_t                      cycle_peak_size;        //! high-water mark since the last empty
+    size_t                      last_cycle_peak_size;   //! high-water mark of the last ended cycle
+    size_t                      count;                  //! reservations since the init
+    size_t                      cycle_count;
+    uint32_t                    tag_count;
+    lna_memory_tag_stats_t      tags[LNA_MEMORY_TRACKING_MAX_TAG_COUNT];   //! the last one gathers the call sites that do not fit
+    struct lna_memory_stats_s*  next;
+} lna_memory_stats_t;
+
+//! the registered stats are listed in the report until they are unregistered,
+//! their owner must stay alive until then. The tracking is not thread safe.
+extern void                 lna_memory_tracking_register        (lna_memory_stats_t* stats, const char* name, size_t max_size);
+extern void                 lna_memory_tracking_unregister      (lna_memory_stats_t* stats);
+//! cur_size is the size used in the tracked allocator after the reservation of size_in_bytes.
+extern void                 lna_memory_tracking_record          (lna_memory_stats_t* stats, size_t cur_size, size_t size_in_bytes, const char* tag);
+//! cur_size is the size used in the tracked allocator after a partial free, the end of a cycle frees all.
+extern void                 lna_memory_tracking_record_free     (lna_memory_stats_t* stats, size_t cur_size);
+extern void                 lna_memory_tracking_end_cycle       (lna_memory_stats_t* stats);
+extern lna_memory_stats_t*  lna_memory_tracking_first_stats     (void);
+
+//! owner is a memory pool or a heap allocator, name must outlive it.
+#define lna_memory_tracking_set_name(owner, name_str) ((owner)->stats.name = (name_str))
+
+#else
+
+#define lna_memory_tracking_set_name(owner, name_str) ((void)0)
+
+#endif
+
+extern void                 lna_memory_tracking_log_report      (void);
+
+#endif
@@ -0,0 +1,118 @@
+#include <string.h>
+#include "core/lna_object_pool.h"
+#include "core/lna_memory_pool.h"
+#include "core/lna_assert.h"
+
+static const uint32_t LNA_OBJECT_POOL_NO_FREE_SLOT = UINT32_MAX;
+
+void lna_object_pool_init(lna_object_pool_t* object_pool, lna_memory_pool_t* memory_pool, size_t element_size, uint32_t max_element_count)
+{
+    lna_assert(object_pool)
+    lna_assert(object_pool->elements == NULL)
+    lna_assert(object_pool->cur_element_count == 0)
+    lna_assert(object_pool->max_element_count == 0)
+    lna_assert(memory_pool)
+    lna_assert(element_size > 0)
+    lna_assert(max_element_count > 0)
+    lna_assert(max_element_count < LNA_OBJECT_POOL_NO_FREE_SLOT)
+
+    object_pool->max_element_count  = max_element_count;
+    object_pool->element_size       = element_size;
+    object_pool->elements           = lna_memory_pool_reserve(
+        memory_pool,
+        element_size * max_element_count
+        );
+    object_pool->generations        = lna_memory_pool_reserve(
+        memory_pool,
+        sizeof(uint32_t) * max_element_count
+        );
+    object_pool->dense_slots        = lna_memory_pool_reserve(
+        memory_pool,
+        sizeof(uint32_t) * max_element_count
+        );
+    object_pool->slot_links         = lna_memory_pool_reserve(
+        memory_pool,
+        sizeof(uint32_t) * max_element_count
+        );
+
+    //! the generations start at 1 so the zero handle is never valid
+    for (uint32_t i = 0; i < max_element_count; ++i)
+    {
+        object_pool->generations[i] = 1;
+        object_pool->slot_links[i]  = (i + 1 < max_element_count) ? i + 1 : LNA_OBJECT_POOL_NO_FREE_SLOT;
+    }
+    object_pool->free_slot = 0;
+}
+
+void* lna_object_pool_new(lna_object_pool_t* object_pool, lna_handle_t* handle)
+{
+    lna_assert(object_pool)
+    lna_assert(object_pool->elements)
+    lna_assert(object_pool->cur_element_count < object_pool->max_element_count)
+    lna_assert(object_pool->free_slot != LNA_OBJECT_POOL_NO_FREE_SLOT)
+    lna_assert(handle)
+
+    const uint32_t slot = object_pool->free_slot;
+    object_pool->free_slot          = object_pool->slot_links[slot];
+    object_pool->slot_links[slot]   = object_pool->cur_element_count;
+    object_pool->dense_slots[object_pool->cur_element_count++] = slot;
+
+    handle->index       = slot;
+    handle->generation  = object_pool->generations[slot];
+
+    void* element = object_pool->elements + object_pool->element_size * slot;
+    memset(
+        element,
+        0,
+        object_pool->element_size
+        );
+    return element;
+}
+
+void* lna_object_pool_get(const lna_object_pool_t* object_pool, lna_handle_t handle)
+{
+    lna_assert(object_pool)
+    lna_assert(object_pool->elements)
+
+    if (handle.index >= object_pool->max_element_count || object_pool->generations[handle.index] != handle.generation)
+    {
+        return NULL;
+    }
+    return object_pool->elements + object_pool->element_size * handle.index;
+}
+
+void lna_object_pool_delete(lna_object_pool_t* object_pool, lna_handle_t handle)
+{
+    lna_assert(object_pool)
+    lna_assert(lna_object_pool_get(object_pool, handle))
+
+    const uint32_t slot         = handle.index;
+    const uint32_t dense_index  = object_pool->slot_links[slot];
+    const uint32_t last_slot    = object_pool->dense_slots[--object_pool->cur_element_count];
+
+    lna_assert(object_pool->dense_slots[dense_index] == slot)
+
+    //! keep the live slot list without hole
+    object_pool->dense_slots[dense_index]   = last_slot;
+    object_pool->slot_links[last_slot]      = dense_index;
+
+    if (++object_pool->generations[slot] == 0)
+    {
+        object_pool->generations[slot] = 1;
+    }
+    object_pool->slot_links[slot]   = object_pool->free_slot;
+    object_pool->free_slot          = slot;
+}
+
+void* lna_object_pool_element(const lna_object_pool_t* object_pool, uint32_t dense_index)
+{
+    lna_assert(object_pool)
+    lna_assert(dense_index < object_pool->cur_element_count)
+
+    return object_pool->elements + object_pool->element_size * object_pool->dense_slots[dense_index];
+}
+
+bool lna_handle_is_null(lna_handle_t handle)
+{
+    return handle.generation == 0;
+}
@@ -0,0 +1,46 @@
+#ifndef LNA_CORE_LNA_OBJECT_POOL_H
+#define LNA_CORE_LNA_OBJECT_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct lna_memory_pool_s lna_memory_pool_t;
+
+//! reference to an object of a pool. The generation is changed each time
+//! the object is deleted, so a handle to a deleted object is detected
+//! even if its slot has been reused. The zero handle is never valid.
+typedef struct lna_handle_s
+{
+    uint32_t    index;
+    uint32_t    generation;
+} lna_handle_t;
+
+//! fixed-size pool of objects of element_size bytes. The objects are stored
+//! in slots whose address does not change while the object lives, the live
+//! slots are also listed without hole so iterating the pool never visits a
+//! deleted object: use lna_object_pool_element with an index from 0 to
+//! cur_element_count. Deleting an object moves the last listed one in its
+//! place, the iteration order is not the creation order.
+typedef struct lna_object_pool_s
+{
+    uint32_t    cur_element_count;
+    uint32_t    max_element_count;
+    size_t      element_size;
+    char*       elements;           //! indexed by slot
+    uint32_t*   generations;        //! indexed by slot
+    uint32_t*   dense_slots;        //! live slots, from 0 to cur_element_count
+    uint32_t*   slot_links;         //! indexed by slot: index in dense_slots for a live slot, next free slot otherwise
+    uint32_t    free_slot;
+} lna_object_pool_t;
+
+extern void         lna_object_pool_init            (lna_object_pool_t* object_pool, lna_memory_pool_t* memory_pool, size_t element_size, uint32_t max_element_count);
+//! the new object is zero initialized.
+extern void*        lna_object_pool_new             (lna_object_pool_t* object_pool, lna_handle_t* handle);
+//! return NULL if the object has been deleted.
+extern void*        lna_object_pool_get             (const lna_object_pool_t* object_pool, lna_handle_t handle);
+extern void         lna_object_pool_delete          (lna_object_pool_t* object_pool, lna_handle_t handle);
+extern void*        lna_object_pool_element         (const lna_object_pool_t* object_pool, uint32_t dense_index);
+extern bool         lna_handle_is_null              (lna_handle_t handle);
+
+#endif
@@ -0,0 +1,135 @@
+#include "core/lna_stack_allocator.h"
+#include "core/lna_assert.h"
+#include "core/lna_heap_allocator.h"
+
+static const size_t LNA_STACK_ALLOCATOR_CONTENT_ALIGNMENT = 16;
+
+static void lna_stack_allocator_update_peak(lna_stack_allocator_t* stack_allocator)
+{
+    if (stack_allocator->pool.cur_content_size > stack_allocator->peak_content_size)
+    {
+        stack_allocator->peak_content_size = stack_allocator->pool.cur_content_size;
+    }
+}
+
+void lna_stack_allocator_init_with_heap(lna_stack_allocator_t* stack_allocator, lna_heap_allocator_t* allocator, size_t size_in_bytes)
+{
+    lna_assert(stack_allocator)
+    lna_assert(stack_allocator->peak_content_size == 0)
+    lna_assert(stack_allocator->marker_count == 0)
+    lna_assert(allocator)
+
+    lna_memory_pool_init_with_heap(
+        &stack_allocator->pool,
+        allocator,
+        size_in_bytes
+        );
+    lna_memory_tracking_set_name(&stack_allocator->pool, "stack allocator");
+}
+
+void lna_stack_allocator_init_with_pool(lna_stack_allocator_t* stack_allocator, lna_memory_pool_t* memory_pool, size_t size_in_bytes)
+{
+    lna_assert(stack_allocator)
+    lna_assert(stack_allocator->pool.content == NULL)
+    lna_assert(stack_allocator->pool.cur_content_size == 0)
+    lna_assert(stack_allocator->pool.max_content_size == 0)
+    lna_assert(stack_allocator->peak_content_size == 0)
+    lna_assert(stack_allocator->marker_count == 0)
+    lna_assert(memory_pool)
+    lna_assert(size_in_bytes > 0)
+
+    //! the region is over reserved to align its start
+    char* region = lna_memory_pool_reserve(
+        memory_pool,
+        size_in_bytes + LNA_STACK_ALLOCATOR_CONTENT_ALIGNMENT - 1
+        );
+    stack_allocator->pool.content           = (char*)(((uintptr_t)region + LNA_STACK_ALLOCATOR_CONTENT_ALIGNMENT - 1) & ~(uintptr_t)(LNA_STACK_ALLOCATOR_CONTENT_ALIGNMENT - 1));
+    stack_allocator->pool.max_content_size  = size_in_bytes;
+#ifdef LNA_MEMORY_TRACKING
+    lna_memory_tracking_register(
+        &stack_allocator->pool.stats,
+        "stack allocator",
+        size_in_bytes
+        );
+#endif
+}
+
+#ifdef LNA_MEMORY_TRACKING
+void* lna_stack_allocator_reserve_tagged(lna_stack_allocator_t* stack_allocator, size_t size_in_bytes, size_t alignment, const char* tag)
+#else
+void* lna_stack_allocator_reserve(lna_stack_allocator_t* stack_allocator, size_t size_in_bytes, size_t alignment)
+#endif
+{
+    lna_assert(stack_allocator)
+    lna_assert(stack_allocator->pool.content)
+    lna_assert(alignment > 0 && (alignment & (alignment - 1)) == 0)
+    lna_assert(size_in_bytes > 0)
+
+    //! the address is aligned, not the offset: the content start may be less aligned than requested
+    const uintptr_t cur_address = (uintptr_t)(stack_allocator->pool.content + stack_allocator->pool.cur_content_size);
+    const size_t    offset      = stack_allocator->pool.cur_content_size + (size_t)(((cur_address + alignment - 1) & ~(uintptr_t)(alignment - 1)) - cur_address);
+    lna_assert(offset + size_in_bytes <= stack_allocator->pool.max_content_size)
+
+    stack_allocator->pool.cur_content_size = offset + size_in_bytes;
+    lna_stack_allocator_update_peak(stack_allocator);
+#ifdef LNA_MEMORY_TRACKING
+    lna_memory_tracking_record(
+        &stack_allocator->pool.stats,
+        stack_allocator->pool.cur_content_size,
+        size_in_bytes,
+        tag
+        );
+#endif
+    return stack_allocator->pool.content + offset;
+}
+
+lna_stack_allocator_marker_t lna_stack_allocator_push_marker(lna_stack_allocator_t* stack_allocator)
+{
+    lna_assert(stack_allocator)
+    lna_assert(stack_allocator->pool.content)
+
+    const lna_stack_allocator_marker_t marker =
+    {
+        .content_size   = stack_allocator->pool.cur_content_size,
+        .depth          = stack_allocator->marker_count++,
+    };
+    return marker;
+}
+
+void lna_stack_allocator_pop_to_marker(lna_stack_allocator_t* stack_allocator, lna_stack_allocator_marker_t marker)
+{
+    lna_assert(stack_allocator)
+    lna_assert(stack_allocator->marker_count > 0)
+    lna_assert(marker.depth == stack_allocator->marker_count - 1)     //! the inner scopes must be popped first
+    lna_assert(marker.content_size <= stack_allocator->pool.cur_content_size)
+
+    //! the functions reserving directly from pool are not seen by lna_stack_allocator_reserve
+    lna_stack_allocator_update_peak(stack_allocator);
+
+    stack_allocator->pool.cur_content_size = marker.content_size;
+    --stack_allocator->marker_count;
+#ifdef LNA_MEMORY_TRACKING
+    lna_memory_tracking_record_free(
+        &stack_allocator->pool.stats,
+        stack_allocator->pool.cur_content_size
+        );
+#endif
+}
+
+void lna_stack_allocator_empty(lna_stack_allocator_t* stack_allocator)
+{
+    lna_assert(stack_allocator)
+
+    lna_stack_allocator_update_peak(stack_allocator);
+    lna_memory_pool_empty(&stack_allocator->pool);
+    stack_allocator->marker_count = 0;
+}
+
+void lna_stack_allocator_release(lna_stack_allocator_t* stack_allocator)
+{
+    lna_assert(stack_allocator)
+    lna_assert(stack_allocator->marker_count == 0)
+
+    lna_memory_pool_release(&stack_allocator->pool);
+    stack_allocator->peak_content_size = 0;
+}
@@ -0,0 +1,46 @@
+#ifndef LNA_CORE_LNA_STACK_ALLOCATOR_H
+#define LNA_CORE_LNA_STACK_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "core/lna_memory_pool.h"
+
+typedef struct lna_heap_allocator_s lna_heap_allocator_t;
+
+//! linear allocator whose reservations are freed in reverse order by
+//! scopes: a marker saves the top of the stack, popping to it frees all
+//! that has been reserved since. Scopes can be nested but must be popped in
+//! reverse order of their push.
+//! pool can be given to the functions reserving from a memory pool, their
+//! reservations are freed with the scope they are made in.
+typedef struct lna_stack_allocator_s
+{
+    lna_memory_pool_t   pool;
+    size_t              peak_content_size;  //! highest top of the stack seen at the end of a scope or by lna_stack_allocator_reserve
+    uint32_t            marker_count;       //! count of scopes currently pushed
+} lna_stack_allocator_t;
+
+typedef struct lna_stack_allocator_marker_s
+{
+    size_t              content_size;
+    uint32_t            depth;
+} lna_stack_allocator_marker_t;
+
+extern void                         lna_stack_allocator_init_with_heap  (lna_stack_allocator_t* stack_allocator, lna_heap_allocator_t* allocator, size_t size_in_bytes);
+//! the stack uses a region of size_in_bytes reserved in memory_pool, it has the lifetime of the pool content.
+extern void                         lna_stack_allocator_init_with_pool  (lna_stack_allocator_t* stack_allocator, lna_memory_pool_t* memory_pool, size_t size_in_bytes);
+//! alignment must be a power of two.
+extern void*                        lna_stack_allocator_reserve         (lna_stack_allocator_t* stack_allocator, size_t size_in_bytes, size_t alignment);
+extern lna_stack_allocator_marker_t lna_stack_allocator_push_marker     (lna_stack_allocator_t* stack_allocator);
+extern void                         lna_stack_allocator_pop_to_marker   (lna_stack_allocator_t* stack_allocator, lna_stack_allocator_marker_t marker);
+extern void                         lna_stack_allocator_empty           (lna_stack_allocator_t* stack_allocator);
+//! must be called before the memory of the stack is released, the stack can then be initialized again.
+extern void                         lna_stack_allocator_release         (lna_stack_allocator_t* stack_allocator);
+
+#ifdef LNA_MEMORY_TRACKING
+extern void*                        lna_stack_allocator_reserve_tagged  (lna_stack_allocator_t* stack_allocator, size_t size_in_bytes, size_t alignment, const char* tag);
+
+#define lna_stack_allocator_reserve(stack_allocator, size_in_bytes, alignment) lna_stack_allocator_reserve_tagged(stack_allocator, size_in_bytes, alignment, LNA_MEMORY_TRACKING_TAG)
+#endif
+
+#endif
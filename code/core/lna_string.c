@@ -1,9 +1,318 @@
 #include <string.h>
 #include <limits.h>
 #include <stdlib.h>
+#include <errno.h>
 #include "core/lna_string.h"
 #include "core/lna_assert.h"
 
+#define LNA_STRING_MAX_MANTISSA_DIGIT_COUNT     19                          //! fits in a uint64_t
+#define LNA_STRING_MAX_EXACT_DOUBLE_MANTISSA    ((uint64_t)1 << 53)
+#define LNA_STRING_MAX_EXACT_POWER_OF_TEN       22
+#define LNA_STRING_MAX_DECIMAL_DIGIT_COUNT      800                         //! more than the exact digits of any float halfway value
+#define LNA_STRING_MAX_DECIMAL_SHIFT            60                          //! 9 << 60 plus the carry fits in a uint64_t
+#define LNA_STRING_MIN_FLOAT_DECIMAL_POINT      (-50)                       //! under half the smallest denormal float
+#define LNA_STRING_MAX_FLOAT_DECIMAL_POINT      39                          //! over the largest float
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LNA_STRING_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__clang__) || defined(__GNUC__)
+#define LNA_STRING_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#else
+#define LNA_STRING_NO_SANITIZE_ADDRESS
+#endif
+
+static const double g_lna_string_powers_of_ten[LNA_STRING_MAX_EXACT_POWER_OF_TEN + 1] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+//! number of consecutive decimal digits at the beginning of string.
+#ifdef LNA_STRING_USE_SSE2
+//! 16 characters are tested at a time. The loads are 16 bytes aligned so
+//! they never cross a page boundary: the bytes read before string or after
+//! its '\0' are in the same page and are ignored ('\0' is not a digit).
+LNA_STRING_NO_SANITIZE_ADDRESS
+static uint32_t lna_string_digit_run_length(const char* string)
+{
+    const uintptr_t misalignment    = (uintptr_t)string & 15;
+    const __m128i*  block           = (const __m128i*)(const void*)(string - misalignment);
+    //! '0'..'9' are moved to -128..-119 so one signed comparison tests the range
+    const __m128i   bias            = _mm_set1_epi8((char)(0x80 - '0'));
+    const __m128i   limit           = _mm_set1_epi8((char)(0x80 + 10));
+
+    uint32_t    count       = 0;
+    uint32_t    bit_count   = 16 - (uint32_t)misalignment;
+    uint32_t    digits      = (uint32_t)_mm_movemask_epi8(_mm_cmplt_epi8(_mm_add_epi8(_mm_load_si128(block), bias), limit)) >> misalignment;
+    for (;;)
+    {
+        const uint32_t non_digits = ~digits & ((1u << bit_count) - 1);
+        if (non_digits)
+        {
+            return count + (uint32_t)__builtin_ctz(non_digits);
+        }
+        count       += bit_count;
+        bit_count   = 16;
+        ++block;
+        digits      = (uint32_t)_mm_movemask_epi8(_mm_cmplt_epi8(_mm_add_epi8(_mm_load_si128(block), bias), limit));
+    }
+}
+#else
+static uint32_t lna_string_digit_run_length(const char* string)
+{
+    uint32_t count = 0;
+    while ((uint32_t)(string[count] - '0') <= 9)
+    {
+        ++count;
+    }
+    return count;
+}
+#endif
+
+//! true if value is exactly halfway between two normal floats.
+static bool lna_string_is_float_halfway(double value)
+{
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    //! a double has 29 more mantissa bits than a float
+    return (bits & ((1ull << 29) - 1)) == (1ull << 28);
+}
+
+//! ============================================================================
+//! exact decimal used by lna_string_parse_float when the fast path cannot give
+//! the correctly rounded float: the value 0.digits * 10^decimal_point is
+//! shifted by powers of two until it lies in [0.5, 1[, then the mantissa is
+//! rounded from its digits (simple decimal conversion, as in Go strconv).
+//! ============================================================================
+
+typedef struct lna_string_decimal_s
+{
+    uint8_t     digits[LNA_STRING_MAX_DECIMAL_DIGIT_COUNT];    //! 0 to 9, no trailing zeros
+    int32_t     digit_count;
+    int32_t     decimal_point;
+    bool        truncated;                                      //! non zero digits were dropped
+} lna_string_decimal_t;
+
+static void lna_string_decimal_trim(lna_string_decimal_t* decimal)
+{
+    while (decimal->digit_count > 0 && decimal->digits[decimal->digit_count - 1] == 0)
+    {
+        --decimal->digit_count;
+    }
+    if (decimal->digit_count == 0)
+    {
+        decimal->decimal_point = 0;
+    }
+}
+
+static void lna_string_decimal_append(lna_string_decimal_t* decimal, uint32_t digit)
+{
+    if (decimal->digit_count < LNA_STRING_MAX_DECIMAL_DIGIT_COUNT)
+    {
+        decimal->digits[decimal->digit_count++] = (uint8_t)digit;
+    }
+    else if (digit != 0)
+    {
+        decimal->truncated = true;
+    }
+}
+
+//! multiply by 2^shift, shift <= LNA_STRING_MAX_DECIMAL_SHIFT.
+static void lna_string_decimal_left_shift(lna_string_decimal_t* decimal, uint32_t shift)
+{
+    //! the digits are written from the last one in a temporary buffer, the
+    //! carry of the first digit gives the new leading digits
+    uint8_t     shifted_digits[LNA_STRING_MAX_DECIMAL_DIGIT_COUNT + 20];
+    int32_t     write_index = (int32_t)(sizeof(shifted_digits) / sizeof(shifted_digits[0]));
+    uint64_t    carry       = 0;
+    for (int32_t i = decimal->digit_count - 1; i >= 0; --i)
+    {
+        const uint64_t value = ((uint64_t)decimal->digits[i] << shift) + carry;
+        shifted_digits[--write_index]   = (uint8_t)(value % 10);
+        carry                           = value / 10;
+    }
+    while (carry > 0)
+    {
+        shifted_digits[--write_index]   = (uint8_t)(carry % 10);
+        carry                           /= 10;
+    }
+
+    const int32_t shifted_digit_count = (int32_t)(sizeof(shifted_digits) / sizeof(shifted_digits[0])) - write_index;
+    decimal->decimal_point  += shifted_digit_count - decimal->digit_count;
+    decimal->digit_count    = 0;
+    for (int32_t i = 0; i < shifted_digit_count; ++i)
+    {
+        lna_string_decimal_append(decimal, shifted_digits[write_index + i]);
+    }
+    lna_string_decimal_trim(decimal);
+}
+
+//! divide by 2^shift, shift <= LNA_STRING_MAX_DECIMAL_SHIFT.
+static void lna_string_decimal_right_shift(lna_string_decimal_t* decimal, uint32_t shift)
+{
+    int32_t     read_index  = 0;
+    int32_t     write_index = 0;
+    uint64_t    value       = 0;
+
+    //! read enough leading digits to get a non zero first digit
+    while ((value >> shift) == 0)
+    {
+        if (read_index >= decimal->digit_count)
+        {
+            if (value == 0)
+            {
+                decimal->digit_count = 0;
+                decimal->decimal_point = 0;
+                return;
+            }
+            while ((value >> shift) == 0)
+            {
+                value *= 10;
+                ++read_index;
+            }
+            break;
+        }
+        value = value * 10 + decimal->digits[read_index++];
+    }
+    decimal->decimal_point -= read_index - 1;
+
+    const uint64_t mask = ((uint64_t)1 << shift) - 1;
+    for (; read_index < decimal->digit_count; ++read_index)
+    {
+        decimal->digits[write_index++]  = (uint8_t)(value >> shift);
+        value                           = (value & mask) * 10 + decimal->digits[read_index];
+    }
+    while (value > 0)
+    {
+        const uint32_t digit = (uint32_t)(value >> shift);
+        if (write_index < LNA_STRING_MAX_DECIMAL_DIGIT_COUNT)
+        {
+            decimal->digits[write_index++] = (uint8_t)digit;
+        }
+        else if (digit > 0)
+        {
+            decimal->truncated = true;
+        }
+        value = (value & mask) * 10;
+    }
+    decimal->digit_count = write_index;
+    lna_string_decimal_trim(decimal);
+}
+
+static void lna_string_decimal_shift(lna_string_decimal_t* decimal, int32_t shift)
+{
+    for (; shift > LNA_STRING_MAX_DECIMAL_SHIFT; shift -= LNA_STRING_MAX_DECIMAL_SHIFT)
+    {
+        lna_string_decimal_left_shift(decimal, LNA_STRING_MAX_DECIMAL_SHIFT);
+    }
+    for (; shift < -LNA_STRING_MAX_DECIMAL_SHIFT; shift += LNA_STRING_MAX_DECIMAL_SHIFT)
+    {
+        lna_string_decimal_right_shift(decimal, LNA_STRING_MAX_DECIMAL_SHIFT);
+    }
+    if (shift > 0)
+    {
+        lna_string_decimal_left_shift(decimal, (uint32_t)shift);
+    }
+    else if (shift < 0)
+    {
+        lna_string_decimal_right_shift(decimal, (uint32_t)-shift);
+    }
+}
+
+//! integer part rounded to nearest, ties to even, decimal_point <= 20.
+static uint64_t lna_string_decimal_rounded_integer(const lna_string_decimal_t* decimal)
+{
+    uint64_t    value   = 0;
+    int32_t     i       = 0;
+    for (; i < decimal->decimal_point && i < decimal->digit_count; ++i)
+    {
+        value = value * 10 + decimal->digits[i];
+    }
+    for (; i < decimal->decimal_point; ++i)
+    {
+        value *= 10;
+    }
+
+    const int32_t first_dropped = decimal->decimal_point;
+    if (first_dropped >= 0 && first_dropped < decimal->digit_count)
+    {
+        const bool halfway = decimal->digits[first_dropped] == 5 && first_dropped + 1 == decimal->digit_count && !decimal->truncated;
+        if (halfway ? (value & 1) != 0 : decimal->digits[first_dropped] >= 5)
+        {
+            ++value;
+        }
+    }
+    return value;
+}
+
+static float lna_string_decimal_to_float(lna_string_decimal_t* decimal, bool negative)
+{
+    //! float layout: 23 mantissa bits, 8 exponent bits, exponent bias 127
+    static const int32_t powers_of_two[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+    static const int32_t power_count     = (int32_t)(sizeof(powers_of_two) / sizeof(powers_of_two[0]));
+
+    uint32_t bits = 0;
+    if (decimal->digit_count == 0 || decimal->decimal_point < LNA_STRING_MIN_FLOAT_DECIMAL_POINT)
+    {
+        bits = 0;
+    }
+    else if (decimal->decimal_point > LNA_STRING_MAX_FLOAT_DECIMAL_POINT)
+    {
+        bits = 0xFFu << 23;
+    }
+    else
+    {
+        //! scale to [0.5, 1[, powers_of_two[n] is the shift making n digits
+        int32_t exponent = 0;
+        while (decimal->decimal_point > 0)
+        {
+            const int32_t shift = decimal->decimal_point >= power_count ? 27 : powers_of_two[decimal->decimal_point];
+            lna_string_decimal_shift(decimal, -shift);
+            exponent += shift;
+        }
+        while (decimal->decimal_point < 0 || (decimal->decimal_point == 0 && decimal->digits[0] < 5))
+        {
+            const int32_t shift = -decimal->decimal_point >= power_count ? 27 : powers_of_two[-decimal->decimal_point];
+            lna_string_decimal_shift(decimal, shift);
+            exponent -= shift;
+        }
+
+        //! [0.5, 1[ to the float range [1, 2[
+        --exponent;
+        if (exponent < -126)
+        {
+            //! denormal
+            lna_string_decimal_shift(decimal, exponent + 126);
+            exponent = -126;
+        }
+
+        lna_string_decimal_shift(decimal, 24);
+        uint64_t mantissa = lna_string_decimal_rounded_integer(decimal);
+        if (mantissa == ((uint64_t)1 << 24))
+        {
+            mantissa >>= 1;
+            ++exponent;
+        }
+        if (exponent + 127 >= 0xFF)
+        {
+            bits = 0xFFu << 23;
+        }
+        else
+        {
+            const uint32_t biased_exponent = (mantissa & ((uint64_t)1 << 23)) ? (uint32_t)(exponent + 127) : 0;
+            bits = ((uint32_t)mantissa & ((1u << 23) - 1)) | (biased_exponent << 23);
+        }
+    }
+
+    bits |= negative ? 0x80000000u : 0;
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
 void lna_string_copy(char* dst, const char* src, size_t dst_max_size)
 {
     lna_assert(dst)
@@ -28,13 +337,8 @@ void lna_string_to_int(int32_t* dst, const char* src)
     lna_assert(src)
 
     char* ptr = 0;
-    errno = 0;
-    long result = strtol(src, &ptr, 10);
-    lna_assert(errno != ERANGE)
+    *dst = lna_string_parse_int((char*)src, &ptr);
     lna_assert(*ptr == '\0')
-    lna_assert(ptr != src)
-    lna_assert(result >= INT_MIN && result <= INT_MAX)
-    *dst = (int)result;
 }
 
 void lna_string_to_uint(uint32_t* dst, const char* src)
@@ -58,12 +362,8 @@ void lna_string_to_float(float* dst, const char* src)
     lna_assert(src)
 
     char* ptr = 0;
-    errno = 0;
-    float result = strtof(src, &ptr);
-    lna_assert(errno != ERANGE)
+    *dst = lna_string_parse_float((char*)src, &ptr);
     lna_assert(*ptr == '\0')
-    lna_assert(ptr != src)
-    *dst = result;
 }
 
 void lna_string_to_double(double* dst, const char* src)
@@ -88,23 +388,18 @@ bool lna_string_begins_with(const char* string, const char* pattern)
 
     // string parameter can be 0 length but not the pattern to find parameter,
     // this is why we only assert if the pattern buffer is 0 length and not if string
-    // buffer is 0 length
+    // buffer is 0 length. The string length is not computed: string can be a
+    // line of a whole file buffer and the comparison stops at its first
+    // '\0' anyway.
 
-    size_t  string_length   = strlen(string);
-    size_t  pattern_length  = strlen(pattern);
-    bool    result          = string_length >= pattern_length;
-    if (result)
+    for (size_t i = 0; pattern[i] != '\0'; ++i)
     {
-        for (size_t i = 0; i < pattern_length; ++i)
+        if (string[i] != pattern[i])
         {
-            if (string[i] != pattern[i])
-            {
-                result = false;
-                break;
-            }
+            return false;
         }
     }
-    return result;
+    return true;
 }
 
 char* lna_string_go_to_next_line(char* string)
@@ -172,53 +467,163 @@ char* lna_string_go_to_next_space_character(char* string)
 
 }
 
-float lna_string_parse_float(char* string)
+float lna_string_parse_float(char* string, char** end)
 {
     lna_assert(string)
 
-    char    buffer[32];
-    char    *ptr            = string;
-    int     buffer_index    = 0;
-    bool    dot_found       = false;
-    while (
-        (*ptr >= '0' && *ptr <= '9')
-        || (!dot_found && *ptr == '.')
-        || (buffer_index == 0 && *ptr == '-')
-        )
+    char*       ptr         = string;
+    const bool  negative    = *ptr == '-';
+    ptr                     += (*ptr == '-' || *ptr == '+') ? 1 : 0;
+    char* const digits      = ptr;
+
+    uint64_t    mantissa    = 0;
+    int32_t     exponent    = 0;
+    uint32_t    digit_count = 0;    //! significant digits in mantissa
+    bool        truncated   = false;
+
+    //! INTEGER PART
+    const uint32_t integer_digit_count = lna_string_digit_run_length(ptr);
+    for (uint32_t i = 0; i < integer_digit_count; ++i)
+    {
+        const uint32_t digit = (uint32_t)(ptr[i] - '0');
+        if (digit_count < LNA_STRING_MAX_MANTISSA_DIGIT_COUNT)
+        {
+            mantissa    = mantissa * 10 + digit;
+            digit_count += mantissa > 0 ? 1 : 0;
+        }
+        else
+        {
+            truncated   = true;
+            ++exponent;
+        }
+    }
+    ptr += integer_digit_count;
+
+    //! FRACTIONAL PART
+    uint32_t fraction_digit_count = 0;
+    if (*ptr == '.')
     {
-        dot_found = (!dot_found && *ptr == '.') ? true : dot_found;
-        lna_assert((uint32_t)buffer_index < (sizeof(buffer) / sizeof(buffer[0])))
-        buffer[buffer_index++] = *ptr;
         ++ptr;
+        fraction_digit_count = lna_string_digit_run_length(ptr);
+        for (uint32_t i = 0; i < fraction_digit_count; ++i)
+        {
+            const uint32_t digit = (uint32_t)(ptr[i] - '0');
+            if (digit_count < LNA_STRING_MAX_MANTISSA_DIGIT_COUNT)
+            {
+                mantissa    = mantissa * 10 + digit;
+                digit_count += mantissa > 0 ? 1 : 0;
+                --exponent;
+            }
+            else
+            {
+                truncated = true;
+            }
+        }
+        ptr += fraction_digit_count;
     }
-    buffer[buffer_index] = '\0';
+    lna_assert(integer_digit_count + fraction_digit_count > 0)
 
-    float result = 0.0f;
-    lna_string_to_float(&result, buffer);
-    return result;
+    //! EXPONENT PART: only when digits follow, "1e" is 1 followed by 'e'
+    int32_t explicit_exponent = 0;
+    if (*ptr == 'e' || *ptr == 'E')
+    {
+        char*       exponent_ptr        = ptr + 1;
+        const bool  negative_exponent   = *exponent_ptr == '-';
+        exponent_ptr                    += (*exponent_ptr == '-' || *exponent_ptr == '+') ? 1 : 0;
+
+        const uint32_t exponent_digit_count = lna_string_digit_run_length(exponent_ptr);
+        if (exponent_digit_count > 0)
+        {
+            int32_t value = 0;
+            for (uint32_t i = 0; i < exponent_digit_count; ++i)
+            {
+                //! clamped, far out of the float range anyway
+                value = value < 100000 ? value * 10 + (exponent_ptr[i] - '0') : value;
+            }
+            explicit_exponent   = negative_exponent ? -value : value;
+            exponent            += explicit_exponent;
+            ptr                 = exponent_ptr + exponent_digit_count;
+        }
+    }
+
+    if (end)
+    {
+        *end = ptr;
+    }
+
+    //! CLINGER FAST PATH: mantissa and 10^exponent are exact doubles so
+    //! the division or multiplication gives the correctly rounded double.
+    //! Rounding it to float is exact too unless it lies exactly halfway
+    //! between two floats (double rounding), the exact decimal handles this
+    //! case and the ones out of the fast path range.
+    if (
+        !truncated
+        && mantissa <= LNA_STRING_MAX_EXACT_DOUBLE_MANTISSA
+        && exponent >= -LNA_STRING_MAX_EXACT_POWER_OF_TEN
+        && exponent <= LNA_STRING_MAX_EXACT_POWER_OF_TEN
+        )
+    {
+        const double value = exponent < 0
+            ? (double)mantissa / g_lna_string_powers_of_ten[-exponent]
+            : (double)mantissa * g_lna_string_powers_of_ten[exponent];
+        if (mantissa == 0 || !lna_string_is_float_halfway(value))
+        {
+            return negative ? -(float)value : (float)value;
+        }
+    }
 
+    //! SLOW PATH: all the digits are read again in an exact decimal
+    lna_string_decimal_t decimal = { 0 };
+    for (uint32_t i = 0; i < integer_digit_count; ++i)
+    {
+        const uint32_t digit = (uint32_t)(digits[i] - '0');
+        if (decimal.digit_count > 0 || digit > 0)
+        {
+            lna_string_decimal_append(&decimal, digit);
+            ++decimal.decimal_point;
+        }
+    }
+    const char* fraction_digits = digits + integer_digit_count + 1;
+    for (uint32_t i = 0; i < fraction_digit_count; ++i)
+    {
+        const uint32_t digit = (uint32_t)(fraction_digits[i] - '0');
+        if (decimal.digit_count > 0 || digit > 0)
+        {
+            lna_string_decimal_append(&decimal, digit);
+        }
+        else
+        {
+            --decimal.decimal_point;
+        }
+    }
+    decimal.decimal_point += explicit_exponent;
+    lna_string_decimal_trim(&decimal);
+    return lna_string_decimal_to_float(&decimal, negative);
 }
 
-int lna_string_parse_int(char* string)
+int lna_string_parse_int(char* string, char** end)
 {
     lna_assert(string)
 
-    char    buffer[32];
-    char    *ptr            = string;
-    int     buffer_index    = 0;
-    while (
-        (*ptr >= '0' && *ptr <= '9')
-        || (buffer_index == 0 && *ptr == '-')
-        )
+    char*       ptr         = string;
+    const bool  negative    = *ptr == '-';
+    ptr                     += (*ptr == '-' || *ptr == '+') ? 1 : 0;
+
+    const uint32_t digit_count = lna_string_digit_run_length(ptr);
+    lna_assert(digit_count > 0)
+
+    int64_t value = 0;
+    for (uint32_t i = 0; i < digit_count; ++i)
     {
-        lna_assert((uint32_t)buffer_index < (sizeof(buffer) / sizeof(buffer[0])))
-        buffer[buffer_index++] = *ptr;
-        ++ptr;
+        value = value * 10 + (ptr[i] - '0');
+        lna_assert(value <= (int64_t)INT_MAX + 1)
     }
-    buffer[buffer_index] = '\0';
-
-    int result = 0;
-    lna_string_to_int(&result, buffer);
-    return result;
+    value = negative ? -value : value;
+    lna_assert(value >= INT_MIN && value <= INT_MAX)
 
+    if (end)
+    {
+        *end = ptr + digit_count;
+    }
+    return (int)value;
 }
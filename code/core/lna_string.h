@@ -14,7 +14,11 @@ extern char*    lna_string_go_to_next_line                  (char* string);
 extern char*    lna_string_go_to_next_character             (char* string, char character);
 extern char*    lna_string_go_to_next_non_space_character   (char* string);
 extern char*    lna_string_go_to_next_space_character       (char* string);
-extern float    lna_string_parse_float                      (char* string);
-extern int      lna_string_parse_int                        (char* string);
+//! locale independent parse of [-+]digits[.digits][(e|E)[-+]digits], at least one digit is expected.
+//! end receives the first character after the number, can be NULL. The result is correctly rounded,
+//! the same as strtof in the "C" locale.
+extern float    lna_string_parse_float                      (char* string, char** end);
+//! locale independent parse of [-+]digits, end receives the first character after the number, can be NULL.
+extern int      lna_string_parse_int                        (char* string, char** end);
 
 #endif // LNA_CORE_LNA_STRING_H
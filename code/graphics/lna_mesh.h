@@ -2,14 +2,19 @@
 #define LNA_GRAPHICS_LNA_MESH_H
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "core/lna_object_pool.h"
 #include "maths/lna_vec2.h"
 #include "maths/lna_vec3.h"
 #include "maths/lna_vec4.h"
 
 typedef struct lna_mesh_system_s    lna_mesh_system_t;
 typedef struct lna_mesh_s           lna_mesh_t;
+typedef struct lna_mesh_geometry_s  lna_mesh_geometry_t;
+typedef struct lna_mesh_instance_s  lna_mesh_instance_t;
 typedef struct lna_memory_pool_s    lna_memory_pool_t;
 typedef struct lna_renderer_s       lna_renderer_t;
+typedef struct lna_renderer_view_s  lna_renderer_view_t;
 typedef struct lna_material_s       lna_material_t;
 typedef struct lna_mat4_s           lna_mat4_t;
 typedef struct lna_model_vertex_s   lna_model_vertex_t;
@@ -17,6 +22,9 @@ typedef struct lna_model_vertex_s   lna_model_vertex_t;
 typedef struct lna_mesh_system_config_s
 {
     uint32_t                        max_mesh_count;
+    uint32_t                        max_geometry_count;     //! shared geometries used by mesh instances, can be 0
+    uint32_t                        max_instance_count;     //! mesh instances, can be 0
+    bool                            static_meshes;          //! the meshes commands are recorded once and reused by the next frames until a mesh is added or deleted, or the swap chain is recreated. Their matrices can still change, their tint is read when the commands are recorded.
     lna_renderer_t*                 renderer;
     lna_memory_pool_t*              memory_pool;
 } lna_mesh_system_config_t;
@@ -27,15 +35,40 @@ typedef struct lna_mesh_config_s
     const lna_model_vertex_t*       vertices;
     uint32_t                        vertex_count;
     const uint32_t*                 indices;
+    const uint16_t*                 indices_16;             //! used instead of indices when not NULL
     uint32_t                        index_count;
     const lna_mat4_t*               model_matrix;
-    const lna_mat4_t*               view_matrix;
-    const lna_mat4_t*               projection_matrix;
+    const lna_vec4_t*               tint;                   //! multiplies the vertex colors, set to NULL to use white
+    const lna_renderer_view_t*      view;
 } lna_mesh_config_t;
 
-extern void         lna_mesh_system_init    (lna_mesh_system_t* mesh_system, const lna_mesh_system_config_t* config);
-extern lna_mesh_t*  lna_mesh_system_new_mesh(lna_mesh_system_t* mesh_system, const lna_mesh_config_t* config);
-extern void         lna_mesh_system_draw    (lna_mesh_system_t* mesh_system);
-extern void         lna_mesh_system_release (lna_mesh_system_t* mesh_system);
+typedef struct lna_mesh_geometry_config_s
+{
+    const lna_model_vertex_t*       vertices;
+    uint32_t                        vertex_count;
+    const uint32_t*                 indices;
+    const uint16_t*                 indices_16;             //! used instead of indices when not NULL
+    uint32_t                        index_count;
+} lna_mesh_geometry_config_t;
+
+//! all instances sharing the same geometry, material and view are drawn
+//! with a single instanced draw call.
+typedef struct lna_mesh_instance_config_s
+{
+    const lna_mesh_geometry_t*      geometry;
+    const lna_material_t*           material;
+    const lna_mat4_t*               model_matrix;
+    const lna_renderer_view_t*      view;
+} lna_mesh_instance_config_t;
+
+extern void                 lna_mesh_system_init            (lna_mesh_system_t* mesh_system, const lna_mesh_system_config_t* config);
+extern lna_handle_t         lna_mesh_system_new_mesh        (lna_mesh_system_t* mesh_system, const lna_mesh_config_t* config);
+//! the gpu resources of the mesh are destroyed once the frames in flight are done with them.
+extern void                 lna_mesh_system_delete_mesh     (lna_mesh_system_t* mesh_system, lna_handle_t mesh);
+extern lna_mesh_geometry_t* lna_mesh_system_new_geometry    (lna_mesh_system_t* mesh_system, const lna_mesh_geometry_config_t* config);
+extern lna_handle_t         lna_mesh_system_new_instance    (lna_mesh_system_t* mesh_system, const lna_mesh_instance_config_t* config);
+extern void                 lna_mesh_system_delete_instance (lna_mesh_system_t* mesh_system, lna_handle_t instance);
+extern void                 lna_mesh_system_draw            (lna_mesh_system_t* mesh_system);
+extern void                 lna_mesh_system_release         (lna_mesh_system_t* mesh_system);
 
 #endif
@@ -1,9 +1,13 @@
 #include <string.h>
 #include "graphics/lna_model.h"
+#include "graphics/lna_model_optimizer.h"
 #include "core/lna_memory_pool.h"
+#include "core/lna_atomic_memory_pool.h"
+#include "core/lna_stack_allocator.h"
 #include "core/lna_assert.h"
 #include "core/lna_string.h"
 #include "core/lna_file.h"
+#include "system/lna_thread.h"
 
 #define LNA_MODEL_FACE_POINT_COUNT 3
 typedef struct lna_model_face_s
@@ -13,188 +17,660 @@ typedef struct lna_model_face_s
     uint32_t    normal_indices[LNA_MODEL_FACE_POINT_COUNT];
 } lna_model_face_t;
 
-void lna_model_init_dev_mode(lna_model_t* model, const lna_model_config_t* config)
+#define LNA_MODEL_MAX_PARSE_THREAD_COUNT    32
+#define LNA_MODEL_MIN_PARSE_CHUNK_SIZE      (1024 * 1024)   //! smaller files are not worth a thread
+
+typedef struct lna_model_obj_chunk_s
+{
+    char*               begin;          //! first character of the first line of the chunk
+    const char*         end;            //! first character after the last line of the chunk
+    lna_memory_pool_t*          memory_pool;    //! for the chunk arrays when the file is parsed by a single thread
+    lna_atomic_memory_pool_t*   shared_pool;    //! for the chunk arrays when the file is parsed by several threads
+    uint32_t            position_count;
+    uint32_t            uv_count;
+    uint32_t            normal_count;
+    uint32_t            face_count;
+    lna_vec3_t*         positions;
+    lna_vec2_t*         uvs;
+    lna_vec3_t*         normals;
+    lna_model_face_t*   faces;
+} lna_model_obj_chunk_t;
+
+#define LNA_MODEL_CACHE_MAGIC       0x4D414E4C  //! "LNAM"
+#define LNA_MODEL_CACHE_VERSION     2
+#define LNA_MODEL_CACHE_ALIGNMENT   16
+
+typedef struct lna_model_cache_header_s
+{
+    uint32_t    magic;
+    uint32_t    version;
+    uint32_t    vertex_size;    //! sizeof(lna_model_vertex_t) of the program which wrote the cache
+    uint32_t    index_size;
+    uint32_t    vertex_count;
+    uint32_t    index_count;
+    uint64_t    vertex_offset;  //! from the beginning of the file
+    uint64_t    index_offset;   //! from the beginning of the file
+    lna_vec3_t  bounds_min;
+    lna_vec3_t  bounds_max;
+} lna_model_cache_header_t;
+
+#define LNA_MODEL_INVALID_INDEX                 ((uint32_t)-1)
+#define LNA_MODEL_MAX_16_BIT_INDEX_VERTEX_COUNT 65536
+
+typedef struct lna_model_point_hash_entry_s
+{
+    uint32_t    position_index;
+    uint32_t    uv_index;
+    uint32_t    normal_index;
+    uint32_t    vertex_index;   //! LNA_MODEL_INVALID_INDEX if the entry is empty
+} lna_model_point_hash_entry_t;
+
+static uint32_t lna_model_point_hash(uint32_t position_index, uint32_t uv_index, uint32_t normal_index)
+{
+    uint32_t h = position_index * 73856093u ^ uv_index * 19349663u ^ normal_index * 83492791u;
+    h ^= h >> 16;
+    h *= 0x7FEB352Du;
+    h ^= h >> 15;
+    return h;
+}
+
+static size_t lna_model_index_size(const lna_model_index_array_t* indices)
+{
+    lna_assert(indices)
+    return indices->data_16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+static uint64_t lna_model_cache_align(uint64_t offset)
+{
+    return (offset + LNA_MODEL_CACHE_ALIGNMENT - 1) & ~((uint64_t)LNA_MODEL_CACHE_ALIGNMENT - 1);
+}
+
+static void lna_model_compute_bounds(lna_model_t* model)
 {
     lna_assert(model)
-    lna_assert(config)
-    lna_assert(config->filename)
-    lna_assert(config->temp_lifetime_mem_pool)
-    lna_assert(config->object_lifetime_mem_pool)
+    lna_assert(model->vertices.count > 0)
 
-    lna_log_message("--------------------------");
-    lna_log_message("load 3d object from file %s:", config->filename);
-    lna_log_message("--------------------------");
+    model->bounds_min = model->vertices.data[0].position;
+    model->bounds_max = model->vertices.data[0].position;
+    for (uint32_t i = 1; i < model->vertices.count; ++i)
+    {
+        const lna_vec3_t* p = &model->vertices.data[i].position;
+        model->bounds_min.x = p->x < model->bounds_min.x ? p->x : model->bounds_min.x;
+        model->bounds_min.y = p->y < model->bounds_min.y ? p->y : model->bounds_min.y;
+        model->bounds_min.z = p->z < model->bounds_min.z ? p->z : model->bounds_min.z;
+        model->bounds_max.x = p->x > model->bounds_max.x ? p->x : model->bounds_max.x;
+        model->bounds_max.y = p->y > model->bounds_max.y ? p->y : model->bounds_max.y;
+        model->bounds_max.z = p->z > model->bounds_max.z ? p->z : model->bounds_max.z;
+    }
+}
 
-    lna_file_content_t obj_file = { 0 };
-    lna_file_debug_load(
-        &obj_file,
-        config->temp_lifetime_mem_pool,
-        config->filename,
-        false
-        );
+static void* lna_model_obj_chunk_reserve(lna_model_obj_chunk_t* chunk, uint32_t count, size_t element_size)
+{
+    if (count == 0)
+    {
+        return NULL;
+    }
+    //! a few big reservations per thread: a cursor would not save atomic operations
+    return chunk->shared_pool ? lna_atomic_memory_pool_reserve(chunk->shared_pool, element_size * count) : lna_memory_pool_reserve(chunk->memory_pool, element_size * count);
+}
 
-    uint32_t position_count = 0;
-    uint32_t uv_count       = 0;
-    uint32_t normal_count   = 0;
-    uint32_t face_count     = 0;
+//! parse the obj lines of the chunk, the chunk arrays are reserved in the
+//! chunk memory pool. Used as a thread function by the parallel parse.
+static int lna_model_parse_obj_chunk(void* data)
+{
+    lna_model_obj_chunk_t* chunk = (lna_model_obj_chunk_t*)data;
+    lna_assert(chunk)
+    lna_assert(chunk->begin)
+    lna_assert(chunk->end)
+    lna_assert(chunk->memory_pool || chunk->shared_pool)
 
-    char* buffer_ptr = obj_file.content;
-    while (buffer_ptr && *buffer_ptr != '\0')
+    chunk->position_count   = 0;
+    chunk->uv_count         = 0;
+    chunk->normal_count     = 0;
+    chunk->face_count       = 0;
+
+    char* buffer_ptr = chunk->begin;
+    while (buffer_ptr && buffer_ptr < chunk->end && *buffer_ptr != '\0')
     {
         if (lna_string_begins_with(buffer_ptr, "v "))
         {
-            ++position_count;
+            ++chunk->position_count;
         }
         else if (lna_string_begins_with(buffer_ptr, "vt "))
         {
-            ++uv_count;
+            ++chunk->uv_count;
         }
         else if (lna_string_begins_with(buffer_ptr, "vn "))
         {
-            ++normal_count;
+            ++chunk->normal_count;
         }
         else if (lna_string_begins_with(buffer_ptr, "f "))
         {
-            ++face_count;
+            ++chunk->face_count;
         }
         buffer_ptr = lna_string_go_to_next_line(buffer_ptr);
     }
-    uint32_t vertex_count   = LNA_MODEL_FACE_POINT_COUNT * face_count;
-    uint32_t index_count    = LNA_MODEL_FACE_POINT_COUNT * face_count;
 
-    lna_log_message("3d object position count: %d", position_count);
-    lna_log_message("3d object uv count      : %d", uv_count);
-    lna_log_message("3d object normal count  : %d", normal_count);
-    lna_log_message("3d object face count    : %d", face_count);
-    lna_log_message("3d object vertex count  : %d", vertex_count);
-    lna_log_message("3d object index count   : %d", index_count);
-
-    lna_vec3_t*         positions   = position_count > 0    ? lna_memory_pool_reserve(config->temp_lifetime_mem_pool, sizeof(lna_vec3_t) * position_count)    : 0;
-    lna_vec2_t*         uvs         = uv_count > 0          ? lna_memory_pool_reserve(config->temp_lifetime_mem_pool, sizeof(lna_vec2_t) * uv_count)          : 0;
-    lna_vec3_t*         normals     = normal_count > 0      ? lna_memory_pool_reserve(config->temp_lifetime_mem_pool, sizeof(lna_vec3_t) * normal_count)      : 0;
-    lna_model_face_t*   faces       = face_count > 0        ? lna_memory_pool_reserve(config->temp_lifetime_mem_pool, sizeof(lna_model_face_t) * face_count)  : 0;
-    uint32_t*           indices     = face_count > 0        ? lna_memory_pool_reserve(config->temp_lifetime_mem_pool, sizeof(uint32_t) * index_count)         : 0;
+    chunk->positions    = lna_model_obj_chunk_reserve(chunk, chunk->position_count, sizeof(lna_vec3_t));
+    chunk->uvs          = lna_model_obj_chunk_reserve(chunk, chunk->uv_count, sizeof(lna_vec2_t));
+    chunk->normals      = lna_model_obj_chunk_reserve(chunk, chunk->normal_count, sizeof(lna_vec3_t));
+    chunk->faces        = lna_model_obj_chunk_reserve(chunk, chunk->face_count, sizeof(lna_model_face_t));
 
     uint32_t position_index = 0;
     uint32_t uv_index       = 0;
     uint32_t normal_index   = 0;
     uint32_t face_index     = 0;
-    buffer_ptr              = obj_file.content;
-    while (buffer_ptr && *buffer_ptr != '\0')
+    buffer_ptr = chunk->begin;
+    while (buffer_ptr && buffer_ptr < chunk->end && *buffer_ptr != '\0')
     {
         if (lna_string_begins_with(buffer_ptr, "v "))
         {
-            lna_assert(position_index < position_count)
+            lna_assert(position_index < chunk->position_count)
 
             // FORMAT: v 1.000000 -1.000000 -1.000000
             buffer_ptr = lna_string_go_to_next_space_character(buffer_ptr);
             buffer_ptr = lna_string_go_to_next_non_space_character(buffer_ptr);
-            positions[position_index].x = lna_string_parse_float(buffer_ptr);
+            chunk->positions[position_index].x = lna_string_parse_float(buffer_ptr, &buffer_ptr);
 
-            buffer_ptr = lna_string_go_to_next_space_character(buffer_ptr);
             buffer_ptr = lna_string_go_to_next_non_space_character(buffer_ptr);
-            positions[position_index].y = lna_string_parse_float(buffer_ptr);
+            chunk->positions[position_index].y = lna_string_parse_float(buffer_ptr, &buffer_ptr);
 
-            buffer_ptr = lna_string_go_to_next_space_character(buffer_ptr);
             buffer_ptr = lna_string_go_to_next_non_space_character(buffer_ptr);
-            positions[position_index].z = lna_string_parse_float(buffer_ptr);
+            chunk->positions[position_index].z = lna_string_parse_float(buffer_ptr, &buffer_ptr);
 
             ++position_index;
         }
         else if (lna_string_begins_with(buffer_ptr, "vt "))
         {
-            lna_assert(uv_index < uv_count)
+            lna_assert(uv_index < chunk->uv_count)
 
             // FORMAT: vt 0.748573 0.750412
             buffer_ptr = lna_string_go_to_next_space_character(buffer_ptr);
             buffer_ptr = lna_string_go_to_next_non_space_character(buffer_ptr);
-            uvs[uv_index].x = lna_string_parse_float(buffer_ptr);
+            chunk->uvs[uv_index].x = lna_string_parse_float(buffer_ptr, &buffer_ptr);
 
-            buffer_ptr = lna_string_go_to_next_space_character(buffer_ptr);
             buffer_ptr = lna_string_go_to_next_non_space_character(buffer_ptr);
-            uvs[uv_index].y = lna_string_parse_float(buffer_ptr);
+            chunk->uvs[uv_index].y = lna_string_parse_float(buffer_ptr, &buffer_ptr);
 
             ++uv_index;
         }
         else if (lna_string_begins_with(buffer_ptr, "vn "))
         {
-            lna_assert(normal_index < normal_count)
+            lna_assert(normal_index < chunk->normal_count)
 
             // FORMAT: v 1.000000 -1.000000 -1.000000
             buffer_ptr = lna_string_go_to_next_space_character(buffer_ptr);
             buffer_ptr = lna_string_go_to_next_non_space_character(buffer_ptr);
-            normals[normal_index].x = lna_string_parse_float(buffer_ptr);
+            chunk->normals[normal_index].x = lna_string_parse_float(buffer_ptr, &buffer_ptr);
 
-            buffer_ptr = lna_string_go_to_next_space_character(buffer_ptr);
             buffer_ptr = lna_string_go_to_next_non_space_character(buffer_ptr);
-            normals[normal_index].y = lna_string_parse_float(buffer_ptr);
+            chunk->normals[normal_index].y = lna_string_parse_float(buffer_ptr, &buffer_ptr);
 
-            buffer_ptr = lna_string_go_to_next_space_character(buffer_ptr);
             buffer_ptr = lna_string_go_to_next_non_space_character(buffer_ptr);
-            normals[normal_index].z = lna_string_parse_float(buffer_ptr);
+            chunk->normals[normal_index].z = lna_string_parse_float(buffer_ptr, &buffer_ptr);
 
             ++normal_index;
         }
         else if (lna_string_begins_with(buffer_ptr, "f "))
         {
-            lna_assert(face_index < face_count)
+            lna_assert(face_index < chunk->face_count)
 
             // FORMAT: f 5/1/1 1/2/1 4/3/1
+            buffer_ptr = lna_string_go_to_next_space_character(buffer_ptr);
             for (uint32_t point_index = 0; point_index < LNA_MODEL_FACE_POINT_COUNT; ++point_index)
             {
-                buffer_ptr = lna_string_go_to_next_space_character(buffer_ptr);
                 buffer_ptr = lna_string_go_to_next_non_space_character(buffer_ptr);
-                faces[face_index].position_indices[point_index] = (uint32_t)lna_string_parse_int(buffer_ptr);
+                chunk->faces[face_index].position_indices[point_index] = (uint32_t)lna_string_parse_int(buffer_ptr, &buffer_ptr);
 
-                buffer_ptr = lna_string_go_to_next_character(buffer_ptr, '/');
+                lna_assert(*buffer_ptr == '/')
                 ++buffer_ptr;
-                faces[face_index].uv_indices[point_index] = (uint32_t)lna_string_parse_int(buffer_ptr);
+                chunk->faces[face_index].uv_indices[point_index] = (uint32_t)lna_string_parse_int(buffer_ptr, &buffer_ptr);
 
-                buffer_ptr = lna_string_go_to_next_character(buffer_ptr, '/');
+                lna_assert(*buffer_ptr == '/')
                 ++buffer_ptr;
-                faces[face_index].normal_indices[point_index] = (uint32_t)lna_string_parse_int(buffer_ptr);
+                chunk->faces[face_index].normal_indices[point_index] = (uint32_t)lna_string_parse_int(buffer_ptr, &buffer_ptr);
             }
             ++face_index;
         }
         buffer_ptr = lna_string_go_to_next_line(buffer_ptr);
     }
 
+    return 0;
+}
+
+void lna_model_init_dev_mode(lna_model_t* model, const lna_model_config_t* config)
+{
+    lna_assert(model)
+    lna_assert(config)
+    lna_assert(config->filename)
+    lna_assert(config->temp_stack)
+    lna_assert(config->object_lifetime_mem_pool)
+
+    lna_log_message("--------------------------");
+    lna_log_message("load 3d object from file %s:", config->filename);
+    lna_log_message("--------------------------");
+
+    //! all the parsing and indexing data are dead once the model arrays
+    //! have been copied in the object lifetime memory pool
+    const lna_stack_allocator_marker_t temp_marker = lna_stack_allocator_push_marker(config->temp_stack);
+
+    lna_file_content_t obj_file = { 0 };
+    lna_file_debug_load(
+        &obj_file,
+        &config->temp_stack->pool,
+        config->filename,
+        false
+        );
+
+    //! the file is split in chunks on line boundaries. Each chunk is parsed
+    //! by its own thread, which reserves its arrays in a pool shared by the
+    //! threads, the chunk arrays are then merged in file order: the obj
+    //! indices are global so the faces are unchanged.
+    const size_t    file_length = strlen(obj_file.content);
+    uint32_t        chunk_count = config->parse_thread_count > 0 ? config->parse_thread_count : lna_thread_cpu_count();
+    if (chunk_count > LNA_MODEL_MAX_PARSE_THREAD_COUNT)
+    {
+        chunk_count = LNA_MODEL_MAX_PARSE_THREAD_COUNT;
+    }
+    if (chunk_count > 1 && file_length < (size_t)chunk_count * LNA_MODEL_MIN_PARSE_CHUNK_SIZE)
+    {
+        chunk_count = (uint32_t)(file_length / LNA_MODEL_MIN_PARSE_CHUNK_SIZE);
+        chunk_count = chunk_count > 0 ? chunk_count : 1;
+    }
+
+    lna_model_obj_chunk_t       chunks[LNA_MODEL_MAX_PARSE_THREAD_COUNT] = { 0 };
+    lna_thread_t*               threads[LNA_MODEL_MAX_PARSE_THREAD_COUNT] = { 0 };
+    lna_atomic_memory_pool_t    shared_pool = { 0 };
+    if (chunk_count > 1)
+    {
+        //! an obj line is never smaller than half of the data parsed from it,
+        //! each of the 4 arrays of a chunk may lose a cache line to the alignment
+        lna_atomic_memory_pool_init_with_pool(
+            &shared_pool,
+            &config->temp_stack->pool,
+            2 * file_length + chunk_count * (sizeof(lna_model_face_t) + 4 * LNA_ATOMIC_MEMORY_POOL_CACHE_LINE_SIZE),
+            0
+            );
+    }
+    char* const             file_end = obj_file.content + file_length;
+    char*                   chunk_begin = obj_file.content;
+    for (uint32_t i = 0; i < chunk_count; ++i)
+    {
+        char* chunk_end = file_end;
+        if (i + 1 < chunk_count)
+        {
+            chunk_end = obj_file.content + file_length / chunk_count * (i + 1);
+            chunk_end = chunk_end > chunk_begin ? chunk_end : chunk_begin;
+            chunk_end = *chunk_end != '\0' ? lna_string_go_to_next_line(chunk_end) : file_end;
+            chunk_end = chunk_end ? chunk_end : file_end;
+        }
+        chunks[i].begin = chunk_begin;
+        chunks[i].end   = chunk_end;
+        chunk_begin     = chunk_end;
+
+        if (chunk_count == 1)
+        {
+            chunks[i].memory_pool = &config->temp_stack->pool;
+        }
+        else
+        {
+            chunks[i].shared_pool = &shared_pool;
+        }
+    }
+
+    //! the calling thread parses the first chunk
+    for (uint32_t i = 1; i < chunk_count; ++i)
+    {
+        threads[i] = lna_thread_start(
+            lna_model_parse_obj_chunk,
+            &chunks[i],
+            "lna_model_parse"
+            );
+    }
+    lna_model_parse_obj_chunk(&chunks[0]);
+    for (uint32_t i = 1; i < chunk_count; ++i)
+    {
+        lna_thread_wait(threads[i]);
+    }
+
+    //! prefix sums of the chunk counts give the chunk offsets in the merged arrays
+    uint32_t position_count = 0;
+    uint32_t uv_count       = 0;
+    uint32_t normal_count   = 0;
+    uint32_t face_count     = 0;
+    uint32_t position_offsets[LNA_MODEL_MAX_PARSE_THREAD_COUNT];
+    uint32_t uv_offsets[LNA_MODEL_MAX_PARSE_THREAD_COUNT];
+    uint32_t normal_offsets[LNA_MODEL_MAX_PARSE_THREAD_COUNT];
+    uint32_t face_offsets[LNA_MODEL_MAX_PARSE_THREAD_COUNT];
+    for (uint32_t i = 0; i < chunk_count; ++i)
+    {
+        position_offsets[i] = position_count;
+        uv_offsets[i]       = uv_count;
+        normal_offsets[i]   = normal_count;
+        face_offsets[i]     = face_count;
+        position_count      += chunks[i].position_count;
+        uv_count            += chunks[i].uv_count;
+        normal_count        += chunks[i].normal_count;
+        face_count          += chunks[i].face_count;
+    }
+    uint32_t vertex_count   = LNA_MODEL_FACE_POINT_COUNT * face_count;
+    uint32_t index_count    = LNA_MODEL_FACE_POINT_COUNT * face_count;
+
+    lna_log_message("3d object parse chunks  : %d", chunk_count);
+    lna_log_message("3d object position count: %d", position_count);
+    lna_log_message("3d object uv count      : %d", uv_count);
+    lna_log_message("3d object normal count  : %d", normal_count);
+    lna_log_message("3d object face count    : %d", face_count);
+    lna_log_message("3d object vertex count  : %d", vertex_count);
+    lna_log_message("3d object index count   : %d", index_count);
+
+    lna_vec3_t*         positions   = chunks[0].positions;
+    lna_vec2_t*         uvs         = chunks[0].uvs;
+    lna_vec3_t*         normals     = chunks[0].normals;
+    lna_model_face_t*   faces       = chunks[0].faces;
+    if (chunk_count > 1)
+    {
+        positions   = position_count > 0    ? lna_memory_pool_reserve(&config->temp_stack->pool, sizeof(lna_vec3_t) * position_count)    : 0;
+        uvs         = uv_count > 0          ? lna_memory_pool_reserve(&config->temp_stack->pool, sizeof(lna_vec2_t) * uv_count)          : 0;
+        normals     = normal_count > 0      ? lna_memory_pool_reserve(&config->temp_stack->pool, sizeof(lna_vec3_t) * normal_count)      : 0;
+        faces       = face_count > 0        ? lna_memory_pool_reserve(&config->temp_stack->pool, sizeof(lna_model_face_t) * face_count)  : 0;
+        for (uint32_t i = 0; i < chunk_count; ++i)
+        {
+            if (chunks[i].position_count > 0)
+            {
+                memcpy(&positions[position_offsets[i]], chunks[i].positions, sizeof(lna_vec3_t) * chunks[i].position_count);
+            }
+            if (chunks[i].uv_count > 0)
+            {
+                memcpy(&uvs[uv_offsets[i]], chunks[i].uvs, sizeof(lna_vec2_t) * chunks[i].uv_count);
+            }
+            if (chunks[i].normal_count > 0)
+            {
+                memcpy(&normals[normal_offsets[i]], chunks[i].normals, sizeof(lna_vec3_t) * chunks[i].normal_count);
+            }
+            if (chunks[i].face_count > 0)
+            {
+                memcpy(&faces[face_offsets[i]], chunks[i].faces, sizeof(lna_model_face_t) * chunks[i].face_count);
+            }
+        }
+    }
+    uint32_t* indices = face_count > 0 ? lna_memory_pool_reserve(&config->temp_stack->pool, sizeof(uint32_t) * index_count) : 0;
+
     lna_assert(vertex_count > 0)
-    model->vertices.count   = vertex_count;
-    model->vertices.data    = lna_memory_pool_reserve(config->object_lifetime_mem_pool, vertex_count * sizeof(lna_model_vertex_t));
+    lna_assert(index_count > 0)
+
+    //! face points sharing the same position, uv and normal indices become
+    //! the same vertex, the hash table maps a point to its vertex index.
+    uint32_t hash_table_size = 1;
+    while (hash_table_size < 2 * vertex_count)
+    {
+        hash_table_size <<= 1;
+    }
+    lna_model_point_hash_entry_t* hash_table = lna_memory_pool_reserve(
+        &config->temp_stack->pool,
+        sizeof(lna_model_point_hash_entry_t) * hash_table_size
+        );
+    for (uint32_t i = 0; i < hash_table_size; ++i)
+    {
+        hash_table[i].vertex_index = LNA_MODEL_INVALID_INDEX;
+    }
+    lna_model_vertex_t* vertices = lna_memory_pool_reserve(
+        &config->temp_stack->pool,
+        sizeof(lna_model_vertex_t) * vertex_count
+        );
 
     uint32_t cur_index_count = 0;
     uint32_t cur_vertex_count = 0;
-    for (face_index = 0; face_index < face_count; ++face_index)
+    for (uint32_t face_index = 0; face_index < face_count; ++face_index)
     {
         for (uint32_t point_index = 0; point_index < LNA_MODEL_FACE_POINT_COUNT; ++point_index)
         {
-            lna_model_vertex_t vertex;
-            vertex.position.x   = positions[faces[face_index].position_indices[point_index] - 1].x;
-            vertex.position.y   = positions[faces[face_index].position_indices[point_index] - 1].y;
-            vertex.position.z   = positions[faces[face_index].position_indices[point_index] - 1].z;
-            vertex.uv.x         = uvs[faces[face_index].uv_indices[point_index] - 1].x;
-            vertex.uv.y         = uvs[faces[face_index].uv_indices[point_index] - 1].y;
-            vertex.normal.x     = normals[faces[face_index].normal_indices[point_index] - 1].x;
-            vertex.normal.y     = normals[faces[face_index].normal_indices[point_index] - 1].y;
-            vertex.normal.z     = normals[faces[face_index].normal_indices[point_index] - 1].z;
-            vertex.color.r      = 1.0f;
-            vertex.color.g      = 1.0f;
-            vertex.color.b      = 1.0f;
-            vertex.color.a      = 1.0f;
-
-            model->vertices.data[cur_vertex_count]  = vertex;
-            indices[cur_index_count++]              = cur_vertex_count++;
+            const uint32_t position_id  = faces[face_index].position_indices[point_index];
+            const uint32_t uv_id        = faces[face_index].uv_indices[point_index];
+            const uint32_t normal_id    = faces[face_index].normal_indices[point_index];
+
+            uint32_t slot = lna_model_point_hash(position_id, uv_id, normal_id) & (hash_table_size - 1);
+            while (
+                hash_table[slot].vertex_index != LNA_MODEL_INVALID_INDEX
+                && (
+                    hash_table[slot].position_index != position_id
+                    || hash_table[slot].uv_index != uv_id
+                    || hash_table[slot].normal_index != normal_id
+                    )
+                )
+            {
+                slot = (slot + 1) & (hash_table_size - 1);
+            }
+
+            if (hash_table[slot].vertex_index == LNA_MODEL_INVALID_INDEX)
+            {
+                lna_model_vertex_t vertex;
+                vertex.position.x   = positions[position_id - 1].x;
+                vertex.position.y   = positions[position_id - 1].y;
+                vertex.position.z   = positions[position_id - 1].z;
+                vertex.uv.x         = uvs[uv_id - 1].x;
+                vertex.uv.y         = uvs[uv_id - 1].y;
+                vertex.normal.x     = normals[normal_id - 1].x;
+                vertex.normal.y     = normals[normal_id - 1].y;
+                vertex.normal.z     = normals[normal_id - 1].z;
+                vertex.color.r      = 1.0f;
+                vertex.color.g      = 1.0f;
+                vertex.color.b      = 1.0f;
+                vertex.color.a      = 1.0f;
+
+                hash_table[slot].position_index = position_id;
+                hash_table[slot].uv_index       = uv_id;
+                hash_table[slot].normal_index   = normal_id;
+                hash_table[slot].vertex_index   = cur_vertex_count;
+                vertices[cur_vertex_count++]    = vertex;
+            }
+            indices[cur_index_count++] = hash_table[slot].vertex_index;
         }
     }
     lna_assert(cur_index_count == index_count)
+    lna_assert(cur_vertex_count <= vertex_count)
+
+    model->vertices.count   = cur_vertex_count;
+    model->vertices.data    = lna_memory_pool_reserve(config->object_lifetime_mem_pool, cur_vertex_count * sizeof(lna_model_vertex_t));
+    memcpy(
+        model->vertices.data,
+        vertices,
+        cur_vertex_count * sizeof(lna_model_vertex_t)
+        );
 
-    lna_assert(index_count > 0)
     model->indices.count    = index_count;
-    model->indices.data     = lna_memory_pool_reserve(config->object_lifetime_mem_pool, index_count * sizeof(uint32_t));
+    model->indices.data     = NULL;
+    model->indices.data_16  = NULL;
+    if (config->use_16_bit_indices && cur_vertex_count <= LNA_MODEL_MAX_16_BIT_INDEX_VERTEX_COUNT)
+    {
+        model->indices.data_16 = lna_memory_pool_reserve(config->object_lifetime_mem_pool, index_count * sizeof(uint16_t));
+        for (uint32_t i = 0; i < index_count; ++i)
+        {
+            model->indices.data_16[i] = (uint16_t)indices[i];
+        }
+    }
+    else
+    {
+        model->indices.data = lna_memory_pool_reserve(config->object_lifetime_mem_pool, index_count * sizeof(uint32_t));
+        memcpy(
+            model->indices.data,
+            indices,
+            index_count * sizeof(uint32_t)
+            );
+    }
+
+    //! a 32 entries fifo is a fair approximation of the gpu post transform cache
+    const uint32_t  transformed_vertex_count    = lna_model_optimizer_compute_stats(
+        &model->indices,
+        cur_vertex_count,
+        LNA_MODEL_OPTIMIZER_DEFAULT_CACHE_SIZE
+        ).transformed_vertex_count;
+    const size_t    unindexed_size              = vertex_count * sizeof(lna_model_vertex_t) + index_count * sizeof(uint32_t);
+    const size_t    indexed_size                = cur_vertex_count * sizeof(lna_model_vertex_t) + index_count * lna_model_index_size(&model->indices);
+
+    lna_log_message("3d object unique vertices: %d (%d removed)", cur_vertex_count, vertex_count - cur_vertex_count);
+    lna_log_message("3d object index size     : %d bits", 8 * (int)lna_model_index_size(&model->indices));
+    lna_log_message("3d object memory saved   : %d bytes (%d -> %d)", (int)(unindexed_size - indexed_size), (int)unindexed_size, (int)indexed_size);
+    lna_log_message("3d object vs invocations : %d avoided (%d -> %d)", vertex_count - transformed_vertex_count, vertex_count, transformed_vertex_count);
+
+    lna_stack_allocator_pop_to_marker(config->temp_stack, temp_marker);
+
+    lna_model_compute_bounds(model);
+}
+
+void lna_model_init(lna_model_t* model, const lna_model_config_t* config)
+{
+    lna_assert(model)
+    lna_assert(config)
+
+    if (config->cache_filename && lna_model_init_from_cache(model, config->cache_filename))
+    {
+        return;
+    }
+
+    lna_model_init_dev_mode(
+        model,
+        config
+        );
+
+    if (config->optimize)
+    {
+        lna_model_optimize(
+            model,
+            config->temp_stack
+            );
+    }
+
+    if (config->cache_filename)
+    {
+        const lna_stack_allocator_marker_t temp_marker = lna_stack_allocator_push_marker(config->temp_stack);
+        if (!lna_model_write_cache(model, config->cache_filename, &config->temp_stack->pool))
+        {
+            lna_log_warning("cannot write model cache file %s", config->cache_filename);
+        }
+        lna_stack_allocator_pop_to_marker(config->temp_stack, temp_marker);
+    }
+}
+
+bool lna_model_init_from_cache(lna_model_t* model, const char* cache_filename)
+{
+    lna_assert(model)
+    lna_assert(model->cache_file_mapping.content == NULL)
+    lna_assert(cache_filename)
+
+    if (!lna_file_map(&model->cache_file_mapping, cache_filename))
+    {
+        return false;
+    }
+
+    const char*                     content = model->cache_file_mapping.content;
+    const uint64_t                  size    = (uint64_t)model->cache_file_mapping.size;
+    const lna_model_cache_header_t* header  = (const lna_model_cache_header_t*)content;
+
+    if (
+        size < sizeof(lna_model_cache_header_t)
+        || header->magic != LNA_MODEL_CACHE_MAGIC
+        || header->version != LNA_MODEL_CACHE_VERSION
+        || header->vertex_size != sizeof(lna_model_vertex_t)
+        || (header->index_size != sizeof(uint32_t) && header->index_size != sizeof(uint16_t))
+        || header->vertex_count == 0
+        || header->index_count == 0
+        || header->vertex_offset % LNA_MODEL_CACHE_ALIGNMENT != 0
+        || header->index_offset % LNA_MODEL_CACHE_ALIGNMENT != 0
+        || header->vertex_offset + (uint64_t)header->vertex_count * header->vertex_size > size
+        || header->index_offset + (uint64_t)header->index_count * header->index_size > size
+        )
+    {
+        lna_log_warning("model cache file %s is invalid or out of date", cache_filename);
+        lna_file_unmap(&model->cache_file_mapping);
+        return false;
+    }
+
+    //! the mapping is read only, the model arrays must not be modified
+    model->vertices.count   = header->vertex_count;
+    model->vertices.data    = (lna_model_vertex_t*)(content + header->vertex_offset);
+    model->indices.count    = header->index_count;
+    model->indices.data     = header->index_size == sizeof(uint32_t) ? (uint32_t*)(content + header->index_offset) : NULL;
+    model->indices.data_16  = header->index_size == sizeof(uint16_t) ? (uint16_t*)(content + header->index_offset) : NULL;
+    model->bounds_min       = header->bounds_min;
+    model->bounds_max       = header->bounds_max;
+
+    lna_log_message("load 3d object from cache file %s: %d vertices, %d indices", cache_filename, model->vertices.count, model->indices.count);
+    return true;
+}
+
+bool lna_model_write_cache(const lna_model_t* model, const char* cache_filename, lna_memory_pool_t* temp_lifetime_mem_pool)
+{
+    lna_assert(model)
+    lna_assert(model->vertices.data)
+    lna_assert(model->vertices.count > 0)
+    lna_assert(model->indices.data || model->indices.data_16)
+    lna_assert(model->indices.count > 0)
+    lna_assert(cache_filename)
+    lna_assert(temp_lifetime_mem_pool)
+
+    const size_t index_size         = lna_model_index_size(&model->indices);
+
+    const uint64_t vertex_offset    = lna_model_cache_align(sizeof(lna_model_cache_header_t));
+    const uint64_t index_offset     = lna_model_cache_align(vertex_offset + (uint64_t)model->vertices.count * sizeof(lna_model_vertex_t));
+    const uint64_t size             = index_offset + (uint64_t)model->indices.count * index_size;
+
+    char* content = lna_memory_pool_reserve(
+        temp_lifetime_mem_pool,
+        (size_t)size
+        );
+    memset(
+        content,
+        0,
+        (size_t)vertex_offset
+        );
+
+    lna_model_cache_header_t* header = (lna_model_cache_header_t*)content;
+    header->magic           = LNA_MODEL_CACHE_MAGIC;
+    header->version         = LNA_MODEL_CACHE_VERSION;
+    header->vertex_size     = sizeof(lna_model_vertex_t);
+    header->index_size      = (uint32_t)index_size;
+    header->vertex_count    = model->vertices.count;
+    header->index_count     = model->indices.count;
+    header->vertex_offset   = vertex_offset;
+    header->index_offset    = index_offset;
+    header->bounds_min      = model->bounds_min;
+    header->bounds_max      = model->bounds_max;
+
+    memcpy(
+        content + vertex_offset,
+        model->vertices.data,
+        model->vertices.count * sizeof(lna_model_vertex_t)
+        );
+    memset(
+        content + vertex_offset + model->vertices.count * sizeof(lna_model_vertex_t),
+        0,
+        (size_t)(index_offset - vertex_offset - model->vertices.count * sizeof(lna_model_vertex_t))
+        );
     memcpy(
-        model->indices.data,
-        indices,
-        index_count * sizeof(uint32_t)
+        content + index_offset,
+        model->indices.data_16 ? (const void*)model->indices.data_16 : (const void*)model->indices.data,
+        model->indices.count * index_size
         );
+
+    return lna_file_write(
+        cache_filename,
+        content,
+        (size_t)size
+        );
+}
+
+void lna_model_release(lna_model_t* model)
+{
+    lna_assert(model)
+
+    if (model->cache_file_mapping.content)
+    {
+        lna_file_unmap(&model->cache_file_mapping);
+    }
+    model->vertices.data    = NULL;
+    model->vertices.count   = 0;
+    model->indices.data     = NULL;
+    model->indices.data_16  = NULL;
+    model->indices.count    = 0;
 }
@@ -1,12 +1,15 @@
 #ifndef LNA_GRAPHICS_LNA_MODEL_H
 #define LNA_GRAPHICS_LNA_MODEL_H
 
+#include <stdbool.h>
 #include <stdint.h>
+#include "core/lna_file.h"
 #include "maths/lna_vec2.h"
 #include "maths/lna_vec3.h"
 #include "maths/lna_vec4.h"
 
-typedef struct lna_memory_pool_s lna_memory_pool_t;
+typedef struct lna_memory_pool_s        lna_memory_pool_t;
+typedef struct lna_stack_allocator_s    lna_stack_allocator_t;
 
 typedef struct lna_model_vertex_s
 {
@@ -24,7 +27,8 @@ typedef struct lna_model_vertex_array_s
 
 typedef struct lna_model_index_array_s
 {
-    uint32_t*                       data;
+    uint32_t*                       data;                       //! NULL when the indices are stored in data_16
+    uint16_t*                       data_16;                    //! NULL when the indices are stored in data
     uint32_t                        count;
 } lna_model_index_array_t;
 
@@ -32,12 +36,19 @@ typedef struct lna_model_s
 {
     lna_model_vertex_array_t        vertices;
     lna_model_index_array_t         indices;
+    lna_vec3_t                      bounds_min;
+    lna_vec3_t                      bounds_max;
+    lna_file_mapping_t              cache_file_mapping;         //! vertices and indices point in the mapped cache file when the model has been loaded from it
 } lna_model_t;
 
 typedef struct lna_model_config_s
 {
     const char*                     filename;
-    lna_memory_pool_t*              temp_lifetime_mem_pool;     //! for temporary object: can be a frame lifetime memory pool
+    const char*                     cache_filename;             //! binary mesh cache loaded instead of filename when it exists, written after filename parsing otherwise. can be NULL
+    bool                            use_16_bit_indices;         //! store the indices in data_16 when there are 65536 unique vertices or less
+    bool                            optimize;                   //! reorder triangles and vertices for the gpu caches (see lna_model_optimizer.h), before the cache is written
+    uint32_t                        parse_thread_count;         //! obj file parsed in parallel by this number of threads, set to 0 to use default value (cpu count)
+    lna_stack_allocator_t*          temp_stack;                 //! for temporary object: popped before the init returns. the parallel parse needs about 2 times the file size more
     lna_memory_pool_t*              object_lifetime_mem_pool;   //! for object lifetime: memory pool must have the same lifetime than the object whom will used the initialized model
 } lna_model_config_t;
 
@@ -56,4 +67,20 @@ typedef struct lna_model_config_s
 //! -----------------------------------------------------------------------------
 extern void lna_model_init_dev_mode(lna_model_t* model, const lna_model_config_t* config);
 
+//! -----------------------------------------------------------------------------
+//! BINARY MESH CACHE:
+//! -----------------------------------------------------------------------------
+//! header, vertex array and index array written as they are in memory. Loading
+//! maps the file and points the model arrays directly in the mapping: there is
+//! no parsing and no copy before the vertices and indices go to the renderer
+//! staging buffer. A cache written with another vertex layout or version is
+//! ignored (and rewritten by lna_model_init). Delete the cache file to force
+//! the conversion after the source file has changed.
+//! -----------------------------------------------------------------------------
+extern void lna_model_init              (lna_model_t* model, const lna_model_config_t* config);
+extern bool lna_model_init_from_cache   (lna_model_t* model, const char* cache_filename);
+extern bool lna_model_write_cache       (const lna_model_t* model, const char* cache_filename, lna_memory_pool_t* temp_lifetime_mem_pool);
+//! unmap the cache file, the model vertices and indices must not be used anymore.
+extern void lna_model_release           (lna_model_t* model);
+
 #endif
@@ -0,0 +1,573 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include "graphics/lna_model_optimizer.h"
+#include "graphics/lna_model.h"
+#include "core/lna_memory_pool.h"
+#include "core/lna_stack_allocator.h"
+#include "core/lna_assert.h"
+#include "core/lna_log.h"
+
+#define LNA_MODEL_OPTIMIZER_INVALID_INDEX           ((uint32_t)-1)
+#define LNA_MODEL_OPTIMIZER_MAX_CACHE_SIZE          64
+#define LNA_MODEL_OPTIMIZER_OVERDRAW_CACHE_SIZE     16
+
+//! forsyth vertex score parameters
+#define LNA_MODEL_OPTIMIZER_CACHE_DECAY_POWER       1.5f
+#define LNA_MODEL_OPTIMIZER_LAST_TRIANGLE_SCORE     0.75f
+#define LNA_MODEL_OPTIMIZER_VALENCE_BOOST_SCALE     2.0f
+#define LNA_MODEL_OPTIMIZER_VALENCE_BOOST_POWER     0.5f
+
+typedef struct lna_model_optimizer_fifo_cache_s
+{
+    uint32_t    entries[LNA_MODEL_OPTIMIZER_MAX_CACHE_SIZE];
+    uint32_t    size;
+    uint32_t    count;
+    uint32_t    head;
+} lna_model_optimizer_fifo_cache_t;
+
+typedef struct lna_model_optimizer_cluster_s
+{
+    uint32_t    first_triangle;
+    uint32_t    triangle_count;
+    float       sort_key;
+} lna_model_optimizer_cluster_t;
+
+//! ============================================================================
+//!                             LOCAL FUNCTIONS
+//! ============================================================================
+
+static uint32_t lna_model_optimizer_index(const lna_model_index_array_t* indices, uint32_t i)
+{
+    return indices->data_16 ? (uint32_t)indices->data_16[i] : indices->data[i];
+}
+
+static void lna_model_optimizer_set_index(lna_model_index_array_t* indices, uint32_t i, uint32_t value)
+{
+    if (indices->data_16)
+    {
+        lna_assert(value <= 0xFFFF)
+        indices->data_16[i] = (uint16_t)value;
+    }
+    else
+    {
+        indices->data[i] = value;
+    }
+}
+
+//! copy the indices as 32 bits indices in the temp memory pool.
+static uint32_t* lna_model_optimizer_copy_indices(const lna_model_index_array_t* indices, lna_memory_pool_t* temp_lifetime_mem_pool)
+{
+    uint32_t* copy = lna_memory_pool_reserve(
+        temp_lifetime_mem_pool,
+        sizeof(uint32_t) * indices->count
+        );
+    for (uint32_t i = 0; i < indices->count; ++i)
+    {
+        copy[i] = lna_model_optimizer_index(indices, i);
+    }
+    return copy;
+}
+
+static void lna_model_optimizer_fifo_cache_reset(lna_model_optimizer_fifo_cache_t* cache, uint32_t size)
+{
+    lna_assert(size > 0 && size <= LNA_MODEL_OPTIMIZER_MAX_CACHE_SIZE)
+    cache->size     = size;
+    cache->count    = 0;
+    cache->head     = 0;
+}
+
+//! return true on a cache miss
+static bool lna_model_optimizer_fifo_cache_access(lna_model_optimizer_fifo_cache_t* cache, uint32_t vertex)
+{
+    for (uint32_t i = 0; i < cache->count; ++i)
+    {
+        if (cache->entries[i] == vertex)
+        {
+            return false;
+        }
+    }
+    cache->entries[cache->head] = vertex;
+    cache->head                 = (cache->head + 1) % cache->size;
+    cache->count                = cache->count < cache->size ? cache->count + 1 : cache->size;
+    return true;
+}
+
+static uint32_t lna_model_optimizer_triangle_miss_count(lna_model_optimizer_fifo_cache_t* cache, const uint32_t* triangle)
+{
+    return (lna_model_optimizer_fifo_cache_access(cache, triangle[0]) ? 1 : 0)
+        + (lna_model_optimizer_fifo_cache_access(cache, triangle[1]) ? 1 : 0)
+        + (lna_model_optimizer_fifo_cache_access(cache, triangle[2]) ? 1 : 0);
+}
+
+static float lna_model_optimizer_vertex_score(int32_t cache_position, uint32_t remaining_valence, uint32_t cache_size)
+{
+    if (remaining_valence == 0)
+    {
+        //! no triangle left to draw with this vertex
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cache_position >= 0)
+    {
+        if (cache_position < 3)
+        {
+            //! used by the last triangle, fixed score to avoid favoring its direct neighbours too much
+            score = LNA_MODEL_OPTIMIZER_LAST_TRIANGLE_SCORE;
+        }
+        else
+        {
+            const float scaler = 1.0f / (float)(cache_size - 3);
+            score = powf(1.0f - (float)(cache_position - 3) * scaler, LNA_MODEL_OPTIMIZER_CACHE_DECAY_POWER);
+        }
+    }
+    //! vertices with few triangles left are boosted to get rid of them
+    score += LNA_MODEL_OPTIMIZER_VALENCE_BOOST_SCALE * powf((float)remaining_valence, -LNA_MODEL_OPTIMIZER_VALENCE_BOOST_POWER);
+    return score;
+}
+
+static int lna_model_optimizer_compare_clusters(const void* a, const void* b)
+{
+    const float ka = ((const lna_model_optimizer_cluster_t*)a)->sort_key;
+    const float kb = ((const lna_model_optimizer_cluster_t*)b)->sort_key;
+    //! descending order
+    return (ka < kb) - (ka > kb);
+}
+
+//! ============================================================================
+//!                             PUBLIC FUNCTIONS
+//! ============================================================================
+
+void lna_model_optimizer_vertex_cache(lna_model_index_array_t* indices, uint32_t vertex_count, lna_memory_pool_t* temp_lifetime_mem_pool)
+{
+    lna_assert(indices)
+    lna_assert(indices->data || indices->data_16)
+    lna_assert(indices->count % 3 == 0)
+    lna_assert(vertex_count > 0)
+    lna_assert(temp_lifetime_mem_pool)
+
+    const uint32_t  cache_size      = LNA_MODEL_OPTIMIZER_DEFAULT_CACHE_SIZE;
+    const uint32_t  triangle_count  = indices->count / 3;
+    const uint32_t* source          = lna_model_optimizer_copy_indices(indices, temp_lifetime_mem_pool);
+
+    uint32_t*   remaining_valences  = lna_memory_pool_reserve(temp_lifetime_mem_pool, sizeof(uint32_t) * vertex_count);
+    uint32_t*   adjacency_offsets   = lna_memory_pool_reserve(temp_lifetime_mem_pool, sizeof(uint32_t) * vertex_count);
+    uint32_t*   adjacency           = lna_memory_pool_reserve(temp_lifetime_mem_pool, sizeof(uint32_t) * indices->count);
+    int32_t*    cache_positions     = lna_memory_pool_reserve(temp_lifetime_mem_pool, sizeof(int32_t) * vertex_count);
+    float*      vertex_scores       = lna_memory_pool_reserve(temp_lifetime_mem_pool, sizeof(float) * vertex_count);
+    float*      triangle_scores     = lna_memory_pool_reserve(temp_lifetime_mem_pool, sizeof(float) * triangle_count);
+    bool*       triangle_emitted    = lna_memory_pool_reserve(temp_lifetime_mem_pool, sizeof(bool) * triangle_count);
+
+    //! TRIANGLE ADJACENCY PART
+
+    memset(remaining_valences, 0, sizeof(uint32_t) * vertex_count);
+    for (uint32_t i = 0; i < indices->count; ++i)
+    {
+        lna_assert(source[i] < vertex_count)
+        ++remaining_valences[source[i]];
+    }
+    uint32_t offset = 0;
+    for (uint32_t v = 0; v < vertex_count; ++v)
+    {
+        adjacency_offsets[v]    = offset;
+        offset                  += remaining_valences[v];
+        remaining_valences[v]   = 0;
+    }
+    for (uint32_t t = 0; t < triangle_count; ++t)
+    {
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            const uint32_t v = source[t * 3 + k];
+            adjacency[adjacency_offsets[v] + remaining_valences[v]++] = t;
+        }
+    }
+
+    //! SCORES PART
+
+    for (uint32_t v = 0; v < vertex_count; ++v)
+    {
+        cache_positions[v]  = -1;
+        vertex_scores[v]    = lna_model_optimizer_vertex_score(-1, remaining_valences[v], cache_size);
+    }
+    uint32_t    best_triangle   = LNA_MODEL_OPTIMIZER_INVALID_INDEX;
+    float       best_score      = -1.0f;
+    for (uint32_t t = 0; t < triangle_count; ++t)
+    {
+        triangle_emitted[t] = false;
+        triangle_scores[t]  = vertex_scores[source[t * 3]] + vertex_scores[source[t * 3 + 1]] + vertex_scores[source[t * 3 + 2]];
+        if (triangle_scores[t] > best_score)
+        {
+            best_score      = triangle_scores[t];
+            best_triangle   = t;
+        }
+    }
+
+    //! EMIT PART
+
+    uint32_t cache[LNA_MODEL_OPTIMIZER_MAX_CACHE_SIZE + 3];
+    uint32_t new_cache[LNA_MODEL_OPTIMIZER_MAX_CACHE_SIZE + 3];
+    uint32_t cache_count            = 0;
+    uint32_t next_unemitted_triangle = 0;
+
+    for (uint32_t emitted_count = 0; emitted_count < triangle_count; ++emitted_count)
+    {
+        if (best_triangle == LNA_MODEL_OPTIMIZER_INVALID_INDEX)
+        {
+            //! dead end: the cache vertices have no triangle left, go on with
+            //! the first triangle not emitted yet.
+            while (triangle_emitted[next_unemitted_triangle])
+            {
+                ++next_unemitted_triangle;
+            }
+            best_triangle = next_unemitted_triangle;
+        }
+
+        const uint32_t* triangle = &source[best_triangle * 3];
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            lna_model_optimizer_set_index(indices, emitted_count * 3 + k, triangle[k]);
+        }
+        triangle_emitted[best_triangle] = true;
+
+        //! remove the triangle from the adjacency of its vertices
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            const uint32_t  v           = triangle[k];
+            uint32_t*       triangles   = &adjacency[adjacency_offsets[v]];
+            for (uint32_t i = 0; i < remaining_valences[v]; ++i)
+            {
+                if (triangles[i] == best_triangle)
+                {
+                    triangles[i] = triangles[--remaining_valences[v]];
+                    break;
+                }
+            }
+        }
+
+        //! the triangle vertices go to the front of the lru cache
+        uint32_t new_cache_count = 0;
+        for (uint32_t k = 0; k < 3; ++k)
+        {
+            new_cache[new_cache_count++] = triangle[k];
+        }
+        for (uint32_t i = 0; i < cache_count; ++i)
+        {
+            const uint32_t v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+            {
+                new_cache[new_cache_count++] = v;
+            }
+        }
+
+        for (uint32_t i = 0; i < new_cache_count; ++i)
+        {
+            const uint32_t v    = new_cache[i];
+            cache_positions[v]  = i < cache_size ? (int32_t)i : -1;
+            vertex_scores[v]    = lna_model_optimizer_vertex_score(cache_positions[v], remaining_valences[v], cache_size);
+        }
+
+        best_triangle   = LNA_MODEL_OPTIMIZER_INVALID_INDEX;
+        best_score      = -1.0f;
+        for (uint32_t i = 0; i < new_cache_count; ++i)
+        {
+            const uint32_t  v           = new_cache[i];
+            const uint32_t* triangles   = &adjacency[adjacency_offsets[v]];
+            for (uint32_t j = 0; j < remaining_valences[v]; ++j)
+            {
+                const uint32_t  t       = triangles[j];
+                const uint32_t* tv      = &source[t * 3];
+                triangle_scores[t]      = vertex_scores[tv[0]] + vertex_scores[tv[1]] + vertex_scores[tv[2]];
+                if (triangle_scores[t] > best_score)
+                {
+                    best_score      = triangle_scores[t];
+                    best_triangle   = t;
+                }
+            }
+        }
+
+        cache_count = new_cache_count < cache_size ? new_cache_count : cache_size;
+        memcpy(
+            cache,
+            new_cache,
+            sizeof(uint32_t) * cache_count
+            );
+    }
+}
+
+void lna_model_optimizer_overdraw(lna_model_index_array_t* indices, const lna_model_vertex_array_t* vertices, float threshold, lna_memory_pool_t* temp_lifetime_mem_pool)
+{
+    lna_assert(indices)
+    lna_assert(indices->data || indices->data_16)
+    lna_assert(indices->count % 3 == 0)
+    lna_assert(vertices)
+    lna_assert(vertices->data)
+    lna_assert(threshold >= 1.0f)
+    lna_assert(temp_lifetime_mem_pool)
+
+    if (indices->count == 0)
+    {
+        return;
+    }
+
+    const uint32_t  triangle_count  = indices->count / 3;
+    const uint32_t* source          = lna_model_optimizer_copy_indices(indices, temp_lifetime_mem_pool);
+
+    lna_model_optimizer_cluster_t* clusters = lna_memory_pool_reserve(
+        temp_lifetime_mem_pool,
+        sizeof(lna_model_optimizer_cluster_t) * triangle_count
+        );
+    uint32_t* hard_boundaries = lna_memory_pool_reserve(
+        temp_lifetime_mem_pool,
+        sizeof(uint32_t) * (triangle_count + 1)
+        );
+
+    //! HARD BOUNDARIES PART: the vertex cache order is kept inside a
+    //! cluster, clusters start where the cache is flushed (the three
+    //! vertices of a triangle are cache misses).
+
+    lna_model_optimizer_fifo_cache_t cache;
+    lna_model_optimizer_fifo_cache_reset(&cache, LNA_MODEL_OPTIMIZER_OVERDRAW_CACHE_SIZE);
+
+    uint32_t hard_boundary_count = 0;
+    for (uint32_t t = 0; t < triangle_count; ++t)
+    {
+        const uint32_t miss_count = lna_model_optimizer_triangle_miss_count(&cache, &source[t * 3]);
+        if (t == 0 || miss_count == 3)
+        {
+            hard_boundaries[hard_boundary_count++] = t;
+        }
+    }
+    hard_boundaries[hard_boundary_count] = triangle_count;
+
+    //! SOFT BOUNDARIES PART: hard clusters are split as soon as the cache
+    //! miss ratio of the cluster in progress stays under the threshold.
+
+    uint32_t cluster_count = 0;
+    for (uint32_t h = 0; h < hard_boundary_count; ++h)
+    {
+        const uint32_t first    = hard_boundaries[h];
+        const uint32_t end      = hard_boundaries[h + 1];
+
+        lna_model_optimizer_fifo_cache_reset(&cache, LNA_MODEL_OPTIMIZER_OVERDRAW_CACHE_SIZE);
+        uint32_t cluster_miss_count = 0;
+        for (uint32_t t = first; t < end; ++t)
+        {
+            cluster_miss_count += lna_model_optimizer_triangle_miss_count(&cache, &source[t * 3]);
+        }
+        const float cluster_threshold = threshold * (float)cluster_miss_count / (float)(end - first);
+
+        lna_model_optimizer_fifo_cache_reset(&cache, LNA_MODEL_OPTIMIZER_OVERDRAW_CACHE_SIZE);
+        uint32_t cluster_first  = first;
+        uint32_t miss_count     = 0;
+        for (uint32_t t = first; t < end; ++t)
+        {
+            miss_count += lna_model_optimizer_triangle_miss_count(&cache, &source[t * 3]);
+            if (t + 1 == end || (float)miss_count / (float)(t + 1 - cluster_first) <= cluster_threshold)
+            {
+                clusters[cluster_count].first_triangle  = cluster_first;
+                clusters[cluster_count].triangle_count  = t + 1 - cluster_first;
+                ++cluster_count;
+                cluster_first   = t + 1;
+                miss_count      = 0;
+                lna_model_optimizer_fifo_cache_reset(&cache, LNA_MODEL_OPTIMIZER_OVERDRAW_CACHE_SIZE);
+            }
+        }
+    }
+
+
+    //! SORT PART: clusters far from the mesh center in the direction they
+    //! face are likely to occlude the others, they are drawn first.
+
+    lna_vec3_t* cluster_centroids = lna_memory_pool_reserve(
+        temp_lifetime_mem_pool,
+        sizeof(lna_vec3_t) * cluster_count
+        );
+    lna_vec3_t* cluster_normals = lna_memory_pool_reserve(
+        temp_lifetime_mem_pool,
+        sizeof(lna_vec3_t) * cluster_count
+        );
+
+    lna_vec3_t  mesh_centroid   = { 0 };
+    float       mesh_area       = 0.0f;
+    for (uint32_t c = 0; c < cluster_count; ++c)
+    {
+        lna_vec3_t  centroid    = { 0 };
+        lna_vec3_t  normal      = { 0 };
+        float       area        = 0.0f;
+        const uint32_t end      = clusters[c].first_triangle + clusters[c].triangle_count;
+        for (uint32_t t = clusters[c].first_triangle; t < end; ++t)
+        {
+            const lna_vec3_t p0 = vertices->data[source[t * 3]].position;
+            const lna_vec3_t p1 = vertices->data[source[t * 3 + 1]].position;
+            const lna_vec3_t p2 = vertices->data[source[t * 3 + 2]].position;
+            const lna_vec3_t n  = lna_vec3_cross_product(
+                lna_vec3_sub(p1, p0),
+                lna_vec3_sub(p2, p0)
+                );
+            //! the cross product length is twice the triangle area, the factor does not matter here
+            const float triangle_area = sqrtf(lna_vec3_dot_product(n, n));
+
+            centroid    = lna_vec3_add(centroid, lna_vec3_mult(lna_vec3_add(lna_vec3_add(p0, p1), p2), triangle_area / 3.0f));
+            normal      = lna_vec3_add(normal, n);
+            area        += triangle_area;
+        }
+
+        mesh_centroid   = lna_vec3_add(mesh_centroid, centroid);
+        mesh_area       += area;
+
+        cluster_centroids[c] = area > 0.0f ? lna_vec3_div(centroid, area) : centroid;
+        cluster_normals[c]   = normal;
+    }
+    mesh_centroid = mesh_area > 0.0f ? lna_vec3_div(mesh_centroid, mesh_area) : mesh_centroid;
+
+    for (uint32_t c = 0; c < cluster_count; ++c)
+    {
+        const float normal_length = sqrtf(lna_vec3_dot_product(cluster_normals[c], cluster_normals[c]));
+        clusters[c].sort_key = normal_length > 0.0f
+            ? lna_vec3_dot_product(lna_vec3_sub(cluster_centroids[c], mesh_centroid), cluster_normals[c]) / normal_length
+            : 0.0f;
+    }
+
+    qsort(
+        clusters,
+        cluster_count,
+        sizeof(lna_model_optimizer_cluster_t),
+        lna_model_optimizer_compare_clusters
+        );
+
+    uint32_t index = 0;
+    for (uint32_t c = 0; c < cluster_count; ++c)
+    {
+        const uint32_t first    = clusters[c].first_triangle * 3;
+        const uint32_t end      = first + clusters[c].triangle_count * 3;
+        for (uint32_t i = first; i < end; ++i)
+        {
+            lna_model_optimizer_set_index(indices, index++, source[i]);
+        }
+    }
+    lna_assert(index == indices->count)
+}
+
+void lna_model_optimizer_vertex_fetch(lna_model_vertex_array_t* vertices, lna_model_index_array_t* indices, lna_memory_pool_t* temp_lifetime_mem_pool)
+{
+    lna_assert(vertices)
+    lna_assert(vertices->data)
+    lna_assert(vertices->count > 0)
+    lna_assert(indices)
+    lna_assert(indices->data || indices->data_16)
+    lna_assert(temp_lifetime_mem_pool)
+
+    uint32_t* remap = lna_memory_pool_reserve(
+        temp_lifetime_mem_pool,
+        sizeof(uint32_t) * vertices->count
+        );
+    lna_model_vertex_t* source = lna_memory_pool_reserve(
+        temp_lifetime_mem_pool,
+        sizeof(lna_model_vertex_t) * vertices->count
+        );
+    memcpy(
+        source,
+        vertices->data,
+        sizeof(lna_model_vertex_t) * vertices->count
+        );
+    for (uint32_t v = 0; v < vertices->count; ++v)
+    {
+        remap[v] = LNA_MODEL_OPTIMIZER_INVALID_INDEX;
+    }
+
+    uint32_t vertex_count = 0;
+    for (uint32_t i = 0; i < indices->count; ++i)
+    {
+        const uint32_t v = lna_model_optimizer_index(indices, i);
+        lna_assert(v < vertices->count)
+        if (remap[v] == LNA_MODEL_OPTIMIZER_INVALID_INDEX)
+        {
+            remap[v]                        = vertex_count;
+            vertices->data[vertex_count]    = source[v];
+            ++vertex_count;
+        }
+        lna_model_optimizer_set_index(indices, i, remap[v]);
+    }
+
+    if (vertex_count < vertices->count)
+    {
+        lna_log_message("3d object unused vertices: %d removed", vertices->count - vertex_count);
+    }
+    vertices->count = vertex_count;
+}
+
+lna_model_optimizer_stats_t lna_model_optimizer_compute_stats(const lna_model_index_array_t* indices, uint32_t vertex_count, uint32_t cache_size)
+{
+    lna_assert(indices)
+    lna_assert(indices->data || indices->data_16)
+    lna_assert(indices->count % 3 == 0)
+
+    lna_model_optimizer_fifo_cache_t cache;
+    lna_model_optimizer_fifo_cache_reset(&cache, cache_size);
+
+    lna_model_optimizer_stats_t stats = { 0 };
+    for (uint32_t i = 0; i < indices->count; ++i)
+    {
+        if (lna_model_optimizer_fifo_cache_access(&cache, lna_model_optimizer_index(indices, i)))
+        {
+            ++stats.transformed_vertex_count;
+        }
+    }
+    stats.acmr = indices->count > 0 ? (float)stats.transformed_vertex_count / (float)(indices->count / 3) : 0.0f;
+    stats.atvr = vertex_count > 0 ? (float)stats.transformed_vertex_count / (float)vertex_count : 0.0f;
+    return stats;
+}
+
+void lna_model_optimize(lna_model_t* model, lna_stack_allocator_t* temp_stack)
+{
+    lna_assert(model)
+    lna_assert(model->cache_file_mapping.content == NULL)
+    lna_assert(temp_stack)
+
+    if (model->indices.count == 0)
+    {
+        return;
+    }
+
+    const lna_model_optimizer_stats_t before = lna_model_optimizer_compute_stats(
+        &model->indices,
+        model->vertices.count,
+        LNA_MODEL_OPTIMIZER_DEFAULT_CACHE_SIZE
+        );
+
+    lna_stack_allocator_marker_t temp_marker = lna_stack_allocator_push_marker(temp_stack);
+    lna_model_optimizer_vertex_cache(
+        &model->indices,
+        model->vertices.count,
+        &temp_stack->pool
+        );
+    lna_stack_allocator_pop_to_marker(temp_stack, temp_marker);
+
+    temp_marker = lna_stack_allocator_push_marker(temp_stack);
+    lna_model_optimizer_overdraw(
+        &model->indices,
+        &model->vertices,
+        LNA_MODEL_OPTIMIZER_DEFAULT_OVERDRAW_THRESHOLD,
+        &temp_stack->pool
+        );
+    lna_stack_allocator_pop_to_marker(temp_stack, temp_marker);
+
+    temp_marker = lna_stack_allocator_push_marker(temp_stack);
+    lna_model_optimizer_vertex_fetch(
+        &model->vertices,
+        &model->indices,
+        &temp_stack->pool
+        );
+    lna_stack_allocator_pop_to_marker(temp_stack, temp_marker);
+
+    const lna_model_optimizer_stats_t after = lna_model_optimizer_compute_stats(
+        &model->indices,
+        model->vertices.count,
+        LNA_MODEL_OPTIMIZER_DEFAULT_CACHE_SIZE
+        );
+
+    lna_log_message("3d object acmr           : %.3f -> %.3f", (double)before.acmr, (double)after.acmr);
+    lna_log_message("3d object atvr           : %.3f -> %.3f", (double)before.atvr, (double)after.atvr);
+    lna_log_message("3d object vs invocations : %d -> %d", before.transformed_vertex_count, after.transformed_vertex_count);
+}
@@ -0,0 +1,39 @@
+#ifndef LNA_GRAPHICS_LNA_MODEL_OPTIMIZER_H
+#define LNA_GRAPHICS_LNA_MODEL_OPTIMIZER_H
+
+#include <stdint.h>
+
+typedef struct lna_memory_pool_s            lna_memory_pool_t;
+typedef struct lna_stack_allocator_s        lna_stack_allocator_t;
+typedef struct lna_model_s                  lna_model_t;
+typedef struct lna_model_vertex_array_s     lna_model_vertex_array_t;
+typedef struct lna_model_index_array_s      lna_model_index_array_t;
+
+#define LNA_MODEL_OPTIMIZER_DEFAULT_CACHE_SIZE          32
+#define LNA_MODEL_OPTIMIZER_DEFAULT_OVERDRAW_THRESHOLD  1.05f
+
+typedef struct lna_model_optimizer_stats_s
+{
+    uint32_t    transformed_vertex_count;   //! vertex shader invocations with a fifo post transform cache
+    float       acmr;                       //! average cache miss ratio: transformed vertices per triangle, 0.5 at best, 3 at worst
+    float       atvr;                       //! average transformed vertex ratio: transformed vertices per vertex, 1 at best
+} lna_model_optimizer_stats_t;
+
+//! all the functions work on indexed triangle lists, with 32 or 16 bits
+//! indices, and use temp_lifetime_mem_pool for their working memory. The
+//! model must not have been loaded from a cache file (its arrays would be
+//! read only).
+
+//! reorder the triangles to maximize the post transform cache hits (Tom Forsyth linear speed vertex cache optimization).
+extern void                         lna_model_optimizer_vertex_cache    (lna_model_index_array_t* indices, uint32_t vertex_count, lna_memory_pool_t* temp_lifetime_mem_pool);
+//! reorder clusters of triangles, front facing outer clusters first, to reduce overdraw (Sander et al. 2007).
+//! must be called after lna_model_optimizer_vertex_cache, threshold is the acmr degradation allowed to split clusters (1.05 means 5%).
+extern void                         lna_model_optimizer_overdraw        (lna_model_index_array_t* indices, const lna_model_vertex_array_t* vertices, float threshold, lna_memory_pool_t* temp_lifetime_mem_pool);
+//! reorder the vertices in the order they are first used by the triangles and remove the unused ones.
+extern void                         lna_model_optimizer_vertex_fetch    (lna_model_vertex_array_t* vertices, lna_model_index_array_t* indices, lna_memory_pool_t* temp_lifetime_mem_pool);
+extern lna_model_optimizer_stats_t  lna_model_optimizer_compute_stats   (const lna_model_index_array_t* indices, uint32_t vertex_count, uint32_t cache_size);
+//! run the three optimizations and log the statistics before and after,
+//! the working memory of each one is popped before the next one starts.
+extern void                         lna_model_optimize                  (lna_model_t* model, lna_stack_allocator_t* temp_stack);
+
+#endif
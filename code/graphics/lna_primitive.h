@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "core/lna_object_pool.h"
 #include "maths/lna_vec2.h"
 #include "maths/lna_vec3.h"
 #include "maths/lna_vec4.h"
@@ -11,6 +12,7 @@ typedef struct lna_primitive_s              lna_primitive_t;
 typedef struct lna_primitive_system_s       lna_primitive_system_t;
 typedef struct lna_memory_pool_s            lna_memory_pool_t;
 typedef struct lna_renderer_s               lna_renderer_t;
+typedef struct lna_renderer_view_s          lna_renderer_view_t;
 typedef struct lna_mat4_s                   lna_mat4_t;
 
 typedef struct lna_primitive_system_config_s
@@ -34,8 +36,8 @@ typedef struct lna_primitive_raw_config_s
     uint32_t                                vertex_count;
     uint32_t                                index_count;
     const lna_mat4_t*                       model_matrix;
-    const lna_mat4_t*                       view_matrix;
-    const lna_mat4_t*                       projection_matrix;
+    const lna_vec4_t*                       tint;           //! multiplies the colors each frame, set to NULL to use white
+    const lna_renderer_view_t*              view;
 } lna_primitive_raw_config_t;
 
 typedef struct lna_primitive_line_config_s
@@ -45,8 +47,8 @@ typedef struct lna_primitive_line_config_s
     const lna_vec4_t*                       col_a;
     const lna_vec4_t*                       col_b;
     const lna_mat4_t*                       model_matrix;
-    const lna_mat4_t*                       view_matrix;
-    const lna_mat4_t*                       projection_matrix;
+    const lna_vec4_t*                       tint;           //! multiplies the colors each frame, set to NULL to use white
+    const lna_renderer_view_t*              view;
 } lna_primitive_line_config_t;
 
 typedef struct lna_primitive_rect_config_s
@@ -55,8 +57,8 @@ typedef struct lna_primitive_rect_config_s
     const lna_vec2_t*                       size;
     const lna_vec4_t*                       color;
     const lna_mat4_t*                       model_matrix;
-    const lna_mat4_t*                       view_matrix;
-    const lna_mat4_t*                       projection_matrix;
+    const lna_vec4_t*                       tint;           //! multiplies the colors each frame, set to NULL to use white
+    const lna_renderer_view_t*              view;
 } lna_primitive_rect_config_t;
 
 typedef struct lna_primitive_circle_config_s
@@ -65,8 +67,8 @@ typedef struct lna_primitive_circle_config_s
     float                                   radius;
     const lna_vec4_t*                       color;
     const lna_mat4_t*                       model_matrix;
-    const lna_mat4_t*                       view_matrix;
-    const lna_mat4_t*                       projection_matrix;
+    const lna_vec4_t*                       tint;           //! multiplies the colors each frame, set to NULL to use white
+    const lna_renderer_view_t*              view;
 } lna_primitive_circle_config_t;
 
 typedef struct lna_primitive_arrow_config_s
@@ -76,8 +78,8 @@ typedef struct lna_primitive_arrow_config_s
     float                                   head_size;
     const lna_vec4_t*                       color;
     const lna_mat4_t*                       model_matrix;
-    const lna_mat4_t*                       view_matrix;
-    const lna_mat4_t*                       projection_matrix;
+    const lna_vec4_t*                       tint;           //! multiplies the colors each frame, set to NULL to use white
+    const lna_renderer_view_t*              view;
 } lna_primitive_arrow_config_t;
 
 typedef struct lna_primitive_cross_config_s
@@ -86,18 +88,20 @@ typedef struct lna_primitive_cross_config_s
     const lna_vec2_t*                       size;
     const lna_vec4_t*                       color;
     const lna_mat4_t*                       model_matrix;
-    const lna_mat4_t*                       view_matrix;
-    const lna_mat4_t*                       projection_matrix;
+    const lna_vec4_t*                       tint;           //! multiplies the colors each frame, set to NULL to use white
+    const lna_renderer_view_t*              view;
 } lna_primitive_cross_config_t;
 
 extern void             lna_primitive_system_init           (lna_primitive_system_t* primitive_system, const lna_primitive_system_config_t* config);
 extern void             lna_primitive_system_draw           (lna_primitive_system_t* primitive_system);
 extern void             lna_primitive_system_release        (lna_primitive_system_t* primitive_system);
-extern lna_primitive_t* lna_primitive_system_new_raw        (lna_primitive_system_t* primitive_system, const lna_primitive_raw_config_t* config);
-extern lna_primitive_t* lna_primitive_system_new_line       (lna_primitive_system_t* primitive_system, const lna_primitive_line_config_t* config);
-extern lna_primitive_t* lna_primitive_system_new_rect_xy    (lna_primitive_system_t* primitive_system, const lna_primitive_rect_config_t* config);
-extern lna_primitive_t* lna_primitive_system_new_circle_xy  (lna_primitive_system_t* primitive_system, const lna_primitive_circle_config_t* config);
-extern lna_primitive_t* lna_primitive_system_new_arrow_xy   (lna_primitive_system_t* primitive_system, const lna_primitive_arrow_config_t* config);
-extern lna_primitive_t* lna_primitive_system_new_cross_xy   (lna_primitive_system_t* primitive_system, const lna_primitive_cross_config_t* config);
+extern lna_handle_t     lna_primitive_system_new_raw        (lna_primitive_system_t* primitive_system, const lna_primitive_raw_config_t* config);
+extern lna_handle_t     lna_primitive_system_new_line       (lna_primitive_system_t* primitive_system, const lna_primitive_line_config_t* config);
+extern lna_handle_t     lna_primitive_system_new_rect_xy    (lna_primitive_system_t* primitive_system, const lna_primitive_rect_config_t* config);
+extern lna_handle_t     lna_primitive_system_new_circle_xy  (lna_primitive_system_t* primitive_system, const lna_primitive_circle_config_t* config);
+extern lna_handle_t     lna_primitive_system_new_arrow_xy   (lna_primitive_system_t* primitive_system, const lna_primitive_arrow_config_t* config);
+extern lna_handle_t     lna_primitive_system_new_cross_xy   (lna_primitive_system_t* primitive_system, const lna_primitive_cross_config_t* config);
+//! the gpu resources of the primitive are destroyed once the frames in flight are done with them.
+extern void             lna_primitive_system_delete         (lna_primitive_system_t* primitive_system, lna_handle_t primitive);
 
 #endif
@@ -4,25 +4,75 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-typedef struct lna_renderer_s       lna_renderer_t;
-typedef struct lna_window_s         lna_window_t;
-typedef struct lna_heap_allocator_s lna_heap_allocator_t;
+typedef struct lna_renderer_s              lna_renderer_t;
+typedef struct lna_window_s                lna_window_t;
+typedef struct lna_heap_allocator_s        lna_heap_allocator_t;
+typedef struct lna_memory_pool_s           lna_memory_pool_t;
+typedef struct lna_atomic_memory_pool_s    lna_atomic_memory_pool_t;
+typedef struct lna_job_system_s            lna_job_system_t;
+typedef struct lna_renderer_view_s         lna_renderer_view_t;
+typedef struct lna_mat4_s                  lna_mat4_t;
+typedef union lna_vec3_u                   lna_vec3_t;
+
+typedef enum lna_renderer_present_mode_e
+{
+    LNA_RENDERER_PRESENT_MODE_DEFAULT,      //! mailbox if available, fifo otherwise
+    LNA_RENDERER_PRESENT_MODE_FIFO,         //! vsync, always available
+    LNA_RENDERER_PRESENT_MODE_FIFO_RELAXED, //! vsync, late frames are presented immediately and may tear
+    LNA_RENDERER_PRESENT_MODE_MAILBOX,      //! no tearing, the last rendered frame replaces the queued one
+    LNA_RENDERER_PRESENT_MODE_IMMEDIATE,    //! no vsync, lowest latency, tears
+} lna_renderer_present_mode_t;
 
 typedef struct lna_renderer_config_s
 {
     const lna_window_t*     window;
     bool                    enable_api_diagnostic;
     lna_heap_allocator_t*   allocator;
+    lna_job_system_t*       job_system;                         //! records the graphics systems in parallel, set to NULL to record on the thread drawing the frame
     uint32_t                max_listener_count;
-    size_t                  frame_mem_pool_size;        //! set to 0 to use default value
-    size_t                  swap_chain_mem_pool_size;   //! set to 0 to use default value
-    size_t                  persistent_mem_pool_size;   //! set to 0 to use default value
+    size_t                  frame_mem_pool_size;                //! set to 0 to use default value
+    size_t                  frame_arena_size;                   //! size of the cpu arena of each frame in flight, set to 0 to use default value
+    size_t                  shared_frame_arena_size;            //! size of the cpu arena of each frame in flight shared by the threads, set to 0 to use default value
+    size_t                  swap_chain_mem_pool_size;           //! set to 0 to use default value
+    size_t                  persistent_mem_pool_size;           //! set to 0 to use default value
+    size_t                  uniform_buffer_size;                //! size of the uniform buffer used by each frame in flight, set to 0 to use default value
+    size_t                  device_memory_block_size;           //! size of the device memory blocks buffers and images are sub-allocated from, set to 0 to use default value
+    uint32_t                max_device_memory_block_count;      //! set to 0 to use default value
+    uint32_t                max_device_memory_allocation_count; //! set to 0 to use default value
+    size_t                  upload_buffer_size;                 //! size of the staging buffer used to upload buffers and images, set to 0 to use default value
+    uint32_t                max_deferred_deletion_count;        //! max count of retired vulkan objects waiting for the frames in flight to complete, set to 0 to use default value (1024)
+    uint32_t                max_secondary_command_buffer_count; //! max count of secondary command buffers recorded in a frame, set to 0 to use default value
+    uint32_t                max_view_count;                     //! set to 0 to use default value
+    uint32_t                frame_in_flight_count;              //! count of frames the cpu can record while the gpu renders the previous ones, from 1 to 4, set to 0 to use default value (2)
+    uint32_t                swap_chain_image_count;             //! clamped to the surface limits, set to 0 to use default value (surface minimum + 1)
+    lna_renderer_present_mode_t present_mode;                   //! falls back to fifo, with a warning, if not supported by the surface
 } lna_renderer_config_t;
 
+//! camera shared by the objects drawn from it. The matrices and the position
+//! are read at the beginning of each frame and given to the shaders in a
+//! single uniform block, bound once per command buffer at descriptor set 0.
+typedef struct lna_renderer_view_config_s
+{
+    const lna_mat4_t*       view_matrix;
+    const lna_mat4_t*       projection_matrix;
+    const lna_vec3_t*       position;           //! camera position in world space
+} lna_renderer_view_config_t;
+
 extern bool     lna_renderer_init               (lna_renderer_t* renderer, const lna_renderer_config_t* config);
 extern void     lna_renderer_begin_draw_frame   (lna_renderer_t* renderer, uint32_t window_width, uint32_t window_height);
 extern void     lna_renderer_end_draw_frame     (lna_renderer_t* renderer, bool window_resized, uint32_t window_width, uint32_t window_height);
 extern void     lna_renderer_wait_idle          (lna_renderer_t* renderer);
 extern void     lna_renderer_release            (lna_renderer_t* renderer);
 
+//! cpu arena of the current frame. Unlike the renderer frame memory pool,
+//! emptied at the end of each frame, it is only emptied when the frame
+//! fence has been signaled, frame_in_flight_count frames later,
+//! so its content can be referenced until the gpu is done with the frame.
+extern lna_memory_pool_t*           lna_renderer_frame_arena        (lna_renderer_t* renderer);
+//! same lifetime as the frame arena but any thread can reserve in it during
+//! the frame, through a lna_atomic_memory_pool_cursor_t per thread.
+extern lna_atomic_memory_pool_t*    lna_renderer_shared_frame_arena (lna_renderer_t* renderer);
+//! called outside of a frame, the view lives as long as the renderer.
+extern lna_renderer_view_t*         lna_renderer_new_view           (lna_renderer_t* renderer, const lna_renderer_view_config_t* config);
+
 #endif
@@ -2,6 +2,7 @@
 #define LNA_GRAPHICS_LNA_TEXTURE_H
 
 #include <stdint.h>
+#include "core/lna_object_pool.h"
 
 typedef struct lna_renderer_s       lna_renderer_t;
 typedef struct lna_texture_s        lna_texture_t;
@@ -55,13 +56,20 @@ typedef struct lna_texture_config_s
     uint32_t                            atlas_row_count;    //! set to 0 if it is not an atlas texture
 } lna_texture_config_t;
 
-extern void             lna_texture_system_init         (lna_texture_system_t* texture_system, const lna_texture_system_config_t* config);
-extern lna_texture_t*   lna_texture_system_new_texture  (lna_texture_system_t* texture_system, const lna_texture_config_t* config);
-extern void             lna_texture_system_release      (lna_texture_system_t* texture_system);
+extern void             lna_texture_system_init           (lna_texture_system_t* texture_system, const lna_texture_system_config_t* config);
+extern lna_handle_t     lna_texture_system_new_texture    (lna_texture_system_t* texture_system, const lna_texture_config_t* config);
+//! return NULL if the texture has been deleted. The address of a texture
+//! does not change until it is deleted.
+extern lna_texture_t*   lna_texture_system_texture        (lna_texture_system_t* texture_system, lna_handle_t texture);
+//! the meshes and sprites using the texture must be deleted before. The gpu
+//! resources of the texture are destroyed once the frames in flight are done
+//! with them.
+extern void             lna_texture_system_delete_texture (lna_texture_system_t* texture_system, lna_handle_t texture);
+extern void             lna_texture_system_release        (lna_texture_system_t* texture_system);
 
-extern uint32_t         lna_texture_width               (lna_texture_t* texture);
-extern uint32_t         lna_texture_height              (lna_texture_t* texture);
-extern uint32_t         lna_texture_atlas_col_count     (lna_texture_t* texture);
-extern uint32_t         lna_texture_atlas_row_count     (lna_texture_t* texture);
+extern uint32_t         lna_texture_width                 (lna_texture_t* texture);
+extern uint32_t         lna_texture_height                (lna_texture_t* texture);
+extern uint32_t         lna_texture_atlas_col_count       (lna_texture_t* texture);
+extern uint32_t         lna_texture_atlas_row_count       (lna_texture_t* texture);
 
 #endif
@@ -5,6 +5,7 @@
 #include "system/lna_input.h"
 #include "system/lna_timer.h"
 #include "system/lna_gamepad.h"
+#include "system/lna_thread.h"
 #include "graphics/lna_renderer.h"
 #include "graphics/lna_ui.h"
 #include "graphics/lna_texture.h"
@@ -14,10 +15,15 @@
 #include "graphics/lna_material.h"
 #include "graphics/lna_model.h"
 #include "core/lna_assert.h"
+#include "core/lna_atomic_memory_pool.h"
 #include "core/lna_heap_allocator.h"
+#include "core/lna_job_system.h"
 #include "core/lna_log.h"
 #include "core/lna_memory_pool.h"
+#include "core/lna_memory_tracking.h"
 #include "core/lna_memory.h"
+#include "core/lna_object_pool.h"
+#include "core/lna_stack_allocator.h"
 #include "tools/lna_tweak_menu.h"
 #include "tools/lna_free_camera.h"
 #include "maths/lna_mat4.h"
@@ -155,3 +155,95 @@ void lna_mat4_mult(const lna_mat4_t* a, const lna_mat4_t* b, lna_mat4_t* result)
         }
     }
 }
+
+void lna_mat4_transpose(const lna_mat4_t* m, lna_mat4_t* result)
+{
+    lna_assert(m)
+    lna_assert(result)
+    lna_assert(m != result)
+
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            result->values[i][j] = m->values[j][i];
+        }
+    }
+}
+
+bool lna_mat4_inverse(const lna_mat4_t* m, lna_mat4_t* result)
+{
+    lna_assert(m)
+    lna_assert(result)
+
+    //! cofactor expansion sharing the 2x2 determinants of the first two and
+    //! of the last two rows
+    const float (*a)[4] = m->values;
+    const float s0 = a[0][0] * a[1][1] - a[1][0] * a[0][1];
+    const float s1 = a[0][0] * a[1][2] - a[1][0] * a[0][2];
+    const float s2 = a[0][0] * a[1][3] - a[1][0] * a[0][3];
+    const float s3 = a[0][1] * a[1][2] - a[1][1] * a[0][2];
+    const float s4 = a[0][1] * a[1][3] - a[1][1] * a[0][3];
+    const float s5 = a[0][2] * a[1][3] - a[1][2] * a[0][3];
+    const float c5 = a[2][2] * a[3][3] - a[3][2] * a[2][3];
+    const float c4 = a[2][1] * a[3][3] - a[3][1] * a[2][3];
+    const float c3 = a[2][1] * a[3][2] - a[3][1] * a[2][2];
+    const float c2 = a[2][0] * a[3][3] - a[3][0] * a[2][3];
+    const float c1 = a[2][0] * a[3][2] - a[3][0] * a[2][2];
+    const float c0 = a[2][0] * a[3][1] - a[3][0] * a[2][1];
+
+    const float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+    if (det == 0.0f)
+    {
+        return false;
+    }
+    const float inv_det = 1.0f / det;
+
+    lna_mat4_t inv;
+    inv.values[0][0] = ( a[1][1] * c5 - a[1][2] * c4 + a[1][3] * c3) * inv_det;
+    inv.values[0][1] = (-a[0][1] * c5 + a[0][2] * c4 - a[0][3] * c3) * inv_det;
+    inv.values[0][2] = ( a[3][1] * s5 - a[3][2] * s4 + a[3][3] * s3) * inv_det;
+    inv.values[0][3] = (-a[2][1] * s5 + a[2][2] * s4 - a[2][3] * s3) * inv_det;
+    inv.values[1][0] = (-a[1][0] * c5 + a[1][2] * c2 - a[1][3] * c1) * inv_det;
+    inv.values[1][1] = ( a[0][0] * c5 - a[0][2] * c2 + a[0][3] * c1) * inv_det;
+    inv.values[1][2] = (-a[3][0] * s5 + a[3][2] * s2 - a[3][3] * s1) * inv_det;
+    inv.values[1][3] = ( a[2][0] * s5 - a[2][2] * s2 + a[2][3] * s1) * inv_det;
+    inv.values[2][0] = ( a[1][0] * c4 - a[1][1] * c2 + a[1][3] * c0) * inv_det;
+    inv.values[2][1] = (-a[0][0] * c4 + a[0][1] * c2 - a[0][3] * c0) * inv_det;
+    inv.values[2][2] = ( a[3][0] * s4 - a[3][1] * s2 + a[3][3] * s0) * inv_det;
+    inv.values[2][3] = (-a[2][0] * s4 + a[2][1] * s2 - a[2][3] * s0) * inv_det;
+    inv.values[3][0] = (-a[1][0] * c3 + a[1][1] * c1 - a[1][2] * c0) * inv_det;
+    inv.values[3][1] = ( a[0][0] * c3 - a[0][1] * c1 + a[0][2] * c0) * inv_det;
+    inv.values[3][2] = (-a[3][0] * s3 + a[3][1] * s1 - a[3][2] * s0) * inv_det;
+    inv.values[3][3] = ( a[2][0] * s3 - a[2][1] * s1 + a[2][2] * s0) * inv_det;
+    *result = inv;
+    return true;
+}
+
+void lna_mat4_normal_matrix(const lna_mat4_t* m, lna_normal_matrix_t* result)
+{
+    lna_assert(m)
+    lna_assert(result)
+
+    //! the columns of the inverse transpose of a 3x3 matrix are the cross
+    //! products of its columns divided by its determinant
+    const lna_vec3_t x = { m->values[0][0], m->values[0][1], m->values[0][2] };
+    const lna_vec3_t y = { m->values[1][0], m->values[1][1], m->values[1][2] };
+    const lna_vec3_t z = { m->values[2][0], m->values[2][1], m->values[2][2] };
+    const lna_vec3_t columns[3] =
+    {
+        lna_vec3_cross_product(y, z),
+        lna_vec3_cross_product(z, x),
+        lna_vec3_cross_product(x, y),
+    };
+    const float det     = lna_vec3_dot_product(x, columns[0]);
+    const float inv_det = det != 0.0f ? 1.0f / det : 1.0f;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        result->values[i][0] = columns[i].x * inv_det;
+        result->values[i][1] = columns[i].y * inv_det;
+        result->values[i][2] = columns[i].z * inv_det;
+        result->values[i][3] = 0.0f;
+    }
+}
@@ -1,6 +1,7 @@
 #ifndef LNA_MATHS_LNA_MAT4_H
 #define LNA_MATHS_LNA_MAT4_H
 
+#include <stdbool.h>
 #include "maths/lna_maths.h"
 
 typedef struct lna_mat4_s
@@ -8,6 +9,13 @@ typedef struct lna_mat4_s
     float values[4][4];
 } lna_mat4_t;
 
+//! upper left 3x3 part of a matrix, each column is padded to 4 floats like a
+//! glsl mat3 in a push constant block or read as 3 vertex attributes.
+typedef struct lna_normal_matrix_s
+{
+    float values[3][4];
+} lna_normal_matrix_t;
+
 extern lna_mat4_t   lna_mat4_identity       (void);
 extern lna_mat4_t   lna_mat4_scale          (float x, float y, float z);
 extern lna_mat4_t   lna_mat4_translation    (float x, float y, float z);
@@ -18,5 +26,12 @@ extern lna_mat4_t   lna_mat4_look_at        (float eye_x, float eye_y, float eye
 extern lna_mat4_t   lna_mat4_perspective    (lna_degree_t fov, float aspect_ratio, float near_z, float far_z);
 extern lna_mat4_t   lna_mat4_ortho          (float right, float left, float top, float bottom, float near, float far);
 extern void         lna_mat4_mult           (const lna_mat4_t* a, const lna_mat4_t* b, lna_mat4_t* result);
+extern void         lna_mat4_transpose      (const lna_mat4_t* m, lna_mat4_t* result);
+//! returns false and leaves result unchanged when m is not invertible.
+extern bool         lna_mat4_inverse        (const lna_mat4_t* m, lna_mat4_t* result);
+//! transpose of the inverse of the upper left 3x3 part of m, which transforms
+//! the normals when m scales them non uniformly. When that part is not
+//! invertible, its cofactor matrix is used, the normals only keep their direction.
+extern void         lna_mat4_normal_matrix  (const lna_mat4_t* m, lna_normal_matrix_t* result);
 
 #endif
@@ -1,12 +1,19 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(binding = 0) uniform uniform_buffer_object
+layout(set = 0, binding = 0) uniform view_uniform
 {
-    mat4 model;
     mat4 view;
     mat4 projection;
-} ubo;
+    mat4 view_projection;
+    vec4 position;
+} camera;
+
+layout(push_constant) uniform object_push_constants
+{
+    mat4 model;
+    vec4 tint;
+} object;
 
 layout(location = 0) in vec3 in_position;
 layout(location = 1) in vec4 in_color;
@@ -14,6 +21,6 @@ layout(location = 0) out vec4 frag_color;
 
 void main()
 {
-    gl_Position = ubo.projection * ubo.view * ubo.model * vec4(in_position, 1.0);
-    frag_color  = in_color;
+    gl_Position = camera.view_projection * object.model * vec4(in_position, 1.0);
+    frag_color  = in_color * object.tint;
 }
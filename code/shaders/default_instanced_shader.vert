@@ -0,0 +1,39 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(set = 0, binding = 0) uniform view_uniform
+{
+    mat4 view;
+    mat4 projection;
+    mat4 view_projection;
+    vec4 position;
+} camera;
+
+layout(push_constant) uniform object_push_constants
+{
+    mat4 model;
+    vec4 tint;
+    mat3 normal_matrix;
+} object;
+
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec4 in_color;
+layout(location = 2) in vec2 in_uv;
+layout(location = 3) in vec3 in_normal;
+layout(location = 4) in mat4 in_instance_model;
+layout(location = 8) in mat3 in_instance_normal_matrix;
+
+layout(location = 0) out vec4 frag_color;
+layout(location = 1) out vec2 frag_uv;
+layout(location = 2) out vec3 frag_normal;
+layout(location = 3) out vec3 frag_position;
+
+void main()
+{
+    frag_normal     = in_instance_normal_matrix * in_normal;
+    frag_position   = vec3(in_instance_model * vec4(in_position, 1.0));
+    frag_color      = in_color * object.tint;
+    frag_uv         = in_uv;
+
+    gl_Position     = camera.view_projection * vec4(frag_position, 1.0);
+}
@@ -8,12 +8,19 @@ layout(location = 3) in vec3 frag_position;
 
 layout(location = 0) out vec4 out_color;
 
-layout(binding = 1) uniform sampler2D texture_sampler;
+layout(set = 0, binding = 0) uniform view_uniform
+{
+    mat4 view;
+    mat4 projection;
+    mat4 view_projection;
+    vec4 position;
+} camera;
+
+layout(set = 1, binding = 1) uniform sampler2D texture_sampler;
 
-layout(binding = 2) uniform light_info_uniform
+layout(set = 1, binding = 2) uniform light_info_uniform
 {
     vec4 light_position;
-    vec4 view_position;
     vec4 light_color;
 } light_info;
 
@@ -21,7 +28,7 @@ void main()
 {
     vec3 norm               = normalize(frag_normal);
     vec3 light_direction    = normalize(light_info.light_position.xyz - frag_position);
-    vec3 view_direction     = normalize(light_info.view_position.xyz - frag_position);
+    vec3 view_direction     = normalize(camera.position.xyz - frag_position);
     vec3 reflect_direction  = reflect(-light_direction, norm);
 
     float ambient_strength  = 0.1;
@@ -1,12 +1,20 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(binding = 0) uniform uniform_buffer_object
+layout(set = 0, binding = 0) uniform view_uniform
 {
-    mat4 model;
     mat4 view;
     mat4 projection;
-} ubo;
+    mat4 view_projection;
+    vec4 position;
+} camera;
+
+layout(push_constant) uniform object_push_constants
+{
+    mat4 model;
+    vec4 tint;
+    mat3 normal_matrix;
+} object;
 
 layout(location = 0) in vec3 in_position;
 layout(location = 1) in vec4 in_color;
@@ -20,10 +28,10 @@ layout(location = 3) out vec3 frag_position;
 
 void main()
 {
-    frag_normal     = mat3(transpose(inverse(ubo.model))) * in_normal;
-    frag_position   = vec3(ubo.model * vec4(in_position, 1.0));
-    frag_color      = in_color;
+    frag_normal     = object.normal_matrix * in_normal;
+    frag_position   = vec3(object.model * vec4(in_position, 1.0));
+    frag_color      = in_color * object.tint;
     frag_uv         = in_uv;
 
-    gl_Position     = ubo.projection * ubo.view * vec4(frag_position, 1.0);
+    gl_Position     = camera.view_projection * vec4(frag_position, 1.0);
 }
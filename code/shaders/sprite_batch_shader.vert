@@ -0,0 +1,24 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+
+layout(set = 0, binding = 0) uniform view_uniform
+{
+    mat4 view;
+    mat4 projection;
+    mat4 view_projection;
+    vec4 position;
+} camera;
+
+layout(location = 0) in vec3 in_position;
+layout(location = 1) in vec2 in_uv;
+layout(location = 2) in vec4 in_color;
+
+layout(location = 0) out vec4 frag_color;
+layout(location = 1) out vec2 frag_uv;
+
+void main()
+{
+    gl_Position = camera.view_projection * vec4(in_position, 1.0);
+    frag_color      = in_color;
+    frag_uv         = in_uv;
+}
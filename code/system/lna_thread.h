@@ -0,0 +1,28 @@
+#ifndef LNA_SYSTEM_LNA_THREAD_H
+#define LNA_SYSTEM_LNA_THREAD_H
+
+#include <stdint.h>
+
+typedef struct lna_thread_s     lna_thread_t;
+typedef struct lna_semaphore_s  lna_semaphore_t;
+
+//! the value returned by the function is returned by lna_thread_wait.
+typedef int (*lna_thread_function_t)(void* data);
+
+//! logical cpu cores available, 1 at least.
+extern uint32_t         lna_thread_cpu_count    (void);
+//! the thread is owned by the backend until it is given to lna_thread_wait.
+extern lna_thread_t*    lna_thread_start        (lna_thread_function_t function, void* data, const char* name);
+//! block until the thread function returns, the thread must not be used anymore after that.
+extern int              lna_thread_wait         (lna_thread_t* thread);
+//! give the rest of the time slice of the calling thread to the other threads.
+extern void             lna_thread_yield        (void);
+
+//! the semaphore is owned by the backend until it is given to lna_semaphore_delete.
+extern lna_semaphore_t* lna_semaphore_new       (uint32_t initial_value);
+extern void             lna_semaphore_post      (lna_semaphore_t* semaphore);
+//! block until the value is greater than 0, then decrement it.
+extern void             lna_semaphore_wait      (lna_semaphore_t* semaphore);
+extern void             lna_semaphore_delete    (lna_semaphore_t* semaphore);
+
+#endif
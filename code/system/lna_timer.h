@@ -13,4 +13,9 @@ extern lna_millisecond_t    lna_timer_elasped_time_in_ms(lna_timer_t* timer);
 extern lna_second_t         lna_timer_delta_time_in_s   (lna_timer_t* timer);
 extern lna_millisecond_t    lna_timer_delta_time_in_ms  (lna_timer_t* timer);
 
+//! cpu side frame limiter: sleeps until target_frame_time has elapsed since
+//! the previous call. Call it just before sampling the inputs, so the frame
+//! starts with the freshest inputs instead of waiting in the present queue.
+extern void                 lna_timer_limit_frame_time  (lna_timer_t* timer, lna_millisecond_t target_frame_time);
+
 #endif
@@ -0,0 +1,222 @@
+//! contention of the reservations made by several threads at the same time:
+//! a memory pool behind a lock, the atomic memory pool with one atomic add per
+//! reservation and the atomic memory pool through a cursor per thread. Each
+//! thread fills its reservations, they are checked once all the threads are
+//! done so an overlap is seen. The thread count can be given as first
+//! argument, it is the cpu count by default.
+//! build (linux, from the code directory):
+//!     gcc -std=c11 -O2 -I . tests/lna_atomic_memory_pool_benchmark.c core/lna_atomic_memory_pool.c core/lna_memory_pool.c core/lna_memory_tracking.c core/lna_heap_allocator.c core/lna_log.c backends/linux/lna_heap_allocator_linux.c backends/sdl/lna_thread_sdl.c $(sdl2-config --cflags --libs) -o lna_atomic_memory_pool_benchmark
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "tests/lna_test.h"
+#include "core/lna_atomic_memory_pool.h"
+#include "core/lna_heap_allocator.h"
+#include "core/lna_memory_pool.h"
+#include "core/lna_log.h"
+#include "system/lna_thread.h"
+
+#define LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MAX_THREAD_COUNT       32
+#define LNA_ATOMIC_MEMORY_POOL_BENCHMARK_RESERVATION_COUNT      (1u << 16)
+#define LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MAX_RESERVATION_SIZE   64
+#define LNA_ATOMIC_MEMORY_POOL_BENCHMARK_REPEAT_COUNT           5
+
+typedef enum lna_atomic_memory_pool_benchmark_mode_e
+{
+    LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MODE_LOCKED_POOL,
+    LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MODE_ATOMIC_RESERVE,
+    LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MODE_CURSOR,
+    LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MODE_COUNT,
+} lna_atomic_memory_pool_benchmark_mode_t;
+
+static const char* LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MODE_NAMES[LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MODE_COUNT] =
+{
+    "locked memory pool",
+    "atomic reserve",
+    "cursor per thread",
+};
+
+typedef struct lna_atomic_memory_pool_benchmark_s
+{
+    lna_atomic_memory_pool_benchmark_mode_t mode;
+    lna_memory_pool_t                       memory_pool;
+    lna_semaphore_t*                        memory_pool_lock;
+    lna_atomic_memory_pool_t                atomic_pool;
+    atomic_bool                             started;
+} lna_atomic_memory_pool_benchmark_t;
+
+typedef struct lna_atomic_memory_pool_benchmark_thread_s
+{
+    lna_atomic_memory_pool_benchmark_t* benchmark;
+    uint32_t                            index;
+    char**                              reservations;
+} lna_atomic_memory_pool_benchmark_thread_t;
+
+static size_t lna_atomic_memory_pool_benchmark_reservation_size(uint32_t reservation_index)
+{
+    return 1 + (reservation_index * 2654435761u >> 16) % LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MAX_RESERVATION_SIZE;
+}
+
+static int lna_atomic_memory_pool_benchmark_thread_main(void* data)
+{
+    lna_atomic_memory_pool_benchmark_thread_t*  thread      = data;
+    lna_atomic_memory_pool_benchmark_t*         benchmark   = thread->benchmark;
+
+    lna_atomic_memory_pool_cursor_t cursor;
+    lna_atomic_memory_pool_cursor_init(
+        &cursor,
+        &benchmark->atomic_pool
+        );
+
+    while (!atomic_load(&benchmark->started))
+    {
+        lna_thread_yield();
+    }
+
+    for (uint32_t i = 0; i < LNA_ATOMIC_MEMORY_POOL_BENCHMARK_RESERVATION_COUNT; ++i)
+    {
+        const size_t    size        = lna_atomic_memory_pool_benchmark_reservation_size(i);
+        char*           reservation = NULL;
+        switch (benchmark->mode)
+        {
+            case LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MODE_LOCKED_POOL:
+                lna_semaphore_wait(benchmark->memory_pool_lock);
+                reservation = lna_memory_pool_reserve(
+                    &benchmark->memory_pool,
+                    size
+                    );
+                lna_semaphore_post(benchmark->memory_pool_lock);
+                break;
+            case LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MODE_ATOMIC_RESERVE:
+                reservation = lna_atomic_memory_pool_reserve(
+                    &benchmark->atomic_pool,
+                    size
+                    );
+                break;
+            default:
+                reservation = lna_atomic_memory_pool_cursor_reserve(
+                    &cursor,
+                    size,
+                    1
+                    );
+                break;
+        }
+        memset(reservation, (int)thread->index + 1, size);
+        thread->reservations[i] = reservation;
+    }
+    return 0;
+}
+
+static double lna_atomic_memory_pool_benchmark_run(lna_atomic_memory_pool_benchmark_t* benchmark, lna_atomic_memory_pool_benchmark_thread_t* threads, uint32_t thread_count)
+{
+    lna_thread_t* thread_handles[LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MAX_THREAD_COUNT];
+
+    lna_memory_pool_empty(&benchmark->memory_pool);
+    lna_atomic_memory_pool_empty(&benchmark->atomic_pool);
+    atomic_store(&benchmark->started, false);
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        thread_handles[i] = lna_thread_start(
+            lna_atomic_memory_pool_benchmark_thread_main,
+            &threads[i],
+            "lna_atomic_memory_pool_benchmark"
+            );
+    }
+
+    const double start_time = lna_test_time_in_ms();
+    atomic_store(&benchmark->started, true);
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        lna_thread_wait(thread_handles[i]);
+    }
+    const double time = lna_test_time_in_ms() - start_time;
+
+    uint32_t overwritten_count = 0;
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        for (uint32_t j = 0; j < LNA_ATOMIC_MEMORY_POOL_BENCHMARK_RESERVATION_COUNT; ++j)
+        {
+            const size_t size = lna_atomic_memory_pool_benchmark_reservation_size(j);
+            for (size_t k = 0; k < size; ++k)
+            {
+                overwritten_count += threads[i].reservations[j][k] != (char)(i + 1) ? 1 : 0;
+            }
+        }
+    }
+    lna_test_check(overwritten_count == 0)
+    return time;
+}
+
+int main(int argc, char** argv)
+{
+    lna_log_set_level(LNA_LOG_LEVEL_ERROR);
+
+    uint32_t thread_count = argc > 1 ? (uint32_t)atoi(argv[1]) : lna_thread_cpu_count();
+    thread_count = thread_count > 0 ? thread_count : 1;
+    thread_count = thread_count < LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MAX_THREAD_COUNT ? thread_count : LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MAX_THREAD_COUNT;
+
+    //! the atomic reservations are rounded up to a cache line, the cursors lose the end of their blocks
+    const size_t pool_size = (size_t)thread_count * (LNA_ATOMIC_MEMORY_POOL_BENCHMARK_RESERVATION_COUNT * LNA_ATOMIC_MEMORY_POOL_CACHE_LINE_SIZE + 2 * 64 * 1024);
+
+    lna_heap_allocator_t allocator = { 0 };
+    lna_heap_allocator_init(
+        &allocator,
+        2 * pool_size + 2 * LNA_ATOMIC_MEMORY_POOL_CACHE_LINE_SIZE
+        );
+
+    static lna_atomic_memory_pool_benchmark_t           benchmark;
+    static lna_atomic_memory_pool_benchmark_thread_t    threads[LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MAX_THREAD_COUNT];
+    lna_memory_pool_init_with_heap(
+        &benchmark.memory_pool,
+        &allocator,
+        pool_size
+        );
+    lna_atomic_memory_pool_init_with_heap(
+        &benchmark.atomic_pool,
+        &allocator,
+        pool_size,
+        0
+        );
+    benchmark.memory_pool_lock = lna_semaphore_new(1);
+    atomic_init(&benchmark.started, false);
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        threads[i].benchmark    = &benchmark;
+        threads[i].index        = i;
+        threads[i].reservations = malloc(sizeof(char*) * LNA_ATOMIC_MEMORY_POOL_BENCHMARK_RESERVATION_COUNT);
+    }
+
+    printf("%u threads, %u reservations of 1 to %u bytes per thread\n", thread_count, LNA_ATOMIC_MEMORY_POOL_BENCHMARK_RESERVATION_COUNT, LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MAX_RESERVATION_SIZE);
+    for (uint32_t mode = 0; mode < LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MODE_COUNT; ++mode)
+    {
+        benchmark.mode = (lna_atomic_memory_pool_benchmark_mode_t)mode;
+        double time = 0.0;
+        for (uint32_t repeat = 0; repeat < LNA_ATOMIC_MEMORY_POOL_BENCHMARK_REPEAT_COUNT; ++repeat)
+        {
+            time += lna_atomic_memory_pool_benchmark_run(
+                &benchmark,
+                threads,
+                thread_count
+                );
+        }
+        time /= LNA_ATOMIC_MEMORY_POOL_BENCHMARK_REPEAT_COUNT;
+        printf(
+            "%-20s: %8.3f ms (%.1f ns per reservation)\n",
+            LNA_ATOMIC_MEMORY_POOL_BENCHMARK_MODE_NAMES[mode],
+            time,
+            time * 1000000.0 / ((double)thread_count * LNA_ATOMIC_MEMORY_POOL_BENCHMARK_RESERVATION_COUNT)
+            );
+    }
+
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        free(threads[i].reservations);
+    }
+    lna_semaphore_delete(benchmark.memory_pool_lock);
+    lna_memory_pool_release(&benchmark.memory_pool);
+    lna_heap_allocator_release(&allocator);
+    return lna_test_result();
+}
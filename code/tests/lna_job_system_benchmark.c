@@ -0,0 +1,185 @@
+//! worker scaling of the job system: the same work is run with 1 worker, then
+//! with twice as many up to the cpu count, the results are checked against a
+//! run without the job system. The highest worker count can be given as
+//! first argument, it is the cpu count by default.
+//! build (linux, from the code directory):
+//!     gcc -std=c11 -O2 -I . tests/lna_job_system_benchmark.c core/lna_job_system.c core/lna_memory_pool.c core/lna_memory_tracking.c core/lna_heap_allocator.c core/lna_log.c backends/linux/lna_heap_allocator_linux.c backends/sdl/lna_thread_sdl.c $(sdl2-config --cflags --libs) -o lna_job_system_benchmark
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "tests/lna_test.h"
+#include "core/lna_job_system.h"
+#include "core/lna_heap_allocator.h"
+#include "core/lna_memory_pool.h"
+#include "core/lna_log.h"
+#include "system/lna_thread.h"
+
+#define LNA_JOB_SYSTEM_BENCHMARK_ELEMENT_COUNT      (1u << 20)
+#define LNA_JOB_SYSTEM_BENCHMARK_ELEMENT_WORK       64
+#define LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_COUNT    (1u << 16)
+#define LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_BATCH    1024
+#define LNA_JOB_SYSTEM_BENCHMARK_REPEAT_COUNT       5
+
+typedef struct lna_job_system_benchmark_small_job_s
+{
+    atomic_uint*    run_count;
+    uint32_t        value;
+} lna_job_system_benchmark_small_job_t;
+
+static uint32_t g_values[LNA_JOB_SYSTEM_BENCHMARK_ELEMENT_COUNT];
+static uint32_t g_expected_values[LNA_JOB_SYSTEM_BENCHMARK_ELEMENT_COUNT];
+
+static uint32_t lna_job_system_benchmark_work(uint32_t value)
+{
+    for (uint32_t i = 0; i < LNA_JOB_SYSTEM_BENCHMARK_ELEMENT_WORK; ++i)
+    {
+        value ^= value << 13;
+        value ^= value >> 17;
+        value ^= value << 5;
+    }
+    return value;
+}
+
+static void lna_job_system_benchmark_parallel_for_function(void* data, uint32_t begin, uint32_t end)
+{
+    uint32_t* values = data;
+    for (uint32_t i = begin; i < end; ++i)
+    {
+        values[i] = lna_job_system_benchmark_work(i + 1);
+    }
+}
+
+static void lna_job_system_benchmark_small_job_function(void* data)
+{
+    lna_job_system_benchmark_small_job_t* small_job = data;
+    small_job->value = lna_job_system_benchmark_work(small_job->value);
+    atomic_fetch_add_explicit(small_job->run_count, 1, memory_order_relaxed);
+}
+
+static void lna_job_system_benchmark_run(lna_heap_allocator_t* allocator, uint32_t worker_count)
+{
+    static lna_job_system_benchmark_small_job_t small_jobs[LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_BATCH];
+    static lna_job_t                            jobs[LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_BATCH];
+
+    lna_memory_pool_t memory_pool = { 0 };
+    lna_memory_pool_init_with_heap(
+        &memory_pool,
+        allocator,
+        1024 * 1024
+        );
+
+    lna_job_system_t job_system = { 0 };
+    const lna_job_system_config_t job_system_config =
+    {
+        .memory_pool            = &memory_pool,
+        .worker_count           = worker_count,
+        .max_queued_job_count   = LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_BATCH,
+    };
+    lna_job_system_init(
+        &job_system,
+        &job_system_config
+        );
+
+    //! large ranges: the time is spent in the work, it shows the scaling
+    double parallel_for_time = 0.0;
+    for (uint32_t repeat = 0; repeat < LNA_JOB_SYSTEM_BENCHMARK_REPEAT_COUNT; ++repeat)
+    {
+        const double start_time = lna_test_time_in_ms();
+        lna_job_system_parallel_for(
+            &job_system,
+            LNA_JOB_SYSTEM_BENCHMARK_ELEMENT_COUNT,
+            1024,
+            lna_job_system_benchmark_parallel_for_function,
+            g_values
+            );
+        parallel_for_time += lna_test_time_in_ms() - start_time;
+    }
+    uint32_t mismatch_count = 0;
+    for (uint32_t i = 0; i < LNA_JOB_SYSTEM_BENCHMARK_ELEMENT_COUNT; ++i)
+    {
+        mismatch_count += g_values[i] != g_expected_values[i] ? 1 : 0;
+    }
+    lna_test_check(mismatch_count == 0)
+
+    //! small jobs: the time is spent in the queues and the steals
+    atomic_uint run_count;
+    atomic_init(&run_count, 0);
+    const double small_job_start_time = lna_test_time_in_ms();
+    for (uint32_t batch = 0; batch < LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_COUNT / LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_BATCH; ++batch)
+    {
+        for (uint32_t i = 0; i < LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_BATCH; ++i)
+        {
+            small_jobs[i].run_count = &run_count;
+            small_jobs[i].value     = batch * LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_BATCH + i + 1;
+            jobs[i].function        = lna_job_system_benchmark_small_job_function;
+            jobs[i].data            = &small_jobs[i];
+        }
+        lna_job_counter_t counter;
+        atomic_init(&counter.count, 0);
+        lna_job_system_run(
+            &job_system,
+            jobs,
+            LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_BATCH,
+            &counter
+            );
+        lna_job_system_wait(
+            &job_system,
+            &counter
+            );
+        for (uint32_t i = 0; i < LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_BATCH; ++i)
+        {
+            lna_test_check(small_jobs[i].value == g_expected_values[batch * LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_BATCH + i])
+        }
+    }
+    const double small_job_time = lna_test_time_in_ms() - small_job_start_time;
+    lna_test_check(atomic_load(&run_count) == LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_COUNT)
+
+    lna_job_system_release(&job_system);
+    lna_memory_pool_release(&memory_pool);
+
+    printf(
+        "%2u workers: parallel for %8.3f ms, %u small jobs %8.3f ms (%.3f us per job)\n",
+        worker_count,
+        parallel_for_time / LNA_JOB_SYSTEM_BENCHMARK_REPEAT_COUNT,
+        LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_COUNT,
+        small_job_time,
+        small_job_time * 1000.0 / LNA_JOB_SYSTEM_BENCHMARK_SMALL_JOB_COUNT
+        );
+}
+
+int main(int argc, char** argv)
+{
+    lna_log_set_level(LNA_LOG_LEVEL_ERROR);
+
+    const double start_time = lna_test_time_in_ms();
+    lna_job_system_benchmark_parallel_for_function(
+        g_expected_values,
+        0,
+        LNA_JOB_SYSTEM_BENCHMARK_ELEMENT_COUNT
+        );
+    printf("no job system: %8.3f ms\n", lna_test_time_in_ms() - start_time);
+
+    lna_heap_allocator_t allocator = { 0 };
+    lna_heap_allocator_init(
+        &allocator,
+        64 * 1024 * 1024
+        );
+
+    const uint32_t max_worker_count = argc > 1 ? (uint32_t)atoi(argv[1]) : lna_thread_cpu_count();
+    for (uint32_t worker_count = 1; ; worker_count *= 2)
+    {
+        worker_count = worker_count < max_worker_count ? worker_count : max_worker_count;
+        lna_job_system_benchmark_run(
+            &allocator,
+            worker_count
+            );
+        if (worker_count >= max_worker_count || worker_count == LNA_JOB_SYSTEM_MAX_WORKER_COUNT)
+        {
+            break;
+        }
+    }
+
+    lna_heap_allocator_release(&allocator);
+    return lna_test_result();
+}
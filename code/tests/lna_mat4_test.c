@@ -0,0 +1,183 @@
+//! the model matrices are pushed as they are in memory to glsl mat4 push
+//! constants: the checks transform the points like the shaders do, with the
+//! matrix columns in values[0] to values[3]. The inverse and the normal
+//! matrix are checked against their definitions on random model matrices.
+//! build (from the code directory):
+//!     gcc -std=c11 -O2 -I . tests/lna_mat4_test.c maths/lna_mat4.c maths/lna_vec3.c maths/lna_maths.c core/lna_log.c -lm -o lna_mat4_test
+
+#include <math.h>
+#include <string.h>
+#include "tests/lna_test.h"
+#include "maths/lna_mat4.h"
+#include "maths/lna_vec4.h"
+
+static const float LNA_MAT4_TEST_EPSILON = 1e-4f;
+
+static uint32_t g_random_state = 2463534242u;
+
+static float lna_mat4_test_random(float min, float max)
+{
+    g_random_state ^= g_random_state << 13;
+    g_random_state ^= g_random_state >> 17;
+    g_random_state ^= g_random_state << 5;
+    return min + (max - min) * (float)(g_random_state >> 8) / (float)(1u << 24);
+}
+
+static bool lna_mat4_test_near(float a, float b)
+{
+    return fabsf(a - b) <= LNA_MAT4_TEST_EPSILON * (1.0f + fabsf(a) + fabsf(b));
+}
+
+//! gl_Position = matrix * vec4(point, w)
+static lna_vec4_t lna_mat4_test_transform(const lna_mat4_t* m, lna_vec4_t point)
+{
+    const float p[4] = { point.x, point.y, point.z, point.w };
+    float       r[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i < 4; ++i)
+    {
+        for (int j = 0; j < 4; ++j)
+        {
+            r[j] += m->values[i][j] * p[i];
+        }
+    }
+    return (lna_vec4_t){ r[0], r[1], r[2], r[3] };
+}
+
+static bool lna_mat4_test_vec4_near(lna_vec4_t a, lna_vec4_t b)
+{
+    return lna_mat4_test_near(a.x, b.x) && lna_mat4_test_near(a.y, b.y) && lna_mat4_test_near(a.z, b.z) && lna_mat4_test_near(a.w, b.w);
+}
+
+//! scale, then rotate on the 3 axes, then translate, with random values
+static lna_mat4_t lna_mat4_test_random_model(void)
+{
+    const lna_mat4_t scale          = lna_mat4_scale(lna_mat4_test_random(0.1f, 4.0f), lna_mat4_test_random(0.1f, 4.0f), lna_mat4_test_random(0.1f, 4.0f));
+    const lna_mat4_t rotation_x     = lna_mat4_rotation_x((lna_degree_t){ lna_mat4_test_random(-180.0f, 180.0f) });
+    const lna_mat4_t rotation_y     = lna_mat4_rotation_y((lna_degree_t){ lna_mat4_test_random(-180.0f, 180.0f) });
+    const lna_mat4_t rotation_z     = lna_mat4_rotation_z((lna_degree_t){ lna_mat4_test_random(-180.0f, 180.0f) });
+    const lna_mat4_t translation    = lna_mat4_translation(lna_mat4_test_random(-100.0f, 100.0f), lna_mat4_test_random(-100.0f, 100.0f), lna_mat4_test_random(-100.0f, 100.0f));
+
+    lna_mat4_t m0;
+    lna_mat4_t m1;
+    lna_mat4_mult(&scale, &rotation_x, &m0);
+    lna_mat4_mult(&m0, &rotation_y, &m1);
+    lna_mat4_mult(&m1, &rotation_z, &m0);
+    lna_mat4_mult(&m0, &translation, &m1);
+    return m1;
+}
+
+static void lna_mat4_test_model_matrix(void)
+{
+    //! the push constant blocks are mat4 model, vec4 tint and, for the meshes, a mat3 of 3 padded columns
+    lna_test_check(sizeof(lna_mat4_t) == 64)
+    lna_test_check(sizeof(lna_vec4_t) == 16)
+    lna_test_check(sizeof(lna_normal_matrix_t) == 48)
+
+    const lna_mat4_t translation = lna_mat4_translation(1.0f, 2.0f, 3.0f);
+    lna_test_check(lna_mat4_test_vec4_near(lna_mat4_test_transform(&translation, (lna_vec4_t){ 4.0f, 5.0f, 6.0f, 1.0f }), (lna_vec4_t){ 5.0f, 7.0f, 9.0f, 1.0f }))
+    lna_test_check(lna_mat4_test_vec4_near(lna_mat4_test_transform(&translation, (lna_vec4_t){ 4.0f, 5.0f, 6.0f, 0.0f }), (lna_vec4_t){ 4.0f, 5.0f, 6.0f, 0.0f }))
+
+    const lna_mat4_t rotation_z = lna_mat4_rotation_z((lna_degree_t){ 90.0f });
+    lna_test_check(lna_mat4_test_vec4_near(lna_mat4_test_transform(&rotation_z, (lna_vec4_t){ 1.0f, 0.0f, 0.0f, 1.0f }), (lna_vec4_t){ 0.0f, -1.0f, 0.0f, 1.0f }))
+
+    //! lna_mat4_mult(a, b) applies a then b
+    for (int i = 0; i < 1000; ++i)
+    {
+        const lna_mat4_t a = lna_mat4_test_random_model();
+        const lna_mat4_t b = lna_mat4_test_random_model();
+        lna_mat4_t ab;
+        lna_mat4_mult(&a, &b, &ab);
+
+        const lna_vec4_t point = { lna_mat4_test_random(-10.0f, 10.0f), lna_mat4_test_random(-10.0f, 10.0f), lna_mat4_test_random(-10.0f, 10.0f), 1.0f };
+        lna_test_check(lna_mat4_test_vec4_near(lna_mat4_test_transform(&ab, point), lna_mat4_test_transform(&b, lna_mat4_test_transform(&a, point))))
+    }
+}
+
+static void lna_mat4_test_inverse(void)
+{
+    //! the translations reach 100 units: the points are compared to the
+    //! precision of the transformed points rather than of the identity
+    for (int i = 0; i < 1000; ++i)
+    {
+        const lna_mat4_t m = lna_mat4_test_random_model();
+        lna_mat4_t inverse;
+        lna_test_check(lna_mat4_inverse(&m, &inverse))
+
+        const lna_vec4_t point          = { lna_mat4_test_random(-10.0f, 10.0f), lna_mat4_test_random(-10.0f, 10.0f), lna_mat4_test_random(-10.0f, 10.0f), 1.0f };
+        const lna_vec4_t transformed    = lna_mat4_test_transform(&m, point);
+        const lna_vec4_t result         = lna_mat4_test_transform(&inverse, transformed);
+        const float      tolerance      = LNA_MAT4_TEST_EPSILON * (1.0f + fabsf(transformed.x) + fabsf(transformed.y) + fabsf(transformed.z));
+        lna_test_check(fabsf(result.x - point.x) <= tolerance && fabsf(result.y - point.y) <= tolerance && fabsf(result.z - point.z) <= tolerance && lna_mat4_test_near(result.w, 1.0f))
+    }
+
+    //! a projection has a non zero w row, the full 4x4 inverse is needed
+    const lna_mat4_t    perspective = lna_mat4_perspective((lna_degree_t){ 60.0f }, 16.0f / 9.0f, 0.1f, 100.0f);
+    const lna_vec4_t    point       = { 1.0f, -2.0f, -10.0f, 1.0f };
+    lna_mat4_t          inverse_perspective;
+    lna_test_check(lna_mat4_inverse(&perspective, &inverse_perspective))
+    lna_test_check(lna_mat4_test_vec4_near(lna_mat4_test_transform(&inverse_perspective, lna_mat4_test_transform(&perspective, point)), point))
+
+    //! a null scale is not invertible, the result is left unchanged
+    const lna_mat4_t    flat    = lna_mat4_scale(1.0f, 0.0f, 1.0f);
+    lna_mat4_t          result  = lna_mat4_translation(7.0f, 8.0f, 9.0f);
+    const lna_mat4_t    before  = result;
+    lna_test_check(!lna_mat4_inverse(&flat, &result))
+    lna_test_check(memcmp(&result, &before, sizeof(lna_mat4_t)) == 0)
+}
+
+static void lna_mat4_test_normal_matrix(void)
+{
+    //! the upper left 3x3 part of transpose(inverse(m)), as the shaders computed it
+    for (int i = 0; i < 1000; ++i)
+    {
+        const lna_mat4_t m = lna_mat4_test_random_model();
+        lna_mat4_t inverse;
+        lna_mat4_t inverse_transpose;
+        lna_test_check(lna_mat4_inverse(&m, &inverse))
+        lna_mat4_transpose(&inverse, &inverse_transpose);
+
+        lna_normal_matrix_t normal_matrix;
+        lna_mat4_normal_matrix(&m, &normal_matrix);
+        bool is_equal = true;
+        for (int j = 0; j < 3; ++j)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                is_equal = is_equal && lna_mat4_test_near(normal_matrix.values[j][k], inverse_transpose.values[j][k]);
+            }
+            is_equal = is_equal && normal_matrix.values[j][3] == 0.0f;
+        }
+        lna_test_check(is_equal)
+    }
+
+    //! a non uniform scale: the normal of the plane x + y = 0 scaled by (2, 1, 1) is (1, 2, 0) up to its length
+    const lna_mat4_t    scale = lna_mat4_scale(2.0f, 1.0f, 1.0f);
+    lna_normal_matrix_t normal_matrix;
+    lna_mat4_normal_matrix(&scale, &normal_matrix);
+    const lna_mat4_t    normal_mat4 =
+    {
+        .values =
+        {
+            { normal_matrix.values[0][0], normal_matrix.values[0][1], normal_matrix.values[0][2], 0.0f },
+            { normal_matrix.values[1][0], normal_matrix.values[1][1], normal_matrix.values[1][2], 0.0f },
+            { normal_matrix.values[2][0], normal_matrix.values[2][1], normal_matrix.values[2][2], 0.0f },
+            { 0.0f, 0.0f, 0.0f, 1.0f },
+        },
+    };
+    const lna_vec4_t    normal = lna_mat4_test_transform(&normal_mat4, (lna_vec4_t){ 1.0f, 1.0f, 0.0f, 0.0f });
+    lna_test_check(lna_mat4_test_near(normal.y, 2.0f * normal.x) && lna_mat4_test_near(normal.z, 0.0f) && normal.x > 0.0f)
+
+    //! a null scale: the cofactors keep the normals of the flattened surfaces
+    const lna_mat4_t flat = lna_mat4_scale(1.0f, 0.0f, 1.0f);
+    lna_mat4_normal_matrix(&flat, &normal_matrix);
+    lna_test_check(normal_matrix.values[1][1] != 0.0f)
+    lna_test_check(normal_matrix.values[0][0] == 0.0f && normal_matrix.values[2][2] == 0.0f)
+}
+
+int main(void)
+{
+    lna_mat4_test_model_matrix();
+    lna_mat4_test_inverse();
+    lna_mat4_test_normal_matrix();
+    return lna_test_result();
+}
@@ -0,0 +1,210 @@
+//! load time of a generated grid model: the obj file is parsed with 1 thread,
+//! then with twice as many up to the cpu count, each result is compared to
+//! the single thread one. The model is then loaded from its binary cache,
+//! the time includes a read of all the mapped data. The grid size can be
+//! given as first argument and the highest thread count as second argument.
+//! build (linux, from the code directory, lna_file.c needs a C library with fopen_s):
+//!     gcc -std=c11 -O2 -I . tests/lna_model_benchmark.c graphics/lna_model.c graphics/lna_model_optimizer.c maths/lna_vec3.c maths/lna_maths.c core/lna_string.c core/lna_file.c core/lna_stack_allocator.c core/lna_atomic_memory_pool.c core/lna_memory_pool.c core/lna_memory_tracking.c core/lna_heap_allocator.c core/lna_log.c backends/linux/lna_file_linux.c backends/linux/lna_heap_allocator_linux.c backends/sdl/lna_thread_sdl.c $(sdl2-config --cflags --libs) -lm -o lna_model_benchmark
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests/lna_test.h"
+#include "graphics/lna_model.h"
+#include "core/lna_heap_allocator.h"
+#include "core/lna_memory_pool.h"
+#include "core/lna_stack_allocator.h"
+#include "core/lna_log.h"
+#include "system/lna_thread.h"
+
+#define LNA_MODEL_BENCHMARK_OBJ_FILENAME        "lna_model_benchmark.obj"
+#define LNA_MODEL_BENCHMARK_CACHE_FILENAME      "lna_model_benchmark.lnam"
+#define LNA_MODEL_BENCHMARK_DEFAULT_GRID_SIZE   512
+#define LNA_MODEL_BENCHMARK_REPEAT_COUNT        3
+
+//! size x size vertices, each grid cell is split in 2 triangles. The
+//! positions and the uvs have the same indices, there is a single normal.
+static size_t lna_model_benchmark_write_obj(uint32_t size)
+{
+    FILE* file = fopen(LNA_MODEL_BENCHMARK_OBJ_FILENAME, "w");
+    lna_test_check(file)
+    if (!file)
+    {
+        return 0;
+    }
+
+    for (uint32_t y = 0; y < size; ++y)
+    {
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            fprintf(file, "v %f %f %f\n", (float)x * 0.125f, (float)((x * 7 + y * 13) % 17) * 0.0625f, (float)y * -0.125f);
+        }
+    }
+    for (uint32_t y = 0; y < size; ++y)
+    {
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            fprintf(file, "vt %f %f\n", (float)x / (float)(size - 1), (float)y / (float)(size - 1));
+        }
+    }
+    fprintf(file, "vn 0.000000 1.000000 0.000000\n");
+    for (uint32_t y = 0; y + 1 < size; ++y)
+    {
+        for (uint32_t x = 0; x + 1 < size; ++x)
+        {
+            //! obj indices start at 1
+            const uint32_t i00 = y * size + x + 1;
+            const uint32_t i10 = i00 + 1;
+            const uint32_t i01 = i00 + size;
+            const uint32_t i11 = i01 + 1;
+            fprintf(file, "f %u/%u/1 %u/%u/1 %u/%u/1\n", i00, i00, i01, i01, i10, i10);
+            fprintf(file, "f %u/%u/1 %u/%u/1 %u/%u/1\n", i10, i10, i01, i01, i11, i11);
+        }
+    }
+
+    const long file_size = ftell(file);
+    fclose(file);
+    return file_size > 0 ? (size_t)file_size : 0;
+}
+
+static double lna_model_benchmark_load(lna_model_t* model, lna_model_config_t* config, lna_memory_pool_t* model_pool)
+{
+    double time = 0.0;
+    for (uint32_t repeat = 0; repeat < LNA_MODEL_BENCHMARK_REPEAT_COUNT; ++repeat)
+    {
+        lna_memory_pool_empty(model_pool);
+        memset(model, 0, sizeof(lna_model_t));
+
+        const double start_time = lna_test_time_in_ms();
+        lna_model_init(
+            model,
+            config
+            );
+        time += lna_test_time_in_ms() - start_time;
+    }
+    return time / LNA_MODEL_BENCHMARK_REPEAT_COUNT;
+}
+
+static bool lna_model_benchmark_equals(const lna_model_t* model, const lna_model_t* expected_model)
+{
+    return
+        model->vertices.count == expected_model->vertices.count
+        && model->indices.count == expected_model->indices.count
+        && memcmp(model->vertices.data, expected_model->vertices.data, sizeof(lna_model_vertex_t) * model->vertices.count) == 0
+        && memcmp(model->indices.data, expected_model->indices.data, sizeof(uint32_t) * model->indices.count) == 0;
+}
+
+int main(int argc, char** argv)
+{
+    lna_log_set_level(LNA_LOG_LEVEL_ERROR);
+
+    uint32_t grid_size = argc > 1 ? (uint32_t)atoi(argv[1]) : LNA_MODEL_BENCHMARK_DEFAULT_GRID_SIZE;
+    grid_size = grid_size > 2 ? grid_size : 2;
+
+    const size_t file_size = lna_model_benchmark_write_obj(grid_size);
+    printf("%u x %u grid, obj file of %.1f MB\n", grid_size, grid_size, (double)file_size / (1024.0 * 1024.0));
+
+    //! the parse needs the file, 2 times its size for the parallel parse, the
+    //! merged arrays, and for each of the 6 indices of a grid cell a vertex
+    //! and up to 4 hash table entries
+    const size_t temp_stack_size    = 4 * file_size + 6 * (size_t)grid_size * grid_size * (sizeof(lna_model_vertex_t) + 4 * 16 + sizeof(uint32_t)) + 1024 * 1024;
+    const size_t model_pool_size    = 2 * (size_t)grid_size * grid_size * (sizeof(lna_model_vertex_t) + 6 * sizeof(uint32_t)) + 1024;
+
+    lna_heap_allocator_t allocator = { 0 };
+    lna_heap_allocator_init(
+        &allocator,
+        temp_stack_size + 3 * model_pool_size
+        );
+    lna_stack_allocator_t temp_stack = { 0 };
+    lna_stack_allocator_init_with_heap(
+        &temp_stack,
+        &allocator,
+        temp_stack_size
+        );
+    lna_memory_pool_t expected_model_pool   = { 0 };
+    lna_memory_pool_t model_pool            = { 0 };
+    lna_memory_pool_init_with_heap(
+        &expected_model_pool,
+        &allocator,
+        model_pool_size
+        );
+    lna_memory_pool_init_with_heap(
+        &model_pool,
+        &allocator,
+        model_pool_size
+        );
+
+    lna_model_config_t config =
+    {
+        .filename                   = LNA_MODEL_BENCHMARK_OBJ_FILENAME,
+        .parse_thread_count         = 1,
+        .temp_stack                 = &temp_stack,
+        .object_lifetime_mem_pool   = &expected_model_pool,
+    };
+    lna_model_t expected_model;
+    const double single_thread_time = lna_model_benchmark_load(
+        &expected_model,
+        &config,
+        &expected_model_pool
+        );
+    lna_test_check(expected_model.vertices.count == grid_size * grid_size)
+    lna_test_check(expected_model.indices.count == 6 * (grid_size - 1) * (grid_size - 1))
+    printf("obj parse  1 thread : %9.3f ms\n", single_thread_time);
+
+    const uint32_t max_thread_count = argc > 2 ? (uint32_t)atoi(argv[2]) : lna_thread_cpu_count();
+    config.object_lifetime_mem_pool = &model_pool;
+    for (uint32_t thread_count = 2; thread_count < 2 * max_thread_count; thread_count *= 2)
+    {
+        config.parse_thread_count = thread_count < max_thread_count ? thread_count : max_thread_count;
+        lna_model_t model;
+        const double time = lna_model_benchmark_load(
+            &model,
+            &config,
+            &model_pool
+            );
+        lna_test_check(lna_model_benchmark_equals(&model, &expected_model))
+        printf("obj parse %2u threads: %9.3f ms (x%.2f)\n", config.parse_thread_count, time, single_thread_time / time);
+    }
+
+    //! the first init parses the obj file and writes the cache, the next ones map it
+    config.parse_thread_count   = 1;
+    config.cache_filename       = LNA_MODEL_BENCHMARK_CACHE_FILENAME;
+    remove(LNA_MODEL_BENCHMARK_CACHE_FILENAME);
+    lna_memory_pool_empty(&model_pool);
+    lna_model_t cached_model = { 0 };
+    lna_model_init(
+        &cached_model,
+        &config
+        );
+    lna_test_check(cached_model.cache_file_mapping.content == NULL)
+    lna_model_release(&cached_model);
+
+    double cache_time = 0.0;
+    for (uint32_t repeat = 0; repeat < LNA_MODEL_BENCHMARK_REPEAT_COUNT; ++repeat)
+    {
+        lna_memory_pool_empty(&model_pool);
+        memset(&cached_model, 0, sizeof(lna_model_t));
+
+        const double start_time = lna_test_time_in_ms();
+        lna_model_init(
+            &cached_model,
+            &config
+            );
+        const bool is_equal = lna_model_benchmark_equals(&cached_model, &expected_model);
+        cache_time += lna_test_time_in_ms() - start_time;
+
+        lna_test_check(cached_model.cache_file_mapping.content != NULL)
+        lna_test_check(is_equal)
+        lna_model_release(&cached_model);
+    }
+    cache_time /= LNA_MODEL_BENCHMARK_REPEAT_COUNT;
+    printf("binary cache        : %9.3f ms (x%.2f)\n", cache_time, single_thread_time / cache_time);
+
+    lna_memory_pool_release(&model_pool);
+    lna_memory_pool_release(&expected_model_pool);
+    lna_stack_allocator_release(&temp_stack);
+    lna_heap_allocator_release(&allocator);
+    remove(LNA_MODEL_BENCHMARK_OBJ_FILENAME);
+    remove(LNA_MODEL_BENCHMARK_CACHE_FILENAME);
+    return lna_test_result();
+}
@@ -0,0 +1,343 @@
+//! the model optimizer on generated grids: each pass must keep the same
+//! triangles with the same winding, the vertex cache pass must lower the
+//! cache miss ratio of shuffled triangles, the vertex fetch pass must number
+//! the vertices in the order of their first use and drop the unused ones.
+//! The 16 bits indices must give the same results as the 32 bits ones.
+//! build (linux, from the code directory):
+//!     gcc -std=c11 -O2 -I . tests/lna_model_optimizer_test.c graphics/lna_model_optimizer.c maths/lna_vec3.c maths/lna_maths.c core/lna_stack_allocator.c core/lna_memory_pool.c core/lna_memory_tracking.c core/lna_heap_allocator.c core/lna_log.c backends/linux/lna_heap_allocator_linux.c -lm -o lna_model_optimizer_test
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests/lna_test.h"
+#include "graphics/lna_model.h"
+#include "graphics/lna_model_optimizer.h"
+#include "core/lna_heap_allocator.h"
+#include "core/lna_memory_pool.h"
+#include "core/lna_stack_allocator.h"
+#include "core/lna_log.h"
+
+#define LNA_MODEL_OPTIMIZER_TEST_GRID_SIZE      64
+#define LNA_MODEL_OPTIMIZER_TEST_VERTEX_COUNT   (LNA_MODEL_OPTIMIZER_TEST_GRID_SIZE * LNA_MODEL_OPTIMIZER_TEST_GRID_SIZE + 1)
+#define LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT    (6 * (LNA_MODEL_OPTIMIZER_TEST_GRID_SIZE - 1) * (LNA_MODEL_OPTIMIZER_TEST_GRID_SIZE - 1))
+
+typedef struct lna_model_optimizer_test_triangle_s
+{
+    uint32_t    indices[3];
+} lna_model_optimizer_test_triangle_t;
+
+static uint32_t g_random_state = 2463534242u;
+static uint32_t g_optimized_indices[LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT];
+
+static uint32_t lna_model_optimizer_test_random(void)
+{
+    g_random_state ^= g_random_state << 13;
+    g_random_state ^= g_random_state >> 17;
+    g_random_state ^= g_random_state << 5;
+    return g_random_state;
+}
+
+//! a bumpy grid with its triangles in a random order, the last vertex is not
+//! used by any triangle. The positions are unique, they identify the vertices.
+static void lna_model_optimizer_test_grid(lna_model_vertex_t* vertices, uint32_t* indices)
+{
+    const uint32_t size = LNA_MODEL_OPTIMIZER_TEST_GRID_SIZE;
+    for (uint32_t y = 0; y < size; ++y)
+    {
+        for (uint32_t x = 0; x < size; ++x)
+        {
+            lna_model_vertex_t* vertex = &vertices[y * size + x];
+            memset(vertex, 0, sizeof(lna_model_vertex_t));
+            vertex->position = (lna_vec3_t){ (float)x, (float)((x * 7 + y * 13) % 5) * 0.25f, -(float)y };
+            vertex->uv       = (lna_vec2_t){ (float)x / (float)(size - 1), (float)y / (float)(size - 1) };
+            vertex->normal   = (lna_vec3_t){ 0.0f, 1.0f, 0.0f };
+        }
+    }
+    memset(&vertices[size * size], 0, sizeof(lna_model_vertex_t));
+    vertices[size * size].position = (lna_vec3_t){ -1.0f, -1.0f, -1.0f };
+
+    lna_model_optimizer_test_triangle_t* triangles = (lna_model_optimizer_test_triangle_t*)indices;
+    uint32_t triangle_count = 0;
+    for (uint32_t y = 0; y + 1 < size; ++y)
+    {
+        for (uint32_t x = 0; x + 1 < size; ++x)
+        {
+            const uint32_t i00 = y * size + x;
+            const uint32_t i10 = i00 + 1;
+            const uint32_t i01 = i00 + size;
+            const uint32_t i11 = i01 + 1;
+            triangles[triangle_count++] = (lna_model_optimizer_test_triangle_t){ { i00, i01, i10 } };
+            triangles[triangle_count++] = (lna_model_optimizer_test_triangle_t){ { i10, i01, i11 } };
+        }
+    }
+    for (uint32_t t = triangle_count - 1; t > 0; --t)
+    {
+        const uint32_t                              other       = lna_model_optimizer_test_random() % (t + 1);
+        const lna_model_optimizer_test_triangle_t   triangle    = triangles[t];
+        triangles[t]        = triangles[other];
+        triangles[other]    = triangle;
+    }
+}
+
+static int lna_model_optimizer_test_compare_triangles(const void* a, const void* b)
+{
+    return memcmp(a, b, sizeof(lna_model_optimizer_test_triangle_t));
+}
+
+static void lna_model_optimizer_test_copy_indices(uint32_t* destination, const lna_model_index_array_t* indices)
+{
+    for (uint32_t i = 0; i < indices->count; ++i)
+    {
+        destination[i] = indices->data_16 ? (uint32_t)indices->data_16[i] : indices->data[i];
+    }
+}
+
+//! the triangles are compared as sets, a rotation of the indices of a
+//! triangle or a flipped winding is a mismatch.
+static bool lna_model_optimizer_test_same_triangles(const lna_model_index_array_t* indices, const uint32_t* expected_indices, uint32_t index_count)
+{
+    static uint32_t sorted_indices[LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT];
+    static uint32_t sorted_expected_indices[LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT];
+    if (indices->count != index_count)
+    {
+        return false;
+    }
+    lna_model_optimizer_test_copy_indices(sorted_indices, indices);
+    memcpy(sorted_expected_indices, expected_indices, sizeof(uint32_t) * index_count);
+    qsort(sorted_indices, index_count / 3, sizeof(lna_model_optimizer_test_triangle_t), lna_model_optimizer_test_compare_triangles);
+    qsort(sorted_expected_indices, index_count / 3, sizeof(lna_model_optimizer_test_triangle_t), lna_model_optimizer_test_compare_triangles);
+    return memcmp(sorted_indices, sorted_expected_indices, sizeof(uint32_t) * index_count) == 0;
+}
+
+static void lna_model_optimizer_test_compute_stats(void)
+{
+    uint32_t                        data[9];
+    lna_model_index_array_t         indices = { .data = data };
+    lna_model_optimizer_stats_t     stats;
+
+    //! a single triangle: 3 misses
+    memcpy(data, (uint32_t[]){ 0, 1, 2 }, sizeof(uint32_t) * 3);
+    indices.count = 3;
+    stats = lna_model_optimizer_compute_stats(&indices, 3, 32);
+    lna_test_check(stats.transformed_vertex_count == 3)
+    lna_test_check(stats.acmr == 3.0f)
+    lna_test_check(stats.atvr == 1.0f)
+
+    //! 2 triangles sharing an edge: 4 misses
+    memcpy(data, (uint32_t[]){ 0, 1, 2, 2, 1, 3 }, sizeof(uint32_t) * 6);
+    indices.count = 6;
+    stats = lna_model_optimizer_compute_stats(&indices, 4, 32);
+    lna_test_check(stats.transformed_vertex_count == 4)
+    lna_test_check(stats.acmr == 2.0f)
+    lna_test_check(stats.atvr == 1.0f)
+
+    //! the first triangle drawn again: hits in a cache of 6 entries, misses
+    //! in a fifo cache of 3 entries, where the second triangle evicted it
+    memcpy(data, (uint32_t[]){ 0, 1, 2, 3, 4, 5, 0, 1, 2 }, sizeof(uint32_t) * 9);
+    indices.count = 9;
+    stats = lna_model_optimizer_compute_stats(&indices, 6, 6);
+    lna_test_check(stats.transformed_vertex_count == 6)
+    stats = lna_model_optimizer_compute_stats(&indices, 6, 3);
+    lna_test_check(stats.transformed_vertex_count == 9)
+    lna_test_check(stats.atvr == 1.5f)
+
+    //! 16 bits indices
+    uint16_t data_16[6] = { 0, 1, 2, 2, 1, 3 };
+    const lna_model_index_array_t indices_16 = { .data_16 = data_16, .count = 6 };
+    stats = lna_model_optimizer_compute_stats(&indices_16, 4, 32);
+    lna_test_check(stats.transformed_vertex_count == 4)
+}
+
+static void lna_model_optimizer_test_passes(lna_memory_pool_t* temp_pool, bool use_16_bits_indices)
+{
+    static lna_model_vertex_t   vertices_data[LNA_MODEL_OPTIMIZER_TEST_VERTEX_COUNT];
+    static lna_model_vertex_t   expected_vertices_data[LNA_MODEL_OPTIMIZER_TEST_VERTEX_COUNT];
+    static uint32_t             indices_data[LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT];
+    static uint16_t             indices_data_16[LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT];
+    static uint32_t             expected_indices[LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT];
+
+    g_random_state = 2463534242u;
+    lna_model_optimizer_test_grid(vertices_data, indices_data);
+    memcpy(expected_vertices_data, vertices_data, sizeof(vertices_data));
+    memcpy(expected_indices, indices_data, sizeof(indices_data));
+
+    lna_model_vertex_array_t    vertices    = { .data = vertices_data, .count = LNA_MODEL_OPTIMIZER_TEST_VERTEX_COUNT };
+    lna_model_index_array_t     indices     = { .data = indices_data, .count = LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT };
+    if (use_16_bits_indices)
+    {
+        for (uint32_t i = 0; i < LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT; ++i)
+        {
+            indices_data_16[i] = (uint16_t)indices_data[i];
+        }
+        indices.data    = NULL;
+        indices.data_16 = indices_data_16;
+    }
+
+    //! VERTEX CACHE PART
+
+    const lna_model_optimizer_stats_t shuffled_stats = lna_model_optimizer_compute_stats(
+        &indices,
+        vertices.count,
+        LNA_MODEL_OPTIMIZER_DEFAULT_CACHE_SIZE
+        );
+    lna_memory_pool_empty(temp_pool);
+    lna_model_optimizer_vertex_cache(
+        &indices,
+        vertices.count,
+        temp_pool
+        );
+    const lna_model_optimizer_stats_t vertex_cache_stats = lna_model_optimizer_compute_stats(
+        &indices,
+        vertices.count,
+        LNA_MODEL_OPTIMIZER_DEFAULT_CACHE_SIZE
+        );
+    lna_test_check(lna_model_optimizer_test_same_triangles(&indices, expected_indices, LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT))
+    //! the shuffled triangles miss almost every vertex, a grid vertex is
+    //! shared by 6 triangles so 0.5 is the lowest ratio
+    lna_test_check(shuffled_stats.acmr > 2.5f)
+    lna_test_check(vertex_cache_stats.acmr < 0.8f)
+    lna_test_check(vertex_cache_stats.acmr >= 0.5f)
+
+    //! OVERDRAW PART
+
+    lna_model_optimizer_test_copy_indices(expected_indices, &indices);
+    lna_memory_pool_empty(temp_pool);
+    lna_model_optimizer_overdraw(
+        &indices,
+        &vertices,
+        LNA_MODEL_OPTIMIZER_DEFAULT_OVERDRAW_THRESHOLD,
+        temp_pool
+        );
+    const lna_model_optimizer_stats_t overdraw_stats = lna_model_optimizer_compute_stats(
+        &indices,
+        vertices.count,
+        LNA_MODEL_OPTIMIZER_DEFAULT_CACHE_SIZE
+        );
+    lna_test_check(lna_model_optimizer_test_same_triangles(&indices, expected_indices, LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT))
+    //! the clusters are split where the cache does well, reordering them
+    //! costs the misses of their first triangles only
+    lna_test_check(overdraw_stats.acmr <= vertex_cache_stats.acmr * LNA_MODEL_OPTIMIZER_DEFAULT_OVERDRAW_THRESHOLD * 1.1f)
+
+    //! VERTEX FETCH PART
+
+    lna_model_optimizer_test_copy_indices(expected_indices, &indices);
+    lna_memory_pool_empty(temp_pool);
+    lna_model_optimizer_vertex_fetch(
+        &vertices,
+        &indices,
+        temp_pool
+        );
+    lna_test_check(vertices.count == LNA_MODEL_OPTIMIZER_TEST_VERTEX_COUNT - 1)
+    lna_test_check(indices.count == LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT)
+    uint32_t next_vertex        = 0;
+    uint32_t order_error_count  = 0;
+    uint32_t vertex_error_count = 0;
+    for (uint32_t i = 0; i < indices.count; ++i)
+    {
+        const uint32_t v = indices.data_16 ? (uint32_t)indices.data_16[i] : indices.data[i];
+        if (v == next_vertex)
+        {
+            ++next_vertex;
+        }
+        order_error_count   += v > next_vertex ? 1 : 0;
+        vertex_error_count  += memcmp(&vertices.data[v], &expected_vertices_data[expected_indices[i]], sizeof(lna_model_vertex_t)) != 0 ? 1 : 0;
+    }
+    lna_test_check(next_vertex == vertices.count)
+    lna_test_check(order_error_count == 0)
+    lna_test_check(vertex_error_count == 0)
+
+    const lna_model_optimizer_stats_t vertex_fetch_stats = lna_model_optimizer_compute_stats(
+        &indices,
+        vertices.count,
+        LNA_MODEL_OPTIMIZER_DEFAULT_CACHE_SIZE
+        );
+    lna_test_check(vertex_fetch_stats.transformed_vertex_count == overdraw_stats.transformed_vertex_count)
+
+    //! the 32 bits pass runs first, the 16 bits one must give the same indices
+    if (use_16_bits_indices)
+    {
+        lna_model_optimizer_test_copy_indices(expected_indices, &indices);
+        lna_test_check(memcmp(expected_indices, g_optimized_indices, sizeof(g_optimized_indices)) == 0)
+    }
+    else
+    {
+        lna_model_optimizer_test_copy_indices(g_optimized_indices, &indices);
+    }
+
+    printf(
+        "%s bits indices: acmr shuffled %.3f, vertex cache %.3f, overdraw %.3f\n",
+        use_16_bits_indices ? "16" : "32",
+        (double)shuffled_stats.acmr,
+        (double)vertex_cache_stats.acmr,
+        (double)overdraw_stats.acmr
+        );
+}
+
+//! lna_model_optimize pops all its working memory
+static void lna_model_optimizer_test_optimize(lna_stack_allocator_t* temp_stack)
+{
+    static lna_model_vertex_t   vertices_data[LNA_MODEL_OPTIMIZER_TEST_VERTEX_COUNT];
+    static uint32_t             indices_data[LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT];
+
+    g_random_state = 2463534242u;
+    lna_model_optimizer_test_grid(vertices_data, indices_data);
+
+    lna_model_t model = { 0 };
+    model.vertices  = (lna_model_vertex_array_t){ .data = vertices_data, .count = LNA_MODEL_OPTIMIZER_TEST_VERTEX_COUNT };
+    model.indices   = (lna_model_index_array_t){ .data = indices_data, .count = LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT };
+
+    lna_stack_allocator_empty(temp_stack);
+    const size_t temp_size = temp_stack->pool.cur_content_size;
+    lna_model_optimize(
+        &model,
+        temp_stack
+        );
+    lna_test_check(temp_stack->pool.cur_content_size == temp_size)
+    lna_test_check(temp_stack->peak_content_size > temp_size)
+    lna_test_check(model.vertices.count == LNA_MODEL_OPTIMIZER_TEST_VERTEX_COUNT - 1)
+    lna_test_check(model.indices.count == LNA_MODEL_OPTIMIZER_TEST_INDEX_COUNT)
+
+    //! an empty model is left as it is
+    lna_model_t empty_model = { 0 };
+    lna_model_optimize(
+        &empty_model,
+        temp_stack
+        );
+    lna_test_check(empty_model.indices.count == 0)
+    lna_test_check(temp_stack->pool.cur_content_size == temp_size)
+}
+
+int main(void)
+{
+    lna_log_set_level(LNA_LOG_LEVEL_ERROR);
+
+    const size_t temp_size = 4 * 1024 * 1024;
+
+    lna_heap_allocator_t allocator = { 0 };
+    lna_heap_allocator_init(
+        &allocator,
+        2 * temp_size
+        );
+    lna_memory_pool_t temp_pool = { 0 };
+    lna_memory_pool_init_with_heap(
+        &temp_pool,
+        &allocator,
+        temp_size
+        );
+    lna_stack_allocator_t temp_stack = { 0 };
+    lna_stack_allocator_init_with_heap(
+        &temp_stack,
+        &allocator,
+        temp_size
+        );
+
+    lna_model_optimizer_test_compute_stats();
+    lna_model_optimizer_test_passes(&temp_pool, false);
+    lna_model_optimizer_test_passes(&temp_pool, true);
+    lna_model_optimizer_test_optimize(&temp_stack);
+
+    lna_stack_allocator_release(&temp_stack);
+    lna_memory_pool_release(&temp_pool);
+    lna_heap_allocator_release(&allocator);
+    return lna_test_result();
+}
@@ -0,0 +1,214 @@
+//! lna_string_parse_float and lna_string_parse_int against strtof and strtol
+//! in the "C" locale: the results must have the same bits and the same end
+//! pointer. The edge cases are followed by random decimal strings and by the
+//! shortest round trip strings of random floats. The parse time of obj like
+//! floats is then compared to strtof.
+//! build (from the code directory):
+//!     gcc -std=c11 -O2 -I . tests/lna_string_test.c core/lna_string.c core/lna_log.c -lm -o lna_string_test
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "tests/lna_test.h"
+#include "core/lna_string.h"
+
+#define LNA_STRING_TEST_RANDOM_COUNT        1000000
+#define LNA_STRING_TEST_BENCHMARK_COUNT     1000000
+#define LNA_STRING_TEST_MAX_LENGTH          64
+
+static uint32_t g_random_state = 2463534242u;
+static uint32_t g_float_mismatch_count  = 0;
+
+static uint32_t lna_string_test_random(void)
+{
+    g_random_state ^= g_random_state << 13;
+    g_random_state ^= g_random_state >> 17;
+    g_random_state ^= g_random_state << 5;
+    return g_random_state;
+}
+
+static uint32_t lna_string_test_float_bits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static void lna_string_test_check_float(const char* string)
+{
+    char buffer[LNA_STRING_TEST_MAX_LENGTH * 2];
+    lna_string_copy(buffer, string, sizeof(buffer));
+
+    char*       expected_end    = NULL;
+    char*       end             = NULL;
+    const float expected        = strtof(buffer, &expected_end);
+    const float result          = lna_string_parse_float(buffer, &end);
+    if (lna_string_test_float_bits(result) != lna_string_test_float_bits(expected) || end != expected_end)
+    {
+        //! only the first mismatches are printed, the count is checked at the end
+        if (g_float_mismatch_count < 16)
+        {
+            printf("float mismatch: \"%s\" gives %.9g, end %d, strtof gives %.9g, end %d\n", string, result, (int)(end - buffer), expected, (int)(expected_end - buffer));
+        }
+        ++g_float_mismatch_count;
+    }
+}
+
+static void lna_string_test_check_int(const char* string)
+{
+    char buffer[LNA_STRING_TEST_MAX_LENGTH];
+    lna_string_copy(buffer, string, sizeof(buffer));
+
+    char*       expected_end    = NULL;
+    char*       end             = NULL;
+    const long  expected        = strtol(buffer, &expected_end, 10);
+    const int   result          = lna_string_parse_int(buffer, &end);
+    lna_test_check(result == (int)expected)
+    lna_test_check(end == expected_end)
+}
+
+static void lna_string_test_edge_cases(void)
+{
+    static const char* FLOAT_STRINGS[] =
+    {
+        "0", "-0", "+0", "0.0", "00000.00000", "1", "-1", "+1", "1.5", "0.1", "0.2", "0.3",
+        "3.14159265358979323846", "1.000000", "-1.000000 -1.000000", "0.748573 0.750412",
+        "5/1/1", "12abc", "1.", "1.e5", "1e", "1e+", "1e-", "1ex", "1E10", "1e+10", "1e-10",
+        //! float limits: max, the halfway to the next power of two, overflow
+        "3.4028234663852886e38", "3.4028235e38", "3.40282356779733661637539395458142568447e38",
+        "3.40282356779733661637539395458142568448e38", "3.4028236e38", "1e39", "-1e39", "1e400",
+        //! normal and subnormal limits, underflow
+        "1.17549435e-38", "1.1754942e-38", "1.4e-45", "1.401298464324817e-45", "7.006492321624085e-46",
+        "7.006492321624087e-46", "7e-46", "1e-46", "1e-400", "-1e-400",
+        //! ties to even on the 24 bit mantissa
+        "16777216", "16777217", "16777218", "16777219", "16777220", "33554434", "33554435",
+        "1.00000005960464477539062500", "1.00000005960464477539062501", "1.00000017881393432617187500",
+        "0.100000001490116119384765625", "0.1000000014901161193847656250000000000000000000001",
+        //! more digits than the exact decimal keeps
+        "1.0000000596046447753906250000000000000000000000000000000000000000000000000000000000000000000000000000000001",
+        "123456789012345678901234567890", "0.000000000000000000000000000000000000000000001234567",
+        "99999999999999999999999999999999999999", "4294967295", "4294967296", "18446744073709551616",
+    };
+    for (size_t i = 0; i < sizeof(FLOAT_STRINGS) / sizeof(FLOAT_STRINGS[0]); ++i)
+    {
+        lna_string_test_check_float(FLOAT_STRINGS[i]);
+    }
+
+    static const char* INT_STRINGS[] =
+    {
+        "0", "-0", "+0", "7", "-7", "+42", "0012", "2147483647", "-2147483648", "5/1/1", "12abc", "1.5", "-1e3",
+    };
+    for (size_t i = 0; i < sizeof(INT_STRINGS) / sizeof(INT_STRINGS[0]); ++i)
+    {
+        lna_string_test_check_int(INT_STRINGS[i]);
+    }
+}
+
+//! [-+]digits[.digits][e[-+]digits] with up to 24 digits, most of them
+//! with a decimal exponent where the fast path cannot be exact.
+static void lna_string_test_random_decimals(void)
+{
+    char string[LNA_STRING_TEST_MAX_LENGTH];
+    for (uint32_t i = 0; i < LNA_STRING_TEST_RANDOM_COUNT; ++i)
+    {
+        size_t          length          = 0;
+        const uint32_t  random          = lna_string_test_random();
+        const uint32_t  digit_count     = 1 + random % 24;
+        const uint32_t  point_position  = (random >> 8) % (digit_count + 1);
+        if (random & (1u << 16))
+        {
+            string[length++] = (random & (1u << 17)) ? '-' : '+';
+        }
+        for (uint32_t j = 0; j < digit_count; ++j)
+        {
+            if (j == point_position && j > 0)
+            {
+                string[length++] = '.';
+            }
+            string[length++] = (char)('0' + lna_string_test_random() % 10);
+        }
+        if (random & (1u << 18))
+        {
+            const int exponent = (int)(lna_string_test_random() % 100) - 60;
+            length += (size_t)snprintf(&string[length], sizeof(string) - length, "e%d", exponent);
+        }
+        string[length] = '\0';
+        lna_string_test_check_float(string);
+    }
+}
+
+//! the 9 significant digits of a float are enough to get it back, the 17
+//! digits ones are close to the halfway points between two floats.
+static void lna_string_test_random_floats(void)
+{
+    char string[LNA_STRING_TEST_MAX_LENGTH];
+    for (uint32_t i = 0; i < LNA_STRING_TEST_RANDOM_COUNT; ++i)
+    {
+        const uint32_t  bits = lna_string_test_random();
+        float           value;
+        memcpy(&value, &bits, sizeof(value));
+        if (!isfinite(value))
+        {
+            continue;
+        }
+
+        snprintf(string, sizeof(string), "%.9g", value);
+        lna_string_test_check_float(string);
+        lna_test_check(lna_string_test_float_bits(lna_string_parse_float(string, NULL)) == bits)
+
+        snprintf(string, sizeof(string), "%.17g", (double)value * (1.0 + 0x1p-25));
+        lna_string_test_check_float(string);
+    }
+}
+
+static void lna_string_test_benchmark(void)
+{
+    //! the floats of an obj file: 6 decimals, a few units at most
+    char* strings = malloc(LNA_STRING_TEST_BENCHMARK_COUNT * 16);
+    lna_test_check(strings)
+    if (!strings)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < LNA_STRING_TEST_BENCHMARK_COUNT; ++i)
+    {
+        const float value = (float)((int32_t)(lna_string_test_random() % 20000001) - 10000000) / 1000000.0f;
+        snprintf(&strings[i * 16], 16, "%f", value);
+    }
+
+    float           sum             = 0.0f;
+    float           expected_sum    = 0.0f;
+    const double    start_time      = lna_test_time_in_ms();
+    for (uint32_t i = 0; i < LNA_STRING_TEST_BENCHMARK_COUNT; ++i)
+    {
+        sum += lna_string_parse_float(&strings[i * 16], NULL);
+    }
+    const double    strtof_start_time   = lna_test_time_in_ms();
+    for (uint32_t i = 0; i < LNA_STRING_TEST_BENCHMARK_COUNT; ++i)
+    {
+        expected_sum += strtof(&strings[i * 16], NULL);
+    }
+    const double    end_time            = lna_test_time_in_ms();
+    lna_test_check(lna_string_test_float_bits(sum) == lna_string_test_float_bits(expected_sum))
+
+    printf(
+        "%d obj floats: lna_string_parse_float %.3f ms, strtof %.3f ms (x%.2f)\n",
+        LNA_STRING_TEST_BENCHMARK_COUNT,
+        strtof_start_time - start_time,
+        end_time - strtof_start_time,
+        (end_time - strtof_start_time) / (strtof_start_time - start_time)
+        );
+    free(strings);
+}
+
+int main(void)
+{
+    lna_string_test_edge_cases();
+    lna_string_test_random_decimals();
+    lna_string_test_random_floats();
+    lna_test_check(g_float_mismatch_count == 0)
+
+    lna_string_test_benchmark();
+    return lna_test_result();
+}
@@ -0,0 +1,36 @@
+#ifndef LNA_TESTS_LNA_TEST_H
+#define LNA_TESTS_LNA_TEST_H
+
+#include <stdio.h>
+#include <time.h>
+
+//! the tests and benchmarks of this directory are standalone programs, each
+//! one gives its build command at the top of its file. They are run from the
+//! code directory and return the count of failed checks.
+
+#define LNA_TEST_STR(x) #x
+#define lna_test_check(x) if(!(x)) { printf("check failed: %s (%s::%d)\n", LNA_TEST_STR(x), __FILE__, __LINE__); ++g_lna_test_failure_count; }
+
+static int g_lna_test_failure_count = 0;
+
+static inline double lna_test_time_in_ms(void)
+{
+    struct timespec time_spec;
+    timespec_get(&time_spec, TIME_UTC);
+    return (double)time_spec.tv_sec * 1000.0 + (double)time_spec.tv_nsec / 1000000.0;
+}
+
+static inline int lna_test_result(void)
+{
+    if (g_lna_test_failure_count == 0)
+    {
+        printf("all checks passed\n");
+    }
+    else
+    {
+        printf("%d checks failed\n", g_lna_test_failure_count);
+    }
+    return g_lna_test_failure_count;
+}
+
+#endif
@@ -0,0 +1,448 @@
+//! stress test of the device memory sub-allocator with tens of thousands of
+//! buffers and images of random sizes and alignments: they are allocated,
+//! then freed and allocated again in random order. The live allocations are
+//! checked for overlaps and alignment, the host visible ones are filled and
+//! checked once the churn is done. The test defines the few vulkan functions
+//! the allocator calls on top of host memory, it needs the vulkan headers but
+//! neither a device nor the vulkan library.
+//! build (linux, from the code directory):
+//!     gcc -std=c11 -O2 -I . tests/lna_vulkan_memory_allocator_test.c backends/vulkan/lna_vulkan_memory_allocator.c core/lna_memory_pool.c core/lna_memory_tracking.c core/lna_heap_allocator.c core/lna_log.c backends/linux/lna_heap_allocator_linux.c -o lna_vulkan_memory_allocator_test
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "tests/lna_test.h"
+#include "backends/vulkan/lna_vulkan_memory_allocator.h"
+#include "backends/vulkan/lna_vulkan.h"
+#include "core/lna_heap_allocator.h"
+#include "core/lna_memory_pool.h"
+#include "core/lna_log.h"
+
+#define LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT   50000
+#define LNA_VULKAN_MEMORY_ALLOCATOR_TEST_CHURN_COUNT        200000
+#define LNA_VULKAN_MEMORY_ALLOCATOR_TEST_CHECK_PERIOD       50000
+#define LNA_VULKAN_MEMORY_ALLOCATOR_TEST_BLOCK_SIZE         (16 * 1024 * 1024)
+#define LNA_VULKAN_MEMORY_ALLOCATOR_TEST_MAX_BLOCK_COUNT    256
+#define LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ATOM_SIZE          64
+
+//! memory types of a discrete gpu: device local, host visible and coherent
+//! (staging, uniforms), host visible and cached but not coherent (readback)
+typedef enum lna_vulkan_memory_allocator_test_type_e
+{
+    LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_DEVICE_LOCAL,
+    LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_HOST_COHERENT,
+    LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_HOST_NON_COHERENT,
+    LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_COUNT,
+} lna_vulkan_memory_allocator_test_type_t;
+
+typedef struct lna_vulkan_memory_allocator_test_allocation_s
+{
+    lna_vulkan_memory_allocation_t          allocation;
+    VkDeviceSize                            requested_size;
+    VkDeviceSize                            alignment;
+    lna_vulkan_memory_allocator_test_type_t type;
+    bool                                    optimal_image;
+    uint8_t                                 fill_value;
+} lna_vulkan_memory_allocator_test_allocation_t;
+
+typedef struct lna_vulkan_memory_allocator_test_range_s
+{
+    uintptr_t                               memory;
+    VkDeviceSize                            offset;
+    VkDeviceSize                            size;
+} lna_vulkan_memory_allocator_test_range_t;
+
+static lna_vulkan_memory_allocator_test_allocation_t    g_allocations[LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT];
+static lna_vulkan_memory_allocator_test_range_t         g_ranges[LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT];
+static uint32_t                                         g_churn_indices[LNA_VULKAN_MEMORY_ALLOCATOR_TEST_CHECK_PERIOD];
+static uint32_t                                         g_random_state                  = 2463534242u;
+static uint32_t                                         g_device_memory_count           = 0;
+static uint32_t                                         g_device_memory_allocate_count  = 0;
+static uint32_t                                         g_flush_count                   = 0;
+
+static uint32_t lna_vulkan_memory_allocator_test_random(void)
+{
+    g_random_state ^= g_random_state << 13;
+    g_random_state ^= g_random_state >> 17;
+    g_random_state ^= g_random_state << 5;
+    return g_random_state;
+}
+
+//! ============================================================================
+//!                             FAKE DEVICE
+//! ============================================================================
+
+void lna_vulkan_check(VkResult result)
+{
+    lna_test_check(result == VK_SUCCESS)
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceMemoryProperties(VkPhysicalDevice physical_device, VkPhysicalDeviceMemoryProperties* memory_properties)
+{
+    (void)physical_device;
+    memset(memory_properties, 0, sizeof(VkPhysicalDeviceMemoryProperties));
+    memory_properties->memoryTypeCount                                                                      = LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_COUNT;
+    memory_properties->memoryTypes[LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_DEVICE_LOCAL].propertyFlags         = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    memory_properties->memoryTypes[LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_HOST_COHERENT].propertyFlags        = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    memory_properties->memoryTypes[LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_HOST_NON_COHERENT].propertyFlags    = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceProperties(VkPhysicalDevice physical_device, VkPhysicalDeviceProperties* properties)
+{
+    (void)physical_device;
+    memset(properties, 0, sizeof(VkPhysicalDeviceProperties));
+    properties->limits.nonCoherentAtomSize      = LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ATOM_SIZE;
+    properties->limits.maxMemoryAllocationCount = 4096;
+}
+
+//! the device memory is host memory, so every memory type can be mapped and
+//! the content of the allocations checked
+VKAPI_ATTR VkResult VKAPI_CALL vkAllocateMemory(VkDevice device, const VkMemoryAllocateInfo* allocate_info, const VkAllocationCallbacks* allocator, VkDeviceMemory* memory)
+{
+    (void)device;
+    (void)allocator;
+    void* content = malloc((size_t)allocate_info->allocationSize);
+    if (!content)
+    {
+        return VK_ERROR_OUT_OF_DEVICE_MEMORY;
+    }
+    ++g_device_memory_count;
+    ++g_device_memory_allocate_count;
+    *memory = (VkDeviceMemory)(uintptr_t)content;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkFreeMemory(VkDevice device, VkDeviceMemory memory, const VkAllocationCallbacks* allocator)
+{
+    (void)device;
+    (void)allocator;
+    lna_test_check(g_device_memory_count > 0)
+    --g_device_memory_count;
+    free((void*)(uintptr_t)memory);
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkMapMemory(VkDevice device, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize size, VkMemoryMapFlags flags, void** data)
+{
+    (void)device;
+    (void)size;
+    (void)flags;
+    *data = (char*)(uintptr_t)memory + offset;
+    return VK_SUCCESS;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkUnmapMemory(VkDevice device, VkDeviceMemory memory)
+{
+    (void)device;
+    (void)memory;
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkFlushMappedMemoryRanges(VkDevice device, uint32_t memory_range_count, const VkMappedMemoryRange* memory_ranges)
+{
+    (void)device;
+    for (uint32_t i = 0; i < memory_range_count; ++i)
+    {
+        lna_test_check(memory_ranges[i].offset % LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ATOM_SIZE == 0)
+        lna_test_check(memory_ranges[i].size % LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ATOM_SIZE == 0)
+    }
+    ++g_flush_count;
+    return VK_SUCCESS;
+}
+
+//! ============================================================================
+//!                             TEST
+//! ============================================================================
+
+static void lna_vulkan_memory_allocator_test_alloc(lna_vulkan_memory_allocator_t* allocator, lna_vulkan_memory_allocator_test_allocation_t* test_allocation)
+{
+    const uint32_t random = lna_vulkan_memory_allocator_test_random();
+
+    //! mostly small vertex, index and uniform buffers, some textures, a few
+    //! buffers big enough to get a dedicated block
+    test_allocation->type           = (lna_vulkan_memory_allocator_test_type_t)(random % 8 < 5 ? LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_DEVICE_LOCAL : random % 8 < 7 ? LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_HOST_COHERENT : LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_HOST_NON_COHERENT);
+    test_allocation->optimal_image  = test_allocation->type == LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_DEVICE_LOCAL && (random >> 3) % 8 == 0;
+    if (test_allocation->optimal_image)
+    {
+        test_allocation->requested_size = 1024 + (lna_vulkan_memory_allocator_test_random() % (256 * 1024));
+        test_allocation->alignment      = 1024 << ((random >> 6) % 3);
+    }
+    else if ((random >> 6) % 4096 == 0)
+    {
+        test_allocation->requested_size = LNA_VULKAN_MEMORY_ALLOCATOR_TEST_BLOCK_SIZE / 2 + 1 + (lna_vulkan_memory_allocator_test_random() % LNA_VULKAN_MEMORY_ALLOCATOR_TEST_BLOCK_SIZE);
+        test_allocation->alignment      = 256;
+    }
+    else
+    {
+        test_allocation->requested_size = 1 + (lna_vulkan_memory_allocator_test_random() % (random & (1u << 20) ? 65536 : 1024));
+        test_allocation->alignment      = 4u << ((random >> 6) % 7);
+    }
+
+    const VkMemoryPropertyFlags properties[LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_COUNT] =
+    {
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,
+    };
+    const VkMemoryRequirements requirements =
+    {
+        .size           = test_allocation->requested_size,
+        .alignment      = test_allocation->alignment,
+        .memoryTypeBits = 1u << test_allocation->type,
+    };
+    lna_vulkan_memory_allocator_alloc(
+        allocator,
+        &requirements,
+        properties[test_allocation->type],
+        test_allocation->optimal_image,
+        &test_allocation->allocation
+        );
+    test_allocation->fill_value = (uint8_t)(1 + random % 255);
+}
+
+//! every allocation is host visible in the fake device, the device local ones
+//! are filled through their block memory. The fill is not timed, the page
+//! faults of the new blocks would hide the allocator time.
+static void lna_vulkan_memory_allocator_test_fill(lna_vulkan_memory_allocator_t* allocator, const lna_vulkan_memory_allocator_test_allocation_t* test_allocation)
+{
+    char* data = (char*)(uintptr_t)test_allocation->allocation.memory + test_allocation->allocation.offset;
+    memset(
+        data,
+        test_allocation->fill_value,
+        (size_t)test_allocation->requested_size
+        );
+    if (test_allocation->type == LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_HOST_NON_COHERENT)
+    {
+        lna_vulkan_memory_allocator_flush(
+            allocator,
+            &test_allocation->allocation,
+            0,
+            test_allocation->requested_size
+            );
+    }
+}
+
+static int lna_vulkan_memory_allocator_test_compare_ranges(const void* a, const void* b)
+{
+    const lna_vulkan_memory_allocator_test_range_t* ra = a;
+    const lna_vulkan_memory_allocator_test_range_t* rb = b;
+    if (ra->memory != rb->memory)
+    {
+        return ra->memory < rb->memory ? -1 : 1;
+    }
+    return (ra->offset > rb->offset) - (ra->offset < rb->offset);
+}
+
+//! alignment, mapping and content of each allocation, then overlaps between
+//! the allocations and their paddings sorted by memory and offset
+static void lna_vulkan_memory_allocator_test_check(const lna_vulkan_memory_allocator_t* allocator)
+{
+    uint32_t        alignment_error_count   = 0;
+    uint32_t        mapping_error_count     = 0;
+    uint32_t        content_error_count     = 0;
+    uint32_t        overlap_count           = 0;
+    VkDeviceSize    used_size               = 0;
+    for (uint32_t i = 0; i < LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT; ++i)
+    {
+        const lna_vulkan_memory_allocator_test_allocation_t*    test_allocation = &g_allocations[i];
+        const lna_vulkan_memory_allocation_t*                   allocation      = &test_allocation->allocation;
+        const char*                                             data            = (const char*)(uintptr_t)allocation->memory + allocation->offset;
+
+        alignment_error_count += allocation->offset % test_allocation->alignment != 0 ? 1 : 0;
+        alignment_error_count += allocation->size < test_allocation->requested_size ? 1 : 0;
+        if (test_allocation->type == LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_HOST_NON_COHERENT)
+        {
+            //! a flush must not reach the atom of another allocation
+            alignment_error_count += allocation->offset % LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ATOM_SIZE != 0 ? 1 : 0;
+            alignment_error_count += allocation->size % LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ATOM_SIZE != 0 ? 1 : 0;
+        }
+        if (test_allocation->type == LNA_VULKAN_MEMORY_ALLOCATOR_TEST_TYPE_DEVICE_LOCAL)
+        {
+            mapping_error_count += allocation->mapped_data != NULL ? 1 : 0;
+        }
+        else
+        {
+            mapping_error_count += allocation->mapped_data != data ? 1 : 0;
+        }
+        for (VkDeviceSize j = 0; j < test_allocation->requested_size; ++j)
+        {
+            if ((uint8_t)data[j] != test_allocation->fill_value)
+            {
+                ++content_error_count;
+                break;
+            }
+        }
+        alignment_error_count += allocation->padding >= test_allocation->alignment && allocation->padding >= LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ATOM_SIZE ? 1 : 0;
+        used_size += allocation->padding + allocation->size;
+
+        g_ranges[i].memory  = (uintptr_t)allocation->memory;
+        g_ranges[i].offset  = allocation->offset - allocation->padding;
+        g_ranges[i].size    = allocation->padding + allocation->size;
+    }
+    qsort(
+        g_ranges,
+        LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT,
+        sizeof(lna_vulkan_memory_allocator_test_range_t),
+        lna_vulkan_memory_allocator_test_compare_ranges
+        );
+    for (uint32_t i = 1; i < LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT; ++i)
+    {
+        const lna_vulkan_memory_allocator_test_range_t* prev = &g_ranges[i - 1];
+        const lna_vulkan_memory_allocator_test_range_t* cur  = &g_ranges[i];
+        overlap_count += prev->memory == cur->memory && prev->offset + prev->size > cur->offset ? 1 : 0;
+    }
+
+    lna_test_check(alignment_error_count == 0)
+    lna_test_check(mapping_error_count == 0)
+    lna_test_check(content_error_count == 0)
+    lna_test_check(overlap_count == 0)
+    lna_test_check(allocator->allocation_count == LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT)
+    lna_test_check(allocator->used_size == used_size)
+    lna_test_check(allocator->allocated_size >= used_size)
+}
+
+static void lna_vulkan_memory_allocator_test_print(const lna_vulkan_memory_allocator_t* allocator, const char* step, double time, uint32_t operation_count)
+{
+    uint32_t block_count = 0;
+    for (uint32_t i = 0; i < allocator->blocks.cur_element_count; ++i)
+    {
+        block_count += allocator->blocks.elements[i].memory != VK_NULL_HANDLE ? 1 : 0;
+    }
+    printf(
+        "%-8s: %7.3f ms (%6.1f ns per operation), %u allocations in %u device memory blocks, %.1f%% of the blocks used\n",
+        step,
+        time,
+        time * 1000000.0 / operation_count,
+        allocator->allocation_count,
+        block_count,
+        100.0 * (double)allocator->used_size / (double)allocator->allocated_size
+        );
+}
+
+int main(void)
+{
+    lna_log_set_level(LNA_LOG_LEVEL_ERROR);
+
+    const size_t memory_pool_size =
+        sizeof(lna_vulkan_memory_block_t) * LNA_VULKAN_MEMORY_ALLOCATOR_TEST_MAX_BLOCK_COUNT
+        + sizeof(lna_vulkan_memory_range_t) * (LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT + LNA_VULKAN_MEMORY_ALLOCATOR_TEST_MAX_BLOCK_COUNT)
+        + 1024;
+
+    lna_heap_allocator_t heap_allocator = { 0 };
+    lna_heap_allocator_init(
+        &heap_allocator,
+        memory_pool_size
+        );
+    lna_memory_pool_t memory_pool = { 0 };
+    lna_memory_pool_init_with_heap(
+        &memory_pool,
+        &heap_allocator,
+        memory_pool_size
+        );
+
+    //! the handles are only compared to VK_NULL_HANDLE by the allocator
+    static char fake_device;
+    static char fake_physical_device;
+    lna_vulkan_memory_allocator_t allocator = { 0 };
+    const lna_vulkan_memory_allocator_config_t config =
+    {
+        .device                 = (VkDevice)(void*)&fake_device,
+        .physical_device        = (VkPhysicalDevice)(void*)&fake_physical_device,
+        .memory_pool            = &memory_pool,
+        .block_size             = LNA_VULKAN_MEMORY_ALLOCATOR_TEST_BLOCK_SIZE,
+        .max_block_count        = LNA_VULKAN_MEMORY_ALLOCATOR_TEST_MAX_BLOCK_COUNT,
+        .max_allocation_count   = LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT,
+    };
+    lna_vulkan_memory_allocator_init(
+        &allocator,
+        &config
+        );
+
+    //! LOAD PART: all the resources are created
+
+    const double alloc_start_time = lna_test_time_in_ms();
+    for (uint32_t i = 0; i < LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT; ++i)
+    {
+        lna_vulkan_memory_allocator_test_alloc(&allocator, &g_allocations[i]);
+    }
+    const double alloc_time = lna_test_time_in_ms() - alloc_start_time;
+    for (uint32_t i = 0; i < LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT; ++i)
+    {
+        lna_vulkan_memory_allocator_test_fill(&allocator, &g_allocations[i]);
+    }
+    lna_vulkan_memory_allocator_test_print(&allocator, "alloc", alloc_time, LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT);
+    lna_vulkan_memory_allocator_test_check(&allocator);
+
+    //! CHURN PART: random resources are deleted and created again, the free
+    //! ranges get fragmented and merged
+
+    double churn_time = 0.0;
+    for (uint32_t i = 0; i < LNA_VULKAN_MEMORY_ALLOCATOR_TEST_CHURN_COUNT; i += LNA_VULKAN_MEMORY_ALLOCATOR_TEST_CHECK_PERIOD)
+    {
+        const double churn_start_time = lna_test_time_in_ms();
+        for (uint32_t j = 0; j < LNA_VULKAN_MEMORY_ALLOCATOR_TEST_CHECK_PERIOD; ++j)
+        {
+            const uint32_t                                  index           = lna_vulkan_memory_allocator_test_random() % LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT;
+            lna_vulkan_memory_allocator_test_allocation_t*  test_allocation = &g_allocations[index];
+            lna_vulkan_memory_allocator_free(&allocator, &test_allocation->allocation);
+            lna_vulkan_memory_allocator_test_alloc(&allocator, test_allocation);
+            g_churn_indices[j] = index;
+        }
+        churn_time += lna_test_time_in_ms() - churn_start_time;
+        for (uint32_t j = 0; j < LNA_VULKAN_MEMORY_ALLOCATOR_TEST_CHECK_PERIOD; ++j)
+        {
+            lna_vulkan_memory_allocator_test_fill(&allocator, &g_allocations[g_churn_indices[j]]);
+        }
+        lna_vulkan_memory_allocator_test_check(&allocator);
+    }
+    lna_vulkan_memory_allocator_test_print(&allocator, "churn", churn_time, 2 * LNA_VULKAN_MEMORY_ALLOCATOR_TEST_CHURN_COUNT);
+
+    //! UNLOAD PART: the regular blocks are kept, the dedicated ones are released
+
+    const double free_start_time = lna_test_time_in_ms();
+    for (uint32_t i = 0; i < LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT; ++i)
+    {
+        lna_vulkan_memory_allocator_free(&allocator, &g_allocations[i].allocation);
+    }
+    const double free_time = lna_test_time_in_ms() - free_start_time;
+    printf("free    : %7.3f ms (%6.1f ns per operation)\n", free_time, free_time * 1000000.0 / LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT);
+
+    uint32_t block_count        = 0;
+    uint32_t free_range_count   = 0;
+    for (uint32_t i = 0; i < allocator.blocks.cur_element_count; ++i)
+    {
+        const lna_vulkan_memory_block_t* block = &allocator.blocks.elements[i];
+        if (block->memory == VK_NULL_HANDLE)
+        {
+            continue;
+        }
+        ++block_count;
+        lna_test_check(!block->dedicated)
+        lna_test_check(block->used_size == 0)
+        lna_test_check(block->allocation_count == 0)
+        //! the freed ranges are merged back in a single one
+        for (uint32_t range = block->first_free_range; range != LNA_VULKAN_MEMORY_INVALID_INDEX; range = allocator.ranges.elements[range].next)
+        {
+            ++free_range_count;
+            lna_test_check(allocator.ranges.elements[range].offset == 0)
+            lna_test_check(allocator.ranges.elements[range].size == block->size)
+        }
+    }
+    lna_test_check(free_range_count == block_count)
+    lna_test_check(allocator.allocation_count == 0)
+    lna_test_check(allocator.used_size == 0)
+    lna_test_check(g_device_memory_count == block_count)
+
+    printf(
+        "%u allocations, %u frees, %u flushes: %u vkAllocateMemory calls\n",
+        LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT + LNA_VULKAN_MEMORY_ALLOCATOR_TEST_CHURN_COUNT,
+        LNA_VULKAN_MEMORY_ALLOCATOR_TEST_ALLOCATION_COUNT + LNA_VULKAN_MEMORY_ALLOCATOR_TEST_CHURN_COUNT,
+        g_flush_count,
+        g_device_memory_allocate_count
+        );
+
+    lna_vulkan_memory_allocator_release(&allocator);
+    lna_test_check(g_device_memory_count == 0)
+
+    lna_memory_pool_release(&memory_pool);
+    lna_heap_allocator_release(&heap_allocator);
+    return lna_test_result();
+}
@@ -0,0 +1,404 @@
+//! the per frame uniform ring buffer on a fake device: the reservations of a
+//! frame must be aligned, must not overlap and must not reach the persistent
+//! reservations, which keep the same offset and content in all the frames
+//! across the resets. Several threads then reserve and fill blocks of the
+//! same frame, each block is checked once they are done. Last, the cpu time
+//! of a frame is measured for a growing mesh count, each mesh writing the 2
+//! uniform blocks (transforms and light) the mesh system used to map and
+//! unmap in their own device memory. The map and unmap calls this replaces
+//! are driver work, they cannot be measured without a device: the printed
+//! times are what the ring buffer leaves on the cpu. The buffers are host
+//! memory, the test needs the vulkan headers but neither a device nor the
+//! vulkan library.
+//! build (linux, from the code directory):
+//!     gcc -std=c11 -O2 -I . tests/lna_vulkan_uniform_ring_buffer_test.c backends/vulkan/lna_vulkan_uniform_ring_buffer.c core/lna_log.c backends/sdl/lna_thread_sdl.c $(sdl2-config --cflags --libs) -o lna_vulkan_uniform_ring_buffer_test
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include "tests/lna_test.h"
+#include "backends/vulkan/lna_vulkan_uniform_ring_buffer.h"
+#include "backends/vulkan/lna_vulkan.h"
+#include "maths/lna_mat4.h"
+#include "maths/lna_vec4.h"
+#include "core/lna_log.h"
+#include "system/lna_thread.h"
+
+#define LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_ALIGNMENT           256
+#define LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_FRAME_COUNT         3
+#define LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_SIZE                (1024 * 1024)
+#define LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_VIEW_COUNT          5
+#define LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_MAX_THREAD_COUNT    32
+#define LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_THREAD_BLOCK_COUNT  256
+#define LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_MAX_MESH_COUNT      16384
+#define LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_BENCHMARK_FRAMES    120
+
+//! the uniform blocks of the mesh shaders before the model matrix moved to the push constants
+typedef struct lna_vulkan_uniform_ring_buffer_test_mvp_s
+{
+    lna_mat4_t  model;
+    lna_mat4_t  view;
+    lna_mat4_t  projection;
+} lna_vulkan_uniform_ring_buffer_test_mvp_t;
+
+typedef struct lna_vulkan_uniform_ring_buffer_test_light_s
+{
+    lna_vec4_t  position;
+    lna_vec4_t  color;
+} lna_vulkan_uniform_ring_buffer_test_light_t;
+
+typedef struct lna_vulkan_uniform_ring_buffer_test_thread_s
+{
+    lna_vulkan_uniform_ring_buffer_t*   ring_buffer;
+    atomic_bool*                        started;
+    uint32_t                            index;
+    uint32_t                            offsets[LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_THREAD_BLOCK_COUNT];
+} lna_vulkan_uniform_ring_buffer_test_thread_t;
+
+static uint32_t g_random_state          = 2463534242u;
+static uint32_t g_buffer_count          = 0;
+static uint32_t g_next_buffer_handle    = 1;
+
+static uint32_t lna_vulkan_uniform_ring_buffer_test_random(void)
+{
+    g_random_state ^= g_random_state << 13;
+    g_random_state ^= g_random_state >> 17;
+    g_random_state ^= g_random_state << 5;
+    return g_random_state;
+}
+
+//! size of the reservation at index, 1 to 700 bytes: up to 3 alignment units
+static size_t lna_vulkan_uniform_ring_buffer_test_block_size(uint32_t index)
+{
+    return 1 + (index * 2654435761u >> 16) % 700;
+}
+
+static VkDeviceSize lna_vulkan_uniform_ring_buffer_test_aligned_size(size_t size)
+{
+    return ((VkDeviceSize)size + LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_ALIGNMENT - 1) & ~(VkDeviceSize)(LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_ALIGNMENT - 1);
+}
+
+//! ============================================================================
+//!                             FAKE DEVICE
+//! ============================================================================
+
+VKAPI_ATTR void VKAPI_CALL vkGetPhysicalDeviceProperties(VkPhysicalDevice physical_device, VkPhysicalDeviceProperties* properties)
+{
+    (void)physical_device;
+    memset(properties, 0, sizeof(VkPhysicalDeviceProperties));
+    properties->limits.minUniformBufferOffsetAlignment = LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_ALIGNMENT;
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyBuffer(VkDevice device, VkBuffer buffer, const VkAllocationCallbacks* allocator)
+{
+    (void)device;
+    (void)allocator;
+    lna_test_check(buffer != VK_NULL_HANDLE)
+    lna_test_check(g_buffer_count > 0)
+    --g_buffer_count;
+}
+
+//! each buffer has its own host memory, filled with a pattern the reservations must overwrite
+void lna_vulkan_create_buffer(lna_vulkan_memory_allocator_t* allocator, VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer* buffer, lna_vulkan_memory_allocation_t* buffer_allocation)
+{
+    (void)allocator;
+    lna_test_check(usage & VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT)
+    lna_test_check((properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) && (properties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT))
+
+    memset(buffer_allocation, 0, sizeof(lna_vulkan_memory_allocation_t));
+    buffer_allocation->size         = size;
+    buffer_allocation->mapped_data  = malloc((size_t)size);
+    lna_test_check(buffer_allocation->mapped_data)
+    memset(buffer_allocation->mapped_data, 0xcd, (size_t)size);
+    *buffer = (VkBuffer)(uintptr_t)g_next_buffer_handle++;
+    ++g_buffer_count;
+}
+
+void lna_vulkan_memory_allocator_free(lna_vulkan_memory_allocator_t* allocator, lna_vulkan_memory_allocation_t* allocation)
+{
+    (void)allocator;
+    free(allocation->mapped_data);
+    memset(allocation, 0, sizeof(lna_vulkan_memory_allocation_t));
+}
+
+//! ============================================================================
+//!                             TESTS
+//! ============================================================================
+
+static void lna_vulkan_uniform_ring_buffer_test_init(lna_vulkan_uniform_ring_buffer_t* ring_buffer, lna_vulkan_memory_allocator_t* memory_allocator, VkDeviceSize size)
+{
+    const lna_vulkan_uniform_ring_buffer_config_t config =
+    {
+        .memory_allocator   = memory_allocator,
+        .frame_count        = LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_FRAME_COUNT,
+        .size               = size,
+    };
+    lna_vulkan_uniform_ring_buffer_init(
+        ring_buffer,
+        &config
+        );
+}
+
+static void lna_vulkan_uniform_ring_buffer_test_reservations(lna_vulkan_memory_allocator_t* memory_allocator)
+{
+    lna_vulkan_uniform_ring_buffer_t ring_buffer;
+    lna_vulkan_uniform_ring_buffer_test_init(
+        &ring_buffer,
+        memory_allocator,
+        LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_SIZE
+        );
+    lna_test_check(g_buffer_count == LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_FRAME_COUNT)
+    lna_test_check(ring_buffer.alignment == LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_ALIGNMENT)
+
+    //! the views are reserved once, at the end of the buffers and down from there
+    uint32_t view_offsets[LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_VIEW_COUNT];
+    VkDeviceSize persistent_size = 0;
+    for (uint32_t i = 0; i < LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_VIEW_COUNT; ++i)
+    {
+        const size_t size = sizeof(lna_vulkan_uniform_ring_buffer_test_mvp_t) + 16 * i;
+        lna_vulkan_uniform_ring_buffer_reserve_persistent(
+            &ring_buffer,
+            size,
+            &view_offsets[i]
+            );
+        persistent_size += lna_vulkan_uniform_ring_buffer_test_aligned_size(size);
+        lna_test_check(view_offsets[i] % LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_ALIGNMENT == 0)
+        lna_test_check((VkDeviceSize)view_offsets[i] == LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_SIZE - persistent_size)
+        lna_test_check(ring_buffer.persistent_size == persistent_size)
+    }
+
+    for (uint32_t frame = 0; frame < 4 * LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_FRAME_COUNT; ++frame)
+    {
+        const uint32_t frame_index = frame % LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_FRAME_COUNT;
+        lna_vulkan_uniform_ring_buffer_reset(&ring_buffer);
+
+        //! the persistent blocks are written each frame in their frame buffer only
+        for (uint32_t i = 0; i < LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_VIEW_COUNT; ++i)
+        {
+            char* data = lna_vulkan_uniform_ring_buffer_persistent_data(
+                &ring_buffer,
+                frame_index,
+                view_offsets[i]
+                );
+            lna_test_check(data == ring_buffer.mapped_data[frame_index] + view_offsets[i])
+            memset(data, (int)(frame + i), sizeof(lna_vulkan_uniform_ring_buffer_test_mvp_t));
+        }
+
+        //! the per frame blocks fill the buffer up to the persistent ones
+        const VkDeviceSize  free_size   = LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_SIZE - persistent_size;
+        VkDeviceSize        used_size   = 0;
+        uint32_t            block_count = 0;
+        uint32_t            error_count = 0;
+        for (;;)
+        {
+            const size_t size = lna_vulkan_uniform_ring_buffer_test_block_size(block_count + frame);
+            if (used_size + size > free_size)
+            {
+                break;
+            }
+            uint32_t    offset;
+            char*       data = lna_vulkan_uniform_ring_buffer_reserve(
+                &ring_buffer,
+                frame_index,
+                size,
+                &offset
+                );
+            error_count += (VkDeviceSize)offset == used_size ? 0 : 1;
+            error_count += data == ring_buffer.mapped_data[frame_index] + offset ? 0 : 1;
+            memset(data, 0x5a, size);
+            used_size += lna_vulkan_uniform_ring_buffer_test_aligned_size(size);
+            ++block_count;
+        }
+        lna_test_check(error_count == 0)
+        lna_test_check(block_count > 1000)
+
+        //! the frame blocks did not reach the views, the other frames kept their own views
+        if (frame < LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_FRAME_COUNT)
+        {
+            continue;
+        }
+        for (uint32_t f = 0; f < LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_FRAME_COUNT; ++f)
+        {
+            const uint32_t written_frame = frame - (frame_index + LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_FRAME_COUNT - f) % LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_FRAME_COUNT;
+            for (uint32_t i = 0; i < LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_VIEW_COUNT; ++i)
+            {
+                const unsigned char* data = (const unsigned char*)ring_buffer.mapped_data[f] + view_offsets[i];
+                lna_test_check(data[0] == (unsigned char)(written_frame + i) && data[sizeof(lna_vulkan_uniform_ring_buffer_test_mvp_t) - 1] == (unsigned char)(written_frame + i))
+            }
+        }
+    }
+
+    lna_vulkan_uniform_ring_buffer_release(&ring_buffer);
+    lna_test_check(g_buffer_count == 0)
+}
+
+static int lna_vulkan_uniform_ring_buffer_test_thread_main(void* data)
+{
+    lna_vulkan_uniform_ring_buffer_test_thread_t* thread = data;
+    while (!atomic_load(thread->started))
+    {
+        lna_thread_yield();
+    }
+
+    for (uint32_t i = 0; i < LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_THREAD_BLOCK_COUNT; ++i)
+    {
+        const size_t    size = lna_vulkan_uniform_ring_buffer_test_block_size(i);
+        char*           block = lna_vulkan_uniform_ring_buffer_reserve(
+            thread->ring_buffer,
+            1,
+            size,
+            &thread->offsets[i]
+            );
+        memset(block, (int)thread->index + 1, size);
+    }
+    return 0;
+}
+
+static void lna_vulkan_uniform_ring_buffer_test_threads(lna_vulkan_memory_allocator_t* memory_allocator, uint32_t thread_count)
+{
+    static lna_vulkan_uniform_ring_buffer_test_thread_t threads[LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_MAX_THREAD_COUNT];
+    lna_thread_t*                   thread_handles[LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_MAX_THREAD_COUNT];
+    lna_vulkan_uniform_ring_buffer_t ring_buffer;
+    atomic_bool                     started;
+    atomic_init(&started, false);
+
+    //! each block takes 3 alignment units at most
+    lna_vulkan_uniform_ring_buffer_test_init(
+        &ring_buffer,
+        memory_allocator,
+        (VkDeviceSize)thread_count * LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_THREAD_BLOCK_COUNT * 3 * LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_ALIGNMENT
+        );
+    lna_vulkan_uniform_ring_buffer_reset(&ring_buffer);
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        threads[i].ring_buffer  = &ring_buffer;
+        threads[i].started      = &started;
+        threads[i].index        = i;
+        thread_handles[i]       = lna_thread_start(
+            lna_vulkan_uniform_ring_buffer_test_thread_main,
+            &threads[i],
+            "lna_vulkan_uniform_ring_buffer_test"
+            );
+    }
+    atomic_store(&started, true);
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        lna_thread_wait(thread_handles[i]);
+    }
+
+    //! every block kept the value of its thread, the blocks cover the reserved size exactly
+    uint32_t        overwritten_count   = 0;
+    VkDeviceSize    reserved_size       = 0;
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        for (uint32_t j = 0; j < LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_THREAD_BLOCK_COUNT; ++j)
+        {
+            const size_t    size    = lna_vulkan_uniform_ring_buffer_test_block_size(j);
+            const char*     block   = ring_buffer.mapped_data[1] + threads[i].offsets[j];
+            overwritten_count += threads[i].offsets[j] % LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_ALIGNMENT == 0 ? 0 : 1;
+            for (size_t k = 0; k < size; ++k)
+            {
+                overwritten_count += block[k] != (char)(i + 1) ? 1 : 0;
+            }
+            reserved_size += lna_vulkan_uniform_ring_buffer_test_aligned_size(size);
+        }
+    }
+    lna_test_check(overwritten_count == 0)
+    lna_test_check(atomic_load(&ring_buffer.cur_offset) == reserved_size)
+
+    lna_vulkan_uniform_ring_buffer_release(&ring_buffer);
+}
+
+static void lna_vulkan_uniform_ring_buffer_test_benchmark(lna_vulkan_memory_allocator_t* memory_allocator)
+{
+    static lna_vulkan_uniform_ring_buffer_test_mvp_t mvps[LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_MAX_MESH_COUNT];
+    for (uint32_t i = 0; i < LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_MAX_MESH_COUNT; ++i)
+    {
+        for (uint32_t j = 0; j < sizeof(lna_vulkan_uniform_ring_buffer_test_mvp_t) / sizeof(float); ++j)
+        {
+            ((float*)&mvps[i])[j] = (float)(lna_vulkan_uniform_ring_buffer_test_random() % 1000) * 0.01f;
+        }
+    }
+    const lna_vulkan_uniform_ring_buffer_test_light_t light =
+    {
+        .position   = { 1.0f, 2.0f, 3.0f, 1.0f },
+        .color      = { 1.0f, 1.0f, 1.0f, 1.0f },
+    };
+
+    lna_vulkan_uniform_ring_buffer_t ring_buffer;
+    lna_vulkan_uniform_ring_buffer_test_init(
+        &ring_buffer,
+        memory_allocator,
+        (VkDeviceSize)LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_MAX_MESH_COUNT * 2 * LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_ALIGNMENT
+        );
+
+    for (uint32_t mesh_count = 256; mesh_count <= LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_MAX_MESH_COUNT; mesh_count *= 4)
+    {
+        //! the offsets are summed so the reservations cannot be optimized out
+        uint64_t        offset_sum  = 0;
+        const double    start_time  = lna_test_time_in_ms();
+        for (uint32_t frame = 0; frame < LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_BENCHMARK_FRAMES; ++frame)
+        {
+            const uint32_t frame_index = frame % LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_FRAME_COUNT;
+            lna_vulkan_uniform_ring_buffer_reset(&ring_buffer);
+            for (uint32_t i = 0; i < mesh_count; ++i)
+            {
+                uint32_t mvp_offset;
+                uint32_t light_offset;
+                memcpy(
+                    lna_vulkan_uniform_ring_buffer_reserve(
+                        &ring_buffer,
+                        frame_index,
+                        sizeof(lna_vulkan_uniform_ring_buffer_test_mvp_t),
+                        &mvp_offset
+                        ),
+                    &mvps[i],
+                    sizeof(lna_vulkan_uniform_ring_buffer_test_mvp_t)
+                    );
+                memcpy(
+                    lna_vulkan_uniform_ring_buffer_reserve(
+                        &ring_buffer,
+                        frame_index,
+                        sizeof(lna_vulkan_uniform_ring_buffer_test_light_t),
+                        &light_offset
+                        ),
+                    &light,
+                    sizeof(lna_vulkan_uniform_ring_buffer_test_light_t)
+                    );
+                offset_sum += mvp_offset + light_offset;
+            }
+        }
+        const double time = (lna_test_time_in_ms() - start_time) / LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_BENCHMARK_FRAMES;
+
+        //! offset of the mesh i blocks: 2 i and 2 i + 1 alignment units
+        lna_test_check(offset_sum == (uint64_t)LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_BENCHMARK_FRAMES * mesh_count * (2 * (uint64_t)mesh_count - 1) * LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_ALIGNMENT)
+        const lna_vulkan_uniform_ring_buffer_test_mvp_t* last_mvp = (const lna_vulkan_uniform_ring_buffer_test_mvp_t*)(ring_buffer.mapped_data[(LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_BENCHMARK_FRAMES - 1) % LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_FRAME_COUNT] + (size_t)(mesh_count - 1) * 2 * LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_ALIGNMENT);
+        lna_test_check(memcmp(last_mvp, &mvps[mesh_count - 1], sizeof(lna_vulkan_uniform_ring_buffer_test_mvp_t)) == 0)
+        printf("%5u meshes: %8.3f ms per frame, %6.1f ns per mesh\n", mesh_count, time, time * 1000000.0 / mesh_count);
+    }
+
+    lna_vulkan_uniform_ring_buffer_release(&ring_buffer);
+}
+
+int main(int argc, char** argv)
+{
+    lna_log_set_level(LNA_LOG_LEVEL_ERROR);
+
+    uint32_t thread_count = argc > 1 ? (uint32_t)atoi(argv[1]) : lna_thread_cpu_count();
+    thread_count = thread_count > 1 ? thread_count : 2;
+    thread_count = thread_count < LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_MAX_THREAD_COUNT ? thread_count : LNA_VULKAN_UNIFORM_RING_BUFFER_TEST_MAX_THREAD_COUNT;
+
+    //! the ring buffer only reads the physical device and gives the allocator back to the fake functions
+    lna_vulkan_memory_allocator_t memory_allocator = { 0 };
+    memory_allocator.physical_device = (VkPhysicalDevice)(uintptr_t)1;
+
+    lna_vulkan_uniform_ring_buffer_test_reservations(&memory_allocator);
+    lna_vulkan_uniform_ring_buffer_test_threads(
+        &memory_allocator,
+        thread_count
+        );
+    lna_vulkan_uniform_ring_buffer_test_benchmark(&memory_allocator);
+    lna_test_check(g_buffer_count == 0)
+    return lna_test_result();
+}
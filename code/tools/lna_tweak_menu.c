@@ -3,6 +3,7 @@
 #include <inttypes.h>
 #include "tools/lna_tweak_menu.h"
 #include "core/lna_memory_pool.h"
+#include "core/lna_memory_tracking.h"
 #include "core/lna_assert.h"
 #include "core/lna_string.h"
 #include "system/lna_input.h"
@@ -19,6 +20,7 @@ typedef enum lna_tweak_menu_node_type_e
     LNA_TWEAK_MENU_NODE_TYPE_VAR_VALUE_FLOAT,
     LNA_TWEAK_MENU_NODE_TYPE_VAR_VALUE_DOUBLE,
     LNA_TWEAK_MENU_NODE_TYPE_VAR_VALUE_BOOL,
+    LNA_TWEAK_MENU_NODE_TYPE_VAR_VALUE_SIZE,        //! read only
 } lna_tweak_menu_node_type_t;
 
 typedef enum lna_tweak_menu_action_e
@@ -193,6 +195,12 @@ static bool lna_tweak_menu_node_is_editable(const lna_tweak_menu_node_t* node)
         );
 }
 
+static bool lna_tweak_menu_node_has_value(const lna_tweak_menu_node_t* node)
+{
+    return lna_tweak_menu_node_is_editable(node)
+        || (node && node->type == LNA_TWEAK_MENU_NODE_TYPE_VAR_VALUE_SIZE);
+}
+
 //! ============================================================================
 //!                          TWEAK MENU FUNCTIONS
 //! ============================================================================
@@ -351,6 +359,7 @@ void lna_tweak_menu_process_input(const lna_input_t* input)
                     break;
                 case LNA_TWEAK_MENU_NODE_TYPE_VAR_VALUE_BOOL:
                     break; //! we do nothing here! boolean are automatically modified when we press enter.
+                case LNA_TWEAK_MENU_NODE_TYPE_VAR_VALUE_SIZE:
                 case LNA_TWEAK_MENU_NODE_TYPE_UNKNOWN:
                 case LNA_TWEAK_MENU_NODE_TYPE_PAGE:
                 case LNA_TWEAK_MENU_NODE_TYPE_VAR:
@@ -427,6 +436,7 @@ void lna_tweak_menu_process_input(const lna_input_t* input)
                 break;
             case LNA_TWEAK_MENU_NODE_TYPE_VAR_VALUE_BOOL:
                 break; //! we do nothing here! boolean are automatically modified when we press enter.
+            case LNA_TWEAK_MENU_NODE_TYPE_VAR_VALUE_SIZE:
             case LNA_TWEAK_MENU_NODE_TYPE_UNKNOWN:
             case LNA_TWEAK_MENU_NODE_TYPE_PAGE:
             case LNA_TWEAK_MENU_NODE_TYPE_VAR:
@@ -442,7 +452,7 @@ void lna_tweak_menu_process_input(const lna_input_t* input)
     {
         if (
             (!nav->edit_mode || node != nav->cur_page_item)
-            && lna_tweak_menu_node_is_editable(node)
+            && lna_tweak_menu_node_has_value(node)
             )
         {
             switch (node->type)
@@ -465,6 +475,9 @@ void lna_tweak_menu_process_input(const lna_input_t* input)
                 case LNA_TWEAK_MENU_NODE_TYPE_VAR_VALUE_BOOL:
                     snprintf(node->edit_buffer, sizeof node->edit_buffer, "%s", *((bool*)node->var_ptr) ? "true" : "false");
                     break;
+                case LNA_TWEAK_MENU_NODE_TYPE_VAR_VALUE_SIZE:
+                    snprintf(node->edit_buffer, sizeof node->edit_buffer, "%zu", *((const size_t*)node->var_ptr));
+                    break;
                 case LNA_TWEAK_MENU_NODE_TYPE_UNKNOWN:
                 case LNA_TWEAK_MENU_NODE_TYPE_PAGE:
                 case LNA_TWEAK_MENU_NODE_TYPE_VAR:
@@ -526,7 +539,7 @@ void lna_tweak_menu_update(void)
         float child_node_width = min_horizontal_empty_space_size + char_length * graphics->font_size + (char_length - 1.0f) * graphics->spacing;  // TODO: find a better way than this double cast
         max_value_name_length = (child_node_width > max_value_name_length) ? child_node_width : max_value_name_length;
         
-        child_node_width += lna_tweak_menu_node_is_editable(child_node) ? LNA_TWEAK_MENU_NODE_EDIT_BUFFER_MAX_LENGTH * graphics->font_size + (LNA_TWEAK_MENU_NODE_EDIT_BUFFER_MAX_LENGTH - 1.0f) * graphics->spacing + LNA_TWEAK_MENU_PADDING * 4.0f : 0.0f;
+        child_node_width += lna_tweak_menu_node_has_value(child_node) ? LNA_TWEAK_MENU_NODE_EDIT_BUFFER_MAX_LENGTH * graphics->font_size + (LNA_TWEAK_MENU_NODE_EDIT_BUFFER_MAX_LENGTH - 1.0f) * graphics->spacing + LNA_TWEAK_MENU_PADDING * 4.0f : 0.0f;
         width = (child_node_width > width) ? child_node_width : width;
 
         child_node = child_node->next_sibling;
@@ -668,7 +681,7 @@ void lna_tweak_menu_update(void)
             }
             );
 
-        if (lna_tweak_menu_node_is_editable(child_node))
+        if (lna_tweak_menu_node_has_value(child_node))
         {
             lna_vec2_t node_value_pos =
             {
@@ -715,7 +728,7 @@ void lna_tweak_menu_update(void)
 
         node_text_pos.y += graphics->font_size + LNA_TWEAK_MENU_PADDING * 2.0f;
         child_node = child_node->next_sibling;
-        node_text_pos.y += (child_node && lna_tweak_menu_node_is_editable(child_node)) ? LNA_TWEAK_MENU_PADDING : 0.0f;
+        node_text_pos.y += (child_node && lna_tweak_menu_node_has_value(child_node)) ? LNA_TWEAK_MENU_PADDING : 0.0f;
     }
 }
 
@@ -934,3 +947,50 @@ void lna_tweak_menu_push_vec4_var(const char* var_name, lna_vec4_t* var_ptr)
         (void*)(&var_ptr->w)
         );
 }
+
+void lna_tweak_menu_push_size_info(const char* info_name, const size_t* info_ptr)
+{
+    lna_assert(g_tweak_menu)
+    lna_assert(info_ptr)
+
+    lna_tweak_menu_node_t* node = lna_tweak_menu_new_node(
+        info_name,
+        LNA_TWEAK_MENU_NODE_TYPE_VAR,
+        g_tweak_menu->node_pool.last_parent_node,
+        (void*)info_ptr
+        );
+    lna_tweak_menu_new_node(
+        "(size) value",
+        LNA_TWEAK_MENU_NODE_TYPE_VAR_VALUE_SIZE,
+        node,
+        (void*)info_ptr
+        );
+}
+
+void lna_tweak_menu_push_memory_page(void)
+{
+    lna_assert(g_tweak_menu)
+
+#ifdef LNA_MEMORY_TRACKING
+    lna_tweak_menu_push_page("memory");
+    lna_memory_stats_t* stats = lna_memory_tracking_first_stats();
+    while (stats)
+    {
+        //! the pools named by their call site are shown by file name and line, cut to the node name length
+        const char* file_name = strrchr(stats->name, '/');
+        char        page_name[LNA_TWEAK_MENU_NODE_NAME_MAX_LENGTH - 1];
+        snprintf(page_name, sizeof page_name, "%s", file_name ? file_name + 1 : stats->name);
+
+        lna_tweak_menu_push_page(page_name);
+        lna_tweak_menu_push_size_info("max size", &stats->max_size);
+        lna_tweak_menu_push_size_info("cur size", &stats->cur_size);
+        lna_tweak_menu_push_size_info("peak size", &stats->peak_size);
+        lna_tweak_menu_push_size_info("last cycle max", &stats->last_cycle_peak_size);
+        lna_tweak_menu_push_size_info("count", &stats->count);
+        lna_tweak_menu_push_size_info("cycle count", &stats->cycle_count);
+        lna_tweak_menu_pop_page();
+        stats = stats->next;
+    }
+    lna_tweak_menu_pop_page();
+#endif
+}
@@ -1,6 +1,7 @@
 #ifndef LNA_TOOLS_TWEAK_MENU_H
 #define LNA_TOOLS_TWEAK_MENU_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include "maths/lna_vec2.h"
@@ -44,5 +45,10 @@ extern void                     lna_tweak_menu_push_double_var          (const c
 extern void                     lna_tweak_menu_push_vec2_var            (const char* var_name, lna_vec2_t* var_ptr);
 extern void                     lna_tweak_menu_push_vec3_var            (const char* var_name, lna_vec3_t* var_ptr);
 extern void                     lna_tweak_menu_push_vec4_var            (const char* var_name, lna_vec4_t* var_ptr);
+//! read only value, refreshed while its page is shown.
+extern void                     lna_tweak_menu_push_size_info           (const char* info_name, const size_t* info_ptr);
+//! a page per memory pool and heap allocator registered so far, nothing is
+//! pushed if LNA_MEMORY_TRACKING is not defined.
+extern void                     lna_tweak_menu_push_memory_page         (void);
 
 #endif